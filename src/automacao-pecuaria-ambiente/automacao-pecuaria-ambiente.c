@@ -6,15 +6,20 @@
  * @date 2025-07-01
  * * @details
  * Este projeto implementa um sistema de automação que monitora e controla
- * um ambiente usando sensores (simulados) e atuadores (relés).
+ * um ambiente usando sensores e atuadores (relés).
  * * Funcionalidades:
- * - Monitora temperatura, umidade e luminosidade.
- * - Controla luzes, um ventilador e um umidificador via relés.
+ * - Monitora temperatura, umidade (DHT11, lido pelo PIO) e luminosidade (LDR, amostrado pelo ADC com DMA e filtrado).
+ * - Controla luzes, um ventilador e um umidificador via relés, por regras com histerese e tempos mínimos.
+ * - Calcula o ITU (índice de temperatura e umidade) e mínimos, máximos e médias móveis de 1 h, 6 h e 24 h.
  * - Exibe o status em um display OLED SSD1306.
- * - Fornece um painel de controle web (dashboard) com atualização automática.
+ * - Fornece um painel de controle web (dashboard) atualizado por Server-Sent Events.
  * - Permite o download do histórico de sensores em formato CSV.
+ * - Consolida o histórico em camadas (5 min por 2 semanas, 1 h por 1 ano) para tendências de longo prazo.
+ * - Opcionalmente, publica o histórico em lotes num broker MQTT, guardando as amostras enquanto o Wi-Fi cai.
  * - Usa uma matriz de LEDs 5x5 (Neopixel) como indicador visual do estado dos atuadores.
  * - Conecta-se à rede Wi-Fi com lógica de reconexão automática.
+ * - Usa os dois núcleos: rede no núcleo 0, controle e interfaces locais no núcleo 1.
+ * - Acessa o hardware só por inc/hal.h; o mesmo código roda no simulador para Linux (simulador/).
  */
 
 // --- BIBLIOTECAS (INCLUDES) ---
@@ -23,19 +28,50 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "inc/ssd1306.h"
-#include "hardware/i2c.h"
-#include "hardware/clocks.h"
-#include "hardware/rtc.h"
-#include "pico/cyw43_arch.h"
 #include "lwip/pbuf.h"
 #include "lwip/tcp.h"
 #include "pico/util/datetime.h"
-#include "ws2818b.pio.h"
+#include "inc/hal.h"
+#include "inc/agendador.h"
+#include "inc/canal_spsc.h"
+#include "inc/historico.h"
+#include "inc/camadas.h"
+#include "inc/data_hora.h"
+#include "inc/formato.h"
+#include "inc/flash_log.h"
+#include "inc/recursos_web.h"
+#include "inc/json.h"
+#include "inc/http_fluxo.h"
+#include "inc/http_requisicao.h"
+#include "inc/serie_binaria.h"
+#include "inc/regras.h"
+#include "inc/agregados.h"
+#include "inc/metricas.h"
+#if TELEMETRIA_MQTT
+#include "inc/telemetria_mqtt.h"
+#endif
+#if SENSOR_DHT11
+#include "inc/dht11.h"
+#endif
+#if SENSOR_LDR
+#include "inc/amostragem_adc.h"
+#endif
 
 // --- DEFINIÇÕES E CONSTANTES GLOBAIS ---
-// I2C para Display OLED
+// Ligação na placa (GPn do Pico W):
+//   GP7        matriz de LEDs WS2812B
+//   GP14/GP15  OLED, SDA/SCL do i2c1
+//   GP16       DHT11 (SENSOR_DHT11)
+//   GP22       relé do umidificador, quando o GP28 está com o LDR (SENSOR_LDR)
+//   GP26       relé das luzes
+//   GP27       relé do ventilador
+//   GP28       LDR (SENSOR_LDR) ou, sem o LDR, relé do umidificador, como nas placas já instaladas
+
+// I2C para Display OLED (os pinos 14 e 15 são do i2c1)
 const uint I2C_SDA = 14;
 const uint I2C_SCL = 15;
+#define OLED_I2C_BUS 1
+#define OLED_I2C_ADDRESS ssd1306_i2c_address
 #define SSD1306_WIDTH 128
 #define SSD1306_HEIGHT 64
 
@@ -47,41 +83,266 @@ const uint I2C_SCL = 15;
 #define WIFI_SSID "S23"
 #define WIFI_PASS "#Vitor123@"
 
+// Telemetria MQTT (opcional): ative com -DTELEMETRIA_MQTT=ON no CMake
+#if TELEMETRIA_MQTT
+#ifndef MQTT_BROKER
+#define MQTT_BROKER "192.168.0.10"
+#endif
+#define MQTT_PORTA 1883
+#define MQTT_CLIENTE "pico-curral-1"
+#define MQTT_TOPICO "fazenda/curral-1/amostras"
+#define MQTT_INTERVALO_MS (5 * 60 * 1000)   // Um lote a cada 5 amostras, com a fila em dia
+#define MQTT_LOTE_MAXIMO 15
+#endif
+
+// Sensor DHT11 (opcional): desative com -DSENSOR_DHT11=OFF para usar valores simulados
+#if SENSOR_DHT11
+#define DHT11_PIN 16
+#define DHT11_INTERVALO_MS (10 * 1000)   // Três leituras por ciclo de controle; o sensor aceita até 1 por segundo
+#endif
+
+// LDR (saída analógica AO) amostrado continuamente pelo ADC; desative com -DSENSOR_LDR=OFF para simular.
+// A bateria (opcional) precisa de um divisor resistivo num pino de ADC livre: 26 e 27 estão com relés
+// e o ADC3 (VSYS) do Pico W divide o pino com o SPI do Wi-Fi, o que impede a amostragem contínua.
+#if SENSOR_LDR
+#define LDR_ADC_PIN 28
+#define BATERIA_ADC_PIN 0                 // Pino do divisor da bateria, 0 se não houver
+#define BATERIA_DIVISOR 2                 // Tensão da bateria = tensão no pino * BATERIA_DIVISOR
+#define ADC_PROCESSAR_INTERVALO_MS 100    // Bem abaixo dos ~256 ms que o anel do DMA leva para dar a volta
+#endif
+
 // Pinos dos Relés
 #define RELAY_LIGHTS_PIN 26
 #define RELAY_FAN_PIN 27
-#define RELAY_HUMIDIFIER_PIN 28
+#if SENSOR_LDR
+#define RELAY_HUMIDIFIER_PIN 22           // Fora dos pinos de ADC: o 28 ficou com o LDR
+#else
+#define RELAY_HUMIDIFIER_PIN 28           // Sem o LDR, a ligação original
+#endif
+
+// Regras de acionamento (inc/regras.h), uma por relé. Limiares em décimos; a faixa entre 'liga' e
+// 'desliga' é a histerese. Sem janela de horário (0-0), a regra vale o dia todo.
+// Valores iniciais; podem ser trocados em funcionamento por POST /api/rules.
+enum { REGRA_LUZ, REGRA_VENTILADOR, REGRA_UMIDIFICADOR, NUM_REGRAS };
+
+const regra_config_t REGRAS_PADRAO[NUM_REGRAS] = {
+    [REGRA_LUZ] = {.nome = "luz", .entrada = REGRA_ENTRADA_LUMINOSIDADE, .sentido = REGRA_LIGA_ABAIXO,
+                   .liga = 400, .desliga = 450, .minimo_ligado_s = 60, .minimo_desligado_s = 60},
+    [REGRA_VENTILADOR] = {.nome = "ventilador", .entrada = REGRA_ENTRADA_TEMPERATURA, .sentido = REGRA_LIGA_ACIMA,
+                          .liga = 280, .desliga = 270, .minimo_ligado_s = 300, .minimo_desligado_s = 120},
+    [REGRA_UMIDIFICADOR] = {.nome = "umidificador", .entrada = REGRA_ENTRADA_UMIDADE, .sentido = REGRA_LIGA_ABAIXO,
+                            .liga = 450, .desliga = 480, .minimo_ligado_s = 300, .minimo_desligado_s = 300},
+};
 
-// Limiares de acionamento
-#define LUMINOSITY_THRESHOLD 40.0         // Acima deste valor, a luz apaga
-#define TEMPERATURE_FAN_THRESHOLD 28.0    // Acima deste valor, o ventilador liga
-#define HUMIDITY_HUMIDIFIER_THRESHOLD 45.0// Abaixo deste valor, o umidificador liga
+// Janelas das estatísticas móveis (inc/agregados.h): largura do balde e baldes completos em cada uma
+enum { JANELA_1H, JANELA_6H, JANELA_24H, NUM_JANELAS };
+
+const struct {
+    const char *nome;
+    uint32_t largura_s;
+    uint8_t baldes;
+} JANELAS_AGREGADOS[NUM_JANELAS] = {
+    [JANELA_1H] = {"1h", 60, 60},
+    [JANELA_6H] = {"6h", 5 * 60, 72},
+    [JANELA_24H] = {"24h", 20 * 60, 72},
+};
 
 // Configuração do histórico
-#define MAX_HISTORICO 10
-const uint32_t SENSOR_READ_INTERVAL_MS = 5 * 60 * 1000; // 5 minutos
+#define HISTORICO_LINHAS_PAINEL 10                   // Registros recentes exibidos no painel web
+#define TENDENCIA_PONTOS 500                         // Pontos de /api/trend sem o parâmetro 'points'
+const uint32_t SENSOR_READ_INTERVAL_MS = 60 * 1000; // 1 minuto
 
-// --- ESTRUTURAS E VARIÁVEIS GLOBAIS ---
-// Sensores (simulados)
-float temperatura_sensor = 25.0;
-float umidade_sensor = 50.0;
-float luminosidade_sensor = 50.0;
+// Períodos das tarefas agendadas
+const uint32_t CONTROL_INTERVAL_MS = 30 * 1000;        // Leitura dos sensores e acionamento dos relés
+const uint32_t CONTROL_FIRST_DELAY_MS = 1000;          // Dá tempo ao primeiro quadro do DHT11 (~25 ms) e à primeira média do LDR (~256 ms)
+const uint32_t WIFI_CHECK_INTERVAL_MS = 10 * 1000;     // Tentativa de reconexão do Wi-Fi
+const uint32_t LINK_CHECK_INTERVAL_MS = 1000;          // Estado do enlace repassado ao display
+const uint32_t INTERFACE_INTERVAL_MS = 500;            // Display OLED e matriz de LEDs
+const uint32_t STATS_INTERVAL_MS = 5 * 60 * 1000;      // Estatísticas das tarefas no console
+const uint32_t FLASH_FLUSH_INTERVAL_MS = 15 * 60 * 1000; // Gravação forçada da página pendente do log em flash
+const uint32_t EVENTOS_KEEPALIVE_MS = 15 * 1000;       // Comentário SSE que mantém abertas as conexões de /events
 
-// Estrutura para o histórico
+// Instrumentação exposta em /metrics (inc/metricas.h); desative com -DMETRICAS=OFF no CMake
+#if METRICAS
+const uint32_t METRICAS_INTERVALO_MS = 5 * 1000;       // Cópia das métricas do núcleo 1 para o núcleo 0
+#define METRICAS_MAX_POOLS 16                          // Pools de memória da rede expostos
+#endif
+
+// Divisão de trabalho entre os núcleos:
+// - Núcleo 0: Wi-Fi (cyw43), lwIP, servidor web e histórico.
+// - Núcleo 1: sensores, relés, display OLED e matriz de LEDs.
+// Os núcleos não compartilham variáveis; trocam mensagens por canais SPSC sem travas.
+#define CORE1_STACK_WORDS 2048
+
+// --- ESTRUTURAS E VARIÁVEIS GLOBAIS ---
+// Retrato do estado do núcleo 1 (sensores e relés), enviado ao núcleo 0 a cada ciclo de controle
 typedef struct {
-    float temperatura;
-    float umidade;
+    int16_t temperatura;        // Décimos de °C
+    int16_t umidade;            // Décimos de %
+    int16_t luminosidade;       // Décimos de %
+    bool luz_ligada;
+    bool ventilador_ligado;
+    bool umidificador_ligado;
+    bool registrar_historico;   // Retrato deve entrar no histórico
     datetime_t timestamp;
-} historico_t;
+    int16_t itu;                // Décimos
+    agregados_resumo_t agregados[NUM_JANELAS][AGREGADOS_GRANDEZAS];
+} snapshot_t;
+
+// Comandos do núcleo 0 para o núcleo 1
+typedef enum {
+    COMANDO_WIFI_STATUS,        // valor: 1 conectado, 0 desconectado
+    COMANDO_REGRA,              // valor: índice da regra; nova configuração em 'regra'
+} tipo_comando_t;
+
+typedef struct {
+    tipo_comando_t tipo;
+    int32_t valor;
+    regra_config_t regra;
+} comando_t;
+
+// Canais entre os núcleos
+snapshot_t buffer_snapshots[8];
+canal_spsc_t canal_snapshots;   // Núcleo 1 -> núcleo 0
+comando_t buffer_comandos[8];
+canal_spsc_t canal_comandos;    // Núcleo 0 -> núcleo 1
+
+// Sensores - pertencem ao núcleo 1
+#if SENSOR_DHT11
+dht11_t dht11;
+bool dht11_ok = false;
+#endif
+#if SENSOR_LDR
+bool adc_ok = false;
+#endif
+// Leituras em ponto fixo (décimos), como o DHT11 as entrega e como o resto do firmware as usa
+int16_t temperatura_sensor = 250;
+int16_t umidade_sensor = 500;
+int16_t luminosidade_sensor = 500;
+bool wifi_conectado = false;    // Cópia local do núcleo 1, atualizada por COMANDO_WIFI_STATUS
+
+// Estatísticas móveis, alimentadas a cada ciclo de controle - pertencem ao núcleo 1
+agregados_t agregados;
+
+// Motor de regras e o pino de cada regra - pertencem ao núcleo 1
+motor_regras_t motor_regras;
+const uint PINOS_REGRAS[NUM_REGRAS] = {
+    [REGRA_LUZ] = RELAY_LIGHTS_PIN,
+    [REGRA_VENTILADOR] = RELAY_FAN_PIN,
+    [REGRA_UMIDIFICADOR] = RELAY_HUMIDIFIER_PIN,
+};
+
+#if METRICAS
+// Métricas do núcleo 1, escritas só por ele; uma cópia vai ao núcleo 0 a cada METRICAS_INTERVALO_MS
+typedef struct {
+    metricas_histograma_t controle;     // tarefa_controle: sensores, regras e retrato
+    metricas_histograma_t display;      // atualizar_display_oled
+    metricas_histograma_t leds;         // npWrite
+    bool pilha_medida;
+    uint32_t pilha_uso;
+    uint32_t pilha_tamanho;
+} metricas_nucleo1_t;
+
+metricas_nucleo1_t metricas_core1;
+metricas_nucleo1_t buffer_metricas[2];
+canal_spsc_t canal_metricas;            // Núcleo 1 -> núcleo 0
+
+// Métricas do núcleo 0 e a última cópia das do núcleo 1 - pertencem ao núcleo 0.
+// A pilha de rede não tem histograma próprio: com pico_cyw43_arch_lwip_threadsafe_background, o
+// driver e o lwIP rodam em interrupções e no contexto assíncrono, e o hal_rede_processar do laço
+// não faz nada. O que roda nas callbacks do lwIP é medido em http_requisicao e http_envio.
+struct {
+    metricas_histograma_t http_requisicao;  // Roteamento e montagem da resposta de cada requisição
+    metricas_histograma_t http_envio;       // Cada rodada de geração e envio ao lwIP
+    metricas_histograma_t bytes_resposta;   // Por resposta concluída (os fluxos de /events não terminam)
+    uint32_t conexoes_recusadas;            // Sem conexão livre no pool
+} metricas_core0;
+metricas_nucleo1_t metricas_core1_recebidas;
+#endif
 
-historico_t historico_sensores[MAX_HISTORICO];
-bool historico_valido[MAX_HISTORICO];
+// Último retrato recebido e o último publicado em /events - pertencem ao núcleo 0
+snapshot_t estado_atual;
+snapshot_t estado_publicado;
 
-// Buffers para Webserver e OLED
-char http_response[4096];
-char csv_content[2048];
-uint8_t oled_buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
-struct render_area frame_area;
+// Configuração das regras vista pela web; o núcleo 0 a altera e repassa ao núcleo 1 por COMANDO_REGRA
+regra_config_t regras_config[NUM_REGRAS];
+
+// O histórico (inc/historico.c) e o log persistente em flash também pertencem ao núcleo 0
+flash_log_t log_flash;
+bool log_flash_ok = false;
+
+// Servidor web: um pool fixo de conexões HTTP/1.1 com keep-alive. Cada conexão analisa
+// as requisições aos poucos e envia as respostas longas (CSV, JSON, recursos estáticos e
+// eventos) no ritmo do tcp_sent.
+#define MAX_CONEXOES_HTTP 6
+// Fluxos /events simultâneos. Sobram sempre duas conexões para as demais rotas: uma para a
+// página e os seus recursos e outra para uma exportação em andamento (CSV ou binária).
+#define MAX_CONEXOES_EVENTOS (MAX_CONEXOES_HTTP - 2)
+#define CONEXAO_BUFFER 1024
+#define HTTP_POLL_INTERVALO 4                          // tcp_poll em unidades de 500 ms
+#define HTTP_OCIOSO_MS (15 * 1000)                     // Keep-alive sem nenhuma requisição nova
+#define HTTP_PRAZO_REQUISICAO_MS (10 * 1000)           // Requisição começada e não terminada
+#define HTTP_PRAZO_ENVIO_MS (45 * 1000)                // Resposta sem nenhum ACK do cliente
+
+typedef enum {
+    RESPOSTA_SIMPLES,           // Cabeçalho e corpo curtos, já prontos no buffer
+    RESPOSTA_CSV,               // Gerada linha a linha a partir do histórico
+    RESPOSTA_JSON,              // Histórico em JSON, gerado da mesma forma
+    RESPOSTA_BINARIA,           // Histórico no formato compacto de inc/serie_binaria.h
+    RESPOSTA_TENDENCIA,         // Pontos consolidados das camadas (inc/camadas.h), em JSON
+    RESPOSTA_ESTATICA,          // Corpo lido direto da flash, sem cópia
+    RESPOSTA_EVENTOS,           // Fluxo SSE de /events, aberto até o cliente desconectar
+#if METRICAS
+    RESPOSTA_METRICAS,          // /metrics, no formato de texto do Prometheus
+#endif
+} tipo_resposta_t;
+
+typedef enum {
+    ETAPA_AGUARDANDO,           // Esperando (ou recebendo) a próxima requisição
+    ETAPA_PREAMBULO,            // Cabeçalho HTTP, depois comentários e títulos das colunas do CSV
+    ETAPA_CORPO,                // Linhas do CSV/JSON, bytes do recurso estático ou eventos
+    ETAPA_FINAL,                // Chunk de tamanho zero (CSV) ou nada mais a enviar
+    ETAPA_CONCLUIDA
+} etapa_resposta_t;
+
+typedef struct {
+    bool em_uso;
+    struct tcp_pcb *pcb;
+    struct pbuf *entrada;       // Bytes recebidos e ainda não analisados
+    http_requisicao_t requisicao;
+    bool manter_aberta;         // Keep-alive depois da resposta atual
+    uint32_t ultima_atividade_ms;
+    tipo_resposta_t tipo;
+    etapa_resposta_t etapa;
+    historico_iterador_t iterador;
+    camadas_iterador_t camadas; // Consulta de /api/trend
+    json_escritor_t json;       // Estado do documento entre um chunk e outro
+    serie_binaria_t serie;      // Valores do último registro binário (base dos deltas)
+    const uint8_t *corpo;       // Próximo byte do recurso estático
+    uint32_t corpo_restante;
+    bool evento_pendente;       // O estado mudou desde o último evento enviado
+    uint32_t proxima_amostra;   // Primeira amostra do histórico que o cliente SSE ainda não recebeu
+#if METRICAS
+    uint32_t metricas_linha;    // Próxima linha de /metrics a enviar
+    uint32_t bytes_resposta;    // Entregues ao lwIP na resposta atual
+#endif
+    char buffer[CONEXAO_BUFFER];
+    uint16_t inicio;            // Primeiro byte ainda não entregue ao lwIP
+    uint16_t fim;               // Fim dos dados válidos no buffer
+} conexao_http_t;
+
+conexao_http_t conexoes_http[MAX_CONEXOES_HTTP];
+
+// Display OLED: quadros, regiões sujas e fila de transmissão (inc/ssd1306_i2c.h)
+ssd1306_t oled;
+
+// Tendência de temperatura e umidade à direita das quatro primeiras linhas do display, uma
+// coluna por registro do histórico (GRAFICO_LARGURA minutos). O texto ao lado cabe em
+// GRAFICO_X - 2 pixels, 14 caracteres.
+#define GRAFICO_X 86
+#define GRAFICO_LARGURA (SSD1306_WIDTH - GRAFICO_X)
+oled_grafico_t grafico_temperatura;     // Páginas 0 e 1, de 10 a 40 °C
+oled_grafico_t grafico_umidade;         // Páginas 2 e 3, de 20 a 100 %
 
 // Estruturas para LEDs Neopixel
 struct pixel_t {
@@ -91,29 +352,36 @@ typedef struct pixel_t pixel_t;
 typedef pixel_t npLED_t;
 
 npLED_t leds[LED_COUNT];
-PIO np_pio;
-uint sm;
+
+// Último quadro empacotado (um GRB de 24 bits por palavra) entregue ao PIO, para não reenviar
+// um quadro idêntico ao anterior
+uint32_t np_quadro[LED_COUNT];
+bool np_quadro_valido = false;
 
 // --- FUNÇÕES PARA LEDS NEOPIXEL ---
 void npInit(uint pin) {
-    uint offset = pio_add_program(pio0, &ws2818b_program);
-    np_pio = pio0;
-    sm = pio_claim_unused_sm(np_pio, false);
-    if (sm < 0) {
-        np_pio = pio1;
-        sm = pio_claim_unused_sm(np_pio, true);
-    }
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+    hal_leds_iniciar(pin, LED_COUNT);
     for (uint i = 0; i < LED_COUNT; ++i) leds[i] = (npLED_t){0, 0, 0};
 }
 
-void npWrite() {
+// Envia o quadro atual de leds[] (por DMA, na placa), somente se ele mudou desde o último envio.
+// Não bloqueia: se o quadro anterior ainda estiver em trânsito ou no latch, retorna false
+// e o envio fica para a próxima chamada.
+bool npWrite() {
+    uint32_t quadro[LED_COUNT];
     for (uint i = 0; i < LED_COUNT; ++i) {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+        quadro[i] = ((uint32_t)leds[i].G << 24) | ((uint32_t)leds[i].R << 16) | ((uint32_t)leds[i].B << 8);
+    }
+
+    if (np_quadro_valido && memcmp(quadro, np_quadro, sizeof(quadro)) == 0) {
+        return true;
+    }
+    if (!hal_leds_enviar(quadro, LED_COUNT)) {
+        return false;
     }
-    sleep_us(100);
+    memcpy(np_quadro, quadro, sizeof(quadro));
+    np_quadro_valido = true;
+    return true;
 }
 
 // Cores pré-definidas para os indicadores
@@ -125,9 +393,9 @@ const pixel_t COR_UMIDIFICADOR = {50, 0, 50};  // Ciano/Azul
 // Função para atualizar a matriz de LEDs com base no estado dos relés
 // Lógica usa LINHAS como indicadores.
 void atualizar_matriz_leds() {
-    bool luz_ligada = gpio_get(RELAY_LIGHTS_PIN);
-    bool ventilador_ligado = gpio_get(RELAY_FAN_PIN);
-    bool umidificador_ligado = gpio_get(RELAY_HUMIDIFIER_PIN);
+    bool luz_ligada = hal_gpio_ler(RELAY_LIGHTS_PIN);
+    bool ventilador_ligado = hal_gpio_ler(RELAY_FAN_PIN);
+    bool umidificador_ligado = hal_gpio_ler(RELAY_HUMIDIFIER_PIN);
 
     for (int y = 0; y < 5; y++) {
         for (int x = 0; x < 5; x++) {
@@ -148,157 +416,1203 @@ void atualizar_matriz_leds() {
 
 // --- FUNÇÕES DE SIMULAÇÃO E CONTROLE ---
 void simular_temperatura_umidade_sensor() {
-    temperatura_sensor = 20.0 + (rand() % 150) / 10.0;
-    umidade_sensor = 30.0 + (rand() % 600) / 10.0;
-    printf("Novos dados simulados: Temp=%.1f C, Umid=%.1f %%\n", temperatura_sensor, umidade_sensor);
+    char temperatura[FORMATO_DECIMOS_MAX], umidade[FORMATO_DECIMOS_MAX];
+    temperatura_sensor = 200 + rand() % 150;
+    umidade_sensor = 300 + rand() % 600;
+    formato_decimos(temperatura, temperatura_sensor);
+    formato_decimos(umidade, umidade_sensor);
+    printf("Novos dados simulados: Temp=%s C, Umid=%s %%\n", temperatura, umidade);
 }
 
+#if SENSOR_DHT11
+// Consome as leituras que o DHT11 enfileirou desde o último ciclo de controle; vale a mais recente.
+// Sem leitura nova, os valores anteriores continuam em uso.
+void ler_temperatura_umidade_sensor() {
+    if (!dht11_ok) {
+        simular_temperatura_umidade_sensor();
+        return;
+    }
+
+    dht11_leitura_t leitura;
+    bool nova = false;
+    while (dht11_receber(&dht11, &leitura)) {
+        nova = true;
+    }
+    if (!nova) {
+        printf("DHT11: nenhuma leitura nova (%lu tempos esgotados, %lu erros de checksum).\n",
+               (unsigned long)dht11.tempos_esgotados, (unsigned long)dht11.erros_checksum);
+        return;
+    }
+
+    char temperatura[FORMATO_DECIMOS_MAX], umidade[FORMATO_DECIMOS_MAX];
+    temperatura_sensor = leitura.temperatura;
+    umidade_sensor = leitura.umidade;
+    formato_decimos(temperatura, temperatura_sensor);
+    formato_decimos(umidade, umidade_sensor);
+    printf("DHT11: Temp=%s C, Umid=%s %% (lida ha %lu ms)\n", temperatura, umidade,
+           (unsigned long)((hal_tempo_us() - leitura.instante_us) / 1000));
+}
+#endif
+
 void simular_luminosidade_sensor() {
-    luminosidade_sensor = rand() % 101;
-    printf("Nova luminosidade simulada: %.1f %%\n", luminosidade_sensor);
+    char luminosidade[FORMATO_DECIMOS_MAX];
+    luminosidade_sensor = (rand() % 101) * 10;
+    formato_decimos(luminosidade, luminosidade_sensor);
+    printf("Nova luminosidade simulada: %s %%\n", luminosidade);
 }
 
-void acionar_rele_luz(bool ligar) {
-    if (ligar) {
-        if (!gpio_get(RELAY_LIGHTS_PIN)) printf("Luzes ligadas (luminosidade baixa).\n");
-        gpio_put(RELAY_LIGHTS_PIN, 1);
-    } else {
-        if (gpio_get(RELAY_LIGHTS_PIN)) printf("Luzes desligadas (luminosidade alta).\n");
-        gpio_put(RELAY_LIGHTS_PIN, 0);
+#if SENSOR_LDR
+// Lê o valor já filtrado do LDR (inc/filtro_adc.h), sem tocar no ADC. No módulo LDR a tensão
+// cai com a luz, então a escala é invertida. Antes da primeira média, mantém o valor anterior.
+void ler_luminosidade_sensor() {
+    if (!adc_ok) {
+        simular_luminosidade_sensor();
+        return;
     }
-}
 
-void acionar_rele_ventilador(float temperatura) {
-    if (temperatura > TEMPERATURE_FAN_THRESHOLD) {
-        if (!gpio_get(RELAY_FAN_PIN)) printf("Ventilador ligado (temperatura alta: %.1f C).\n", temperatura);
-        gpio_put(RELAY_FAN_PIN, 1);
-    } else {
-        if (gpio_get(RELAY_FAN_PIN)) printf("Ventilador desligado (temperatura OK: %.1f C).\n", temperatura);
-        gpio_put(RELAY_FAN_PIN, 0);
+    const filtro_adc_t *ldr = amostragem_adc_filtro(LDR_ADC_PIN);
+    if (ldr->atualizacoes == 0) {
+        return;
     }
+    char luminosidade[FORMATO_DECIMOS_MAX];
+    luminosidade_sensor = 1000 - (ldr->valor * 1000u + 65520 / 2) / 65520;   // Décimos, arredondados
+    formato_decimos(luminosidade, luminosidade_sensor);
+    printf("LDR: luminosidade %s %%\n", luminosidade);
 }
+#endif
 
-void acionar_rele_umidificador(float umidade) {
-    if (umidade < HUMIDITY_HUMIDIFIER_THRESHOLD) {
-        if (!gpio_get(RELAY_HUMIDIFIER_PIN)) printf("Umidificador ligado (umidade baixa: %.1f %%).\n", umidade);
-        gpio_put(RELAY_HUMIDIFIER_PIN, 1);
-    } else {
-        if (gpio_get(RELAY_HUMIDIFIER_PIN)) printf("Umidificador desligado (umidade OK: %.1f %%).\n", umidade);
-        gpio_put(RELAY_HUMIDIFIER_PIN, 0);
+// Reavalia as regras pendentes e aplica aos relés as que trocaram de estado
+void aplicar_regras() {
+    uint32_t trocadas = regras_avaliar(&motor_regras, (uint32_t)(hal_tempo_us() / 1000000));
+    for (int i = 0; i < NUM_REGRAS; i++) {
+        if (!(trocadas & (1u << i))) {
+            continue;
+        }
+        const regra_t *r = &motor_regras.regras[i];
+        hal_gpio_escrever(PINOS_REGRAS[i], r->ligado);
+        char leitura[FORMATO_DECIMOS_MAX], liga[FORMATO_DECIMOS_MAX], desliga[FORMATO_DECIMOS_MAX];
+        formato_decimos(leitura, motor_regras.entradas[r->config.entrada]);
+        formato_decimos(liga, r->config.liga);
+        formato_decimos(desliga, r->config.desliga);
+        printf("Regra %s: %s (leitura %s, liga %s, desliga %s).\n", r->config.nome,
+               r->ligado ? "ligado" : "desligado", leitura, liga, desliga);
     }
 }
 
-void salvar_historico_sensores() {
-    datetime_t t;
-    rtc_get_datetime(&t);
-    for (int i = MAX_HISTORICO - 1; i > 0; i--) {
-        historico_sensores[i] = historico_sensores[i - 1];
-        historico_valido[i] = historico_valido[i - 1];
+// Executada no núcleo 0, com o retrato vindo do núcleo 1
+void salvar_historico_sensores(const snapshot_t *s) {
+    datetime_t t = s->timestamp;
+    amostra_t amostra = {
+        .epoch = data_hora_para_epoch(&t),
+        .temperatura = s->temperatura,
+        .umidade = s->umidade,
+        .luminosidade = s->luminosidade,
+        .reles = (s->luz_ligada ? HISTORICO_RELE_LUZ : 0) |
+                 (s->ventilador_ligado ? HISTORICO_RELE_VENTILADOR : 0) |
+                 (s->umidificador_ligado ? HISTORICO_RELE_UMIDIFICADOR : 0),
+    };
+    historico_adicionar(&amostra);
+    camadas_adicionar(&amostra);
+    if (log_flash_ok) {
+        flash_log_anexar(&log_flash, &amostra);
     }
-    historico_sensores[0] = (historico_t){.temperatura = temperatura_sensor, .umidade = umidade_sensor, .timestamp = t};
-    historico_valido[0] = true;
-    printf("Novo registro salvo: %02d/%02d %02d:%02d:%02d - Temp=%.1f, Umid=%.1f\n",
-           t.day, t.month, t.hour, t.min, t.sec, temperatura_sensor, umidade_sensor);
+    char temperatura[FORMATO_DECIMOS_MAX], umidade[FORMATO_DECIMOS_MAX];
+    formato_decimos(temperatura, s->temperatura);
+    formato_decimos(umidade, s->umidade);
+    printf("Novo registro salvo: %02d/%02d %02d:%02d:%02d - Temp=%s, Umid=%s\n",
+           t.day, t.month, t.hour, t.min, t.sec, temperatura, umidade);
 }
 
 // --- FUNÇÕES DE INTERFACE (DISPLAY E WEB) ---
+void iniciar_graficos_oled() {
+    oled_grafico_iniciar(&grafico_temperatura, GRAFICO_X, 0, GRAFICO_LARGURA, 2, 100, 400);
+    oled_grafico_iniciar(&grafico_umidade, GRAFICO_X, 2, GRAFICO_LARGURA, 2, 200, 1000);
+}
+
+// Uma linha por página de 8 pixels: as oito páginas do display estão ocupadas. Só o texto é
+// apagado e redesenhado; os gráficos mudam apenas quando chega uma amostra (publicar_snapshot).
 void atualizar_display_oled() {
     char text[32];
-    memset(oled_buffer, 0, sizeof(oled_buffer));
+    agregados_resumo_t itu_24h;
+    ssd1306_clear_area(&oled, 0, GRAFICO_X - 1, 0, 3);
+    ssd1306_clear_area(&oled, 0, SSD1306_WIDTH - 1, 4, 7);
 
-    sprintf(text, "Temp: %.1f C", temperatura_sensor);
-    ssd1306_draw_string(oled_buffer, 0, 0, text);
+    formato_texto(formato_decimos(formato_texto(text, "Temp: "), temperatura_sensor), " °C");
+    ssd1306_draw_string(&oled, 0, 0, text);
 
-    sprintf(text, "Umid: %.1f %%", umidade_sensor);
-    ssd1306_draw_string(oled_buffer, 0, 10, text);
+    formato_texto(formato_decimos(formato_texto(text, "Umid: "), umidade_sensor), " %");
+    ssd1306_draw_string(&oled, 0, 8, text);
 
-    sprintf(text, "Luz:    %s", gpio_get(RELAY_LIGHTS_PIN) ? "Ligada" : "Desligada");
-    ssd1306_draw_string(oled_buffer, 0, 20, text);
-    
-    sprintf(text, "Vent:   %s", gpio_get(RELAY_FAN_PIN) ? "Ligado" : "Desligado");
-    ssd1306_draw_string(oled_buffer, 0, 30, text);
+    // ITU da última leitura e o máximo do dia, direto das estatísticas móveis
+    if (agregados_resumo(&agregados, JANELA_24H, AGREGADO_ITU, &itu_24h)) {
+        formato_decimos(formato_texto(text, "ITU:  "), agregados.ultimo[AGREGADO_ITU]);
+        ssd1306_draw_string(&oled, 0, 16, text);
+        formato_decimos(formato_texto(text, "Máx 24h: "), itu_24h.maximo);
+        ssd1306_draw_string(&oled, 0, 24, text);
+    } else {
+        ssd1306_draw_string(&oled, 0, 16, "ITU:  --");
+    }
+
+    // Linhas de estado: só há duas versões de cada, então vão inteiras, sem formatar
+    ssd1306_draw_string(&oled, 0, 32, hal_gpio_ler(RELAY_LIGHTS_PIN) ? "Luz:    Ligada" : "Luz:    Desligada");
+    ssd1306_draw_string(&oled, 0, 40, hal_gpio_ler(RELAY_FAN_PIN) ? "Vent:   Ligado" : "Vent:   Desligado");
+    ssd1306_draw_string(&oled, 0, 48, hal_gpio_ler(RELAY_HUMIDIFIER_PIN) ? "Umidif: Ligado" : "Umidif: Desligado");
+    ssd1306_draw_string(&oled, 0, 56, wifi_conectado ? "WiFi: Conectado" : "WiFi: Desconectado");
 
-    sprintf(text, "Umidif: %s", gpio_get(RELAY_HUMIDIFIER_PIN) ? "Ligado" : "Desligado");
-    ssd1306_draw_string(oled_buffer, 0, 40, text);
+    // Só as páginas que mudaram desde o último quadro vão para o barramento I2C
+    render_changes_on_display(&oled);
+}
+
+// Campos do estado atual, dentro de um objeto JSON aberto. Leituras com uma casa decimal.
+void escrever_estado_json(json_escritor_t *j, const snapshot_t *s) {
+    datetime_t t = s->timestamp;
+    json_chave(j, "epoch");
+    json_inteiro(j, data_hora_para_epoch(&t));
+    json_chave(j, "temperatura");
+    json_decimos(j, s->temperatura);
+    json_chave(j, "umidade");
+    json_decimos(j, s->umidade);
+    json_chave(j, "luminosidade");
+    json_decimos(j, s->luminosidade);
+    json_chave(j, "itu");
+    json_decimos(j, s->itu);
+    json_chave(j, "luz");
+    json_booleano(j, s->luz_ligada);
+    json_chave(j, "ventilador");
+    json_booleano(j, s->ventilador_ligado);
+    json_chave(j, "umidificador");
+    json_booleano(j, s->umidificador_ligado);
+}
+
+// Amostra do histórico como lista compacta: [epoch, temperatura, umidade, luminosidade, relés],
+// com as leituras em décimos
+void escrever_amostra_json(json_escritor_t *j, const amostra_t *a) {
+    json_abrir_lista(j);
+    json_inteiro(j, a->epoch);
+    json_inteiro(j, a->temperatura);
+    json_inteiro(j, a->umidade);
+    json_inteiro(j, a->luminosidade);
+    json_inteiro(j, a->reles);
+    json_fechar_lista(j);
+}
+
+// /api/status: valores atuais e os registros mais recentes (o mais novo primeiro), para o painel.
+// Retorna o tamanho do documento.
+size_t gerar_status_json(char *buffer, size_t capacidade) {
+    json_escritor_t j;
+    json_iniciar(&j, buffer, capacidade);
+    json_abrir_objeto(&j);
+    escrever_estado_json(&j, &estado_atual);
+    json_chave(&j, "historico");
+    json_abrir_lista(&j);
+    amostra_t a;
+    for (int i = 0; i < HISTORICO_LINHAS_PAINEL && historico_obter_recente(i, &a); i++) {
+        escrever_amostra_json(&j, &a);
+    }
+    json_fechar_lista(&j);
+    json_fechar_objeto(&j);
+    return j.tamanho;
+}
+
+// /api/stats: ITU atual e, por janela, mínimo, máximo e média de cada grandeza, já calculados
+// no núcleo 1. Uma janela ainda sem amostras só traz "amostras":0.
+size_t gerar_agregados_json(char *buffer, size_t capacidade) {
+    static const char *const NOMES_GRANDEZAS[AGREGADOS_GRANDEZAS] = {
+        [AGREGADO_TEMPERATURA] = "temperatura",
+        [AGREGADO_UMIDADE] = "umidade",
+        [AGREGADO_ITU] = "itu",
+    };
+    const snapshot_t *s = &estado_atual;
+    json_escritor_t j;
+    json_iniciar(&j, buffer, capacidade);
+    json_abrir_objeto(&j);
+    json_chave(&j, "itu");
+    json_decimos(&j, s->itu);
+    json_chave(&j, "faixa");
+    json_texto(&j, agregados_itu_faixa(s->itu));
+    json_chave(&j, "janelas");
+    json_abrir_lista(&j);
+    for (int i = 0; i < NUM_JANELAS; i++) {
+        json_abrir_objeto(&j);
+        json_chave(&j, "nome");
+        json_texto(&j, JANELAS_AGREGADOS[i].nome);
+        json_chave(&j, "amostras");
+        json_inteiro(&j, s->agregados[i][0].amostras);
+        for (int g = 0; g < AGREGADOS_GRANDEZAS && s->agregados[i][g].amostras > 0; g++) {
+            const agregados_resumo_t *r = &s->agregados[i][g];
+            json_chave(&j, NOMES_GRANDEZAS[g]);
+            json_abrir_objeto(&j);
+            json_chave(&j, "min");
+            json_decimos(&j, r->minimo);
+            json_chave(&j, "max");
+            json_decimos(&j, r->maximo);
+            json_chave(&j, "media");
+            json_decimos(&j, r->media);
+            json_fechar_objeto(&j);
+        }
+        json_fechar_objeto(&j);
+    }
+    json_fechar_lista(&j);
+    json_fechar_objeto(&j);
+    return j.tamanho;
+}
+
+// --- FUNÇÕES DE SERVIDOR WEB (LWIP) ---
+// Reserva à frente do buffer para o cabeçalho das respostas de tamanho conhecido
+#define CABECALHO_RESERVA 192
+
+uint32_t agora_ms() {
+    return (uint32_t)(hal_tempo_us() / 1000);
+}
+
+void liberar_conexao(conexao_http_t *c) {
+    if (c) {
+        if (c->entrada) {
+            pbuf_free(c->entrada);
+            c->entrada = NULL;
+        }
+        c->em_uso = false;
+        c->pcb = NULL;
+    }
+}
 
-    sprintf(text, "%s", (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP) ? "WiFi: Conectado" : "WiFi: Desconectado");
-    ssd1306_draw_string(oled_buffer, 0, 54, text);
+// Retorna ERR_ABRT se o pcb precisou ser abortado (as callbacks do lwIP devem repassar esse valor)
+err_t fechar_conexao(struct tcp_pcb *tpcb, conexao_http_t *c) {
+    err_t resultado = ERR_OK;
+    tcp_arg(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    if (tcp_close(tpcb) != ERR_OK) {
+        tcp_abort(tpcb);
+        resultado = ERR_ABRT;
+    }
+    liberar_conexao(c);
+    return resultado;
+}
 
-    render_on_display(oled_buffer, &frame_area);
+// Conexão keep-alive esperando uma requisição que ainda nem começou a chegar
+bool conexao_ociosa(const conexao_http_t *c) {
+    return c->em_uso && c->etapa == ETAPA_AGUARDANDO && c->entrada == NULL && c->requisicao.tamanho_cabecalho == 0;
 }
 
-void create_http_response() {
-    char history_table_rows[2048] = "";
-    char *ptr = history_table_rows;
-    for (int i = 0; i < MAX_HISTORICO; i++) {
-        if (historico_valido[i]) {
-            ptr += sprintf(ptr, "<tr><td>%02d/%02d/%04d %02d:%02d:%02d</td><td>%.1f &deg;C</td><td>%.1f %%</td></tr>",
-                           historico_sensores[i].timestamp.day, historico_sensores[i].timestamp.month, historico_sensores[i].timestamp.year,
-                           historico_sensores[i].timestamp.hour, historico_sensores[i].timestamp.min, historico_sensores[i].timestamp.sec,
-                           historico_sensores[i].temperatura, historico_sensores[i].umidade);
+// Reserva uma conexão do pool. Com o pool cheio, fecha a conexão ociosa há mais tempo;
+// sem nenhuma ociosa, retorna NULL (o chamador responde 503).
+conexao_http_t *alocar_conexao(struct tcp_pcb *pcb) {
+    conexao_http_t *escolhida = NULL;
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        conexao_http_t *c = &conexoes_http[i];
+        if (!c->em_uso) {
+            escolhida = c;
+            break;
+        }
+        if (conexao_ociosa(c) && (!escolhida || (int32_t)(c->ultima_atividade_ms - escolhida->ultima_atividade_ms) < 0)) {
+            escolhida = c;
         }
     }
+    if (!escolhida) {
+        return NULL;
+    }
+    if (escolhida->em_uso) {
+        fechar_conexao(escolhida->pcb, escolhida);
+    }
 
-    const char *light_status = gpio_get(RELAY_LIGHTS_PIN) ? "Ligadas" : "Desligadas";
-    const char *fan_status = gpio_get(RELAY_FAN_PIN) ? "Ligado" : "Desligado";
-    const char *humidifier_status = gpio_get(RELAY_HUMIDIFIER_PIN) ? "Ligado" : "Desligado";
+    *escolhida = (conexao_http_t){.em_uso = true, .pcb = pcb, .etapa = ETAPA_AGUARDANDO, .ultima_atividade_ms = agora_ms()};
+    http_requisicao_iniciar(&escolhida->requisicao);
+    return escolhida;
+}
 
-    snprintf(http_response, sizeof(http_response),
-             "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=UTF-8\r\n\r\n"
-             "<!DOCTYPE html><html><head><meta charset=\"UTF-8\"><title>Pico W Home Control</title><meta http-equiv=\"refresh\" content=\"10\">"
-             "<style>body{font-family:sans-serif;background:#f4f4f4;color:#333;}.container{max-width:800px;margin:auto;padding:20px;background:#fff;"
-             "border-radius:8px;box-shadow:0 2px 4px rgba(0,0,0,0.1);}table{width:100%%;border-collapse:collapse;margin-bottom:20px;}th,td{padding:12px;"
-             "text-align:left;border-bottom:1px solid #ddd;}th{background-color:#007bff;color:white;}h1,h2{color:#007bff;}a.button{display:inline-block;"
-             "padding:10px 15px;background-color:#28a745;color:white;text-decoration:none;border-radius:5px;}</style></head><body><div class=\"container\">"
-             "<h1>Painel de Controle - Pico W</h1><h2>Status Atual</h2><table><tr><th>Sensor/Atuador</th><th>Valor/Estado</th></tr>"
-             "<tr><td>Temperatura</td><td>%.1f &deg;C</td></tr><tr><td>Umidade</td><td>%.1f %%</td></tr><tr><td>Luminosidade</td><td>%.1f %%</td></tr>"
-             "<tr><td>Luzes</td><td>%s</td></tr><tr><td>Ventilador</td><td>%s</td></tr><tr><td>Umidificador</td><td>%s</td></tr></table>"
-             "<h2>Histórico Recente dos Sensores</h2><p><a href=\"/download\" class=\"button\">Baixar Histórico (CSV)</a></p>"
-             "<table><tr><th>Data e Hora</th><th>Temperatura</th><th>Umidade</th></tr>%s</table></div></body></html>\r\n",
-             temperatura_sensor, umidade_sensor, luminosidade_sensor, light_status, fan_status, humidifier_status, history_table_rows);
+const char *valor_connection(const conexao_http_t *c) {
+    return c->manter_aberta ? "keep-alive" : "close";
 }
 
-void create_csv_content() {
-    char *ptr = csv_content;
-    *ptr = '\0';
+// Fecha os dados gerados em [buffer + HTTP_FLUXO_RESERVA, fim_dados) como um chunk HTTP.
+// Sem dados, monta o chunk final.
+void enquadrar_chunk(conexao_http_t *c, char *fim_dados) {
+    size_t tamanho = fim_dados - (c->buffer + HTTP_FLUXO_RESERVA);
+    size_t fim;
+    c->inicio = http_fluxo_chunk(c->buffer, tamanho, &fim);
+    c->fim = fim;
+    if (tamanho == 0) {
+        // Resposta esgotada
+        c->etapa = ETAPA_FINAL;
+    }
+}
+
+// Formata as próximas linhas do CSV no buffer da conexão, como um chunk HTTP completo
+void gerar_chunk_csv(conexao_http_t *c) {
+    char *dados = c->buffer + HTTP_FLUXO_RESERVA;
+    char *fim = c->buffer + CONEXAO_BUFFER - HTTP_FLUXO_FOLGA;   // Espaço para o "\r\n" que fecha o chunk
+    char *ptr = dados;
     datetime_t t;
-    rtc_get_datetime(&t);
-    ptr += sprintf(ptr, "# Relatório de Histórico dos Sensores - Pico W\n");
-    ptr += sprintf(ptr, "# Gerado em: %04d-%02d-%02d %02d:%02d:%02d\n\n", t.year, t.month, t.day, t.hour, t.min, t.sec);
-    ptr += sprintf(ptr, "Timestamp;Temperatura (C);Umidade (%%)\n");
-    for (int i = 0; i < MAX_HISTORICO; i++) {
-        if (historico_valido[i]) {
-            ptr += sprintf(ptr, "%04d-%02d-%02d %02d:%02d:%02d;%.1f;%.1f\n",
-                           historico_sensores[i].timestamp.year, historico_sensores[i].timestamp.month, historico_sensores[i].timestamp.day,
-                           historico_sensores[i].timestamp.hour, historico_sensores[i].timestamp.min, historico_sensores[i].timestamp.sec,
-                           historico_sensores[i].temperatura, historico_sensores[i].umidade);
+
+    if (c->etapa == ETAPA_PREAMBULO) {
+        hal_rtc_ler(&t);
+        ptr += sprintf(ptr, "# Relatório de Histórico dos Sensores - Pico W\n");
+        ptr = formato_texto(formato_data_hora(formato_texto(ptr, "# Gerado em: "), &t), "\n\n");
+        ptr += sprintf(ptr, "Timestamp;Temperatura (C);Umidade (%%)\n");
+        c->etapa = ETAPA_CORPO;
+    }
+
+    // Cada linha tem no máximo ~40 bytes; para antes de uma linha não caber
+    amostra_t a;
+    while (fim - ptr > 48 && historico_proximo(&c->iterador, &a)) {
+        data_hora_de_epoch(a.epoch, &t);
+        ptr = formato_data_hora(ptr, &t);
+        *ptr++ = ';';
+        ptr = formato_decimos(ptr, a.temperatura);
+        *ptr++ = ';';
+        ptr = formato_decimos(ptr, a.umidade);
+        *ptr++ = '\n';
+    }
+
+    enquadrar_chunk(c, ptr);
+}
+
+// Histórico em JSON: {"historico":[[epoch,t,u,l,reles],...]}, um chunk por vez.
+// O escritor guarda o aninhamento e as vírgulas de um chunk para o outro.
+void gerar_chunk_json(conexao_http_t *c) {
+    char *dados = c->buffer + HTTP_FLUXO_RESERVA;
+    json_escritor_t *j = &c->json;
+    json_trocar_buffer(j, dados, CONEXAO_BUFFER - HTTP_FLUXO_RESERVA - HTTP_FLUXO_FOLGA);
+
+    if (c->etapa == ETAPA_PREAMBULO) {
+        json_abrir_objeto(j);
+        json_chave(j, "historico");
+        json_abrir_lista(j);
+        c->etapa = ETAPA_CORPO;
+    }
+
+    // Cada amostra tem no máximo ~40 bytes; o documento termina quando o nível volta a zero
+    amostra_t a;
+    while (j->nivel > 0 && json_livre(j) > 48) {
+        if (historico_proximo(&c->iterador, &a)) {
+            escrever_amostra_json(j, &a);
+        } else {
+            json_fechar_lista(j);
+            json_fechar_objeto(j);
         }
     }
+
+    enquadrar_chunk(c, dados + j->tamanho);
+}
+
+// Tendência: {"camada":...,"resolucao":s,"agrupamento":n,"pontos":[[epoch,tmin,tmed,tmax,umin,umed,umax,luz],...]},
+// leituras em décimos. Gerada um chunk por vez, como o histórico em JSON.
+void gerar_chunk_tendencia(conexao_http_t *c) {
+    static const char *const NOMES_CAMADAS[CAMADAS_NUM] = {"bruta", "5min", "1h"};
+    char *dados = c->buffer + HTTP_FLUXO_RESERVA;
+    json_escritor_t *j = &c->json;
+    json_trocar_buffer(j, dados, CONEXAO_BUFFER - HTTP_FLUXO_RESERVA - HTTP_FLUXO_FOLGA);
+
+    if (c->etapa == ETAPA_PREAMBULO) {
+        json_abrir_objeto(j);
+        json_chave(j, "camada");
+        json_texto(j, NOMES_CAMADAS[c->camadas.camada]);
+        json_chave(j, "resolucao");
+        json_inteiro(j, camadas_largura(c->camadas.camada) * c->camadas.agrupar);
+        json_chave(j, "agrupamento");
+        json_inteiro(j, c->camadas.agrupar);
+        json_chave(j, "pontos");
+        json_abrir_lista(j);
+        c->etapa = ETAPA_CORPO;
+    }
+
+    // Cada ponto tem no máximo ~60 bytes
+    camadas_ponto_t p;
+    while (j->nivel > 0 && json_livre(j) > 72) {
+        if (camadas_proximo(&c->camadas, &p)) {
+            json_abrir_lista(j);
+            json_inteiro(j, p.epoch);
+            for (int i = 0; i < 3; i++) json_inteiro(j, p.temperatura[i]);
+            for (int i = 0; i < 3; i++) json_inteiro(j, p.umidade[i]);
+            json_inteiro(j, p.luminosidade);
+            json_fechar_lista(j);
+        } else {
+            json_fechar_lista(j);
+            json_fechar_objeto(j);
+        }
+    }
+
+    enquadrar_chunk(c, dados + j->tamanho);
+}
+
+// Histórico binário (inc/serie_binaria.h): cabeçalho e depois registros com deltas, um chunk por vez
+void gerar_chunk_binario(conexao_http_t *c) {
+    uint8_t *dados = (uint8_t *)c->buffer + HTTP_FLUXO_RESERVA;
+    uint8_t *fim = (uint8_t *)c->buffer + CONEXAO_BUFFER - HTTP_FLUXO_FOLGA;
+    uint8_t *ptr = dados;
+    amostra_t a;
+
+    if (c->etapa == ETAPA_PREAMBULO) {
+        uint32_t epoch_base = historico_obter(c->iterador.sequencia, &a) ? a.epoch : 0;
+        ptr += serie_binaria_cabecalho(&c->serie, ptr, c->iterador.sequencia, c->iterador.fim, epoch_base);
+        c->etapa = ETAPA_CORPO;
+    }
+
+    while (fim - ptr >= SERIE_BINARIA_REGISTRO_MAX && historico_proximo(&c->iterador, &a)) {
+        ptr += serie_binaria_registro(&c->serie, ptr, c->iterador.sequencia - 1, &a);
+    }
+
+    enquadrar_chunk(c, (char *)ptr);
+}
+
+#if METRICAS
+// O documento de /metrics, na mesma ordem a cada chamada: o escritor só emite as linhas a partir
+// de e->inicio, então ele é refeito do começo a cada chunk
+void escrever_metricas(metricas_escritor_t *e) {
+    static const char *const ETAPAS_NUCLEO1[] = {"nucleo=\"1\",etapa=\"controle\"", "nucleo=\"1\",etapa=\"display\"",
+                                                 "nucleo=\"1\",etapa=\"leds\""};
+    const metricas_nucleo1_t *m1 = &metricas_core1_recebidas;
+    const metricas_histograma_t *histogramas_nucleo1[] = {&m1->controle, &m1->display, &m1->leds};
+
+    metricas_familia(e, "automacao_tempo_ativo_segundos", "gauge", "Tempo desde o boot");
+    metricas_valor(e, "automacao_tempo_ativo_segundos", "", hal_tempo_us() / 1000000);
+
+    metricas_familia(e, "automacao_etapa_duracao_segundos", "histogram",
+                     "Duracao de cada etapa dos lacos principais. O lwIP e o driver do Wi-Fi rodam em segundo plano "
+                     "e nao sao medidos; no nucleo 0 entram so as etapas HTTP, dentro das callbacks do lwIP");
+    metricas_histograma(e, "automacao_etapa_duracao_segundos", "nucleo=\"0\",etapa=\"http_requisicao\"",
+                        &metricas_core0.http_requisicao, &METRICAS_ESCALA_US);
+    metricas_histograma(e, "automacao_etapa_duracao_segundos", "nucleo=\"0\",etapa=\"http_envio\"",
+                        &metricas_core0.http_envio, &METRICAS_ESCALA_US);
+    for (int i = 0; i < (int)count_of(ETAPAS_NUCLEO1); i++) {
+        metricas_histograma(e, "automacao_etapa_duracao_segundos", ETAPAS_NUCLEO1[i],
+                            histogramas_nucleo1[i], &METRICAS_ESCALA_US);
+    }
+
+    metricas_familia(e, "automacao_http_resposta_bytes", "histogram", "Tamanho das respostas HTTP concluidas");
+    metricas_histograma(e, "automacao_http_resposta_bytes", "", &metricas_core0.bytes_resposta, &METRICAS_ESCALA_BYTES);
+
+    metricas_familia(e, "automacao_http_conexoes_recusadas_total", "counter", "Conexoes recusadas por falta de espaco no pool");
+    metricas_valor(e, "automacao_http_conexoes_recusadas_total", "", metricas_core0.conexoes_recusadas);
+
+    // Memória da rede: uma família por campo, um valor por pool
+    hal_memoria_t pools[METRICAS_MAX_POOLS];
+    int n = hal_rede_memoria(pools, METRICAS_MAX_POOLS);
+    char rotulos[40];
+    static const struct { const char *nome, *tipo, *ajuda; } CAMPOS[] = {
+        {"automacao_lwip_memoria_uso", "gauge", "Itens em uso em cada pool do lwIP"},
+        {"automacao_lwip_memoria_maximo", "gauge", "Maior uso de cada pool do lwIP desde o boot"},
+        {"automacao_lwip_memoria_capacidade", "gauge", "Capacidade de cada pool do lwIP (0 = sem limite fixo)"},
+        {"automacao_lwip_memoria_falhas_total", "counter", "Alocacoes recusadas em cada pool do lwIP"},
+    };
+    for (int campo = 0; campo < (int)count_of(CAMPOS); campo++) {
+        metricas_familia(e, CAMPOS[campo].nome, CAMPOS[campo].tipo, CAMPOS[campo].ajuda);
+        for (int i = 0; i < n; i++) {
+            const uint32_t valores[] = {pools[i].uso, pools[i].maximo, pools[i].capacidade, pools[i].falhas};
+            snprintf(rotulos, sizeof(rotulos), "pool=\"%s\"", pools[i].nome);
+            metricas_valor(e, CAMPOS[campo].nome, rotulos, valores[campo]);
+        }
+    }
+
+    // Pilhas: a do núcleo 0 medida aqui, a do núcleo 1 vinda na última cópia das métricas dele
+    uint32_t uso[2], tamanho[2];
+    bool medida[2];
+    medida[0] = hal_pilha_uso(0, &uso[0], &tamanho[0]);
+    medida[1] = m1->pilha_medida;
+    uso[1] = m1->pilha_uso;
+    tamanho[1] = m1->pilha_tamanho;
+    metricas_familia(e, "automacao_pilha_uso_bytes", "gauge", "Maior profundidade ja alcancada na pilha de cada nucleo");
+    for (int i = 0; i < 2; i++) {
+        if (medida[i]) {
+            snprintf(rotulos, sizeof(rotulos), "nucleo=\"%d\"", i);
+            metricas_valor(e, "automacao_pilha_uso_bytes", rotulos, uso[i]);
+        }
+    }
+    metricas_familia(e, "automacao_pilha_tamanho_bytes", "gauge", "Tamanho da pilha de cada nucleo");
+    for (int i = 0; i < 2; i++) {
+        if (medida[i]) {
+            snprintf(rotulos, sizeof(rotulos), "nucleo=\"%d\"", i);
+            metricas_valor(e, "automacao_pilha_tamanho_bytes", rotulos, tamanho[i]);
+        }
+    }
+}
+
+// /metrics, um chunk por vez: cada chunk leva as linhas inteiras que couberem a partir da primeira
+// ainda não enviada, com os valores do momento em que é gerado
+void gerar_chunk_metricas(conexao_http_t *c) {
+    char *dados = c->buffer + HTTP_FLUXO_RESERVA;
+    metricas_escritor_t e;
+
+    c->etapa = ETAPA_CORPO;
+    metricas_iniciar(&e, dados, CONEXAO_BUFFER - HTTP_FLUXO_RESERVA - HTTP_FLUXO_FOLGA, c->metricas_linha);
+    escrever_metricas(&e);
+    c->metricas_linha = e.linha;
+
+    enquadrar_chunk(c, dados + e.tamanho);
+}
+#endif
+
+// Próximo evento SSE: estado atual e as amostras que o cliente ainda não recebeu
+// event: estado
+// data: {"epoch":...,"temperatura":28.5,...,"amostras":[[...]]}
+void gerar_evento_sse(conexao_http_t *c) {
+    size_t cabecalho = http_fluxo_abrir_evento(c->buffer, "estado");
+    char *dados = c->buffer + cabecalho;
+
+    json_escritor_t j;
+    json_iniciar(&j, dados, CONEXAO_BUFFER - cabecalho - HTTP_FLUXO_FOLGA);
+    json_abrir_objeto(&j);
+    escrever_estado_json(&j, &estado_atual);
+
+    // Amostras novas desde o último evento (no máximo as que couberem neste)
+    if (c->proxima_amostra < historico_proxima_sequencia()) {
+        historico_iterador_t it;
+        historico_iterar_desde(&it, c->proxima_amostra);
+        json_chave(&j, "amostras");
+        json_abrir_lista(&j);
+        amostra_t a;
+        while (json_livre(&j) > 48 && historico_proximo(&it, &a)) {
+            escrever_amostra_json(&j, &a);
+        }
+        json_fechar_lista(&j);
+        c->proxima_amostra = it.sequencia;
+    }
+    json_fechar_objeto(&j);
+
+    // O JSON não tem quebras de linha, então cabe numa única linha 'data:'
+    c->inicio = 0;
+    c->fim = http_fluxo_fechar_evento(c->buffer, cabecalho + j.tamanho);
+    c->evento_pendente = c->proxima_amostra < historico_proxima_sequencia();
+}
+
+// Envia o próximo trecho do recurso estático direto da flash (sem TCP_WRITE_FLAG_COPY:
+// os dados são const e continuam válidos até o ACK). Retorna false se a janela estiver cheia.
+bool enviar_corpo_estatico(conexao_http_t *c) {
+    if (c->corpo_restante == 0) {
+        c->etapa = ETAPA_FINAL;
+        return true;
+    }
+    uint16_t disponivel = tcp_sndbuf(c->pcb);
+    uint16_t tamanho = c->corpo_restante < disponivel ? c->corpo_restante : disponivel;
+    if (tamanho == 0 || tcp_write(c->pcb, c->corpo, tamanho, 0) != ERR_OK) {
+        return false;
+    }
+    c->corpo += tamanho;
+    c->corpo_restante -= tamanho;
+#if METRICAS
+    c->bytes_resposta += tamanho;
+#endif
+    return true;
+}
+
+// Entrega ao lwIP tudo o que couber na janela de envio. Com a janela ou a fila cheia, para
+// e continua no próximo tcp_sent (ou tcp_poll): a resposta avança no ritmo do cliente.
+void continuar_resposta(conexao_http_t *c) {
+    struct tcp_pcb *tpcb = c->pcb;
+
+    while (true) {
+        if (c->inicio == c->fim) {
+            if (c->etapa == ETAPA_FINAL) {
+                c->etapa = ETAPA_CONCLUIDA;
+#if METRICAS
+                metricas_observar(&metricas_core0.bytes_resposta, &METRICAS_ESCALA_BYTES, c->bytes_resposta);
+                c->bytes_resposta = 0;
+#endif
+            }
+            if (c->etapa == ETAPA_CONCLUIDA) {
+                break;
+            }
+            if (c->tipo == RESPOSTA_ESTATICA) {
+                if (!enviar_corpo_estatico(c)) break;
+                continue;
+            }
+            if (c->tipo == RESPOSTA_EVENTOS) {
+                if (!c->evento_pendente) break;   // A conexão fica aberta esperando o próximo evento
+                gerar_evento_sse(c);
+            } else if (c->tipo == RESPOSTA_JSON) {
+                gerar_chunk_json(c);
+            } else if (c->tipo == RESPOSTA_BINARIA) {
+                gerar_chunk_binario(c);
+            } else if (c->tipo == RESPOSTA_TENDENCIA) {
+                gerar_chunk_tendencia(c);
+#if METRICAS
+            } else if (c->tipo == RESPOSTA_METRICAS) {
+                gerar_chunk_metricas(c);
+#endif
+            } else {
+                gerar_chunk_csv(c);
+            }
+        }
+
+        uint16_t disponivel = tcp_sndbuf(tpcb);
+        uint16_t pendente = c->fim - c->inicio;
+        uint16_t tamanho = pendente < disponivel ? pendente : disponivel;
+        if (tamanho == 0 || tcp_write(tpcb, c->buffer + c->inicio, tamanho, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+            break;
+        }
+        c->inicio += tamanho;
+#if METRICAS
+        c->bytes_resposta += tamanho;
+#endif
+    }
+    tcp_output(tpcb);
+}
+
+// Valor de um parâmetro da query string (?nome=valor&...), ou NULL se ausente
+const char *ler_parametro(const char *alvo, const char *nome) {
+    const char *query = strchr(alvo, '?');
+    size_t n = strlen(nome);
+    for (const char *p = query; p; p = strchr(p + 1, '&')) {
+        if (strncmp(p + 1, nome, n) == 0 && p[1 + n] == '=') {
+            return p + 2 + n;
+        }
+    }
+    return NULL;
+}
+
+bool ler_parametro_data(const char *alvo, const char *nome, uint32_t *epoch) {
+    const char *valor = ler_parametro(alvo, nome);
+    return valor && data_hora_analisar(valor, epoch);
+}
+
+// Inicia a exportação do histórico: /download (CSV) ou /api/history (JSON), com [?from=...&to=...]
+// As datas aceitam segundos desde 1970 ou AAAA-MM-DD[THH:MM[:SS]].
+void iniciar_historico(conexao_http_t *c, const char *alvo, tipo_resposta_t tipo) {
+    uint32_t de = 0, ate = UINT32_MAX;
+    ler_parametro_data(alvo, "from", &de);
+    ler_parametro_data(alvo, "to", &ate);
+    historico_iterar_intervalo(&c->iterador, de, ate);
+
+    int n;
+    if (tipo == RESPOSTA_JSON) {
+        json_iniciar(&c->json, NULL, 0);
+        n = sprintf(c->buffer,
+                    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-store\r\n"
+                    "Transfer-Encoding: chunked\r\nConnection: %s\r\n\r\n", valor_connection(c));
+    } else {
+        n = sprintf(c->buffer,
+                    "HTTP/1.1 200 OK\r\nContent-Disposition: attachment; filename=\"historico_sensores.csv\"\r\n"
+                    "Content-Type: text/csv\r\nTransfer-Encoding: chunked\r\nConnection: %s\r\n\r\n", valor_connection(c));
+    }
+    c->tipo = tipo;
+    c->inicio = 0;
+    c->fim = n;
+    c->etapa = ETAPA_PREAMBULO;
+}
+
+// Inicia uma consulta de longo prazo: /api/trend[?from=...&to=...&points=N]. A camada é a mais fina
+// que guarda o intervalo inteiro em até N pontos (padrão TENDENCIA_PONTOS); sem nenhuma que caiba,
+// a de 1 h responde com baldes somados em grupos.
+void iniciar_tendencia(conexao_http_t *c, const char *alvo) {
+    uint32_t de = 0, ate = UINT32_MAX;
+    ler_parametro_data(alvo, "from", &de);
+    ler_parametro_data(alvo, "to", &ate);
+    const char *pontos = ler_parametro(alvo, "points");
+    uint32_t max_pontos = pontos ? strtoul(pontos, NULL, 10) : TENDENCIA_PONTOS;
+    camadas_iterar(&c->camadas, de, ate, max_pontos ? max_pontos : TENDENCIA_PONTOS);
+
+    json_iniciar(&c->json, NULL, 0);
+    c->tipo = RESPOSTA_TENDENCIA;
+    c->inicio = 0;
+    c->fim = sprintf(c->buffer,
+                     "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-store\r\n"
+                     "Transfer-Encoding: chunked\r\nConnection: %s\r\n\r\n", valor_connection(c));
+    c->etapa = ETAPA_PREAMBULO;
+}
+
+// Inicia a exportação binária: /api/history.bin[?since=N], com N = proxima_sequencia da coleta
+// anterior. O fim é fixado agora, e o cabeçalho já traz o cursor da próxima coleta.
+void iniciar_historico_binario(conexao_http_t *c, const char *alvo) {
+    const char *since = ler_parametro(alvo, "since");
+    uint32_t primeira = historico_primeira_sequencia();
+    uint32_t proxima = historico_proxima_sequencia();
+    uint32_t desde = since ? strtoul(since, NULL, 10) : primeira;
+    if (desde < primeira) {
+        desde = primeira;   // Amostras já sobrescritas
+    }
+    if (desde > proxima) {
+        desde = proxima;
+    }
+    historico_iterar_desde(&c->iterador, desde);
+    c->iterador.fim = proxima;
+
+    int n = sprintf(c->buffer,
+                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nCache-Control: no-store\r\n"
+                    "Transfer-Encoding: chunked\r\nConnection: %s\r\n\r\n", valor_connection(c));
+    c->tipo = RESPOSTA_BINARIA;
+    c->inicio = 0;
+    c->fim = n;
+    c->etapa = ETAPA_PREAMBULO;
+}
+
+#if METRICAS
+void iniciar_metricas(conexao_http_t *c) {
+    c->tipo = RESPOSTA_METRICAS;
+    c->metricas_linha = 0;
+    c->inicio = 0;
+    c->fim = sprintf(c->buffer,
+                     "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nCache-Control: no-store\r\n"
+                     "Transfer-Encoding: chunked\r\nConnection: %s\r\n\r\n", valor_connection(c));
+    c->etapa = ETAPA_PREAMBULO;
+}
+#endif
+
+int contar_conexoes_eventos() {
+    int n = 0;
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        if (conexoes_http[i].em_uso && conexoes_http[i].tipo == RESPOSTA_EVENTOS) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// Abre o fluxo SSE de /events; o primeiro evento (estado atual) vai logo em seguida ao cabeçalho
+void iniciar_eventos(conexao_http_t *c) {
+    int n = sprintf(c->buffer,
+                    "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-store\r\n"
+                    "Connection: keep-alive\r\n\r\nretry: 5000\n\n");
+    c->tipo = RESPOSTA_EVENTOS;
+    c->etapa = ETAPA_CORPO;
+    c->inicio = 0;
+    c->fim = n;
+    c->evento_pendente = true;
+    c->proxima_amostra = historico_proxima_sequencia();  // O painel já recebe o histórico recente por /api/status
+}
+
+err_t atender_conexao(conexao_http_t *c);
+
+// Avisa os clientes de /events que o estado mudou
+void notificar_eventos() {
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        conexao_http_t *c = &conexoes_http[i];
+        if (c->em_uso && c->tipo == RESPOSTA_EVENTOS) {
+            c->evento_pendente = true;
+            atender_conexao(c);
+        }
+    }
+}
+
+// Comentário SSE periódico: mantém a conexão viva em proxies e revela clientes que sumiram.
+// Roda no laço principal, então toma o lock do lwIP.
+void tarefa_eventos_keepalive(void *contexto) {
+    hal_rede_travar();
+    for (int i = 0; i < MAX_CONEXOES_HTTP; i++) {
+        conexao_http_t *c = &conexoes_http[i];
+        if (c->em_uso && c->tipo == RESPOSTA_EVENTOS && c->inicio == c->fim && !c->evento_pendente) {
+            c->inicio = 0;
+            c->fim = http_fluxo_comentario(c->buffer);
+            atender_conexao(c);
+        }
+    }
+    hal_rede_liberar();
+}
+
+const recurso_web_t *buscar_recurso(const char *caminho, size_t tamanho) {
+    for (uint32_t i = 0; i < recursos_web_quantidade; i++) {
+        if (strlen(recursos_web[i].caminho) == tamanho && strncmp(recursos_web[i].caminho, caminho, tamanho) == 0) {
+            return &recursos_web[i];
+        }
+    }
+    return NULL;
+}
+
+// Inicia o envio de um recurso estático pré-comprimido, ou 304 se o navegador já tem esta versão
+void iniciar_recurso_estatico(conexao_http_t *c, const recurso_web_t *r) {
+    bool atual = strstr(c->requisicao.if_none_match, r->etag) != NULL;
+
+    int n;
+    if (atual) {
+        n = sprintf(c->buffer, "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: no-cache\r\nConnection: %s\r\n\r\n",
+                    r->etag, valor_connection(c));
+        c->corpo_restante = 0;
+    } else {
+        n = sprintf(c->buffer,
+                    "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Encoding: gzip\r\nContent-Length: %lu\r\n"
+                    "ETag: %s\r\nCache-Control: no-cache\r\nConnection: %s\r\n\r\n",
+                    r->tipo, (unsigned long)r->tamanho, r->etag, valor_connection(c));
+        c->corpo = r->dados;
+        c->corpo_restante = r->tamanho;
+    }
+    c->tipo = RESPOSTA_ESTATICA;
+    c->etapa = ETAPA_CORPO;
+    c->inicio = 0;
+    c->fim = n;
+}
+
+// Resposta de tamanho conhecido, com o corpo já escrito em c->buffer + CABECALHO_RESERVA.
+// O cabeçalho é montado logo antes do corpo, e os dois saem do mesmo buffer.
+void responder(conexao_http_t *c, const char *status, const char *tipo, const char *extras, size_t tamanho_corpo) {
+    char cabecalho[CABECALHO_RESERVA];
+    int n = snprintf(cabecalho, sizeof(cabecalho),
+                     "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nCache-Control: no-store\r\n%sConnection: %s\r\n\r\n",
+                     status, tipo, (unsigned)tamanho_corpo, extras, valor_connection(c));
+    memcpy(c->buffer + CABECALHO_RESERVA - n, cabecalho, n);
+    c->tipo = RESPOSTA_SIMPLES;
+    c->inicio = CABECALHO_RESERVA - n;
+    c->fim = CABECALHO_RESERVA + tamanho_corpo;
+    c->etapa = ETAPA_FINAL;
+}
+
+void responder_texto(conexao_http_t *c, const char *status, const char *extras, const char *texto) {
+    size_t n = strlen(texto);
+    memcpy(c->buffer + CABECALHO_RESERVA, texto, n);
+    responder(c, status, "text/plain", extras, n);
+}
+
+bool rota(const char *caminho, size_t tamanho, const char *nome) {
+    return tamanho == strlen(nome) && strncmp(caminho, nome, tamanho) == 0;
+}
+
+// --- REGRAS PELA WEB ---
+bool enviar_comando(const comando_t *c);
+
+const char *const NOMES_ENTRADAS[REGRA_NUM_ENTRADAS] = {
+    [REGRA_ENTRADA_TEMPERATURA] = "temperatura",
+    [REGRA_ENTRADA_UMIDADE] = "umidade",
+    [REGRA_ENTRADA_LUMINOSIDADE] = "luminosidade",
+};
+
+bool regra_ligada(const snapshot_t *s, int indice) {
+    return indice == REGRA_LUZ ? s->luz_ligada : indice == REGRA_VENTILADOR ? s->ventilador_ligado : s->umidificador_ligado;
+}
+
+// "HH:MM" de um minuto do dia. A configuração já vem validada (< REGRAS_MINUTOS_DIA); o resto
+// da divisão só garante as duas casas da hora.
+char *formato_hora_minuto(char *destino, uint16_t minuto) {
+    minuto %= REGRAS_MINUTOS_DIA;
+    char *p = formato_zeros(destino, minuto / 60, 2);
+    *p++ = ':';
+    return formato_zeros(p, minuto % 60, 2);
+}
+
+void escrever_regra_json(json_escritor_t *j, int indice) {
+    const regra_config_t *r = &regras_config[indice];
+    char janela[sizeof("HH:MM-HH:MM")];
+    char *p = formato_hora_minuto(janela, r->janela_inicio);
+    *p++ = '-';
+    formato_hora_minuto(p, r->janela_fim);
+
+    json_abrir_objeto(j);
+    json_chave(j, "nome");
+    json_texto(j, r->nome);
+    json_chave(j, "entrada");
+    json_texto(j, NOMES_ENTRADAS[r->entrada]);
+    json_chave(j, "sentido");
+    json_texto(j, r->sentido == REGRA_LIGA_ACIMA ? "acima" : "abaixo");
+    json_chave(j, "liga");
+    json_decimos(j, r->liga);
+    json_chave(j, "desliga");
+    json_decimos(j, r->desliga);
+    json_chave(j, "min_ligado");
+    json_inteiro(j, r->minimo_ligado_s);
+    json_chave(j, "min_desligado");
+    json_inteiro(j, r->minimo_desligado_s);
+    json_chave(j, "janela");
+    json_texto(j, janela);
+    json_chave(j, "ligado");
+    json_booleano(j, regra_ligada(&estado_atual, indice));
+    json_fechar_objeto(j);
+}
+
+// GET /api/rules: configuração de todas as regras e o estado atual de cada relé
+size_t gerar_regras_json(char *buffer, size_t capacidade) {
+    json_escritor_t j;
+    json_iniciar(&j, buffer, capacidade);
+    json_abrir_objeto(&j);
+    json_chave(&j, "regras");
+    json_abrir_lista(&j);
+    for (int i = 0; i < NUM_REGRAS; i++) {
+        escrever_regra_json(&j, i);
+    }
+    json_fechar_lista(&j);
+    json_fechar_objeto(&j);
+    return j.tamanho;
+}
+
+// Os leitores abaixo deixam o valor como está se o parâmetro faltar e retornam false se estiver malformado.
+// Leitura em décimos: "29", "27.5" ou "-3.2"
+bool ler_parametro_decimos(const char *alvo, const char *nome, int16_t *decimos) {
+    const char *valor = ler_parametro(alvo, nome);
+    if (!valor) {
+        return true;
+    }
+    const char *p = valor + (*valor == '-');
+    if (*p < '0' || *p > '9') {
+        return false;
+    }
+    long v = 0;
+    for (; *p >= '0' && *p <= '9' && v < 100000; p++) {
+        v = v * 10 + (*p - '0');
+    }
+    v *= 10;
+    if (*p == '.' && p[1] >= '0' && p[1] <= '9') {
+        v += p[1] - '0';
+        for (p += 2; *p >= '0' && *p <= '9'; p++) {
+        }
+    }
+    if ((*p && *p != '&') || v > INT16_MAX) {
+        return false;
+    }
+    *decimos = (int16_t)(*valor == '-' ? -v : v);
+    return true;
+}
+
+bool ler_parametro_segundos(const char *alvo, const char *nome, uint16_t *segundos) {
+    const char *valor = ler_parametro(alvo, nome);
+    if (!valor) {
+        return true;
+    }
+    char *fim;
+    unsigned long v = strtoul(valor, &fim, 10);
+    if (fim == valor || (*fim && *fim != '&') || v > UINT16_MAX) {
+        return false;
+    }
+    *segundos = (uint16_t)v;
+    return true;
+}
+
+// Janela de horário "HH:MM-HH:MM"; "00:00-00:00" = o dia todo
+bool ler_parametro_janela(const char *alvo, uint16_t *inicio, uint16_t *fim) {
+    const char *valor = ler_parametro(alvo, "janela");
+    if (!valor) {
+        return true;
+    }
+    unsigned h1, m1, h2, m2;
+    int n = 0;
+    if (sscanf(valor, "%2u:%2u-%2u:%2u%n", &h1, &m1, &h2, &m2, &n) != 4 || (valor[n] && valor[n] != '&') ||
+        h1 > 23 || h2 > 23 || m1 > 59 || m2 > 59) {
+        return false;
+    }
+    *inicio = h1 * 60 + m1;
+    *fim = h2 * 60 + m2;
+    return true;
+}
+
+// POST /api/rules?regra=<nome>[&liga=..][&desliga=..][&min_ligado=s][&min_desligado=s][&janela=HH:MM-HH:MM]
+// Só os parâmetros presentes mudam. A nova configuração vai ao núcleo 1 e vale a partir da próxima
+// avaliação (imediata); ela não sobrevive a um reboot.
+void atualizar_regra(conexao_http_t *c, const char *alvo) {
+    const char *nome = ler_parametro(alvo, "regra");
+    int indice = -1;
+    for (int i = 0; nome && i < NUM_REGRAS; i++) {
+        size_t n = strlen(regras_config[i].nome);
+        if (strncmp(nome, regras_config[i].nome, n) == 0 && (nome[n] == '\0' || nome[n] == '&')) {
+            indice = i;
+        }
+    }
+    if (indice < 0) {
+        responder_texto(c, "404 Not Found", "", "Regra desconhecida");
+        return;
+    }
+
+    regra_config_t nova = regras_config[indice];
+    if (!ler_parametro_decimos(alvo, "liga", &nova.liga) ||
+        !ler_parametro_decimos(alvo, "desliga", &nova.desliga) ||
+        !ler_parametro_segundos(alvo, "min_ligado", &nova.minimo_ligado_s) ||
+        !ler_parametro_segundos(alvo, "min_desligado", &nova.minimo_desligado_s) ||
+        !ler_parametro_janela(alvo, &nova.janela_inicio, &nova.janela_fim) ||
+        !regras_config_valida(&nova)) {
+        responder_texto(c, "400 Bad Request", "", "Configuracao invalida");
+        return;
+    }
+
+    comando_t comando = {.tipo = COMANDO_REGRA, .valor = indice, .regra = nova};
+    if (!enviar_comando(&comando)) {
+        responder_texto(c, "503 Service Unavailable", "Retry-After: 1\r\n", "");
+        return;
+    }
+    regras_config[indice] = nova;
+    char liga[FORMATO_DECIMOS_MAX], desliga[FORMATO_DECIMOS_MAX];
+    formato_decimos(liga, nova.liga);
+    formato_decimos(desliga, nova.desliga);
+    printf("Regra %s atualizada pela web: liga %s, desliga %s.\n", nova.nome, liga, desliga);
+
+    json_escritor_t j;
+    json_iniciar(&j, c->buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+    escrever_regra_json(&j, indice);
+    responder(c, "200 OK", "application/json", "", j.tamanho);
+}
+
+// Escolhe a resposta para a requisição recém-analisada
+void despachar_requisicao(conexao_http_t *c) {
+    http_requisicao_t *r = &c->requisicao;
+    c->manter_aberta = r->manter_aberta;
+
+    if (http_requisicao_erro(r)) {
+        c->manter_aberta = false;   // Não dá para saber onde começa a próxima requisição
+        responder_texto(c, http_requisicao_status_erro(r), "", "");
+        return;
+    }
+
+    // Caminho sem a query string
+    const char *caminho = r->alvo;
+    size_t tamanho_caminho = strcspn(caminho, "?");
+
+    if (rota(caminho, tamanho_caminho, "/api/rules")) {
+        if (r->metodo == HTTP_METODO_POST) {
+            atualizar_regra(c, r->alvo);
+        } else if (r->metodo == HTTP_METODO_GET) {
+            size_t n = gerar_regras_json(c->buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+            responder(c, "200 OK", "application/json", "", n);
+        } else {
+            responder_texto(c, "405 Method Not Allowed", "Allow: GET, POST\r\n", "");
+        }
+        return;
+    }
+    if (r->metodo != HTTP_METODO_GET) {
+        responder_texto(c, "405 Method Not Allowed", "Allow: GET\r\n", "");
+        return;
+    }
+
+    if (rota(caminho, tamanho_caminho, "/api/status")) {
+        size_t n = gerar_status_json(c->buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+        responder(c, "200 OK", "application/json", "", n);
+    } else if (rota(caminho, tamanho_caminho, "/api/stats")) {
+        size_t n = gerar_agregados_json(c->buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+        responder(c, "200 OK", "application/json", "", n);
+    } else if (rota(caminho, tamanho_caminho, "/api/trend")) {
+        iniciar_tendencia(c, r->alvo);
+    } else if (rota(caminho, tamanho_caminho, "/api/history.bin")) {
+        iniciar_historico_binario(c, r->alvo);
+    } else if (rota(caminho, tamanho_caminho, "/api/history")) {
+        iniciar_historico(c, r->alvo, RESPOSTA_JSON);
+    } else if (rota(caminho, tamanho_caminho, "/download")) {
+        iniciar_historico(c, r->alvo, RESPOSTA_CSV);
+    } else if (rota(caminho, tamanho_caminho, "/events")) {
+        if (contar_conexoes_eventos() >= MAX_CONEXOES_EVENTOS) {
+            responder_texto(c, "503 Service Unavailable", "Retry-After: 5\r\n", "");
+        } else {
+            iniciar_eventos(c);
+        }
+#if METRICAS
+    } else if (rota(caminho, tamanho_caminho, "/metrics")) {
+        iniciar_metricas(c);
+#endif
+    } else {
+        if (rota(caminho, tamanho_caminho, "/index.html")) {
+            tamanho_caminho = 1;
+        }
+        const recurso_web_t *recurso = buscar_recurso(caminho, tamanho_caminho);
+        if (recurso) {
+            iniciar_recurso_estatico(c, recurso);
+        } else {
+            responder_texto(c, "404 Not Found", "", "Nao encontrado");
+        }
+    }
+}
+
+// Passa ao analisador os bytes recebidos, um pbuf por vez, liberando (e devolvendo à janela
+// TCP) só o que foi consumido. Bytes de uma próxima requisição ficam guardados até a vez dela.
+bool consumir_requisicao(conexao_http_t *c) {
+    http_requisicao_t *r = &c->requisicao;
+    while (c->entrada && !http_requisicao_completa(r) && !http_requisicao_erro(r)) {
+        struct pbuf *p = c->entrada;
+        u16_t usados = http_requisicao_alimentar(r, p->payload, p->len);
+        if (usados == 0) {
+            break;
+        }
+        c->entrada = pbuf_free_header(p, usados);
+        tcp_recved(c->pcb, usados);
+    }
+    return http_requisicao_completa(r) || http_requisicao_erro(r);
+}
+
+// Avança a conexão: responde à requisição completa, envia o que couber e, terminada a resposta,
+// passa à próxima (keep-alive) ou fecha. Chamada em toda recepção, tcp_sent e tcp_poll.
+err_t atender_conexao(conexao_http_t *c) {
+    while (true) {
+        if (c->etapa == ETAPA_AGUARDANDO) {
+            if (!consumir_requisicao(c)) {
+                return ERR_OK;
+            }
+            METRICAS_MEDIR(metricas_core0.http_requisicao, despachar_requisicao(c));
+        }
+
+        METRICAS_MEDIR(metricas_core0.http_envio, continuar_resposta(c));
+        if (c->etapa != ETAPA_CONCLUIDA) {
+            return ERR_OK;      // Janela cheia ou fluxo SSE aberto
+        }
+        if (!c->manter_aberta) {
+            return fechar_conexao(c->pcb, c);
+        }
+        c->etapa = ETAPA_AGUARDANDO;
+        http_requisicao_iniciar(&c->requisicao);
+    }
+}
+
+static err_t http_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    conexao_http_t *c = arg;
+    if (!c) {
+        return ERR_OK;
+    }
+    c->ultima_atividade_ms = agora_ms();
+    return atender_conexao(c);
+}
+
+static void http_err_callback(void *arg, err_t err) {
+    // O lwIP já liberou o pcb; só a conexão (e o que ela guardava) volta ao pool
+    liberar_conexao(arg);
 }
 
-// --- FUNÇÕES DE SERVIDOR WEB (LWIP) ---
 static err_t http_callback(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    conexao_http_t *c = arg;
+    if (!c) {
+        if (p) {
+            pbuf_free(p);
+        }
+        return ERR_OK;
+    }
     if (p == NULL) {
-        tcp_close(tpcb);
+        // O cliente não vai enviar mais nada: termina a resposta em andamento e fecha
+        if (c->etapa == ETAPA_AGUARDANDO || c->tipo == RESPOSTA_EVENTOS) {
+            return fechar_conexao(tpcb, c);
+        }
+        c->manter_aberta = false;
         return ERR_OK;
     }
-    char *request = (char *)p->payload;
-    if (strstr(request, "GET /download")) {
-        create_csv_content();
-        snprintf(http_response, sizeof(http_response),
-                 "HTTP/1.1 200 OK\r\nContent-Disposition: attachment; filename=\"historico_sensores.csv\"\r\nContent-Type: text/csv\r\n"
-                 "Content-Length: %d\r\n\r\n%s", strlen(csv_content), csv_content);
-        tcp_write(tpcb, http_response, strlen(http_response), TCP_WRITE_FLAG_COPY);
+
+    if (c->entrada) {
+        pbuf_cat(c->entrada, p);
     } else {
-        create_http_response();
-        tcp_write(tpcb, http_response, strlen(http_response), TCP_WRITE_FLAG_COPY);
+        c->entrada = p;
     }
-    pbuf_free(p);
-    return ERR_OK;
+    c->ultima_atividade_ms = agora_ms();
+    return atender_conexao(c);
+}
+
+// A cada ~2 s: retoma envios recusados por falta de memória e fecha conexões paradas
+static err_t http_poll_callback(void *arg, struct tcp_pcb *tpcb) {
+    conexao_http_t *c = arg;
+    if (!c) {
+        return ERR_OK;
+    }
+    uint32_t parado = agora_ms() - c->ultima_atividade_ms;
+    if (c->etapa == ETAPA_AGUARDANDO) {
+        bool iniciada = c->entrada || c->requisicao.tamanho_cabecalho > 0;
+        if (parado > (iniciada ? HTTP_PRAZO_REQUISICAO_MS : HTTP_OCIOSO_MS)) {
+            return fechar_conexao(tpcb, c);
+        }
+    } else if (parado > HTTP_PRAZO_ENVIO_MS) {
+        // Cliente que não confirma nada há muito tempo (nem os comentários de keep-alive do SSE)
+        liberar_conexao(c);
+        tcp_arg(tpcb, NULL);
+        tcp_err(tpcb, NULL);
+        tcp_abort(tpcb);
+        return ERR_ABRT;
+    }
+    return atender_conexao(c);
 }
 
 static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    static const char ocupado[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 5\r\nConnection: close\r\n\r\n";
+
+    conexao_http_t *c = alocar_conexao(newpcb);
+    if (!c) {
+#if METRICAS
+        metricas_core0.conexoes_recusadas++;
+#endif
+        tcp_write(newpcb, ocupado, sizeof(ocupado) - 1, 0);
+        return fechar_conexao(newpcb, NULL);
+    }
+    tcp_arg(newpcb, c);
     tcp_recv(newpcb, http_callback);
+    tcp_sent(newpcb, http_sent_callback);
+    tcp_err(newpcb, http_err_callback);
+    tcp_poll(newpcb, http_poll_callback, HTTP_POLL_INTERVALO);
     return ERR_OK;
 }
 
@@ -310,103 +1624,447 @@ static void start_http_server(void) {
     printf("Servidor HTTP rodando na porta 80...\n");
 }
 
+// Chamada a cada WIFI_CHECK_INTERVAL_MS pelo agendador
 void verificar_wifi() {
-    static absolute_time_t ultima_tentativa = {0};
-    if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_UP) {
-        absolute_time_t agora = get_absolute_time();
-        if (absolute_time_diff_us(ultima_tentativa, agora) > 10 * 1000 * 1000) {
-            printf("Tentando reconectar ao Wi-Fi...\n");
-            ultima_tentativa = agora;
-            cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK);
+    if (!hal_rede_enlace()) {
+        printf("Tentando reconectar ao Wi-Fi...\n");
+        hal_rede_conectar(WIFI_SSID, WIFI_PASS);
+    }
+}
+
+// --- NÚCLEO 1: SENSORES, RELÉS E INTERFACES LOCAIS ---
+agendador_t agendador_core1;
+int tarefa_interfaces_id;
+uint32_t pilha_core1[CORE1_STACK_WORDS];
+
+void processar_snapshots(void);
+
+// Envia o estado atual ao núcleo 0 e o acorda para processá-lo. Um registro do histórico
+// também é uma coluna nova nos gráficos do display.
+void publicar_snapshot(bool registrar_historico) {
+    snapshot_t s = {
+        .temperatura = temperatura_sensor,
+        .umidade = umidade_sensor,
+        .luminosidade = luminosidade_sensor,
+        .luz_ligada = hal_gpio_ler(RELAY_LIGHTS_PIN),
+        .ventilador_ligado = hal_gpio_ler(RELAY_FAN_PIN),
+        .umidificador_ligado = hal_gpio_ler(RELAY_HUMIDIFIER_PIN),
+        .registrar_historico = registrar_historico,
+        .itu = agregados.ultimo[AGREGADO_ITU],
+    };
+    hal_rtc_ler(&s.timestamp);
+    if (registrar_historico) {
+        ssd1306_sparkline_add(&oled, &grafico_temperatura, temperatura_sensor);
+        ssd1306_sparkline_add(&oled, &grafico_umidade, umidade_sensor);
+    }
+    for (int i = 0; i < NUM_JANELAS; i++) {
+        for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+            agregados_resumo(&agregados, i, g, &s.agregados[i][g]);
+        }
+    }
+
+    if (!canal_spsc_enviar(&canal_snapshots, &s)) {
+        printf("Canal de retratos cheio; retrato descartado.\n");
+    }
+    hal_rede_sinalizar();
+}
+
+void processar_comandos() {
+    comando_t c;
+    while (canal_spsc_receber(&canal_comandos, &c)) {
+        switch (c.tipo) {
+            case COMANDO_WIFI_STATUS:
+                wifi_conectado = c.valor != 0;
+                agendador_antecipar(&agendador_core1, tarefa_interfaces_id);
+                break;
+            case COMANDO_REGRA:
+                // Vale já, com as leituras atuais; o núcleo 0 já validou a configuração
+                if (regras_configurar(&motor_regras, c.valor, &c.regra)) {
+                    aplicar_regras();
+                    publicar_snapshot(false);
+                    agendador_antecipar(&agendador_core1, tarefa_interfaces_id);
+                }
+                break;
+        }
+    }
+}
+
+// Lê (ou simula) os sensores e controla os relés pelas regras. Só as regras cuja entrada
+// mudou (ou que esperam um tempo mínimo) são reavaliadas.
+void tarefa_controle(void *contexto) {
+    static bool primeiro_ciclo = true;
+#if METRICAS
+    uint64_t inicio = hal_tempo_us();
+#endif
+
+#if SENSOR_LDR
+    ler_luminosidade_sensor();
+#else
+    simular_luminosidade_sensor();
+#endif
+#if SENSOR_DHT11
+    ler_temperatura_umidade_sensor();
+#else
+    simular_temperatura_umidade_sensor();
+#endif
+
+    datetime_t agora;
+    hal_rtc_ler(&agora);
+    regras_horario(&motor_regras, agora.hour * 60 + agora.min);
+    regras_entrada(&motor_regras, REGRA_ENTRADA_LUMINOSIDADE, luminosidade_sensor);
+    regras_entrada(&motor_regras, REGRA_ENTRADA_TEMPERATURA, temperatura_sensor);
+    regras_entrada(&motor_regras, REGRA_ENTRADA_UMIDADE, umidade_sensor);
+    aplicar_regras();
+
+    // Estatísticas móveis e ITU, em O(1) por ciclo; o retrato leva os resumos ao núcleo 0
+    agregados_amostra(&agregados, (uint32_t)(hal_tempo_us() / 1000000), temperatura_sensor, umidade_sensor);
+
+    // O primeiro retrato, já com leituras reais, também abre o histórico desta execução
+    publicar_snapshot(primeiro_ciclo);
+    primeiro_ciclo = false;
+#if METRICAS
+    metricas_observar(&metricas_core1.controle, &METRICAS_ESCALA_US, (uint32_t)(hal_tempo_us() - inicio));
+#endif
+
+    // Valores novos: atualiza display e LEDs sem esperar o próximo período
+    agendador_antecipar(&agendador_core1, tarefa_interfaces_id);
+}
+
+void tarefa_historico(void *contexto) {
+    publicar_snapshot(true);
+}
+
+#if SENSOR_DHT11
+// Só dispara o quadro; a leitura chega pela fila do driver
+void tarefa_dht11(void *contexto) {
+    dht11_disparar(&dht11);
+}
+#endif
+
+#if SENSOR_LDR
+// Filtra o que o DMA trouxe do ADC desde a última passagem
+void tarefa_adc(void *contexto) {
+    amostragem_adc_processar();
+}
+#endif
+
+// Atualiza as interfaces visuais; display e LEDs só transmitem o que mudou
+void tarefa_interfaces(void *contexto) {
+    METRICAS_MEDIR(metricas_core1.display, atualizar_display_oled());
+    atualizar_matriz_leds();
+    METRICAS_MEDIR(metricas_core1.leds, npWrite());
+}
+
+void tarefa_estatisticas_core1(void *contexto) {
+    printf("--- Núcleo 1 ---\n");
+    agendador_imprimir_estatisticas(&agendador_core1);
+    printf("Regras: %lu avaliacoes", (unsigned long)motor_regras.avaliacoes);
+    for (int i = 0; i < NUM_REGRAS; i++) {
+        printf(", %s %lu trocas", motor_regras.regras[i].config.nome, (unsigned long)motor_regras.regras[i].trocas);
+    }
+    printf("\n");
+#if SENSOR_DHT11
+    if (dht11_ok) {
+        printf("DHT11: %lu leituras, %lu erros de checksum, %lu tempos esgotados, %lu descartadas por fila cheia\n",
+               (unsigned long)dht11.leituras, (unsigned long)dht11.erros_checksum,
+               (unsigned long)dht11.tempos_esgotados, (unsigned long)dht11.fila.descartados);
+    }
+#endif
+#if SENSOR_LDR
+    if (adc_ok) {
+        const filtro_adc_t *ldr = amostragem_adc_filtro(LDR_ADC_PIN);
+        printf("ADC: LDR %u/65520 (%lu medias), %lu reinicios do DMA\n", ldr->valor,
+               (unsigned long)ldr->atualizacoes, (unsigned long)amostragem_adc_reinicios());
+#if BATERIA_ADC_PIN
+        const filtro_adc_t *bateria = amostragem_adc_filtro(BATERIA_ADC_PIN);
+        printf("ADC: bateria %lu mV\n", (unsigned long)bateria->valor * 3300 * BATERIA_DIVISOR / 65520);
+#endif
+    }
+#endif
+}
+
+#if METRICAS
+// Copia as métricas do núcleo 1 para o núcleo 0, que as expõe em /metrics. Com o canal cheio a
+// cópia é descartada; a próxima traz os mesmos contadores, acumulados.
+void tarefa_metricas_core1(void *contexto) {
+    metricas_core1.pilha_medida = hal_pilha_uso(1, &metricas_core1.pilha_uso, &metricas_core1.pilha_tamanho);
+    if (canal_spsc_enviar(&canal_metricas, &metricas_core1)) {
+        hal_rede_sinalizar();
+    }
+}
+#endif
+
+// Inicialização do núcleo 1, já rodando nele: as interrupções dos LEDs, do DHT11 e do ADC ficam aqui
+void core1_iniciar() {
+    // Inicializa I2C e Display OLED
+    hal_i2c_iniciar(OLED_I2C_BUS, I2C_SDA, I2C_SCL, 400 * 1000);
+    ssd1306_init(&oled, OLED_I2C_BUS, OLED_I2C_ADDRESS, SSD1306_WIDTH, SSD1306_HEIGHT, false);
+    ssd1306_draw_string(&oled, 0, 0, "Inicializando...");
+    render_on_display(&oled);
+    ssd1306_clear(&oled);
+    iniciar_graficos_oled();
+    printf("Display OLED inicializado.\n");
+
+    // Inicializa LEDs Neopixel (a interrupção do DMA fica neste núcleo)
+    npInit(LED_PIN_PIO);
+    printf("Matriz de LEDs inicializada no pino %d.\n", LED_PIN_PIO);
+
+    srand(hal_tempo_us());
+
+    regras_iniciar(&motor_regras);
+    for (int i = 0; i < NUM_REGRAS; i++) {
+        regras_adicionar(&motor_regras, &REGRAS_PADRAO[i]);
+    }
+
+    agregados_iniciar(&agregados);
+    for (int i = 0; i < NUM_JANELAS; i++) {
+        agregados_adicionar_janela(&agregados, JANELAS_AGREGADOS[i].largura_s, JANELAS_AGREGADOS[i].baldes);
+    }
+
+    agendador_iniciar(&agendador_core1);
+#if SENSOR_DHT11
+    // Também aqui fica a interrupção do PIO, produtora da fila de leituras
+    dht11_ok = dht11_iniciar(&dht11, DHT11_PIN);
+    if (dht11_ok) {
+        printf("DHT11 inicializado no pino %d.\n", DHT11_PIN);
+        agendador_periodica(&agendador_core1, "dht11", tarefa_dht11, NULL, DHT11_INTERVALO_MS, 0);
+    }
+#endif
+#if SENSOR_LDR
+    const uint pinos_adc[] = {
+        LDR_ADC_PIN,
+#if BATERIA_ADC_PIN
+        BATERIA_ADC_PIN,
+#endif
+    };
+    adc_ok = amostragem_adc_iniciar(pinos_adc, count_of(pinos_adc));
+    if (adc_ok) {
+        printf("ADC amostrando o LDR no pino %d a %d Hz.\n", LDR_ADC_PIN, AMOSTRAGEM_ADC_TAXA_HZ);
+        agendador_periodica(&agendador_core1, "adc", tarefa_adc, NULL, ADC_PROCESSAR_INTERVALO_MS, ADC_PROCESSAR_INTERVALO_MS);
+    }
+#endif
+    agendador_periodica(&agendador_core1, "controle", tarefa_controle, NULL, CONTROL_INTERVAL_MS, CONTROL_FIRST_DELAY_MS);
+    agendador_periodica(&agendador_core1, "historico", tarefa_historico, NULL, SENSOR_READ_INTERVAL_MS, SENSOR_READ_INTERVAL_MS);
+    tarefa_interfaces_id = agendador_periodica(&agendador_core1, "interfaces", tarefa_interfaces, NULL, INTERFACE_INTERVAL_MS, 0);
+    agendador_periodica(&agendador_core1, "estatisticas", tarefa_estatisticas_core1, NULL, STATS_INTERVAL_MS, STATS_INTERVAL_MS);
+#if METRICAS
+    agendador_periodica(&agendador_core1, "metricas", tarefa_metricas_core1, NULL, METRICAS_INTERVALO_MS, METRICAS_INTERVALO_MS);
+#endif
+}
+
+// Uma volta do laço do núcleo 1. Retorna o próximo prazo: o núcleo dorme até lá ou até o núcleo 0
+// enviar um comando (hal_nucleo1_acordar).
+uint64_t core1_passo() {
+    processar_comandos();
+    agendador_executar_pendentes(&agendador_core1);
+    return agendador_proximo_prazo(&agendador_core1);
+}
+
+// --- NÚCLEO 0: REDE E SERVIDOR WEB ---
+agendador_t agendador_core0;
+
+bool estado_mudou(const snapshot_t *a, const snapshot_t *b) {
+    return a->temperatura != b->temperatura || a->umidade != b->umidade || a->luminosidade != b->luminosidade ||
+           a->luz_ligada != b->luz_ligada || a->ventilador_ligado != b->ventilador_ligado ||
+           a->umidificador_ligado != b->umidificador_ligado;
+}
+
+// Consome os retratos do núcleo 1 (e a cópia das métricas dele). Roda no contexto da rede
+// (hal_rede_trabalho), o mesmo das callbacks do lwIP.
+void processar_snapshots(void) {
+#if METRICAS
+    while (canal_spsc_receber(&canal_metricas, &metricas_core1_recebidas)) {
+    }
+#endif
+
+    snapshot_t s;
+    bool amostra_nova = false;
+    while (canal_spsc_receber(&canal_snapshots, &s)) {
+        estado_atual = s;
+        if (s.registrar_historico) {
+            salvar_historico_sensores(&s);
+            amostra_nova = true;
+        }
+    }
+
+    // /events só recebe algo quando uma leitura (na resolução exibida) ou um relé muda
+    if (amostra_nova || estado_mudou(&estado_publicado, &estado_atual)) {
+        estado_publicado = estado_atual;
+        notificar_eventos();
+    }
+}
+
+// Retorna false (sem bloquear) se o canal estiver cheio
+bool enviar_comando(const comando_t *c) {
+    if (!canal_spsc_enviar(&canal_comandos, c)) {
+        return false;
+    }
+    hal_nucleo1_acordar();
+    return true;
+}
+
+void tarefa_wifi(void *contexto) {
+    verificar_wifi();
+}
+
+// Repassa ao núcleo 1 as mudanças no estado do enlace Wi-Fi
+void tarefa_enlace(void *contexto) {
+    static int ultimo_estado = -1;
+    int conectado = hal_rede_enlace();
+    if (conectado != ultimo_estado) {
+        ultimo_estado = conectado;
+        enviar_comando(&(comando_t){.tipo = COMANDO_WIFI_STATUS, .valor = conectado});
+#if TELEMETRIA_MQTT
+        telemetria_mqtt_enlace(conectado);
+#endif
+    }
+}
+
+void tarefa_estatisticas(void *contexto) {
+    printf("--- Núcleo 0 ---\n");
+    agendador_imprimir_estatisticas(&agendador_core0);
+    if (log_flash_ok) {
+        printf("Log em flash: seq %lu..%lu, %lu paginas gravadas, %lu setores apagados, %lu registros corrompidos, %lu falhas\n",
+               (unsigned long)flash_log_primeira_sequencia(&log_flash), (unsigned long)flash_log_proxima_sequencia(&log_flash),
+               (unsigned long)log_flash.gravacoes_pagina, (unsigned long)log_flash.apagamentos,
+               (unsigned long)log_flash.registros_corrompidos, (unsigned long)log_flash.falhas);
+    }
+    for (int k = CAMADA_5MIN; k < CAMADAS_NUM; k++) {
+        const flash_log_t *l = camadas_log(k);
+        if (l) {
+            printf("Log da camada %d: seq %lu..%lu, %lu paginas gravadas, %lu setores apagados, %lu registros corrompidos, %lu falhas\n",
+                   k, (unsigned long)flash_log_primeira_sequencia(l), (unsigned long)flash_log_proxima_sequencia(l),
+                   (unsigned long)l->gravacoes_pagina, (unsigned long)l->apagamentos,
+                   (unsigned long)l->registros_corrompidos, (unsigned long)l->falhas);
+        }
+    }
+#if TELEMETRIA_MQTT
+    telemetria_mqtt_imprimir_estatisticas();
+#endif
+}
+
+// Grava as páginas pendentes dos logs (amostras e camadas), limitando o que se perde numa queda de
+// energia. Os logs também são usados por processar_snapshots e por /api/trend, no contexto da
+// rede; o lock evita as duas coisas ao mesmo tempo.
+void tarefa_descarregar_flash(void *contexto) {
+    hal_rede_travar();
+    if (log_flash_ok) {
+        flash_log_descarregar(&log_flash);
+    }
+    camadas_descarregar();
+    hal_rede_liberar();
+}
+
+// Monta os logs em flash, recarrega no histórico em RAM as amostras mais recentes e, com elas,
+// refaz os baldes em andamento das camadas
+void restaurar_historico() {
+    if (!camadas_iniciar(hal_flash_camada(CAMADA_5MIN), hal_flash_camada(CAMADA_1H))) {
+        printf("Camadas sem log em flash; apenas os baldes em andamento.\n");
+    }
+    log_flash_ok = flash_log_montar(&log_flash, hal_flash_log(), FLASH_LOG_AMOSTRAS);
+    if (!log_flash_ok) {
+        printf("Log em flash indisponivel; historico apenas em RAM.\n");
+        return;
+    }
+
+    // Só o fim do log é lido: os baldes fechados já estão nos logs das camadas, que apenas
+    // completam os que faltarem
+    uint32_t fim = flash_log_proxima_sequencia(&log_flash);
+    uint32_t inicio = flash_log_primeira_sequencia(&log_flash);
+    if (fim - inicio > HISTORICO_CAPACIDADE) {
+        inicio = fim - HISTORICO_CAPACIDADE;
+    }
+
+    historico_continuar_sequencia(inicio);
+    amostra_t a;
+    for (uint32_t seq = inicio; seq < fim; seq++) {
+        if (flash_log_ler(&log_flash, seq, &a)) {
+            historico_adicionar(&a);
+            camadas_adicionar(&a);
+        }
+    }
+    printf("Historico restaurado da flash: %lu amostras.\n", (unsigned long)historico_quantidade());
+
+    // Sem fonte de hora externa, o RTC volta à data fixa do boot; segue a partir da última amostra
+    // para que os timestamps continuem crescentes
+    if (historico_obter_recente(0, &a)) {
+        datetime_t agora;
+        hal_rtc_ler(&agora);
+        if (data_hora_para_epoch(&agora) <= a.epoch) {
+            data_hora_de_epoch(a.epoch + SENSOR_READ_INTERVAL_MS / 1000, &agora);
+            hal_rtc_ajustar(&agora);
         }
     }
 }
 
 // --- FUNÇÃO PRINCIPAL (MAIN) ---
 int main() {
-    stdio_init_all();
-    sleep_ms(3000); // Pausa para abrir o monitor serial
+    hal_iniciar();
 
     // Define data e hora iniciais (Ano, Mês, Dia, Dia da Semana, Hora, Minuto, Segundo)
     datetime_t t = {.year = 2025, .month = 7, .day = 1, .dotw = 2, .hour = 22, .min = 43, .sec = 0};
-    rtc_init();
-    rtc_set_datetime(&t);
+    hal_rtc_iniciar(&t);
 
-    for (int i = 0; i < MAX_HISTORICO; i++) historico_valido[i] = false;
+    historico_iniciar();
 
-    if (cyw43_arch_init()) {
+    if (!hal_rede_iniciar()) {
         printf("Erro ao iniciar o Wi-Fi\n");
         return 1;
     }
-    cyw43_arch_enable_sta_mode();
-    cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK);
+    hal_rede_conectar(WIFI_SSID, WIFI_PASS);
     printf("Wi-Fi: tentando conectar...\n");
 
     // Inicializa os pinos dos relés como saída
-    gpio_init(RELAY_LIGHTS_PIN);
-    gpio_set_dir(RELAY_LIGHTS_PIN, GPIO_OUT);
-    gpio_init(RELAY_FAN_PIN);
-    gpio_set_dir(RELAY_FAN_PIN, GPIO_OUT);
-    gpio_init(RELAY_HUMIDIFIER_PIN);
-    gpio_set_dir(RELAY_HUMIDIFIER_PIN, GPIO_OUT);
+    hal_gpio_saida(RELAY_LIGHTS_PIN);
+    hal_gpio_saida(RELAY_FAN_PIN);
+    hal_gpio_saida(RELAY_HUMIDIFIER_PIN);
 
-    // Inicializa I2C e Display OLED
-    i2c_init(i2c1, 400 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
-    ssd1306_init();
-    frame_area = (struct render_area){.start_column = 0, .end_column = SSD1306_WIDTH - 1, .start_page = 0, .end_page = (SSD1306_HEIGHT / 8) - 1};
-    calculate_render_area_buffer_length(&frame_area);
-    ssd1306_draw_string(oled_buffer, 0, 0, "Inicializando...");
-    render_on_display(oled_buffer, &frame_area);
-    printf("Display OLED inicializado.\n");
+    canal_spsc_iniciar(&canal_snapshots, buffer_snapshots, sizeof(snapshot_t), count_of(buffer_snapshots));
+    canal_spsc_iniciar(&canal_comandos, buffer_comandos, sizeof(comando_t), count_of(buffer_comandos));
+#if METRICAS
+    canal_spsc_iniciar(&canal_metricas, buffer_metricas, sizeof(metricas_nucleo1_t), count_of(buffer_metricas));
+#endif
+    memcpy(regras_config, REGRAS_PADRAO, sizeof(regras_config));
 
-    // Inicializa LEDs Neopixel
-    npInit(LED_PIN_PIO);
-    printf("Matriz de LEDs inicializada no pino %d.\n", LED_PIN_PIO);
+    // O histórico é restaurado (e o RTC ajustado) antes de o núcleo 1 produzir o primeiro retrato
+    restaurar_historico();
+
+    // Sensores, relés e interfaces locais passam para o núcleo 1
+    hal_nucleo1_lancar(core1_iniciar, core1_passo, pilha_core1, sizeof(pilha_core1));
+    hal_rede_trabalho(processar_snapshots);
 
-    srand(to_us_since_boot(get_absolute_time()));
     start_http_server();
 
-    absolute_time_t last_sensor_read_time = get_absolute_time();
-    simular_temperatura_umidade_sensor();
-    simular_luminosidade_sensor();
-    salvar_historico_sensores();
+    agendador_iniciar(&agendador_core0);
+    agendador_periodica(&agendador_core0, "wifi", tarefa_wifi, NULL, WIFI_CHECK_INTERVAL_MS, WIFI_CHECK_INTERVAL_MS);
+    agendador_periodica(&agendador_core0, "enlace", tarefa_enlace, NULL, LINK_CHECK_INTERVAL_MS, 0);
+    agendador_periodica(&agendador_core0, "estatisticas", tarefa_estatisticas, NULL, STATS_INTERVAL_MS, STATS_INTERVAL_MS);
+    agendador_periodica(&agendador_core0, "flash", tarefa_descarregar_flash, NULL, FLASH_FLUSH_INTERVAL_MS, FLASH_FLUSH_INTERVAL_MS);
+    agendador_periodica(&agendador_core0, "eventos", tarefa_eventos_keepalive, NULL, EVENTOS_KEEPALIVE_MS, EVENTOS_KEEPALIVE_MS);
+
+#if TELEMETRIA_MQTT
+    // Só as amostras novas vão para o broker; as restauradas da flash já foram publicadas antes
+    telemetria_mqtt_config_t mqtt = {
+        .broker = MQTT_BROKER,
+        .porta = MQTT_PORTA,
+        .cliente = MQTT_CLIENTE,
+        .topico = MQTT_TOPICO,
+        .intervalo_ms = MQTT_INTERVALO_MS,
+        .lote_maximo = MQTT_LOTE_MAXIMO,
+    };
+    if (telemetria_mqtt_iniciar(&mqtt, historico_proxima_sequencia())) {
+        agendador_periodica(&agendador_core0, "mqtt", telemetria_mqtt_tarefa, NULL, TELEMETRIA_MQTT_PASSO_MS, TELEMETRIA_MQTT_PASSO_MS);
+    }
+#endif
 
     // --- LOOP PRINCIPAL ---
     while (true) {
-        cyw43_arch_poll();
-        verificar_wifi();
-
-        // Bloco de tempo para simular sensores e controlar os relés (a cada 30 segundos)
-        static absolute_time_t last_control_check = {0};
-        absolute_time_t now = get_absolute_time();
-        if (absolute_time_diff_us(last_control_check, now) > 30 * 1000 * 1000) {
-            last_control_check = now;
-            simular_luminosidade_sensor();
-            acionar_rele_luz(luminosidade_sensor < LUMINOSITY_THRESHOLD);
-
-            simular_temperatura_umidade_sensor();
-            acionar_rele_ventilador(temperatura_sensor);
-            acionar_rele_umidificador(umidade_sensor);
-        }
-
-        // Bloco de tempo para salvar os dados no histórico (a cada 5 minutos)
-        if (absolute_time_diff_us(last_sensor_read_time, now) > (int64_t)SENSOR_READ_INTERVAL_MS * 1000) {
-            last_sensor_read_time = now;
-            salvar_historico_sensores();
-        }
-
-        // Atualiza as interfaces visuais
-        atualizar_display_oled();
-        atualizar_matriz_leds();
-        npWrite();
+        hal_rede_processar();
+        agendador_executar_pendentes(&agendador_core0);
 
-        sleep_ms(100); // Pequena pausa para reduzir o uso de CPU
+        // Dorme até o próximo prazo do agendador ou até o Wi-Fi/lwIP (ou o núcleo 1) sinalizar trabalho
+        hal_rede_aguardar(agendador_proximo_prazo(&agendador_core0));
     }
 
-    cyw43_arch_deinit();
     return 0;
 }
@@ -0,0 +1,468 @@
+/**
+ * Bancada de microbenchmarks das rotinas quentes do firmware: montagem das respostas HTTP, chunks
+ * do histórico (CSV, JSON, binário), eventos SSE, texto no OLED e matriz de LEDs. Cada caso roda
+ * N vezes e sai com média, p50, p90, p99 e máximo por chamada, mais a profundidade de pilha da
+ * chamada; o tamanho de código de cada rotina vem da tabela de símbolos, depois do link
+ * (bancada/tamanho_codigo.cmake). Tudo é comparado com a linha de base da plataforma, embutida na
+ * compilação. No host ela depende do compilador e da máquina, então não vem no repositório: é
+ * gravada no diretório de build pelo alvo bancada_linha_base. Na placa, ainda sem medidas, só há o
+ * modelo bancada/modelo_linha_base_pico.txt. Sem linha de base, cada caso sai como "sem base".
+ *
+ * Na placa, os tempos são ciclos do SysTick, e o total de cada caso vem de time_us_64(); o
+ * resultado sai pelo console USB. No host, com a HAL do simulador, os tempos são nanossegundos
+ * de CLOCK_MONOTONIC:
+ *
+ *   cmake -S . -B build-sim -DSIMULACAO_HOST=ON && cmake --build build-sim --target bancada
+ *   ./build-sim/bancada --repeticoes 5000
+ *   ./build-sim/bancada | grep -E '^(tempo|pilha);'    # Linhas no formato da linha de base
+ *   cmake --build build-sim --target bancada_linha_base && cmake build-sim   # Linha de base desta máquina
+ *
+ * O arquivo principal do firmware é incluído aqui inteiro (com main() renomeada), então os casos
+ * chamam as mesmas funções, sobre os mesmos tipos e variáveis globais, que o firmware usa.
+ */
+
+#define main firmware_main
+#include "automacao-pecuaria-ambiente.c"
+#undef main
+
+#include "bancada_linha_base.h"   // Gerado a partir de linha_base_<plataforma>.txt (bancada/bancada.cmake)
+
+#if SIMULACAO_HOST
+#include <getopt.h>
+#include <time.h>
+#include <ucontext.h>
+#include "simulador.h"
+
+// A HAL do host lê a configuração do simulador; na bancada, sem quadros, eventos nem flash em arquivo
+simulador_config_t simulador = {.dias = 1};
+#else
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#endif
+
+#define BANCADA_REPETICOES 1000
+#define BANCADA_REPETICOES_MAX 20000
+#define BANCADA_PILHA_PALAVRAS 4096       // Pilha própria dos casos, pintada para medir a profundidade
+#define BANCADA_PILHA_PADRAO 0xDEADBEEFu
+#define BANCADA_PILHA_MARGEM 32           // Palavras logo abaixo do marcador, reservadas ao quadro do medidor
+#define BANCADA_LIMIAR_TEMPO 25           // % acima do p50 da linha de base que conta como regressão
+#define BANCADA_LIMIAR_PILHA 32           // Bytes acima da linha de base que contam como regressão
+
+// --- CONTADOR ---
+#if SIMULACAO_HOST
+#define BANCADA_UNIDADE "ns"
+
+static inline uint32_t contador_ler(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((uint64_t)t.tv_sec * 1000000000u + t.tv_nsec);
+}
+
+static inline uint32_t contador_diferenca(uint32_t antes, uint32_t depois) {
+    return depois - antes;
+}
+
+static uint64_t bancada_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000u + t.tv_nsec / 1000;
+}
+#else
+#define BANCADA_UNIDADE "ciclos"
+
+// SysTick de 24 bits no clock do processador, decrescente. Uma chamada acima de 2^24 ciclos
+// (~134 ms a 125 MHz) daria a volta; nenhum caso chega perto.
+static void contador_iniciar(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;   // ENABLE | CLKSOURCE (processador), sem interrupção
+}
+
+static inline uint32_t contador_ler(void) {
+    return systick_hw->cvr;
+}
+
+static inline uint32_t contador_diferenca(uint32_t antes, uint32_t depois) {
+    return (antes - depois) & 0x00FFFFFF;
+}
+
+static uint64_t bancada_us(void) {
+    return time_us_64();
+}
+#endif
+
+// --- CASOS ---
+typedef struct {
+    const char *nome;
+    const char *rotina;          // Rotina do firmware medida (a principal, quando o caso encadeia mais de uma)
+    void (*preparar)(void);      // Antes de cada chamada, fora da medida; pode ser NULL
+    void (*executar)(void);
+} bancada_caso_t;
+
+static conexao_http_t bancada_conexao;
+static const char bancada_texto[] = "Temp: 28.5 °C";
+static uint32_t bancada_chamadas;
+
+static void caso_resposta_status(void) {
+    size_t n = gerar_status_json(bancada_conexao.buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+    responder(&bancada_conexao, "200 OK", "application/json", "", n);
+}
+
+static void caso_resposta_agregados(void) {
+    size_t n = gerar_agregados_json(bancada_conexao.buffer + CABECALHO_RESERVA, CONEXAO_BUFFER - CABECALHO_RESERVA);
+    responder(&bancada_conexao, "200 OK", "application/json", "", n);
+}
+
+// Os chunks percorrem o histórico inteiro e recomeçam a exportação quando ela termina, então as
+// medidas misturam o primeiro chunk (com o preâmbulo) e os do corpo na proporção de um download
+static void preparar_chunk(tipo_resposta_t tipo) {
+    if (bancada_conexao.tipo == tipo && bancada_conexao.etapa != ETAPA_FINAL) {
+        return;
+    }
+    if (tipo == RESPOSTA_BINARIA) {
+        iniciar_historico_binario(&bancada_conexao, "/api/history.bin");
+    } else {
+        iniciar_historico(&bancada_conexao, "/download", tipo);
+    }
+}
+
+static void preparar_chunk_csv(void) {
+    preparar_chunk(RESPOSTA_CSV);
+}
+
+static void preparar_chunk_json(void) {
+    preparar_chunk(RESPOSTA_JSON);
+}
+
+static void preparar_chunk_binario(void) {
+    preparar_chunk(RESPOSTA_BINARIA);
+}
+
+static void caso_chunk_csv(void) {
+    gerar_chunk_csv(&bancada_conexao);
+}
+
+static void caso_chunk_json(void) {
+    gerar_chunk_json(&bancada_conexao);
+}
+
+static void caso_chunk_binario(void) {
+    gerar_chunk_binario(&bancada_conexao);
+}
+
+// Um evento por minuto de operação: o estado e a única amostra nova
+static void preparar_evento_sse(void) {
+    bancada_conexao.proxima_amostra = historico_proxima_sequencia() - 1;
+}
+
+static void caso_evento_sse(void) {
+    gerar_evento_sse(&bancada_conexao);
+}
+
+static void caso_draw_string(void) {
+    ssd1306_draw_string(&oled, 0, 0, bancada_texto);
+}
+
+// Fora do alinhamento das páginas: cada coluna é deslocada e combinada com duas páginas
+static void caso_draw_string_y3(void) {
+    ssd1306_draw_string(&oled, 0, 3, bancada_texto);
+}
+
+static void caso_draw_string_2x(void) {
+    ssd1306_draw_string_scaled(&oled, 0, 16, bancada_texto, 2);
+}
+
+// Uma amostra nova no gráfico de temperatura: desloca as duas páginas e desenha uma coluna
+static void caso_grafico(void) {
+    ssd1306_sparkline_add(&oled, &grafico_temperatura, 240 + (int32_t)(bancada_chamadas++ % 120));
+}
+
+// A temperatura alterna entre as chamadas, então ao menos uma página vai para o barramento.
+// A transferência anterior termina fora da medida: o tempo é só o de CPU.
+static void preparar_display_oled(void) {
+    ssd1306_wait(&oled);
+    temperatura_sensor = (bancada_chamadas++ & 1) ? 284 : 285;
+}
+
+static void caso_display_oled(void) {
+    atualizar_display_oled();
+}
+
+static void caso_matriz_leds(void) {
+    atualizar_matriz_leds();
+}
+
+// Quadro repetido, o caso de quase todos os ciclos de interface: empacota, compara e não envia
+static void caso_np_write(void) {
+    npWrite();
+}
+
+static const bancada_caso_t CASOS[] = {
+    {"resposta_status", "gerar_status_json", NULL, caso_resposta_status},
+    {"resposta_agregados", "gerar_agregados_json", NULL, caso_resposta_agregados},
+    {"chunk_csv", "gerar_chunk_csv", preparar_chunk_csv, caso_chunk_csv},
+    {"chunk_json", "gerar_chunk_json", preparar_chunk_json, caso_chunk_json},
+    {"chunk_binario", "gerar_chunk_binario", preparar_chunk_binario, caso_chunk_binario},
+    {"evento_sse", "gerar_evento_sse", preparar_evento_sse, caso_evento_sse},
+    {"draw_string", "ssd1306_draw_string", NULL, caso_draw_string},
+    {"draw_string_y3", "ssd1306_draw_string", NULL, caso_draw_string_y3},
+    {"draw_string_2x", "ssd1306_draw_string_scaled", NULL, caso_draw_string_2x},
+    {"grafico", "ssd1306_sparkline_add", NULL, caso_grafico},
+    {"display_oled", "atualizar_display_oled", preparar_display_oled, caso_display_oled},
+    {"matriz_leds", "atualizar_matriz_leds", NULL, caso_matriz_leds},
+    {"np_write", "npWrite", NULL, caso_np_write},
+};
+
+// Estado de um dia de operação: histórico cheio, estatísticas móveis com 24 h de amostras e o
+// display e a matriz de LEDs inicializados, como o firmware os deixa depois do boot
+static void preparar_estado(void) {
+    hal_i2c_iniciar(OLED_I2C_BUS, I2C_SDA, I2C_SCL, 400 * 1000);
+    ssd1306_init(&oled, OLED_I2C_BUS, OLED_I2C_ADDRESS, SSD1306_WIDTH, SSD1306_HEIGHT, false);
+    iniciar_graficos_oled();
+    npInit(LED_PIN_PIO);
+
+    historico_iniciar();
+    camadas_iniciar(NULL, NULL);   // Sem logs: a bancada não grava na flash
+    agregados_iniciar(&agregados);
+    for (int i = 0; i < NUM_JANELAS; i++) {
+        agregados_adicionar_janela(&agregados, JANELAS_AGREGADOS[i].largura_s, JANELAS_AGREGADOS[i].baldes);
+    }
+
+    const uint32_t inicio = 1751328000u;   // 2025-07-01 00:00
+    for (uint32_t i = 0; i < 24 * 60; i++) {
+        amostra_t a = {
+            .epoch = inicio + i * 60,
+            .temperatura = (int16_t)(240 + (i % 120)),
+            .umidade = (int16_t)(650 - (i % 200)),
+            .luminosidade = (int16_t)(i % 1000),
+            .reles = (uint8_t)(i / 90 % 8),
+        };
+        historico_adicionar(&a);
+        camadas_adicionar(&a);
+        agregados_amostra(&agregados, a.epoch, a.temperatura, a.umidade);
+        ssd1306_sparkline_add(&oled, &grafico_temperatura, a.temperatura);
+        ssd1306_sparkline_add(&oled, &grafico_umidade, a.umidade);
+    }
+
+    estado_atual = (snapshot_t){
+        .temperatura = 285,
+        .umidade = 612,
+        .luminosidade = 730,
+        .ventilador_ligado = true,
+        .itu = agregados.ultimo[AGREGADO_ITU],
+    };
+    data_hora_de_epoch(inicio + 24 * 60 * 60, &estado_atual.timestamp);
+    for (int i = 0; i < NUM_JANELAS; i++) {
+        for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+            agregados_resumo(&agregados, i, g, &estado_atual.agregados[i][g]);
+        }
+    }
+    bancada_conexao.em_uso = true;
+    bancada_conexao.manter_aberta = true;
+}
+
+// --- LINHA DE BASE ---
+typedef struct {
+    bool tem_tempo;
+    bool tem_pilha;
+    uint32_t p50;
+    uint32_t pilha;
+} bancada_base_t;
+
+// Procura o caso nas linhas "tempo;caso;media;p50;p90;p99;max" e "pilha;caso;bytes"
+static bancada_base_t buscar_linha_base(const char *caso) {
+    bancada_base_t b = {0};
+    size_t tamanho = strlen(caso);
+    for (const char *p = linha_base; *p; p = strchr(p, '\n') ? strchr(p, '\n') + 1 : p + strlen(p)) {
+        unsigned media, p50;
+        if (strncmp(p, "tempo;", 6) == 0 && strncmp(p + 6, caso, tamanho) == 0 && p[6 + tamanho] == ';' &&
+            sscanf(p + 7 + tamanho, "%u;%u", &media, &p50) == 2) {
+            b.tem_tempo = true;
+            b.p50 = p50;
+        } else if (strncmp(p, "pilha;", 6) == 0 && strncmp(p + 6, caso, tamanho) == 0 && p[6 + tamanho] == ';') {
+            b.tem_pilha = true;
+            b.pilha = strtoul(p + 7 + tamanho, NULL, 10);
+        }
+    }
+    return b;
+}
+
+// --- EXECUÇÃO ---
+static uint32_t bancada_pilha[BANCADA_PILHA_PALAVRAS];
+static uint32_t bancada_amostras[BANCADA_REPETICOES_MAX];
+static uint32_t bancada_repeticoes = BANCADA_REPETICOES;
+static int bancada_regressoes;
+
+typedef struct {
+    uint32_t media, p50, p90, p99, max;
+    uint32_t pilha;
+    uint64_t total_us;
+} bancada_resultado_t;
+
+// Pinta a pilha livre abaixo deste quadro, executa o caso uma vez e procura a palavra pintada mais
+// funda que mudou. A margem guarda o resto do quadro desta função, então abaixo dela (128 bytes)
+// a profundidade não se distingue; a pintura é volatile para não virar uma chamada a memset.
+static uint32_t medir_pilha(const bancada_caso_t *caso) {
+    volatile uint32_t marcador = 0;
+    uint32_t *topo = (uint32_t *)((uintptr_t)&marcador & ~(uintptr_t)3) - BANCADA_PILHA_MARGEM;
+    for (volatile uint32_t *p = bancada_pilha; p < topo; p++) {
+        *p = BANCADA_PILHA_PADRAO;
+    }
+    caso->executar();
+    const uint32_t *p = bancada_pilha;
+    while (p < topo && *p == BANCADA_PILHA_PADRAO) {
+        p++;
+    }
+    return (uint32_t)((uintptr_t)&marcador - (uintptr_t)p);
+}
+
+static int comparar_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void medir_caso(const bancada_caso_t *caso, bancada_resultado_t *r) {
+    // Duas chamadas fora da estatística: a primeira aquece caches e a segunda mede a pilha
+    for (int i = 0; i < 2; i++) {
+        if (caso->preparar) caso->preparar();
+        if (i == 0) {
+            caso->executar();
+        } else {
+            r->pilha = medir_pilha(caso);
+        }
+    }
+
+    uint64_t soma = 0;
+    uint64_t total_us = 0;
+    for (uint32_t i = 0; i < bancada_repeticoes; i++) {
+        if (caso->preparar) caso->preparar();
+        uint64_t inicio_us = bancada_us();
+        uint32_t antes = contador_ler();
+        caso->executar();
+        uint32_t depois = contador_ler();
+        total_us += bancada_us() - inicio_us;
+        bancada_amostras[i] = contador_diferenca(antes, depois);
+        soma += bancada_amostras[i];
+    }
+
+    qsort(bancada_amostras, bancada_repeticoes, sizeof(uint32_t), comparar_u32);
+    uint32_t n = bancada_repeticoes;
+    r->media = (uint32_t)(soma / n);
+    r->p50 = bancada_amostras[(n - 1) * 50 / 100];
+    r->p90 = bancada_amostras[(n - 1) * 90 / 100];
+    r->p99 = bancada_amostras[(n - 1) * 99 / 100];
+    r->max = bancada_amostras[n - 1];
+    r->total_us = total_us;
+}
+
+// Diferença para a linha de base, em texto; marca e conta as regressões
+static void comparar(char *texto, size_t tamanho, const bancada_resultado_t *r, const bancada_base_t *b) {
+    int n = 0;
+    bool regressao = false;
+    if (b->tem_tempo && b->p50 > 0) {
+        int variacao = (int)(((int64_t)r->p50 - b->p50) * 100 / b->p50);
+        n += snprintf(texto + n, tamanho - n, "p50 %+d%%", variacao);
+        regressao |= variacao > BANCADA_LIMIAR_TEMPO;
+    } else {
+        n += snprintf(texto + n, tamanho - n, "p50 sem base");
+    }
+    if (b->tem_pilha) {
+        int variacao = (int)r->pilha - (int)b->pilha;
+        n += snprintf(texto + n, tamanho - n, ", pilha %+d", variacao);
+        regressao |= variacao > BANCADA_LIMIAR_PILHA;
+    }
+    if (regressao) {
+        snprintf(texto + n, tamanho - n, "  REGRESSAO");
+        bancada_regressoes++;
+    }
+}
+
+static void executar_bancada(void) {
+    static bancada_resultado_t resultados[count_of(CASOS)];
+    preparar_estado();
+
+#if SIMULACAO_HOST
+    printf("Bancada no host: %u repeticoes por caso, tempos em " BANCADA_UNIDADE "\n", (unsigned)bancada_repeticoes);
+#else
+    contador_iniciar();
+    printf("Bancada na placa a %lu MHz: %u repeticoes por caso, tempos em " BANCADA_UNIDADE "\n",
+           (unsigned long)(clock_get_hz(clk_sys) / 1000000), (unsigned)bancada_repeticoes);
+#endif
+    printf("%-20s %8s %8s %8s %8s %8s %9s %6s  %s\n", "caso", "media", "p50", "p90", "p99", "max", "total_us", "pilha", "linha de base");
+    for (size_t i = 0; i < count_of(CASOS); i++) {
+        bancada_resultado_t *r = &resultados[i];
+        medir_caso(&CASOS[i], r);
+        bancada_base_t b = buscar_linha_base(CASOS[i].nome);
+        char diferenca[64];
+        comparar(diferenca, sizeof(diferenca), r, &b);
+        printf("%-20s %8lu %8lu %8lu %8lu %8lu %9llu %6lu  %s\n", CASOS[i].nome,
+               (unsigned long)r->media, (unsigned long)r->p50, (unsigned long)r->p90, (unsigned long)r->p99,
+               (unsigned long)r->max, (unsigned long long)r->total_us, (unsigned long)r->pilha, diferenca);
+    }
+    printf("Regressoes: %d (limiares: p50 +%d%%, pilha +%d bytes)\n\n", bancada_regressoes,
+           BANCADA_LIMIAR_TEMPO, BANCADA_LIMIAR_PILHA);
+
+    // No formato da linha de base, para substituí-la quando a mudança for intencional
+    for (size_t i = 0; i < count_of(CASOS); i++) {
+        const bancada_resultado_t *r = &resultados[i];
+        printf("tempo;%s;%lu;%lu;%lu;%lu;%lu\n", CASOS[i].nome, (unsigned long)r->media, (unsigned long)r->p50,
+               (unsigned long)r->p90, (unsigned long)r->p99, (unsigned long)r->max);
+    }
+    for (size_t i = 0; i < count_of(CASOS); i++) {
+        printf("pilha;%s;%lu\n", CASOS[i].nome, (unsigned long)resultados[i].pilha);
+    }
+}
+
+#if SIMULACAO_HOST
+static ucontext_t contexto_principal, contexto_bancada;
+
+int main(int argc, char **argv) {
+    static const struct option opcoes[] = {
+        {"repeticoes", required_argument, NULL, 'r'},
+        {"estrito", no_argument, NULL, 'e'},
+        {"ajuda", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    bool estrito = false;
+    int opcao;
+    while ((opcao = getopt_long(argc, argv, "h", opcoes, NULL)) != -1) {
+        switch (opcao) {
+            case 'r': bancada_repeticoes = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'e': estrito = true; break;
+            default:
+                fprintf(stderr, "Uso: %s [--repeticoes N (1..%d, padrao %d)] [--estrito: sai com 1 se houver regressao]\n",
+                        argv[0], BANCADA_REPETICOES_MAX, BANCADA_REPETICOES);
+                return opcao == 'h' ? 0 : 2;
+        }
+    }
+    if (bancada_repeticoes < 1 || bancada_repeticoes > BANCADA_REPETICOES_MAX) {
+        fprintf(stderr, "--repeticoes fora de 1..%d\n", BANCADA_REPETICOES_MAX);
+        return 2;
+    }
+
+    // Os casos rodam numa pilha própria, como o núcleo 1 na placa, para que a pintura a cubra inteira
+    getcontext(&contexto_bancada);
+    contexto_bancada.uc_stack.ss_sp = bancada_pilha;
+    contexto_bancada.uc_stack.ss_size = sizeof(bancada_pilha);
+    contexto_bancada.uc_link = &contexto_principal;
+    makecontext(&contexto_bancada, executar_bancada, 0);
+    swapcontext(&contexto_principal, &contexto_bancada);
+
+    return estrito && bancada_regressoes > 0 ? 1 : 0;
+}
+#else
+// Terminada a bancada, o núcleo 1 só dorme
+static uint64_t bancada_ociosa(void) {
+    return HAL_PRAZO_NENHUM;
+}
+
+int main() {
+    hal_iniciar();
+    // No núcleo 1, com a pilha da bancada; o núcleo 0 fica parado para não disputar a memória
+    hal_nucleo1_lancar(executar_bancada, bancada_ociosa, bancada_pilha, sizeof(bancada_pilha));
+    while (true) {
+        tight_loop_contents();
+    }
+}
+#endif
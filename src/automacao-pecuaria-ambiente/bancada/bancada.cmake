@@ -0,0 +1,78 @@
+# Microbenchmarks of the firmware's hot routines (see bancada/bancada.c). The target reuses the
+# sources, definitions, include directories and libraries of the firmware (or, with
+# SIMULACAO_HOST, of the simulator), minus the files that define main(). Not part of the default
+# build:
+#   cmake --build build --target bancada
+
+if (SIMULACAO_HOST)
+    set(BANCADA_BASE simulador)
+    set(BANCADA_PLATAFORMA host)
+else()
+    set(BANCADA_BASE automacao-pecuaria-ambiente)
+    set(BANCADA_PLATAFORMA pico)
+endif()
+
+get_target_property(BANCADA_FONTES ${BANCADA_BASE} SOURCES)
+list(REMOVE_ITEM BANCADA_FONTES automacao-pecuaria-ambiente.c simulador/simulador.c)
+add_executable(bancada EXCLUDE_FROM_ALL bancada/bancada.c ${BANCADA_FONTES})
+foreach (PROPRIEDADE COMPILE_DEFINITIONS INCLUDE_DIRECTORIES LINK_LIBRARIES)
+    get_target_property(VALOR ${BANCADA_BASE} ${PROPRIEDADE})
+    if (VALOR)
+        set_property(TARGET bancada PROPERTY ${PROPRIEDADE} ${VALOR})
+    endif()
+endforeach()
+
+# The generated sources (web resources, PIO headers) come from the base target's custom commands
+add_dependencies(bancada ${BANCADA_BASE})
+
+# The baseline is compiled in as a C string, so the board can compare without a file system.
+# Looked up in order: linha_base_<platform>.txt in the build directory (measured on this machine,
+# see bancada_linha_base below), then in bancada/ (a committed baseline, for a fixed target such as
+# the board), then the template modelo_linha_base_<platform>.txt: same format, no measurements, so
+# every case reports "sem base" and no code size is compared.
+set(BANCADA_LINHA_BASE ${CMAKE_CURRENT_BINARY_DIR}/linha_base_${BANCADA_PLATAFORMA}.txt)
+if (NOT EXISTS ${BANCADA_LINHA_BASE})
+    set(BANCADA_LINHA_BASE ${CMAKE_CURRENT_SOURCE_DIR}/bancada/linha_base_${BANCADA_PLATAFORMA}.txt)
+endif()
+if (NOT EXISTS ${BANCADA_LINHA_BASE})
+    set(BANCADA_LINHA_BASE ${CMAKE_CURRENT_SOURCE_DIR}/bancada/modelo_linha_base_${BANCADA_PLATAFORMA}.txt)
+    message(STATUS "bancada: sem linha de base medida para ${BANCADA_PLATAFORMA}; usando o modelo ${BANCADA_LINHA_BASE}")
+endif()
+file(READ ${BANCADA_LINHA_BASE} BANCADA_CONTEUDO)
+string(REPLACE "\\" "\\\\" BANCADA_CONTEUDO "${BANCADA_CONTEUDO}")
+string(REPLACE "\"" "\\\"" BANCADA_CONTEUDO "${BANCADA_CONTEUDO}")
+string(REPLACE "\n" "\\n\"\n\"" BANCADA_CONTEUDO "${BANCADA_CONTEUDO}")
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bancada_linha_base.h.tmp
+        "// Gerado de ${BANCADA_LINHA_BASE}\nstatic const char linha_base[] =\n\"${BANCADA_CONTEUDO}\";\n")
+configure_file(${CMAKE_CURRENT_BINARY_DIR}/bancada_linha_base.h.tmp ${CMAKE_CURRENT_BINARY_DIR}/bancada_linha_base.h COPYONLY)
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${BANCADA_LINHA_BASE})
+target_include_directories(bancada PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+
+# Code size of each routine in the baseline, checked after every link; the current sizes are
+# written to bancada_codigo.txt in the build directory, in the baseline's format
+add_custom_command(TARGET bancada POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -DNM=${CMAKE_NM} -DELF=$<TARGET_FILE:bancada> -DLINHA_BASE=${BANCADA_LINHA_BASE}
+                -DSAIDA=${CMAKE_CURRENT_BINARY_DIR}/bancada_codigo.txt
+                -P ${CMAKE_CURRENT_SOURCE_DIR}/bancada/tamanho_codigo.cmake
+        VERBATIM)
+
+if (SIMULACAO_HOST)
+    # Host timings and code sizes only hold for the compiler and machine that measured them, so the
+    # host baseline is generated in the build directory instead of committed:
+    #   cmake --build build-sim --target bancada_linha_base && cmake build-sim
+    add_custom_target(bancada_linha_base
+            COMMAND ${CMAKE_COMMAND} -DBANCADA=$<TARGET_FILE:bancada> -DCODIGO=${CMAKE_CURRENT_BINARY_DIR}/bancada_codigo.txt
+                    -DSAIDA=${CMAKE_CURRENT_BINARY_DIR}/linha_base_host.txt
+                    -P ${CMAKE_CURRENT_SOURCE_DIR}/bancada/gravar_linha_base.cmake
+            DEPENDS bancada
+            VERBATIM)
+
+    # No lazy binding: resolving a libc symbol on its first call uses far more stack than the
+    # routine that calls it, and would show up in the stack depth
+    target_link_options(bancada PRIVATE -Wl,-z,now)
+else()
+    # The results go to the USB serial console
+    pico_enable_stdio_uart(bancada 0)
+    pico_enable_stdio_usb(bancada 1)
+    pico_add_extra_outputs(bancada)
+endif()
@@ -0,0 +1,24 @@
+# Writes a baseline for this machine: the tempo; and pilha; lines of one bench run plus the codigo;
+# lines of bancada_codigo.txt, written by the bancada target after linking (see bancada/bancada.cmake):
+#   cmake -DBANCADA=<bancada> -DCODIGO=<bancada_codigo.txt> -DSAIDA=<linha_base_host.txt> -P gravar_linha_base.cmake
+# The build compiles the baseline in at configure time, so it takes effect after the next cmake run.
+
+execute_process(COMMAND ${BANCADA} --repeticoes 5000
+        OUTPUT_VARIABLE RESULTADOS RESULT_VARIABLE RESULTADO)
+if (NOT RESULTADO EQUAL 0)
+    message(FATAL_ERROR "${BANCADA} falhou")
+endif()
+
+# ';' separates CMake list items, so the lines are matched with '|' in its place
+string(REPLACE ";" "|" RESULTADOS "${RESULTADOS}")
+string(REGEX MATCHALL "(tempo|pilha)\\|[^\n]*\n" LINHAS "${RESULTADOS}")
+string(REPLACE ";" "" LINHAS "${LINHAS}")
+string(REPLACE "|" ";" LINHAS "${LINHAS}")
+file(READ ${CODIGO} LINHAS_CODIGO)
+
+string(TIMESTAMP DATA "%Y-%m-%d")
+file(WRITE ${SAIDA} "# Linha de base da bancada (bancada/bancada.c) gravada nesta maquina em ${DATA} por\n"
+        "# bancada/gravar_linha_base.cmake; os tempos so valem para ela.\n"
+        "${LINHAS}${LINHAS_CODIGO}")
+get_filename_component(BUILD ${SAIDA} DIRECTORY)
+message(STATUS "Linha de base gravada em ${SAIDA}; vale a partir da proxima configuracao (cmake ${BUILD})")
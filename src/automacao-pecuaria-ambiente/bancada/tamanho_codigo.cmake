@@ -0,0 +1,38 @@
+# Code size, from the symbol table, of each routine listed in the baseline as "codigo;<symbol>;<bytes>",
+# compared with the baseline size (0 = not measured yet). Run by the bancada target after linking (see bancada/bancada.cmake):
+#   cmake -DNM=<nm> -DELF=<bancada elf> -DLINHA_BASE=<linha_base_*.txt> -DSAIDA=<codigo.txt> -P tamanho_codigo.cmake
+# A routine more than 10% larger than its baseline is reported as a warning; the build goes on.
+
+execute_process(COMMAND ${NM} --print-size --defined-only ${ELF}
+        OUTPUT_VARIABLE SIMBOLOS RESULT_VARIABLE RESULTADO)
+if (NOT RESULTADO EQUAL 0)
+    message(FATAL_ERROR "${NM} falhou em ${ELF}")
+endif()
+
+# ';' separates CMake list items, so the baseline's fields are read with '|' in their place
+file(READ ${LINHA_BASE} TEXTO)
+string(REPLACE ";" "|" TEXTO "${TEXTO}")
+string(REGEX MATCHALL "(^|\n)codigo\\|[A-Za-z0-9_]+\\|[0-9]+" ENTRADAS "${TEXTO}")
+
+set(CODIGO "")
+foreach (ENTRADA ${ENTRADAS})
+    string(REGEX MATCH "codigo\\|([A-Za-z0-9_]+)\\|([0-9]+)" _ "${ENTRADA}")
+    set(SIMBOLO ${CMAKE_MATCH_1})
+    set(BASE ${CMAKE_MATCH_2})
+    if ("${SIMBOLOS}" MATCHES "(^|\n)[0-9a-fA-F]+ ([0-9a-fA-F]+) [TtWw] ${SIMBOLO}\n")
+        math(EXPR BYTES "0x${CMAKE_MATCH_2}")
+        if (BASE EQUAL 0)
+            message(STATUS "Codigo: ${SIMBOLO} ${BYTES} bytes (sem linha de base)")
+        else()
+            math(EXPR VARIACAO "(${BYTES} - ${BASE}) * 100 / ${BASE}")
+            message(STATUS "Codigo: ${SIMBOLO} ${BYTES} bytes (linha de base ${BASE}, ${VARIACAO}%)")
+            if (VARIACAO GREATER 10)
+                message(WARNING "${SIMBOLO} cresceu ${VARIACAO}%: ${BYTES} bytes, linha de base ${BASE}")
+            endif()
+        endif()
+        string(APPEND CODIGO "codigo;${SIMBOLO};${BYTES}\n")
+    else()
+        message(WARNING "${SIMBOLO} nao esta na tabela de simbolos de ${ELF}")
+    endif()
+endforeach()
+file(WRITE ${SAIDA} "${CODIGO}")
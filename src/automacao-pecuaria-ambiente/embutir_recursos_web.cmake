@@ -0,0 +1,61 @@
+# Gera um arquivo C com os recursos estáticos do painel web comprimidos em gzip.
+# Uso: cmake -DENTRADAS="a.html|b.css" -DSAIDA=recursos_web.c -DTEMP=<dir> -P embutir_recursos_web.cmake
+#
+# Cada recurso vira um array const (fica na flash), com o tipo MIME e um ETag derivado do
+# conteúdo original (o gzip guarda a data do arquivo), para que o servidor responda 304 quando o navegador já tiver a versão atual.
+
+cmake_minimum_required(VERSION 3.19)
+
+string(REPLACE "|" ";" ENTRADAS "${ENTRADAS}")
+file(MAKE_DIRECTORY ${TEMP})
+
+set(DADOS "")
+set(TABELA "")
+set(INDICE 0)
+
+foreach(ENTRADA ${ENTRADAS})
+    get_filename_component(NOME ${ENTRADA} NAME)
+    get_filename_component(EXTENSAO ${ENTRADA} LAST_EXT)
+
+    if(EXTENSAO STREQUAL ".html")
+        set(TIPO "text/html; charset=UTF-8")
+    elseif(EXTENSAO STREQUAL ".css")
+        set(TIPO "text/css")
+    elseif(EXTENSAO STREQUAL ".js")
+        set(TIPO "application/javascript")
+    else()
+        set(TIPO "application/octet-stream")
+    endif()
+
+    if(NOME STREQUAL "index.html")
+        set(CAMINHO "/")
+    else()
+        set(CAMINHO "/${NOME}")
+    endif()
+
+    # Compressão feita pelo próprio CMake, sem depender de um gzip instalado
+    set(COMPRIMIDO ${TEMP}/${NOME}.gz)
+    file(ARCHIVE_CREATE OUTPUT ${COMPRIMIDO} PATHS ${ENTRADA} FORMAT raw COMPRESSION GZip COMPRESSION_LEVEL 9)
+
+    file(SHA1 ${ENTRADA} HASH)
+    string(SUBSTRING ${HASH} 0 16 ETAG)
+    file(SIZE ${COMPRIMIDO} TAMANHO)
+    file(READ ${COMPRIMIDO} HEX HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+    string(REGEX REPLACE "(0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,0x..,)" "\\1\n    " BYTES "${BYTES}")
+
+    string(APPEND DADOS "// ${NOME}\nstatic const uint8_t recurso_${INDICE}[] = {\n    ${BYTES}\n};\n\n")
+    string(APPEND TABELA "    {\"${CAMINHO}\", \"${TIPO}\", \"\\\"${ETAG}\\\"\", recurso_${INDICE}, ${TAMANHO}},\n")
+    math(EXPR INDICE "${INDICE} + 1")
+endforeach()
+
+file(WRITE ${SAIDA}.tmp
+"// Gerado por embutir_recursos_web.cmake - não edite\n"
+"#include \"inc/recursos_web.h\"\n\n"
+"${DADOS}"
+"const recurso_web_t recursos_web[] = {\n${TABELA}};\n\n"
+"const uint32_t recursos_web_quantidade = ${INDICE};\n")
+
+# Só substitui o arquivo se mudou, evitando recompilações desnecessárias
+file(COPY_FILE ${SAIDA}.tmp ${SAIDA} ONLY_IF_DIFFERENT)
+file(REMOVE ${SAIDA}.tmp)
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <string.h>
+#include "agendador.h"
+#include "hal.h"
+
+// --- OPERAÇÕES DO MIN-HEAP ---
+static bool heap_menor(const agendador_t *ag, int a, int b) {
+    return ag->tarefas[ag->heap[a]].prazo_us < ag->tarefas[ag->heap[b]].prazo_us;
+}
+
+static void heap_trocar(agendador_t *ag, int a, int b) {
+    uint8_t tmp = ag->heap[a];
+    ag->heap[a] = ag->heap[b];
+    ag->heap[b] = tmp;
+    ag->posicao[ag->heap[a]] = a;
+    ag->posicao[ag->heap[b]] = b;
+}
+
+static void heap_subir(agendador_t *ag, int i) {
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (!heap_menor(ag, i, pai)) break;
+        heap_trocar(ag, i, pai);
+        i = pai;
+    }
+}
+
+static void heap_descer(agendador_t *ag, int i) {
+    while (true) {
+        int menor = i;
+        int esq = 2 * i + 1;
+        int dir = esq + 1;
+        if (esq < ag->tamanho_heap && heap_menor(ag, esq, menor)) menor = esq;
+        if (dir < ag->tamanho_heap && heap_menor(ag, dir, menor)) menor = dir;
+        if (menor == i) break;
+        heap_trocar(ag, i, menor);
+        i = menor;
+    }
+}
+
+static void heap_inserir(agendador_t *ag, int id) {
+    int i = ag->tamanho_heap++;
+    ag->heap[i] = id;
+    ag->posicao[id] = i;
+    heap_subir(ag, i);
+}
+
+static void heap_remover(agendador_t *ag, int id) {
+    int i = ag->posicao[id];
+    int ultimo = --ag->tamanho_heap;
+    if (i != ultimo) {
+        heap_trocar(ag, i, ultimo);
+        int movida = ag->heap[i];
+        heap_subir(ag, i);
+        heap_descer(ag, ag->posicao[movida]);
+    }
+}
+
+// --- API DO AGENDADOR ---
+void agendador_iniciar(agendador_t *ag) {
+    memset(ag, 0, sizeof(*ag));
+}
+
+static int agendador_criar(agendador_t *ag, const char *nome, tarefa_fn_t funcao, void *contexto,
+                           uint64_t periodo_us, uint64_t atraso_us) {
+    for (int id = 0; id < AGENDADOR_MAX_TAREFAS; id++) {
+        tarefa_t *t = &ag->tarefas[id];
+        if (t->ativa) continue;
+
+        *t = (tarefa_t){
+            .nome = nome,
+            .funcao = funcao,
+            .contexto = contexto,
+            .periodo_us = periodo_us,
+            .prazo_us = hal_tempo_us() + atraso_us,
+            .ativa = true
+        };
+        heap_inserir(ag, id);
+        return id;
+    }
+    printf("Agendador: sem espaço para a tarefa %s\n", nome);
+    return -1;
+}
+
+// Cria uma tarefa repetida a cada periodo_ms, com o primeiro disparo após atraso_inicial_ms
+int agendador_periodica(agendador_t *ag, const char *nome, tarefa_fn_t funcao, void *contexto,
+                        uint32_t periodo_ms, uint32_t atraso_inicial_ms) {
+    return agendador_criar(ag, nome, funcao, contexto, (uint64_t)periodo_ms * 1000, (uint64_t)atraso_inicial_ms * 1000);
+}
+
+// Cria uma tarefa executada uma única vez após atraso_ms
+int agendador_unica(agendador_t *ag, const char *nome, tarefa_fn_t funcao, void *contexto, uint32_t atraso_ms) {
+    return agendador_criar(ag, nome, funcao, contexto, 0, (uint64_t)atraso_ms * 1000);
+}
+
+// Faz a tarefa disparar na próxima passagem do laço (útil quando um evento exige atualização imediata)
+void agendador_antecipar(agendador_t *ag, int id) {
+    if (id < 0 || id >= AGENDADOR_MAX_TAREFAS || !ag->tarefas[id].ativa) return;
+    ag->tarefas[id].prazo_us = hal_tempo_us();
+    heap_subir(ag, ag->posicao[id]);
+}
+
+void agendador_cancelar(agendador_t *ag, int id) {
+    if (id < 0 || id >= AGENDADOR_MAX_TAREFAS || !ag->tarefas[id].ativa) return;
+    heap_remover(ag, id);
+    ag->tarefas[id].ativa = false;
+}
+
+// Executa todas as tarefas cujo prazo já venceu. Retorna quantas foram executadas.
+int agendador_executar_pendentes(agendador_t *ag) {
+    int executadas = 0;
+
+    while (ag->tamanho_heap > 0) {
+        int id = ag->heap[0];
+        tarefa_t *t = &ag->tarefas[id];
+        uint64_t inicio = hal_tempo_us();
+        if (t->prazo_us > inicio) break;
+
+        uint64_t prazo = t->prazo_us;
+        if (t->periodo_us > 0) {
+            // Reagenda antes de executar: a tarefa pode se cancelar ou antecipar durante a execução.
+            // Prazos perdidos não se acumulam; o próximo disparo fica sempre no futuro.
+            t->prazo_us += t->periodo_us;
+            if (t->prazo_us <= inicio) t->prazo_us = inicio + t->periodo_us;
+            heap_descer(ag, 0);
+        } else {
+            heap_remover(ag, id);
+            t->ativa = false;
+        }
+
+        t->funcao(t->contexto);
+
+        uint32_t duracao = (uint32_t)(hal_tempo_us() - inicio);
+        uint32_t atraso = (uint32_t)(inicio - prazo);
+        t->execucoes++;
+        t->tempo_total_us += duracao;
+        if (duracao > t->tempo_max_us) t->tempo_max_us = duracao;
+        if (atraso > t->atraso_max_us) t->atraso_max_us = atraso;
+        executadas++;
+    }
+    return executadas;
+}
+
+// Prazo da próxima tarefa, para o laço principal dormir até lá (HAL_PRAZO_NENHUM sem tarefas)
+uint64_t agendador_proximo_prazo(const agendador_t *ag) {
+    if (ag->tamanho_heap == 0) {
+        return HAL_PRAZO_NENHUM;
+    }
+    return ag->tarefas[ag->heap[0]].prazo_us;
+}
+
+void agendador_imprimir_estatisticas(const agendador_t *ag) {
+    printf("Tarefa           Execucoes  Media(us)  Max(us)  Atraso max(us)\n");
+    for (int id = 0; id < AGENDADOR_MAX_TAREFAS; id++) {
+        const tarefa_t *t = &ag->tarefas[id];
+        if (t->execucoes == 0) continue;
+        printf("%-16s %9lu %10lu %8lu %15lu\n", t->nome, (unsigned long)t->execucoes,
+               (unsigned long)(t->tempo_total_us / t->execucoes), (unsigned long)t->tempo_max_us,
+               (unsigned long)t->atraso_max_us);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef agendador_inc_h
+#define agendador_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Agendador cooperativo de tarefas por prazo (deadline).
+// As tarefas ficam num min-heap ordenado pelo próximo disparo; o laço principal executa as
+// vencidas e dorme até o próximo prazo, em vez de acordar em intervalos fixos.
+
+#define AGENDADOR_MAX_TAREFAS 12
+
+typedef void (*tarefa_fn_t)(void *contexto);
+
+typedef struct {
+    const char *nome;
+    tarefa_fn_t funcao;
+    void *contexto;
+    uint64_t periodo_us;     // 0 para tarefas de disparo único
+    uint64_t prazo_us;       // Próximo disparo, em microssegundos desde o boot
+    bool ativa;
+
+    // Estatísticas de execução da própria tarefa
+    uint32_t execucoes;
+    uint64_t tempo_total_us;
+    uint32_t tempo_max_us;
+    uint32_t atraso_max_us;  // Maior atraso entre o prazo e o início da execução
+} tarefa_t;
+
+typedef struct {
+    tarefa_t tarefas[AGENDADOR_MAX_TAREFAS];
+    uint8_t heap[AGENDADOR_MAX_TAREFAS];     // Índices das tarefas ativas, ordenados por prazo
+    uint8_t posicao[AGENDADOR_MAX_TAREFAS];  // Posição de cada tarefa no heap
+    uint8_t tamanho_heap;
+} agendador_t;
+
+void agendador_iniciar(agendador_t *ag);
+int agendador_periodica(agendador_t *ag, const char *nome, tarefa_fn_t funcao, void *contexto,
+                        uint32_t periodo_ms, uint32_t atraso_inicial_ms);
+int agendador_unica(agendador_t *ag, const char *nome, tarefa_fn_t funcao, void *contexto, uint32_t atraso_ms);
+void agendador_antecipar(agendador_t *ag, int id);
+void agendador_cancelar(agendador_t *ag, int id);
+int agendador_executar_pendentes(agendador_t *ag);
+uint64_t agendador_proximo_prazo(const agendador_t *ag);
+void agendador_imprimir_estatisticas(const agendador_t *ag);
+
+#endif
@@ -0,0 +1,160 @@
+#include <string.h>
+#include "agregados.h"
+
+void agregados_iniciar(agregados_t *a) {
+    memset(a, 0, sizeof(*a));
+}
+
+// Retorna o índice da janela, ou -1 se não houver espaço ou o tamanho for inválido
+int agregados_adicionar_janela(agregados_t *a, uint32_t largura_s, uint8_t baldes) {
+    if (a->quantidade == AGREGADOS_JANELAS_MAX || largura_s == 0 || baldes == 0 || baldes > AGREGADOS_BALDES_MAX) {
+        return -1;
+    }
+    int indice = a->quantidade++;
+    a->janelas[indice] = (agregados_janela_t){.largura_s = largura_s, .baldes = baldes};
+    return indice;
+}
+
+// ITU de Thom na forma usada para bovinos de leite (NRC, 1971):
+//   ITU = (1,8 T + 32) - (0,55 - 0,0055 UR) (1,8 T - 26)
+// Com T e UR em décimos, o valor em décimos é um único quociente inteiro, arredondado no fim.
+int16_t agregados_itu(int16_t temperatura, int16_t umidade) {
+    int32_t ur = umidade < 0 ? 0 : umidade > 1000 ? 1000 : umidade;
+    int64_t numerador = 100000LL * (18 * temperatura + 3200) - 55LL * (1000 - ur) * (18 * temperatura - 2600);
+    return (int16_t)(numerador >= 0 ? (numerador + 500000) / 1000000 : -((-numerador + 500000) / 1000000));
+}
+
+// Faixas de estresse térmico de Armstrong (1994)
+const char *agregados_itu_faixa(int16_t itu) {
+    return itu < 720 ? "conforto" : itu < 800 ? "leve" : itu < 900 ? "moderado" : itu <= 980 ? "severo" : "perigo";
+}
+
+static int16_t valor_balde(const agregados_balde_t *b, int g, bool maximo) {
+    return maximo ? b->maximo[g] : b->minimo[g];
+}
+
+// Descarta do fim as posições que nunca mais serão o extremo (a nova é tão boa quanto elas e
+// sai da janela depois) e põe a nova no fim
+static void fila_inserir(agregados_fila_t *f, const agregados_janela_t *j, uint8_t posicao, int g, bool maximo) {
+    int16_t v = valor_balde(&j->anel[posicao], g, maximo);
+    while (f->quantidade > 0) {
+        uint8_t ultima = f->posicoes[(f->inicio + f->quantidade - 1) % j->baldes];
+        int16_t u = valor_balde(&j->anel[ultima], g, maximo);
+        if (maximo ? u > v : u < v) {
+            break;
+        }
+        f->quantidade--;
+    }
+    f->posicoes[(f->inicio + f->quantidade) % j->baldes] = posicao;
+    f->quantidade++;
+}
+
+// O balde da posição vai ser sobrescrito; se estiver na fila, é o mais antigo dela
+static void fila_expirar(agregados_fila_t *f, const agregados_janela_t *j, uint8_t posicao) {
+    if (f->quantidade > 0 && f->posicoes[f->inicio] == posicao) {
+        f->inicio = (f->inicio + 1) % j->baldes;
+        f->quantidade--;
+    }
+}
+
+// Fecha o balde em andamento: ele toma o lugar, no anel, do balde que acaba de sair da janela
+static void fechar_balde(agregados_janela_t *j) {
+    uint8_t posicao = j->sequencia % j->baldes;
+    agregados_balde_t *antigo = &j->anel[posicao];
+    for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+        j->soma[g] -= antigo->soma[g];
+        fila_expirar(&j->minimos[g], j, posicao);
+        fila_expirar(&j->maximos[g], j, posicao);
+    }
+    j->amostras -= antigo->amostras;
+
+    *antigo = j->atual;
+    if (antigo->amostras > 0) {
+        for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+            j->soma[g] += antigo->soma[g];
+            fila_inserir(&j->minimos[g], j, posicao, g, false);
+            fila_inserir(&j->maximos[g], j, posicao, g, true);
+        }
+        j->amostras += antigo->amostras;
+    }
+    memset(&j->atual, 0, sizeof(j->atual));
+    j->sequencia++;
+}
+
+static void janela_amostra(agregados_janela_t *j, uint32_t instante_s, const int16_t *valores) {
+    uint32_t sequencia = instante_s / j->largura_s;
+    if (!j->iniciada) {
+        j->iniciada = true;
+        j->sequencia = sequencia;
+    }
+    if (sequencia > j->sequencia) {
+        // Depois de baldes + 1 fechamentos, todo o anel está vazio: o resto do intervalo é só um salto
+        uint32_t fechar = sequencia - j->sequencia;
+        if (fechar > j->baldes + 1u) {
+            fechar = j->baldes + 1u;
+        }
+        while (fechar--) {
+            fechar_balde(j);
+        }
+        j->sequencia = sequencia;
+    }
+    // Um instante anterior ao balde em andamento (não acontece com o tempo desde o boot) entra nele
+
+    agregados_balde_t *b = &j->atual;
+    for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+        if (b->amostras == 0 || valores[g] < b->minimo[g]) {
+            b->minimo[g] = valores[g];
+        }
+        if (b->amostras == 0 || valores[g] > b->maximo[g]) {
+            b->maximo[g] = valores[g];
+        }
+        b->soma[g] += valores[g];
+    }
+    b->amostras++;
+}
+
+// Uma leitura, em décimos; 'instante_s' deve ser monotônico (segundos desde o boot)
+void agregados_amostra(agregados_t *a, uint32_t instante_s, int16_t temperatura, int16_t umidade) {
+    a->ultimo[AGREGADO_TEMPERATURA] = temperatura;
+    a->ultimo[AGREGADO_UMIDADE] = umidade;
+    a->ultimo[AGREGADO_ITU] = agregados_itu(temperatura, umidade);
+    a->amostras++;
+    for (int i = 0; i < a->quantidade; i++) {
+        janela_amostra(&a->janelas[i], instante_s, a->ultimo);
+    }
+}
+
+static int16_t dividir_arredondando(int64_t n, uint32_t d) {
+    return (int16_t)(n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d));
+}
+
+// Combina o balde em andamento com a frente das filas e a soma dos baldes completos.
+// Retorna false se a janela ainda não tem amostras.
+bool agregados_resumo(const agregados_t *a, int janela, agregado_grandeza_t grandeza, agregados_resumo_t *r) {
+    if (janela < 0 || janela >= a->quantidade || grandeza >= AGREGADOS_GRANDEZAS) {
+        return false;
+    }
+    const agregados_janela_t *j = &a->janelas[janela];
+    int g = grandeza;
+    r->amostras = j->amostras + j->atual.amostras;
+    if (r->amostras == 0) {
+        return false;
+    }
+
+    r->minimo = INT16_MAX;
+    r->maximo = INT16_MIN;
+    if (j->atual.amostras > 0) {
+        r->minimo = j->atual.minimo[g];
+        r->maximo = j->atual.maximo[g];
+    }
+    const agregados_fila_t *f = &j->minimos[g];
+    if (f->quantidade > 0 && j->anel[f->posicoes[f->inicio]].minimo[g] < r->minimo) {
+        r->minimo = j->anel[f->posicoes[f->inicio]].minimo[g];
+    }
+    f = &j->maximos[g];
+    if (f->quantidade > 0 && j->anel[f->posicoes[f->inicio]].maximo[g] > r->maximo) {
+        r->maximo = j->anel[f->posicoes[f->inicio]].maximo[g];
+    }
+    r->media = dividir_arredondando(j->soma[g] + j->atual.soma[g], r->amostras);
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef agregados_inc_h
+#define agregados_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Mínimo, máximo e média móveis da temperatura, da umidade e do Índice de Temperatura e Umidade
+// (ITU, o THI da literatura), em várias janelas ao mesmo tempo, sem percorrer o histórico.
+// Tudo em inteiros (décimos) e sem dependência do SDK.
+//
+// Cada janela divide o tempo em baldes de 'largura_s' segundos e cobre o balde em andamento mais
+// os 'baldes' anteriores. Um balde guarda mínimo, máximo e soma das suas amostras; a janela mantém
+// a soma dos baldes completos e, por grandeza, duas filas monotônicas (mínimos crescentes e máximos
+// decrescentes) cuja frente é o extremo da janela. Cada amostra custa O(1) amortizado por janela,
+// e a consulta custa O(1). Um intervalo sem amostras só deixa baldes vazios.
+
+#define AGREGADOS_BALDES_MAX 72
+#define AGREGADOS_JANELAS_MAX 3
+
+typedef enum {
+    AGREGADO_TEMPERATURA,
+    AGREGADO_UMIDADE,
+    AGREGADO_ITU,
+    AGREGADOS_GRANDEZAS
+} agregado_grandeza_t;
+
+typedef struct {
+    int16_t minimo;          // Décimos
+    int16_t maximo;
+    int16_t media;           // Arredondada
+    uint32_t amostras;       // 0: janela sem amostras, demais campos sem significado
+} agregados_resumo_t;
+
+typedef struct {
+    int16_t minimo[AGREGADOS_GRANDEZAS];
+    int16_t maximo[AGREGADOS_GRANDEZAS];
+    int32_t soma[AGREGADOS_GRANDEZAS];
+    uint16_t amostras;
+} agregados_balde_t;
+
+// Posições do anel de baldes, em ordem de chegada (circular)
+typedef struct {
+    uint8_t posicoes[AGREGADOS_BALDES_MAX];
+    uint8_t inicio;
+    uint8_t quantidade;
+} agregados_fila_t;
+
+typedef struct {
+    uint32_t largura_s;
+    uint8_t baldes;                                  // Baldes completos na janela
+    bool iniciada;
+    uint32_t sequencia;                              // Balde em andamento: instante / largura_s
+    agregados_balde_t atual;
+    agregados_balde_t anel[AGREGADOS_BALDES_MAX];    // Balde completo s na posição s % baldes
+    int64_t soma[AGREGADOS_GRANDEZAS];               // Soma dos baldes completos
+    uint32_t amostras;
+    agregados_fila_t minimos[AGREGADOS_GRANDEZAS];
+    agregados_fila_t maximos[AGREGADOS_GRANDEZAS];
+} agregados_janela_t;
+
+typedef struct {
+    agregados_janela_t janelas[AGREGADOS_JANELAS_MAX];
+    uint8_t quantidade;
+    int16_t ultimo[AGREGADOS_GRANDEZAS];             // Valores da amostra mais recente
+    uint32_t amostras;
+} agregados_t;
+
+void agregados_iniciar(agregados_t *a);
+int agregados_adicionar_janela(agregados_t *a, uint32_t largura_s, uint8_t baldes);
+void agregados_amostra(agregados_t *a, uint32_t instante_s, int16_t temperatura, int16_t umidade);
+bool agregados_resumo(const agregados_t *a, int janela, agregado_grandeza_t grandeza, agregados_resumo_t *r);
+
+int16_t agregados_itu(int16_t temperatura, int16_t umidade);
+const char *agregados_itu_faixa(int16_t itu);
+
+#endif
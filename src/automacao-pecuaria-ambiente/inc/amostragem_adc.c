@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "amostragem_adc.h"
+
+#define AMOSTRAGEM_ADC_MASCARA (AMOSTRAGEM_ADC_ANEL - 1)
+#define AMOSTRAGEM_ADC_BITS_ANEL 9     // log2 do tamanho do anel em bytes
+
+_Static_assert((AMOSTRAGEM_ADC_ANEL & AMOSTRAGEM_ADC_MASCARA) == 0, "AMOSTRAGEM_ADC_ANEL deve ser potencia de 2");
+_Static_assert((1u << AMOSTRAGEM_ADC_BITS_ANEL) == AMOSTRAGEM_ADC_ANEL * sizeof(uint16_t),
+               "AMOSTRAGEM_ADC_BITS_ANEL nao corresponde a AMOSTRAGEM_ADC_ANEL");
+
+// O wrap de endereço do DMA exige o anel alinhado ao próprio tamanho
+static uint16_t anel[AMOSTRAGEM_ADC_ANEL] __attribute__((aligned(AMOSTRAGEM_ADC_ANEL * sizeof(uint16_t))));
+
+static uint pinos_canais[AMOSTRAGEM_ADC_MAX_CANAIS];   // Em ordem crescente de canal: a ordem do round-robin
+static filtro_adc_t filtros[AMOSTRAGEM_ADC_MAX_CANAIS];
+static uint num_canais = 0;
+static int dma_canal = -1;
+static uint32_t cursor = 0;        // Próxima posição do anel a filtrar
+static uint32_t reinicios = 0;
+
+// Posição 0 do anel recebe sempre o canal de menor número, então posição % num_canais dá o canal.
+// A contagem do DMA dura ~49 dias a 1 kHz; quando se esgota, o ADC para e tudo recomeça do início.
+static void iniciar_captura(void) {
+    adc_run(false);
+    adc_fifo_drain();
+    adc_select_input(pinos_canais[0] - 26);
+    dma_channel_set_write_addr(dma_canal, anel, false);
+    dma_channel_set_trans_count(dma_canal, UINT32_MAX & ~AMOSTRAGEM_ADC_MASCARA, true);
+    cursor = 0;
+    adc_run(true);
+}
+
+// Recebe os pinos (26 a 28) a amostrar; mais de um canal usa o round-robin do ADC
+bool amostragem_adc_iniciar(const uint *pinos, uint quantidade) {
+    if (quantidade == 0 || quantidade > AMOSTRAGEM_ADC_MAX_CANAIS) {
+        return false;
+    }
+
+    adc_init();
+    uint mascara_round_robin = 0;
+    for (uint i = 0; i < quantidade; i++) {
+        if (pinos[i] < 26 || pinos[i] > 28) {
+            printf("ADC: pino %u nao tem entrada analogica\n", pinos[i]);
+            return false;
+        }
+        // Inserção ordenada por canal
+        uint j = i;
+        while (j > 0 && pinos_canais[j - 1] > pinos[i]) {
+            pinos_canais[j] = pinos_canais[j - 1];
+            j--;
+        }
+        pinos_canais[j] = pinos[i];
+        mascara_round_robin |= 1u << (pinos[i] - 26);
+        filtro_adc_iniciar(&filtros[i]);
+        adc_gpio_init(pinos[i]);
+    }
+    num_canais = quantidade;
+
+    adc_set_round_robin(quantidade > 1 ? mascara_round_robin : 0);
+    adc_fifo_setup(true, true, 1, false, false);   // FIFO com DREQ a cada leitura, 12 bits sem flag de erro
+    adc_set_clkdiv(48000000.f / AMOSTRAGEM_ADC_TAXA_HZ - 1);
+
+    dma_canal = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_canal);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, AMOSTRAGEM_ADC_BITS_ANEL);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(dma_canal, &c, anel, &adc_hw->fifo, 0, false);
+
+    iniciar_captura();
+    return true;
+}
+
+// Filtra as leituras que o DMA escreveu desde a última chamada. Precisa rodar antes de o anel dar
+// a volta (AMOSTRAGEM_ADC_ANEL / AMOSTRAGEM_ADC_TAXA_HZ segundos); só processa grupos completos.
+void amostragem_adc_processar(void) {
+    if (dma_canal < 0) {
+        return;
+    }
+    if (!dma_channel_is_busy(dma_canal)) {
+        reinicios++;
+        iniciar_captura();
+        return;
+    }
+
+    uint32_t escrita = (dma_channel_hw_addr(dma_canal)->write_addr - (uintptr_t)anel) / sizeof(uint16_t);
+    uint32_t novas = (escrita - cursor) & AMOSTRAGEM_ADC_MASCARA;
+    novas -= novas % num_canais;
+
+    for (uint32_t i = 0; i < novas; i++) {
+        uint32_t posicao = (cursor + i) & AMOSTRAGEM_ADC_MASCARA;
+        filtro_adc_amostra(&filtros[posicao % num_canais], anel[posicao]);
+    }
+    cursor = (cursor + novas) & AMOSTRAGEM_ADC_MASCARA;
+}
+
+// Filtro (e valor publicado) do canal ligado ao pino, ou NULL se o pino não é amostrado
+const filtro_adc_t *amostragem_adc_filtro(uint pino) {
+    for (uint i = 0; i < num_canais; i++) {
+        if (pinos_canais[i] == pino) {
+            return &filtros[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t amostragem_adc_reinicios(void) {
+    return reinicios;
+}
@@ -0,0 +1,21 @@
+#ifndef amostragem_adc_inc_h
+#define amostragem_adc_inc_h
+
+#include "pico/stdlib.h"
+#include "filtro_adc.h"
+
+// Aquisição contínua do ADC: o conversor roda livre (em round-robin se houver mais de um canal),
+// a FIFO do ADC alimenta um canal de DMA e o DMA escreve num anel em RAM, sem interrupções.
+// amostragem_adc_processar(), chamada periodicamente, passa as leituras novas do anel pela cadeia
+// de filtros de cada canal (inc/filtro_adc.h); o valor filtrado fica publicado no filtro.
+
+#define AMOSTRAGEM_ADC_TAXA_HZ 1000    // Leituras por segundo, somando todos os canais
+#define AMOSTRAGEM_ADC_ANEL 256        // Leituras no anel do DMA (potência de 2, ~256 ms a 1 kHz)
+#define AMOSTRAGEM_ADC_MAX_CANAIS 2    // Precisa dividir AMOSTRAGEM_ADC_ANEL
+
+bool amostragem_adc_iniciar(const uint *pinos, uint num_canais);
+void amostragem_adc_processar(void);
+const filtro_adc_t *amostragem_adc_filtro(uint pino);
+uint32_t amostragem_adc_reinicios(void);
+
+#endif
@@ -0,0 +1,342 @@
+#include <string.h>
+#include "camadas.h"
+
+#define CODIGO_MAXIMO 254
+#define TEMPERATURA_DESLOCAMENTO 400     // -40,0 °C vira código 0
+
+// Balde consolidado (7 bytes): mínimo, média e máximo em passos de 0,5
+typedef struct {
+    uint8_t temperatura[3];
+    uint8_t umidade[3];
+    uint8_t luminosidade;
+} balde_t;
+
+// Balde em andamento, com as somas exatas em décimos
+typedef struct {
+    uint32_t sequencia;
+    uint32_t amostras;
+    int32_t soma[3];                     // Temperatura, umidade, luminosidade
+    int16_t minimo[2];                   // Temperatura, umidade
+    int16_t maximo[2];
+} acumulador_t;
+
+typedef struct {
+    uint32_t largura_s;
+    uint32_t tipo;                       // Tipo do log na flash (inc/flash_log.h)
+    flash_log_t *log;                    // Baldes fechados: o registro de sequência s é o balde s
+    bool armazenada;                     // Log montado
+    acumulador_t atual;
+} camada_t;
+
+static flash_log_t log_5min;
+static flash_log_t log_1h;
+
+static camada_t camadas[CAMADAS_NUM] = {
+    [CAMADA_5MIN] = {.largura_s = CAMADA_5MIN_LARGURA, .tipo = 0x35304348u /* "HC05" */, .log = &log_5min},
+    [CAMADA_1H] = {.largura_s = CAMADA_1H_LARGURA, .tipo = 0x30364348u /* "HC60" */, .log = &log_1h},
+};
+
+bool camadas_iniciar(flash_dispositivo_t *flash_5min, flash_dispositivo_t *flash_1h) {
+    flash_dispositivo_t *dispositivos[CAMADAS_NUM] = {[CAMADA_5MIN] = flash_5min, [CAMADA_1H] = flash_1h};
+    bool ok = true;
+    for (int k = CAMADA_5MIN; k < CAMADAS_NUM; k++) {
+        camada_t *c = &camadas[k];
+        c->armazenada = dispositivos[k] && flash_log_montar(c->log, dispositivos[k], c->tipo);
+        ok = ok && (c->armazenada || !dispositivos[k]);
+        memset(&c->atual, 0, sizeof(c->atual));
+    }
+    return ok;
+}
+
+// Grava as páginas pendentes dos logs (veja flash_log_descarregar())
+bool camadas_descarregar(void) {
+    bool ok = true;
+    for (int k = CAMADA_5MIN; k < CAMADAS_NUM; k++) {
+        if (camadas[k].armazenada && !flash_log_descarregar(camadas[k].log)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Log da camada, para as estatísticas; NULL se ela não tem um montado
+const flash_log_t *camadas_log(int camada) {
+    return camada != CAMADA_BRUTA && camadas[camada].armazenada ? camadas[camada].log : NULL;
+}
+
+static uint8_t codificar(int32_t decimos, int32_t deslocamento) {
+    int32_t v = decimos + deslocamento;
+    if (v < 0) {
+        v = 0;
+    }
+    v = (v + 2) / 5;
+    return v > CODIGO_MAXIMO ? CODIGO_MAXIMO : (uint8_t)v;
+}
+
+static int16_t decodificar(uint8_t codigo, int32_t deslocamento) {
+    return (int16_t)(codigo * 5 - deslocamento);
+}
+
+static int32_t media(int32_t soma, uint32_t amostras) {
+    return soma >= 0 ? (soma + (int32_t)amostras / 2) / (int32_t)amostras : -((-soma + (int32_t)amostras / 2) / (int32_t)amostras);
+}
+
+static void acumular(acumulador_t *a, const acumulador_t *parcial) {
+    for (int i = 0; i < 2; i++) {
+        if (a->amostras == 0 || parcial->minimo[i] < a->minimo[i]) a->minimo[i] = parcial->minimo[i];
+        if (a->amostras == 0 || parcial->maximo[i] > a->maximo[i]) a->maximo[i] = parcial->maximo[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        a->soma[i] += parcial->soma[i];
+    }
+    a->amostras += parcial->amostras;
+}
+
+// Grava um balde no log; os baldes pulados desde o último fechamento ficam vazios. Um balde que o
+// log já tem (refeito no boot, ou relógio que voltou) não é gravado de novo.
+static void guardar(camada_t *c, uint32_t sequencia, const balde_t *b) {
+    if (!c->armazenada || sequencia < flash_log_proxima_sequencia(c->log)) {
+        return;
+    }
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS] = {0};
+    memcpy(dados, b, sizeof(*b));
+    if (flash_log_avancar(c->log, sequencia)) {
+        flash_log_anexar_dados(c->log, dados);
+    }
+}
+
+static void incluir(int k, uint32_t epoch, const acumulador_t *parcial);
+
+// Fecha o balde em andamento da camada k e o repassa, com as somas exatas, à camada seguinte
+static void fechar(int k) {
+    camada_t *c = &camadas[k];
+    acumulador_t *a = &c->atual;
+    balde_t b = {
+        .temperatura = {codificar(a->minimo[0], TEMPERATURA_DESLOCAMENTO),
+                        codificar(media(a->soma[0], a->amostras), TEMPERATURA_DESLOCAMENTO),
+                        codificar(a->maximo[0], TEMPERATURA_DESLOCAMENTO)},
+        .umidade = {codificar(a->minimo[1], 0), codificar(media(a->soma[1], a->amostras), 0), codificar(a->maximo[1], 0)},
+        .luminosidade = codificar(media(a->soma[2], a->amostras), 0),
+    };
+    guardar(c, a->sequencia, &b);
+    if (k + 1 < CAMADAS_NUM) {
+        incluir(k + 1, a->sequencia * c->largura_s, a);
+    }
+    a->amostras = 0;
+    memset(a->soma, 0, sizeof(a->soma));
+}
+
+// Soma um parcial (uma amostra ou um balde fechado da camada anterior) ao balde em andamento da
+// camada k. Um parcial de um balde já passado (relógio voltou) entra no balde em andamento.
+// Por isso a hora em andamento só vê os baldes de 5 min já fechados.
+static void incluir(int k, uint32_t epoch, const acumulador_t *parcial) {
+    camada_t *c = &camadas[k];
+    uint32_t sequencia = epoch / c->largura_s;
+    if (c->atual.amostras > 0 && sequencia > c->atual.sequencia) {
+        fechar(k);
+    }
+    if (c->atual.amostras == 0) {
+        c->atual.sequencia = sequencia;
+    }
+    acumular(&c->atual, parcial);
+}
+
+void camadas_adicionar(const amostra_t *amostra) {
+    acumulador_t a = {
+        .amostras = 1,
+        .soma = {amostra->temperatura, amostra->umidade, amostra->luminosidade},
+        .minimo = {amostra->temperatura, amostra->umidade},
+        .maximo = {amostra->temperatura, amostra->umidade},
+    };
+    incluir(CAMADA_5MIN, amostra->epoch, &a);
+}
+
+uint32_t camadas_largura(int camada) {
+    return camada == CAMADA_BRUTA ? CAMADA_BRUTA_LARGURA : camadas[camada].largura_s;
+}
+
+// Primeiro e último balde da camada, do mais antigo ainda no log ao em andamento; false se ela
+// ainda não tem nada
+static bool faixa(const camada_t *c, uint32_t *primeira, uint32_t *ultima) {
+    bool guardados = c->armazenada && flash_log_proxima_sequencia(c->log) > flash_log_primeira_sequencia(c->log);
+    if (!guardados && c->atual.amostras == 0) {
+        return false;
+    }
+    if (guardados) {
+        *primeira = flash_log_primeira_sequencia(c->log);
+        *ultima = flash_log_proxima_sequencia(c->log) - 1;
+    }
+    if (c->atual.amostras > 0) {
+        if (!guardados || c->atual.sequencia < *primeira) *primeira = c->atual.sequencia;
+        if (!guardados || c->atual.sequencia > *ultima) *ultima = c->atual.sequencia;
+    }
+    return true;
+}
+
+// Epoch do dado mais antigo da camada; false se ela ainda não tem nada
+bool camadas_inicio(int camada, uint32_t *epoch) {
+    if (camada == CAMADA_BRUTA) {
+        amostra_t a;
+        if (!historico_obter(historico_primeira_sequencia(), &a)) {
+            return false;
+        }
+        *epoch = a.epoch;
+        return true;
+    }
+    const camada_t *c = &camadas[camada];
+    uint32_t primeira, ultima;
+    if (!faixa(c, &primeira, &ultima)) {
+        return false;
+    }
+    *epoch = primeira * c->largura_s;
+    return true;
+}
+
+// A camada guarda tudo a partir de epoch_de: ou começa antes dele, ou não perdeu nada, isto é,
+// nenhuma camada mais grossa tem um balde inteiro anterior ao seu início
+static bool cobre(int camada, uint32_t epoch_de) {
+    uint32_t inicio;
+    if (!camadas_inicio(camada, &inicio)) {
+        inicio = UINT32_MAX;
+    } else if (inicio <= epoch_de) {
+        return true;
+    }
+    for (int k = camada + 1; k < CAMADAS_NUM; k++) {
+        uint32_t anterior;
+        if (camadas_inicio(k, &anterior) && anterior + camadas_largura(k) <= inicio) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Baldes (ou amostras, na camada 0) com início em [epoch_de, epoch_ate], contando o em andamento
+uint32_t camadas_contar(int camada, uint32_t epoch_de, uint32_t epoch_ate) {
+    if (epoch_de > epoch_ate) {
+        return 0;
+    }
+    if (camada == CAMADA_BRUTA) {
+        uint32_t fim = epoch_ate == UINT32_MAX ? historico_proxima_sequencia() : historico_buscar_epoch(epoch_ate + 1);
+        return fim - historico_buscar_epoch(epoch_de);
+    }
+    const camada_t *c = &camadas[camada];
+    uint32_t de = (epoch_de + c->largura_s - 1) / c->largura_s;
+    uint32_t ate = epoch_ate / c->largura_s;
+    uint32_t primeira, ultima;
+    if (!faixa(c, &primeira, &ultima)) {
+        return 0;
+    }
+    if (de < primeira) de = primeira;
+    if (ate > ultima) ate = ultima;
+    return ate >= de ? ate - de + 1 : 0;
+}
+
+// Escolhe a camada mais fina que guarda todo o intervalo dentro do orçamento de pontos (0: sem
+// limite). Se nenhuma couber, fica a mais grossa, com baldes somados em grupos ('agrupar').
+int camadas_escolher(uint32_t epoch_de, uint32_t epoch_ate, uint32_t max_pontos, uint32_t *agrupar) {
+    *agrupar = 1;
+    for (int k = CAMADA_BRUTA; k < CAMADAS_NUM - 1; k++) {
+        if (cobre(k, epoch_de) && (max_pontos == 0 || camadas_contar(k, epoch_de, epoch_ate) <= max_pontos)) {
+            return k;
+        }
+    }
+    uint32_t n = camadas_contar(CAMADAS_NUM - 1, epoch_de, epoch_ate);
+    if (max_pontos > 0 && n > max_pontos) {
+        *agrupar = (n + max_pontos - 1) / max_pontos;
+    }
+    return CAMADAS_NUM - 1;
+}
+
+void camadas_iterar(camadas_iterador_t *it, uint32_t epoch_de, uint32_t epoch_ate, uint32_t max_pontos) {
+    it->camada = camadas_escolher(epoch_de, epoch_ate, max_pontos, &it->agrupar);
+    if (it->camada == CAMADA_BRUTA) {
+        historico_iterar_intervalo(&it->bruto, epoch_de, epoch_ate);
+        return;
+    }
+    uint32_t largura = camadas[it->camada].largura_s;
+    it->sequencia = (epoch_de + largura - 1) / largura;
+    it->fim = epoch_ate / largura;
+}
+
+// Balde s da camada: do log, ou o em andamento; false se vazio ou fora do que está guardado
+static bool obter_balde(camada_t *c, uint32_t s, camadas_ponto_t *p) {
+    if (c->atual.amostras > 0 && s == c->atual.sequencia) {
+        const acumulador_t *a = &c->atual;
+        *p = (camadas_ponto_t){
+            .temperatura = {a->minimo[0], (int16_t)media(a->soma[0], a->amostras), a->maximo[0]},
+            .umidade = {a->minimo[1], (int16_t)media(a->soma[1], a->amostras), a->maximo[1]},
+            .luminosidade = (int16_t)media(a->soma[2], a->amostras),
+        };
+        return true;
+    }
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS];
+    balde_t b;
+    if (!c->armazenada || !flash_log_ler_dados(c->log, s, dados)) {
+        return false;
+    }
+    memcpy(&b, dados, sizeof(b));
+    for (int i = 0; i < 3; i++) {
+        p->temperatura[i] = decodificar(b.temperatura[i], TEMPERATURA_DESLOCAMENTO);
+        p->umidade[i] = decodificar(b.umidade[i], 0);
+    }
+    p->luminosidade = decodificar(b.luminosidade, 0);
+    return true;
+}
+
+// Próximo ponto; num grupo, a média é a dos baldes (sem peso pela contagem, que o log não guarda)
+bool camadas_proximo(camadas_iterador_t *it, camadas_ponto_t *ponto) {
+    if (it->camada == CAMADA_BRUTA) {
+        amostra_t a;
+        if (!historico_proximo(&it->bruto, &a)) {
+            return false;
+        }
+        *ponto = (camadas_ponto_t){
+            .epoch = a.epoch,
+            .temperatura = {a.temperatura, a.temperatura, a.temperatura},
+            .umidade = {a.umidade, a.umidade, a.umidade},
+            .luminosidade = a.luminosidade,
+        };
+        return true;
+    }
+
+    camada_t *c = &camadas[it->camada];
+    uint32_t primeira, ultima;
+    if (!faixa(c, &primeira, &ultima)) {
+        return false;
+    }
+    if (it->sequencia < primeira) {
+        it->sequencia = primeira;
+    }
+    uint32_t fim = it->fim < ultima ? it->fim : ultima;
+
+    while (it->sequencia <= fim) {
+        uint32_t grupo = it->sequencia;
+        uint32_t baldes = 0;
+        int32_t soma[3] = {0};
+        camadas_ponto_t b;
+        for (; it->sequencia < grupo + it->agrupar && it->sequencia <= fim; it->sequencia++) {
+            if (!obter_balde(c, it->sequencia, &b)) {
+                continue;
+            }
+            if (baldes == 0) {
+                *ponto = b;
+            }
+            if (b.temperatura[0] < ponto->temperatura[0]) ponto->temperatura[0] = b.temperatura[0];
+            if (b.temperatura[2] > ponto->temperatura[2]) ponto->temperatura[2] = b.temperatura[2];
+            if (b.umidade[0] < ponto->umidade[0]) ponto->umidade[0] = b.umidade[0];
+            if (b.umidade[2] > ponto->umidade[2]) ponto->umidade[2] = b.umidade[2];
+            soma[0] += b.temperatura[1];
+            soma[1] += b.umidade[1];
+            soma[2] += b.luminosidade;
+            baldes++;
+        }
+        if (baldes > 0) {
+            ponto->epoch = grupo * c->largura_s;
+            ponto->temperatura[1] = (int16_t)media(soma[0], baldes);
+            ponto->umidade[1] = (int16_t)media(soma[1], baldes);
+            ponto->luminosidade = (int16_t)media(soma[2], baldes);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef camadas_inc_h
+#define camadas_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "historico.h"
+#include "flash_log.h"
+
+// Histórico de longo prazo em camadas de resolução decrescente, à maneira do RRDtool:
+//   camada 0: as amostras brutas do próprio histórico (inc/historico.h), algumas horas;
+//   camada 1: baldes de 5 min com mínimo, média e máximo, por 2 semanas;
+//   camada 2: baldes de 1 h, por 1 ano.
+// A consolidação é incremental: cada amostra entra no acumulador do balde de 5 min em andamento;
+// quando ele fecha, vai para o log da camada 1 e é somado (soma e contagem exatas, antes da
+// quantização) ao acumulador da hora, que por sua vez fecha no log da camada 2. Intervalos sem
+// amostras viram baldes vazios. Um balde ocupa 7 bytes, com as leituras em passos de 0,5
+// (temperatura de -40 a 87, umidade e luz de 0 a 127).
+//
+// Os baldes fechados ficam só na flash, num log por camada (inc/flash_log.h), em que a sequência
+// do registro é a do balde (epoch / largura); as consultas os leem de lá. Na RAM ficam apenas os
+// acumuladores em andamento. No boot, eles são refeitos repassando a camadas_adicionar() o fim do
+// log de amostras: os baldes que já estavam na flash não são gravados de novo.
+
+#define CAMADAS_NUM 3
+#define CAMADA_BRUTA 0
+#define CAMADA_5MIN 1
+#define CAMADA_1H 2
+
+#define CAMADA_5MIN_LARGURA (5 * 60)
+#define CAMADA_5MIN_BALDES (14 * 24 * 12)     // 2 semanas
+#define CAMADA_1H_LARGURA (60 * 60)
+#define CAMADA_1H_BALDES (365 * 24)           // 1 ano
+#define CAMADA_BRUTA_LARGURA 60               // Período nominal das amostras do histórico
+
+// Ponto de uma consulta, em décimos: mínimo, média e máximo (iguais numa amostra bruta)
+typedef struct {
+    uint32_t epoch;                  // Início do intervalo (ou instante da amostra bruta)
+    int16_t temperatura[3];
+    int16_t umidade[3];
+    int16_t luminosidade;            // Média
+} camadas_ponto_t;
+
+// Percorre uma consulta em ordem cronológica. Sobrevive a inserções durante a iteração: baldes
+// sobrescritos no meio do caminho são pulados.
+typedef struct {
+    uint8_t camada;
+    uint32_t agrupar;                // Baldes consecutivos somados em cada ponto
+    uint32_t sequencia;              // Próximo balde (epoch / largura)
+    uint32_t fim;                    // Último balde da consulta (inclusivo)
+    historico_iterador_t bruto;      // Usado na camada 0
+} camadas_iterador_t;
+
+// Monta os logs das camadas 1 e 2 nos dispositivos dados. Com NULL (ou se a montagem falhar), a
+// camada guarda só o balde em andamento. Retorna false se algum dos logs não pôde ser montado.
+bool camadas_iniciar(flash_dispositivo_t *flash_5min, flash_dispositivo_t *flash_1h);
+void camadas_adicionar(const amostra_t *amostra);
+bool camadas_descarregar(void);
+const flash_log_t *camadas_log(int camada);
+
+uint32_t camadas_largura(int camada);
+bool camadas_inicio(int camada, uint32_t *epoch);
+uint32_t camadas_contar(int camada, uint32_t epoch_de, uint32_t epoch_ate);
+int camadas_escolher(uint32_t epoch_de, uint32_t epoch_ate, uint32_t max_pontos, uint32_t *agrupar);
+
+void camadas_iterar(camadas_iterador_t *it, uint32_t epoch_de, uint32_t epoch_ate, uint32_t max_pontos);
+bool camadas_proximo(camadas_iterador_t *it, camadas_ponto_t *ponto);
+
+#endif
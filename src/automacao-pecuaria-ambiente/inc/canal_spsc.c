@@ -0,0 +1,48 @@
+#include <string.h>
+#include <assert.h>
+#include "canal_spsc.h"
+
+void canal_spsc_iniciar(canal_spsc_t *canal, void *buffer, uint32_t tamanho_elemento, uint32_t capacidade) {
+    assert(capacidade > 0 && (capacidade & (capacidade - 1)) == 0);
+
+    canal->buffer = buffer;
+    canal->tamanho_elemento = tamanho_elemento;
+    canal->mascara = capacidade - 1;
+    canal->descartados = 0;
+    atomic_init(&canal->cabeca, 0);
+    atomic_init(&canal->cauda, 0);
+}
+
+// Lado do produtor. Retorna false (sem bloquear) se o canal estiver cheio.
+bool canal_spsc_enviar(canal_spsc_t *canal, const void *elemento) {
+    uint32_t cabeca = atomic_load_explicit(&canal->cabeca, memory_order_relaxed);
+    uint32_t cauda = atomic_load_explicit(&canal->cauda, memory_order_acquire);
+
+    if (cabeca - cauda > canal->mascara) {
+        canal->descartados++;
+        return false;
+    }
+
+    memcpy(canal->buffer + (cabeca & canal->mascara) * canal->tamanho_elemento, elemento, canal->tamanho_elemento);
+    atomic_store_explicit(&canal->cabeca, cabeca + 1, memory_order_release);
+    return true;
+}
+
+// Lado do consumidor. Retorna false se não houver elemento disponível.
+bool canal_spsc_receber(canal_spsc_t *canal, void *elemento) {
+    uint32_t cauda = atomic_load_explicit(&canal->cauda, memory_order_relaxed);
+    uint32_t cabeca = atomic_load_explicit(&canal->cabeca, memory_order_acquire);
+
+    if (cabeca == cauda) {
+        return false;
+    }
+
+    memcpy(elemento, canal->buffer + (cauda & canal->mascara) * canal->tamanho_elemento, canal->tamanho_elemento);
+    atomic_store_explicit(&canal->cauda, cauda + 1, memory_order_release);
+    return true;
+}
+
+uint32_t canal_spsc_ocupacao(canal_spsc_t *canal) {
+    return atomic_load_explicit(&canal->cabeca, memory_order_acquire) -
+           atomic_load_explicit(&canal->cauda, memory_order_acquire);
+}
@@ -0,0 +1,26 @@
+#ifndef canal_spsc_inc_h
+#define canal_spsc_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Canal sem travas de um produtor e um consumidor (SPSC), usado para trocar mensagens entre os núcleos.
+// Só o produtor escreve em 'cabeca' e só o consumidor escreve em 'cauda'; a publicação de cada
+// elemento usa ordem release/acquire, então nenhum mutex ou spinlock é necessário.
+
+typedef struct {
+    uint8_t *buffer;
+    uint32_t tamanho_elemento;
+    uint32_t mascara;          // capacidade - 1 (a capacidade deve ser potência de 2)
+    atomic_uint cabeca;        // Total de elementos escritos
+    atomic_uint cauda;         // Total de elementos lidos
+    uint32_t descartados;      // Envios recusados por canal cheio (contado pelo produtor)
+} canal_spsc_t;
+
+void canal_spsc_iniciar(canal_spsc_t *canal, void *buffer, uint32_t tamanho_elemento, uint32_t capacidade);
+bool canal_spsc_enviar(canal_spsc_t *canal, const void *elemento);
+bool canal_spsc_receber(canal_spsc_t *canal, void *elemento);
+uint32_t canal_spsc_ocupacao(canal_spsc_t *canal);
+
+#endif
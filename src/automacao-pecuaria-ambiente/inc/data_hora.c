@@ -0,0 +1,87 @@
+#include "data_hora.h"
+
+// Dias desde 1970-01-01 para uma data do calendário gregoriano (algoritmo de Howard Hinnant)
+static int32_t dias_desde_epoch(int32_t ano, uint32_t mes, uint32_t dia) {
+    ano -= mes <= 2;
+    int32_t era = (ano >= 0 ? ano : ano - 399) / 400;
+    uint32_t ano_da_era = (uint32_t)(ano - era * 400);
+    uint32_t dia_do_ano = (153 * (mes + (mes > 2 ? -3 : 9)) + 2) / 5 + dia - 1;
+    uint32_t dia_da_era = ano_da_era * 365 + ano_da_era / 4 - ano_da_era / 100 + dia_do_ano;
+    return era * 146097 + (int32_t)dia_da_era - 719468;
+}
+
+uint32_t data_hora_para_epoch(const datetime_t *t) {
+    int32_t dias = dias_desde_epoch(t->year, t->month, t->day);
+    return (uint32_t)dias * 86400u + t->hour * 3600u + t->min * 60u + t->sec;
+}
+
+void data_hora_de_epoch(uint32_t epoch, datetime_t *t) {
+    int32_t z = epoch / 86400 + 719468;
+    uint32_t segundos = epoch % 86400;
+
+    int32_t era = z / 146097;
+    uint32_t dia_da_era = (uint32_t)(z - era * 146097);
+    uint32_t ano_da_era = (dia_da_era - dia_da_era / 1460 + dia_da_era / 36524 - dia_da_era / 146096) / 365;
+    uint32_t dia_do_ano = dia_da_era - (365 * ano_da_era + ano_da_era / 4 - ano_da_era / 100);
+    uint32_t mp = (5 * dia_do_ano + 2) / 153;
+    uint32_t dia = dia_do_ano - (153 * mp + 2) / 5 + 1;
+    uint32_t mes = mp < 10 ? mp + 3 : mp - 9;
+
+    t->year = (int16_t)(ano_da_era + era * 400 + (mes <= 2));
+    t->month = (int8_t)mes;
+    t->day = (int8_t)dia;
+    t->dotw = (int8_t)((epoch / 86400 + 4) % 7); // 1970-01-01 foi quinta-feira
+    t->hour = (int8_t)(segundos / 3600);
+    t->min = (int8_t)(segundos / 60 % 60);
+    t->sec = (int8_t)(segundos % 60);
+}
+
+// Lê um número de 'digitos' algarismos; retorna false se faltar algum
+static bool ler_numero(const char **texto, int digitos, int *valor) {
+    *valor = 0;
+    for (int i = 0; i < digitos; i++) {
+        char c = (*texto)[i];
+        if (c < '0' || c > '9') return false;
+        *valor = *valor * 10 + (c - '0');
+    }
+    *texto += digitos;
+    return true;
+}
+
+// Interpreta segundos desde 1970 ("1751409780") ou data e hora no formato
+// AAAA-MM-DD[THH:MM[:SS]] ("2025-07-01", "2025-07-01T22:43"). O texto termina
+// no primeiro caractere que não faça parte do valor (por exemplo '&' numa query string).
+bool data_hora_analisar(const char *texto, uint32_t *epoch) {
+    const char *p = texto;
+    uint32_t valor = 0;
+    while (*p >= '0' && *p <= '9') {
+        valor = valor * 10 + (*p - '0');
+        p++;
+    }
+    if (p == texto) return false;
+    if (*p != '-') {
+        *epoch = valor;
+        return true;
+    }
+
+    int ano, mes, dia, hora = 0, minuto = 0, segundo = 0;
+    p = texto;
+    if (!ler_numero(&p, 4, &ano) || *p++ != '-' || !ler_numero(&p, 2, &mes) || *p++ != '-' || !ler_numero(&p, 2, &dia)) {
+        return false;
+    }
+    if (*p == 'T' || *p == ' ') {
+        p++;
+        if (!ler_numero(&p, 2, &hora) || *p++ != ':' || !ler_numero(&p, 2, &minuto)) return false;
+        if (*p == ':') {
+            p++;
+            if (!ler_numero(&p, 2, &segundo)) return false;
+        }
+    }
+    if (mes < 1 || mes > 12 || dia < 1 || dia > 31 || hora > 23 || minuto > 59 || segundo > 59) {
+        return false;
+    }
+
+    datetime_t t = {.year = ano, .month = mes, .day = dia, .hour = hora, .min = minuto, .sec = segundo};
+    *epoch = data_hora_para_epoch(&t);
+    return true;
+}
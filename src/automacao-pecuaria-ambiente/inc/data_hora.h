@@ -0,0 +1,13 @@
+#ifndef data_hora_inc_h
+#define data_hora_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/util/datetime.h"
+
+// Conversões entre o datetime_t do RTC e segundos desde 1970-01-01 (no fuso do próprio RTC)
+uint32_t data_hora_para_epoch(const datetime_t *t);
+void data_hora_de_epoch(uint32_t epoch, datetime_t *t);
+bool data_hora_analisar(const char *texto, uint32_t *epoch);
+
+#endif
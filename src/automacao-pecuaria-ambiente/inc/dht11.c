@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "dht11.h"
+#include "dht11.pio.h"
+
+// Um único sensor por firmware; a interrupção do PIO precisa achar o driver
+static dht11_t *instancia;
+
+// Fim de quadro: roda no núcleo que chamou dht11_iniciar(), produtor único da fila
+static void dht11_irq_handler(void) {
+    dht11_t *d = instancia;
+    if (!pio_interrupt_get(d->pio, d->sm)) {
+        return;
+    }
+    pio_interrupt_clear(d->pio, d->sm);
+
+    if (pio_sm_get_rx_fifo_level(d->pio, d->sm) < 2) {
+        return;
+    }
+    uint32_t palavra = pio_sm_get(d->pio, d->sm);
+    uint32_t checksum = pio_sm_get(d->pio, d->sm);
+    d->lendo = false;
+
+    dht11_leitura_t leitura = {.instante_us = time_us_64()};
+    if (!dht11_decodificar(palavra, checksum, &leitura)) {
+        d->erros_checksum++;
+        return;
+    }
+    d->leituras++;
+    canal_spsc_enviar(&d->fila, &leitura);
+}
+
+bool dht11_iniciar(dht11_t *d, uint pino) {
+    if (!pio_claim_free_sm_and_add_program(&dht11_program, &d->pio, &d->sm, &d->offset)) {
+        printf("DHT11: sem maquina de estados ou memoria de instrucoes livre no PIO\n");
+        return false;
+    }
+    d->pino = pino;
+    d->lendo = false;
+    d->leituras = 0;
+    d->erros_checksum = 0;
+    d->tempos_esgotados = 0;
+    canal_spsc_iniciar(&d->fila, d->buffer_fila, sizeof(dht11_leitura_t), DHT11_FILA_CAPACIDADE);
+    instancia = d;
+
+    dht11_program_init(d->pio, d->sm, d->offset, pino);
+
+    uint irq = pio_get_irq_num(d->pio, 0);
+    pio_set_irq0_source_enabled(d->pio, (enum pio_interrupt_source)(pis_interrupt0 + d->sm), true);
+    irq_add_shared_handler(irq, dht11_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+// Leva a máquina de estados de volta ao início do programa, com a linha solta
+static void dht11_reiniciar(dht11_t *d) {
+    pio_sm_set_enabled(d->pio, d->sm, false);
+    pio_sm_clear_fifos(d->pio, d->sm);
+    pio_sm_restart(d->pio, d->sm);
+    pio_sm_set_consecutive_pindirs(d->pio, d->sm, d->pino, 1, false);
+    pio_interrupt_clear(d->pio, d->sm);
+    pio_sm_exec(d->pio, d->sm, pio_encode_jmp(d->offset));
+    pio_sm_set_enabled(d->pio, d->sm, true);
+}
+
+// Inicia uma leitura e retorna na hora. Deve ser chamada com intervalo de pelo menos 1 s,
+// o que também dá ao quadro anterior tempo de sobra para terminar.
+void dht11_disparar(dht11_t *d) {
+    if (d->lendo) {
+        d->tempos_esgotados++;
+        dht11_reiniciar(d);
+    }
+    d->lendo = true;
+    pio_sm_put(d->pio, d->sm, DHT11_PULSO_INICIO_US);
+}
+
+// Lado do consumidor: retorna false se não houver leitura nova
+bool dht11_receber(dht11_t *d, dht11_leitura_t *leitura) {
+    return canal_spsc_receber(&d->fila, leitura);
+}
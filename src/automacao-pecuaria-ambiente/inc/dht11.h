@@ -0,0 +1,45 @@
+#ifndef dht11_inc_h
+#define dht11_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/pio.h"
+#include "canal_spsc.h"
+
+// Driver não bloqueante do DHT11, sobre o programa PIO de dht11.pio.
+// dht11_disparar() só escreve a duração do pulso de início na FIFO do PIO; o pulso de ~18 ms e a
+// leitura dos 40 bits (~4 ms) correm no hardware. No fim do quadro, a interrupção do PIO confere o
+// checksum e põe a leitura, com o instante da captura, numa fila SPSC consumida pelo controle.
+// Um quadro que não termina até o disparo seguinte (sensor ausente ou linha presa) conta como
+// tempo esgotado e a máquina de estados é reiniciada.
+
+#define DHT11_PULSO_INICIO_US 20000  // O datasheet pede pelo menos 18 ms
+#define DHT11_FILA_CAPACIDADE 8      // Deve ser potência de 2
+
+typedef struct {
+    uint64_t instante_us;    // Fim do quadro, em microssegundos desde o boot
+    int16_t temperatura;     // Décimos de °C
+    int16_t umidade;         // Décimos de %
+} dht11_leitura_t;
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint offset;
+    uint pino;
+    volatile bool lendo;                 // Disparado e ainda sem quadro
+    canal_spsc_t fila;                   // Interrupção do PIO -> controle
+    dht11_leitura_t buffer_fila[DHT11_FILA_CAPACIDADE];
+
+    // Contadores
+    uint32_t leituras;
+    uint32_t erros_checksum;
+    uint32_t tempos_esgotados;
+} dht11_t;
+
+bool dht11_iniciar(dht11_t *d, uint pino);
+void dht11_disparar(dht11_t *d);
+bool dht11_receber(dht11_t *d, dht11_leitura_t *leitura);
+bool dht11_decodificar(uint32_t palavra, uint32_t checksum, dht11_leitura_t *leitura);
+
+#endif
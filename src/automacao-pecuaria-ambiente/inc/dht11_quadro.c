@@ -0,0 +1,25 @@
+#include "dht11.h"
+
+// Decodificação do quadro de 40 bits, fora de dht11.c por não depender do SDK: o simulador
+// (simulador/dht11_host.c) passa os quadros que gera por esta mesma função.
+
+// Confere o checksum e converte o quadro para décimos. No DHT11 o byte decimal da temperatura
+// traz o sinal no bit 7 (revisões mais novas do sensor); o da umidade costuma ser zero.
+bool dht11_decodificar(uint32_t palavra, uint32_t checksum, dht11_leitura_t *leitura) {
+    uint8_t umidade_int = palavra >> 24;
+    uint8_t umidade_dec = palavra >> 16;
+    uint8_t temperatura_int = palavra >> 8;
+    uint8_t temperatura_dec = palavra;
+
+    uint8_t soma = umidade_int + umidade_dec + temperatura_int + temperatura_dec;
+    if (soma != (uint8_t)checksum) {
+        return false;
+    }
+
+    leitura->umidade = umidade_int * 10 + umidade_dec % 10;
+    leitura->temperatura = temperatura_int * 10 + (temperatura_dec & 0x7F) % 10;
+    if (temperatura_dec & 0x80) {
+        leitura->temperatura = -leitura->temperatura;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#include <string.h>
+#include "filtro_adc.h"
+
+_Static_assert(FILTRO_ADC_MEDIANA % 2 == 1, "FILTRO_ADC_MEDIANA deve ser impar");
+_Static_assert((4095u * FILTRO_ADC_SOBREAMOSTRAGEM) >> FILTRO_ADC_DESLOCAMENTO <= UINT16_MAX,
+               "A media sobreamostrada deve caber em 16 bits");
+
+void filtro_adc_iniciar(filtro_adc_t *f) {
+    memset(f, 0, sizeof(*f));
+}
+
+// Mediana das médias guardadas; com a janela ainda incompleta, usa as que já existem
+static uint16_t mediana(const filtro_adc_t *f) {
+    uint16_t ordenadas[FILTRO_ADC_MEDIANA];
+    uint8_t n = f->preenchidas;
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t v = f->janela[i];
+        uint8_t j = i;
+        while (j > 0 && ordenadas[j - 1] > v) {
+            ordenadas[j] = ordenadas[j - 1];
+            j--;
+        }
+        ordenadas[j] = v;
+    }
+    return ordenadas[n / 2];
+}
+
+static uint16_t mediana3(uint16_t a, uint16_t b, uint16_t c) {
+    if (a > b) { uint16_t t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+// Acrescenta uma leitura de 12 bits. Retorna true quando ela fecha uma média e 'valor' é recalculado.
+bool filtro_adc_amostra(filtro_adc_t *f, uint16_t leitura) {
+    leitura &= 0x0FFF;
+    uint16_t anterior = f->brutas[0];
+    f->brutas[0] = f->brutas[1];
+    f->brutas[1] = leitura;
+    if (f->brutas_validas < 2) {
+        f->brutas_validas++;   // As duas primeiras leituras só abastecem a mediana de 3
+        return false;
+    }
+    f->soma += mediana3(anterior, f->brutas[0], leitura);
+    if (++f->contagem < FILTRO_ADC_SOBREAMOSTRAGEM) {
+        return false;
+    }
+
+    f->janela[f->posicao] = (uint16_t)(f->soma >> FILTRO_ADC_DESLOCAMENTO);
+    f->posicao = (f->posicao + 1) % FILTRO_ADC_MEDIANA;
+    if (f->preenchidas < FILTRO_ADC_MEDIANA) f->preenchidas++;
+    f->soma = 0;
+    f->contagem = 0;
+
+    f->valor = mediana(f);
+    f->atualizacoes++;
+    return true;
+}
+
+// Acrescenta um bloco de leituras; 'passo' pula as de outros canais num buffer intercalado
+void filtro_adc_amostras(filtro_adc_t *f, const uint16_t *leituras, uint32_t quantidade, uint32_t passo) {
+    for (uint32_t i = 0; i < quantidade; i += passo) {
+        filtro_adc_amostra(f, leituras[i]);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef filtro_adc_inc_h
+#define filtro_adc_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cadeia de filtragem de um canal do ADC, toda em inteiros e sem dependência do SDK.
+// 1. Mediana de 3 leituras consecutivas: descarta leituras isoladas fora da curva (o ruído de um
+//    relé chaveando perto do fio) antes da média.
+// 2. Sobreamostragem: a média de FILTRO_ADC_SOBREAMOSTRAGEM leituras de 12 bits vira um valor
+//    de 16 bits (4^4 leituras rendem 4 bits a mais; o ruído do ADC faz o papel de dither).
+// 3. Mediana das últimas FILTRO_ADC_MEDIANA médias: picos e quedas que ocupam menos de metade da
+//    janela (~1 s a 1 kHz, como um farol ou uma sombra passageira) não chegam à saída.
+// O valor filtrado fica em 'valor', pronto para ser lido a qualquer momento sem custo.
+
+#define FILTRO_ADC_SOBREAMOSTRAGEM 256  // Leituras por média (potência de 4)
+#define FILTRO_ADC_DESLOCAMENTO 4       // Soma de 256 leituras de 12 bits (20 bits) >> 4 = 16 bits
+#define FILTRO_ADC_MEDIANA 9            // Médias na janela da mediana (ímpar)
+
+typedef struct {
+    uint16_t brutas[2];                    // Duas últimas leituras, para a mediana de 3
+    uint8_t brutas_validas;
+    uint32_t soma;
+    uint16_t contagem;
+    uint16_t janela[FILTRO_ADC_MEDIANA];   // Últimas médias, em ordem de chegada (circular)
+    uint8_t posicao;
+    uint8_t preenchidas;
+    volatile uint16_t valor;               // Saída: 0..65520 (escala de 16 bits)
+    volatile uint32_t atualizacoes;        // Médias fechadas; 0 = ainda sem valor
+} filtro_adc_t;
+
+void filtro_adc_iniciar(filtro_adc_t *f);
+bool filtro_adc_amostra(filtro_adc_t *f, uint16_t leitura);
+void filtro_adc_amostras(filtro_adc_t *f, const uint16_t *leituras, uint32_t quantidade, uint32_t passo);
+
+#endif
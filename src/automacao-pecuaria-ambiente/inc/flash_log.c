@@ -0,0 +1,347 @@
+#include <stddef.h>
+#include <string.h>
+#include "flash_log.h"
+
+typedef struct {
+    uint32_t tipo;
+    uint32_t sequencia_setor;
+    uint32_t primeira_sequencia;
+    uint32_t crc;
+} cabecalho_setor_t;
+
+// Num log de amostras, os dados são epoch, temperatura, umidade, luminosidade (little-endian) e relés.
+// Dados todos em 0xFF marcam um registro vazio, que só ocupa o lugar de uma sequência pulada.
+typedef struct {
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS];
+    uint8_t sequencia_baixa;   // Byte menos significativo da sequência, para conferência
+    uint32_t crc;
+} registro_t;
+
+_Static_assert(sizeof(cabecalho_setor_t) == FLASH_LOG_TAMANHO_REGISTRO, "cabecalho deve ocupar um slot");
+_Static_assert(sizeof(registro_t) == FLASH_LOG_TAMANHO_REGISTRO, "registro deve ocupar um slot");
+
+// CRC-32 (IEEE 802.3), bit a bit: poucos bytes por registro, sem tabela na RAM
+static uint32_t crc32(const void *dados, uint32_t tamanho) {
+    const uint8_t *p = dados;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (tamanho--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static bool apagado(const void *bytes, uint32_t tamanho) {
+    const uint8_t *p = bytes;
+    for (uint32_t i = 0; i < tamanho; i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static uint32_t deslocamento_slot(const flash_log_t *log, uint32_t setor, uint32_t slot) {
+    return setor * log->dispositivo->tamanho_setor + slot * FLASH_LOG_TAMANHO_REGISTRO;
+}
+
+// Apaga o setor e grava o cabeçalho com a sequência informada
+static bool abrir_setor(flash_log_t *log, uint32_t setor, uint32_t sequencia_setor, uint32_t primeira_sequencia) {
+    flash_dispositivo_t *d = log->dispositivo;
+
+    log->setores[setor].valido = false;
+    if (!d->apagar_setor(d, setor)) return false;
+    log->apagamentos++;
+
+    // A página é gravada inteira; os bytes 0xFF deixam os demais slots intactos
+    memset(log->pagina, 0xFF, d->tamanho_pagina);
+    cabecalho_setor_t cab = {
+        .tipo = log->tipo,
+        .sequencia_setor = sequencia_setor,
+        .primeira_sequencia = primeira_sequencia,
+    };
+    cab.crc = crc32(&cab, offsetof(cabecalho_setor_t, crc));
+    memcpy(log->pagina, &cab, sizeof(cab));
+    if (!d->programar(d, setor * d->tamanho_setor, log->pagina, d->tamanho_pagina)) return false;
+    log->gravacoes_pagina++;
+
+    log->setores[setor] = (flash_log_setor_t){
+        .valido = true,
+        .sequencia_setor = sequencia_setor,
+        .primeira_sequencia = primeira_sequencia,
+    };
+    log->setor_atual = setor;
+    log->slot_atual = 1;
+    log->slot_pagina = 0;
+    log->pendentes = 0;
+    memset(log->pagina, 0xFF, d->tamanho_pagina);
+    return true;
+}
+
+// Callbacks de flash_regiao_t: repassam a operação ao dispositivo base, deslocada
+static void regiao_ler(flash_dispositivo_t *d, uint32_t deslocamento, void *destino, uint32_t tamanho) {
+    flash_regiao_t *r = (flash_regiao_t *)d;
+    r->base->ler(r->base, r->primeiro_setor * d->tamanho_setor + deslocamento, destino, tamanho);
+}
+
+static bool regiao_programar(flash_dispositivo_t *d, uint32_t deslocamento, const void *origem, uint32_t tamanho) {
+    flash_regiao_t *r = (flash_regiao_t *)d;
+    return r->base->programar(r->base, r->primeiro_setor * d->tamanho_setor + deslocamento, origem, tamanho);
+}
+
+static bool regiao_apagar_setor(flash_dispositivo_t *d, uint32_t setor) {
+    flash_regiao_t *r = (flash_regiao_t *)d;
+    return r->base->apagar_setor(r->base, r->primeiro_setor + setor);
+}
+
+// Setores [primeiro_setor, primeiro_setor + num_setores) de 'base', numerados a partir de 0
+flash_dispositivo_t *flash_regiao_iniciar(flash_regiao_t *regiao, flash_dispositivo_t *base, uint32_t primeiro_setor,
+                                          uint32_t num_setores) {
+    *regiao = (flash_regiao_t){
+        .dispositivo = {
+            .tamanho_setor = base->tamanho_setor,
+            .tamanho_pagina = base->tamanho_pagina,
+            .num_setores = num_setores,
+            .ler = regiao_ler,
+            .programar = regiao_programar,
+            .apagar_setor = regiao_apagar_setor,
+        },
+        .base = base,
+        .primeiro_setor = primeiro_setor,
+    };
+    return &regiao->dispositivo;
+}
+
+// Lê os cabeçalhos de todos os setores e localiza o ponto de escrita no setor mais recente.
+// Setores sem cabeçalho válido do tipo pedido ficam de fora e são reaproveitados no rodízio.
+bool flash_log_montar(flash_log_t *log, flash_dispositivo_t *dispositivo, uint32_t tipo) {
+    memset(log, 0, sizeof(*log));
+    log->dispositivo = dispositivo;
+    log->tipo = tipo;
+    log->registros_por_setor = dispositivo->tamanho_setor / FLASH_LOG_TAMANHO_REGISTRO;
+    log->registros_por_pagina = dispositivo->tamanho_pagina / FLASH_LOG_TAMANHO_REGISTRO;
+
+    if (dispositivo->num_setores > FLASH_LOG_MAX_SETORES || dispositivo->tamanho_pagina > sizeof(log->pagina)) {
+        return false;
+    }
+
+    bool encontrou = false;
+    for (uint32_t s = 0; s < dispositivo->num_setores; s++) {
+        cabecalho_setor_t cab;
+        dispositivo->ler(dispositivo, s * dispositivo->tamanho_setor, &cab, sizeof(cab));
+        if (cab.tipo != tipo || cab.crc != crc32(&cab, offsetof(cabecalho_setor_t, crc))) {
+            continue;
+        }
+        log->setores[s] = (flash_log_setor_t){
+            .valido = true,
+            .sequencia_setor = cab.sequencia_setor,
+            .primeira_sequencia = cab.primeira_sequencia,
+        };
+        if (!encontrou || cab.sequencia_setor > log->setores[log->setor_atual].sequencia_setor) {
+            log->setor_atual = s;
+            encontrou = true;
+        }
+    }
+
+    if (!encontrou) {
+        return abrir_setor(log, 0, 1, 0);
+    }
+
+    // Só o setor atual é varrido: o primeiro slot totalmente apagado marca o fim do log.
+    // Um slot parcialmente gravado (queda de energia) não está vazio e é simplesmente pulado.
+    uint8_t slot[FLASH_LOG_TAMANHO_REGISTRO];
+    log->slot_atual = log->registros_por_setor;
+    for (uint32_t i = 1; i < log->registros_por_setor; i++) {
+        dispositivo->ler(dispositivo, deslocamento_slot(log, log->setor_atual, i), slot, sizeof(slot));
+        if (apagado(slot, sizeof(slot))) {
+            log->slot_atual = i;
+            break;
+        }
+    }
+
+    memset(log->pagina, 0xFF, dispositivo->tamanho_pagina);
+    log->slot_pagina = log->slot_atual - log->slot_atual % log->registros_por_pagina;
+    log->pendentes = 0;
+    return true;
+}
+
+// Grava a página em RAM, se houver registros pendentes. Se a flash recusar a gravação, a página
+// continua pendente, para ser tentada de novo.
+bool flash_log_descarregar(flash_log_t *log) {
+    if (log->pendentes == 0) {
+        return true;
+    }
+    flash_dispositivo_t *d = log->dispositivo;
+    log->gravacoes_pagina++;
+    if (!d->programar(d, deslocamento_slot(log, log->setor_atual, log->slot_pagina), log->pagina, d->tamanho_pagina)) {
+        log->falhas++;
+        return false;
+    }
+    log->pendentes = 0;
+
+    // Os slots já gravados voltam a 0xFF na cópia em RAM: regravá-los não alteraria nada
+    memset(log->pagina, 0xFF, d->tamanho_pagina);
+    return true;
+}
+
+uint32_t flash_log_proxima_sequencia(const flash_log_t *log) {
+    const flash_log_setor_t *atual = &log->setores[log->setor_atual];
+    return atual->primeira_sequencia + log->slot_atual - 1;
+}
+
+// Sequência do registro mais antigo ainda presente na flash
+uint32_t flash_log_primeira_sequencia(const flash_log_t *log) {
+    uint32_t primeira = flash_log_proxima_sequencia(log);
+    for (uint32_t s = 0; s < log->dispositivo->num_setores; s++) {
+        if (log->setores[s].valido && log->setores[s].primeira_sequencia < primeira) {
+            primeira = log->setores[s].primeira_sequencia;
+        }
+    }
+    return primeira;
+}
+
+// Acrescenta um registro ao log. Retorna false se ele foi recusado porque a flash recusou uma
+// operação de que ele dependia: a gravação da página anterior ou a abertura do setor seguinte.
+// As duas são tentadas de novo na próxima anexação. Antes delas, nada pode ser gravado adiante:
+// com o setor seguinte pela metade, a página iria para o início do setor depois dele, sobre
+// registros válidos; e depois de uma página não gravada, a montagem tomaria os slots apagados
+// pelo fim do log e reutilizaria as sequências seguintes.
+// Um registro aceito pode estar ainda só na página em RAM (veja flash_log_descarregar()).
+bool flash_log_anexar_dados(flash_log_t *log, const void *dados) {
+    flash_dispositivo_t *d = log->dispositivo;
+
+    if (log->slot_atual >= log->registros_por_setor) {
+        if (!flash_log_descarregar(log)) {
+            return false;
+        }
+        uint32_t proximo = (log->setor_atual + 1) % d->num_setores;
+        if (!abrir_setor(log, proximo, log->setores[log->setor_atual].sequencia_setor + 1, flash_log_proxima_sequencia(log))) {
+            log->falhas++;
+            return false;
+        }
+    }
+    if (log->slot_atual >= log->slot_pagina + log->registros_por_pagina) {
+        if (!flash_log_descarregar(log)) {
+            return false;
+        }
+        log->slot_pagina = log->slot_atual - log->slot_atual % log->registros_por_pagina;
+    }
+
+    registro_t r = {.sequencia_baixa = (uint8_t)flash_log_proxima_sequencia(log)};
+    memcpy(r.dados, dados, sizeof(r.dados));
+    r.crc = crc32(&r, offsetof(registro_t, crc));
+
+    memcpy(log->pagina + (log->slot_atual - log->slot_pagina) * FLASH_LOG_TAMANHO_REGISTRO, &r, sizeof(r));
+    log->pendentes++;
+    log->slot_atual++;
+
+    // Página cheia: grava agora (ou na próxima anexação, se a flash recusar)
+    if (log->slot_atual == log->slot_pagina + log->registros_por_pagina && flash_log_descarregar(log)) {
+        log->slot_pagina = log->slot_atual;
+    }
+    return true;
+}
+
+// Leva a próxima sequência do log até 'sequencia', para logs em que a sequência tem significado
+// próprio (nas camadas, o número do balde). As sequências puladas que cabem no setor atual viram
+// registros vazios; as que não cabem ficam de fora, num setor novo que começa em 'sequencia'. Um
+// log ainda sem registros apenas recomeça o setor atual em 'sequencia'.
+// Retorna false se 'sequencia' já passou ou se a flash recusou uma operação; parte das puladas
+// pode já ter sido preenchida, e uma nova chamada continua de onde parou.
+bool flash_log_avancar(flash_log_t *log, uint32_t sequencia) {
+    uint32_t proxima = flash_log_proxima_sequencia(log);
+    if (sequencia <= proxima) {
+        return sequencia == proxima;
+    }
+
+    const flash_log_setor_t *atual = &log->setores[log->setor_atual];
+    if (flash_log_primeira_sequencia(log) == proxima && log->slot_atual == 1) {
+        if (!abrir_setor(log, log->setor_atual, atual->sequencia_setor, sequencia)) {
+            log->falhas++;
+            return false;
+        }
+        return true;
+    }
+    if (sequencia - proxima > log->registros_por_setor - log->slot_atual) {
+        if (!flash_log_descarregar(log)) {
+            return false;
+        }
+        uint32_t proximo = (log->setor_atual + 1) % log->dispositivo->num_setores;
+        if (!abrir_setor(log, proximo, atual->sequencia_setor + 1, sequencia)) {
+            log->falhas++;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t vazio[FLASH_LOG_TAMANHO_DADOS];
+    memset(vazio, 0xFF, sizeof(vazio));
+    while (flash_log_proxima_sequencia(log) < sequencia) {
+        if (!flash_log_anexar_dados(log, vazio)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lê um registro pela sequência (inclusive os que ainda estão na página em RAM).
+// Retorna false se a sequência não existir mais, se ela foi pulada (registro vazio ou slot
+// apagado) ou se o registro estiver corrompido.
+bool flash_log_ler_dados(flash_log_t *log, uint32_t sequencia, void *dados) {
+    flash_dispositivo_t *d = log->dispositivo;
+    uint32_t capacidade_setor = log->registros_por_setor - 1;
+
+    for (uint32_t s = 0; s < d->num_setores; s++) {
+        const flash_log_setor_t *setor = &log->setores[s];
+        if (!setor->valido || sequencia < setor->primeira_sequencia || sequencia - setor->primeira_sequencia >= capacidade_setor) {
+            continue;
+        }
+        uint32_t slot = sequencia - setor->primeira_sequencia + 1;
+        if (s == log->setor_atual && slot >= log->slot_atual) {
+            return false;
+        }
+
+        registro_t r;
+        if (s == log->setor_atual && slot >= log->slot_atual - log->pendentes) {
+            memcpy(&r, log->pagina + (slot - log->slot_pagina) * FLASH_LOG_TAMANHO_REGISTRO, sizeof(r));
+        } else {
+            d->ler(d, deslocamento_slot(log, s, slot), &r, sizeof(r));
+        }
+        if (apagado(&r, sizeof(r))) {
+            return false;
+        }
+        if (r.crc != crc32(&r, offsetof(registro_t, crc)) || r.sequencia_baixa != (uint8_t)sequencia) {
+            log->registros_corrompidos++;
+            return false;
+        }
+        if (apagado(r.dados, sizeof(r.dados))) {
+            return false;
+        }
+        memcpy(dados, r.dados, sizeof(r.dados));
+        return true;
+    }
+    return false;
+}
+
+bool flash_log_anexar(flash_log_t *log, const amostra_t *amostra) {
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS];
+    memcpy(dados, &amostra->epoch, 4);
+    memcpy(dados + 4, &amostra->temperatura, 2);
+    memcpy(dados + 6, &amostra->umidade, 2);
+    memcpy(dados + 8, &amostra->luminosidade, 2);
+    dados[10] = (uint8_t)amostra->reles;
+    return flash_log_anexar_dados(log, dados);
+}
+
+bool flash_log_ler(flash_log_t *log, uint32_t sequencia, amostra_t *amostra) {
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS];
+    if (!flash_log_ler_dados(log, sequencia, dados)) {
+        return false;
+    }
+    *amostra = (amostra_t){.reles = dados[10]};
+    memcpy(&amostra->epoch, dados, 4);
+    memcpy(&amostra->temperatura, dados + 4, 2);
+    memcpy(&amostra->umidade, dados + 6, 2);
+    memcpy(&amostra->luminosidade, dados + 8, 2);
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef flash_log_inc_h
+#define flash_log_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "historico.h"
+
+// Log persistente só de anexação (append-only), numa região reservada da flash: as amostras do
+// histórico e, em logs à parte, os baldes fechados das camadas (inc/camadas.h).
+//
+// Cada setor começa com um cabeçalho (tipo do log, número de sequência do setor e sequência do
+// primeiro registro) seguido de registros de 16 bytes com CRC, cada um com 11 bytes de dados. Os setores são apagados em rodízio, o que nivela o
+// desgaste. Os registros ficam num buffer de página em RAM e só são gravados quando a página
+// enche ou em flash_log_descarregar(). A montagem lê apenas os cabeçalhos dos setores e varre só
+// o setor mais recente. Registros com CRC inválido (gravação interrompida) são ignorados.
+//
+// O acesso ao hardware passa por flash_dispositivo_t, de modo que o mesmo código roda sobre a
+// flash do RP2040 (flash_pico.c) ou sobre qualquer memória que imite uma flash NOR.
+
+#define FLASH_LOG_TAMANHO_REGISTRO 16
+#define FLASH_LOG_TAMANHO_DADOS 11
+#define FLASH_LOG_MAX_SETORES 256
+
+// Tipo do log, gravado no cabeçalho de cada setor: a montagem ignora setores de outro tipo
+#define FLASH_LOG_AMOSTRAS 0x474F4C48u   // "HLOG"
+
+typedef struct flash_dispositivo {
+    uint32_t tamanho_setor;     // Unidade de apagamento (4096 no RP2040)
+    uint32_t tamanho_pagina;    // Unidade de gravação (256 no RP2040)
+    uint32_t num_setores;
+    void (*ler)(struct flash_dispositivo *dispositivo, uint32_t deslocamento, void *destino, uint32_t tamanho);
+    bool (*programar)(struct flash_dispositivo *dispositivo, uint32_t deslocamento, const void *origem, uint32_t tamanho);
+    bool (*apagar_setor)(struct flash_dispositivo *dispositivo, uint32_t setor);
+    void *contexto;
+} flash_dispositivo_t;
+
+// Faixa de setores de outro dispositivo, vista como um dispositivo à parte: os logs repartem
+// assim a mesma região da flash
+typedef struct {
+    flash_dispositivo_t dispositivo;
+    flash_dispositivo_t *base;
+    uint32_t primeiro_setor;
+} flash_regiao_t;
+
+typedef struct {
+    bool valido;
+    uint32_t sequencia_setor;   // Cresce a cada setor aberto; o maior é o setor atual
+    uint32_t primeira_sequencia;// Sequência do primeiro registro do setor
+} flash_log_setor_t;
+
+typedef struct {
+    flash_dispositivo_t *dispositivo;
+    uint32_t tipo;
+    uint32_t registros_por_setor;
+    uint32_t registros_por_pagina;
+
+    // Índice em RAM, reconstruído a partir dos cabeçalhos na montagem
+    flash_log_setor_t setores[FLASH_LOG_MAX_SETORES];
+    uint32_t setor_atual;
+    uint32_t slot_atual;        // Próximo slot livre no setor atual (o slot 0 é o cabeçalho)
+
+    // Página em montagem na RAM
+    uint8_t pagina[256];
+    uint32_t slot_pagina;       // Primeiro slot coberto pela página em RAM
+    uint32_t pendentes;         // Registros na página ainda não gravados
+
+    uint32_t gravacoes_pagina;  // Estatísticas de uso da flash
+    uint32_t apagamentos;
+    uint32_t registros_corrompidos;
+    uint32_t falhas;            // Gravações ou aberturas de setor que a flash recusou
+} flash_log_t;
+
+flash_dispositivo_t *flash_regiao_iniciar(flash_regiao_t *regiao, flash_dispositivo_t *base, uint32_t primeiro_setor,
+                                          uint32_t num_setores);
+
+bool flash_log_montar(flash_log_t *log, flash_dispositivo_t *dispositivo, uint32_t tipo);
+bool flash_log_descarregar(flash_log_t *log);
+uint32_t flash_log_primeira_sequencia(const flash_log_t *log);
+uint32_t flash_log_proxima_sequencia(const flash_log_t *log);
+
+// Registros de FLASH_LOG_TAMANHO_DADOS bytes, de conteúdo livre
+bool flash_log_anexar_dados(flash_log_t *log, const void *dados);
+bool flash_log_ler_dados(flash_log_t *log, uint32_t sequencia, void *dados);
+bool flash_log_avancar(flash_log_t *log, uint32_t sequencia);
+
+// Amostras do histórico (logs FLASH_LOG_AMOSTRAS)
+bool flash_log_anexar(flash_log_t *log, const amostra_t *amostra);
+bool flash_log_ler(flash_log_t *log, uint32_t sequencia, amostra_t *amostra);
+
+#endif
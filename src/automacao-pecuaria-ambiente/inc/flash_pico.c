@@ -0,0 +1,65 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "flash_pico.h"
+
+// Implementação de flash_dispositivo_t sobre a flash QSPI do RP2040.
+// Leitura direta pela janela XIP; gravação e apagamento via flash_safe_execute(), que suspende
+// o outro núcleo (que deve ter chamado multicore_lockout_victim_init) e as interrupções.
+// Antes de o núcleo 1 ser iniciado, basta desabilitar as interrupções.
+
+typedef struct {
+    uint32_t deslocamento;
+    const void *origem;
+    uint32_t tamanho;
+} operacao_flash_t;
+
+static void executar_programacao(void *parametro) {
+    operacao_flash_t *op = parametro;
+    flash_range_program(op->deslocamento, op->origem, op->tamanho);
+}
+
+static void executar_apagamento(void *parametro) {
+    operacao_flash_t *op = parametro;
+    flash_range_erase(op->deslocamento, op->tamanho);
+}
+
+static bool executar_com_seguranca(void (*funcao)(void *), operacao_flash_t *op) {
+    if (!multicore_lockout_victim_is_initialized(1 - get_core_num())) {
+        uint32_t interrupcoes = save_and_disable_interrupts();
+        funcao(op);
+        restore_interrupts(interrupcoes);
+        return true;
+    }
+    return flash_safe_execute(funcao, op, 100) == PICO_OK;
+}
+
+static void flash_pico_ler(flash_dispositivo_t *d, uint32_t deslocamento, void *destino, uint32_t tamanho) {
+    memcpy(destino, (const void *)(XIP_BASE + FLASH_RESERVADA_DESLOCAMENTO + deslocamento), tamanho);
+}
+
+static bool flash_pico_programar(flash_dispositivo_t *d, uint32_t deslocamento, const void *origem, uint32_t tamanho) {
+    operacao_flash_t op = {.deslocamento = FLASH_RESERVADA_DESLOCAMENTO + deslocamento, .origem = origem, .tamanho = tamanho};
+    return executar_com_seguranca(executar_programacao, &op);
+}
+
+static bool flash_pico_apagar_setor(flash_dispositivo_t *d, uint32_t setor) {
+    operacao_flash_t op = {.deslocamento = FLASH_RESERVADA_DESLOCAMENTO + setor * FLASH_SECTOR_SIZE, .tamanho = FLASH_SECTOR_SIZE};
+    return executar_com_seguranca(executar_apagamento, &op);
+}
+
+static flash_dispositivo_t dispositivo = {
+    .tamanho_setor = FLASH_SECTOR_SIZE,
+    .tamanho_pagina = FLASH_PAGE_SIZE,
+    .num_setores = FLASH_RESERVADA_SETORES,
+    .ler = flash_pico_ler,
+    .programar = flash_pico_programar,
+    .apagar_setor = flash_pico_apagar_setor,
+};
+
+flash_dispositivo_t *flash_pico_dispositivo(void) {
+    return &dispositivo;
+}
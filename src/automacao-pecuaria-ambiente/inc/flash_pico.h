@@ -0,0 +1,26 @@
+#ifndef flash_pico_inc_h
+#define flash_pico_inc_h
+
+#include "flash_log.h"
+
+// Região reservada aos logs no fim da flash do Pico W, repartida em setores (flash_regiao_t):
+//   baldes de 1 h (inc/camadas.h)     38 setores
+//   baldes de 5 min                   18 setores
+//   amostras                          64 setores = 256 KB, ~16 mil amostras
+// Cada camada guarda os seus baldes com um setor de folga para o que o rodízio apaga de uma vez.
+// O log de amostras fica no fim, onde sempre esteve. O firmware precisa caber abaixo de
+// FLASH_RESERVADA_DESLOCAMENTO: a compilação falha se não couber (verificar_flash.cmake).
+#define FLASH_CAMADA_1H_SETORES 38
+#define FLASH_CAMADA_5MIN_SETORES 18
+#define FLASH_LOG_SETORES 64
+
+#define FLASH_CAMADA_1H_INICIO 0
+#define FLASH_CAMADA_5MIN_INICIO (FLASH_CAMADA_1H_INICIO + FLASH_CAMADA_1H_SETORES)
+#define FLASH_LOG_INICIO (FLASH_CAMADA_5MIN_INICIO + FLASH_CAMADA_5MIN_SETORES)
+#define FLASH_RESERVADA_SETORES (FLASH_LOG_INICIO + FLASH_LOG_SETORES)
+#define FLASH_RESERVADA_DESLOCAMENTO (PICO_FLASH_SIZE_BYTES - FLASH_RESERVADA_SETORES * FLASH_SECTOR_SIZE)
+
+// Toda a região reservada, de FLASH_RESERVADA_SETORES setores
+flash_dispositivo_t *flash_pico_dispositivo(void);
+
+#endif
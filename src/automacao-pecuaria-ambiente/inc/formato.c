@@ -0,0 +1,75 @@
+#include "formato.h"
+
+char *formato_texto(char *destino, const char *texto) {
+    while (*texto) {
+        *destino++ = *texto++;
+    }
+    *destino = '\0';
+    return destino;
+}
+
+static const uint32_t POTENCIAS_DE_10[] = {
+    10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+// Quantos algarismos 'valor' tem, só com comparações: as divisões ficam para os algarismos
+static int contar_algarismos(uint32_t valor) {
+    int n = 1;
+    while (n <= 9 && valor >= POTENCIAS_DE_10[n - 1]) {
+        n++;
+    }
+    return n;
+}
+
+// Escreve 'valor' com exatamente 'digitos' algarismos, do último para o primeiro
+static void algarismos(char *destino, uint32_t valor, int digitos) {
+    for (int i = digitos - 1; i >= 0; i--) {
+        destino[i] = '0' + valor % 10;
+        valor /= 10;
+    }
+}
+
+char *formato_inteiro(char *destino, int32_t valor) {
+    uint32_t v = valor < 0 ? 0u - (uint32_t)valor : (uint32_t)valor;
+    if (valor < 0) {
+        *destino++ = '-';
+    }
+    int n = contar_algarismos(v);
+    algarismos(destino, v, n);
+    destino[n] = '\0';
+    return destino + n;
+}
+
+char *formato_decimos(char *destino, int32_t decimos) {
+    uint32_t v = decimos < 0 ? 0u - (uint32_t)decimos : (uint32_t)decimos;
+    if (decimos < 0) {
+        *destino++ = '-';
+    }
+    int n = contar_algarismos(v / 10);
+    algarismos(destino, v / 10, n);
+    destino[n] = '.';
+    destino[n + 1] = '0' + v % 10;
+    destino[n + 2] = '\0';
+    return destino + n + 2;
+}
+
+// Sem algarismos além de 'digitos': o valor é truncado à esquerda, como um campo de largura fixa
+char *formato_zeros(char *destino, uint32_t valor, int digitos) {
+    algarismos(destino, valor, digitos);
+    destino[digitos] = '\0';
+    return destino + digitos;
+}
+
+char *formato_data_hora(char *destino, const datetime_t *t) {
+    char *p = formato_zeros(destino, t->year, 4);
+    *p++ = '-';
+    p = formato_zeros(p, t->month, 2);
+    *p++ = '-';
+    p = formato_zeros(p, t->day, 2);
+    *p++ = ' ';
+    p = formato_zeros(p, t->hour, 2);
+    *p++ = ':';
+    p = formato_zeros(p, t->min, 2);
+    *p++ = ':';
+    return formato_zeros(p, t->sec, 2);
+}
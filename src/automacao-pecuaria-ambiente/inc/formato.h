@@ -0,0 +1,23 @@
+#ifndef formato_inc_h
+#define formato_inc_h
+
+#include <stdint.h>
+#include "pico/util/datetime.h"
+
+// Formatação de números e datas sem printf: o RP2040 não tem FPU e o %f puxa o printf de ponto
+// flutuante inteiro. As leituras andam em ponto fixo (décimos) do sensor até a saída.
+// Cada função escreve a partir de 'destino', termina com '\0' e retorna o ponteiro para ele,
+// para encadear: p = formato_decimos(formato_texto(p, "Temp: "), 285) -> "Temp: 28.5".
+// O chamador garante o espaço; os tamanhos máximos (com o '\0') estão abaixo.
+
+#define FORMATO_INTEIRO_MAX 12      // "-2147483648"
+#define FORMATO_DECIMOS_MAX 13      // "-214748364.8"
+#define FORMATO_DATA_HORA_MAX 20    // "2025-07-01 12:00:00"
+
+char *formato_texto(char *destino, const char *texto);
+char *formato_inteiro(char *destino, int32_t valor);
+char *formato_decimos(char *destino, int32_t decimos);         // 285 -> "28.5", -5 -> "-0.5"
+char *formato_zeros(char *destino, uint32_t valor, int digitos); // formato_zeros(p, 7, 2) -> "07"
+char *formato_data_hora(char *destino, const datetime_t *t);
+
+#endif
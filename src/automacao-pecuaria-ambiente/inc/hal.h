@@ -0,0 +1,86 @@
+#ifndef hal_inc_h
+#define hal_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "pico/util/datetime.h"
+
+// Camada de abstração do hardware: tudo o que o firmware usa do RP2040 e do CYW43 e que não cabe
+// nos drivers com interface própria (inc/dht11.h, inc/amostragem_adc.h, flash_dispositivo_t).
+// Há duas implementações, escolhidas na ligação:
+//   inc/hal_pico.c      - a placa, sobre o SDK do Pico;
+//   simulador/hal_host.c - o simulador no Linux, com relógio virtual e periféricos simulados.
+// Os tempos são sempre em microssegundos desde o boot; HAL_PRAZO_NENHUM é "sem prazo".
+
+#define HAL_PRAZO_NENHUM UINT64_MAX
+
+// Palavra do I2C no formato do registrador IC_DATA_CMD: byte nos 8 bits de baixo e este bit para
+// gerar um STOP depois dele
+#define HAL_I2C_STOP (1u << 9)
+
+// Console e tempo
+void hal_iniciar(void);                    // Console pronto (na placa, com pausa para abrir o monitor serial)
+uint64_t hal_tempo_us(void);
+
+// GPIO dos relés
+void hal_gpio_saida(uint pino);
+void hal_gpio_escrever(uint pino, bool valor);
+bool hal_gpio_ler(uint pino);
+
+// Relógio de tempo real
+void hal_rtc_iniciar(const datetime_t *t);
+void hal_rtc_ler(datetime_t *t);
+void hal_rtc_ajustar(const datetime_t *t);
+
+// I2C: fila de palavras enviada sem bloquear (transações consecutivas separadas por HAL_I2C_STOP)
+// e escrita simples bloqueante. Um único escravo por barramento de cada vez.
+void hal_i2c_iniciar(uint barramento, uint sda, uint scl, uint32_t frequencia_hz);
+void hal_i2c_enviar(uint barramento, uint8_t endereco, const uint16_t *palavras, int quantidade);
+bool hal_i2c_ocupado(uint barramento);
+void hal_i2c_escrever(uint barramento, uint8_t endereco, const uint8_t *dados, size_t tamanho);
+
+// Fita de LEDs WS2812B, um GRB de 24 bits (alinhado à esquerda) por palavra. hal_leds_enviar()
+// não bloqueia; retorna false se o quadro anterior ainda estiver em trânsito ou no latch.
+void hal_leds_iniciar(uint pino, uint quantidade);
+bool hal_leds_enviar(const uint32_t *quadro, uint quantidade);
+
+// Rede (Wi-Fi e lwIP). As callbacks do lwIP e a função de hal_rede_trabalho() rodam num contexto
+// próprio; quem mexe no lwIP ou no histórico fora dele usa hal_rede_travar()/hal_rede_liberar().
+bool hal_rede_iniciar(void);
+void hal_rede_conectar(const char *ssid, const char *senha);
+bool hal_rede_enlace(void);
+void hal_rede_travar(void);
+void hal_rede_liberar(void);
+void hal_rede_trabalho(void (*funcao)(void));
+void hal_rede_sinalizar(void);             // Agenda a função de hal_rede_trabalho(); pode vir do núcleo 1
+void hal_rede_processar(void);
+void hal_rede_aguardar(uint64_t prazo_us); // Dorme até o prazo ou até haver trabalho de rede
+
+// Núcleo 1: 'iniciar' roda uma vez, já no núcleo 1; depois 'passo' roda em laço e retorna até
+// quando o núcleo pode dormir. hal_nucleo1_acordar() encurta esse sono.
+void hal_nucleo1_lancar(void (*iniciar)(void), uint64_t (*passo)(void), uint32_t *pilha, size_t tamanho_pilha);
+void hal_nucleo1_acordar(void);
+
+// Regiões da flash reservadas aos logs (inc/flash_log.h): o de amostras e o dos baldes fechados de
+// uma camada (CAMADA_5MIN ou CAMADA_1H, inc/camadas.h; NULL para as demais)
+struct flash_dispositivo *hal_flash_log(void);
+struct flash_dispositivo *hal_flash_camada(int camada);
+
+// Memória, para as métricas (inc/metricas.h); só implementadas com METRICAS.
+// hal_rede_memoria() preenche até 'maximo' pools da pilha de rede e retorna quantos preencheu.
+// hal_pilha_uso() dá a maior profundidade já alcançada na pilha de um núcleo, pintada antes de ele
+// começar; retorna false se a plataforma não a mede.
+typedef struct {
+    const char *nome;
+    uint32_t uso;
+    uint32_t maximo;        // Maior uso desde o boot
+    uint32_t capacidade;    // 0 = sem limite fixo
+    uint32_t falhas;        // Alocações recusadas
+} hal_memoria_t;
+
+int hal_rede_memoria(hal_memoria_t *pools, int maximo);
+bool hal_pilha_uso(uint nucleo, uint32_t *uso, uint32_t *tamanho);
+
+#endif
@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "pico/multicore.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/rtc.h"
+#include "ws2818b.pio.h"
+#include "hal.h"
+#include "flash_pico.h"
+#include "camadas.h"
+#if METRICAS
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#endif
+
+// Implementação de inc/hal.h sobre o SDK do Pico W
+
+static absolute_time_t para_absoluto(uint64_t prazo_us) {
+    return prazo_us >= (uint64_t)INT64_MAX ? at_the_end_of_time : from_us_since_boot(prazo_us);
+}
+
+// --- PILHAS ---
+#if METRICAS
+// As pilhas são pintadas com um padrão antes do uso; a palavra pintada mais funda que mudou dá a
+// maior profundidade já alcançada. A do núcleo 0 vem do memmap do SDK (PICO_STACK_SIZE, na
+// SCRATCH_Y); a do núcleo 1 é a passada a hal_nucleo1_lancar().
+#define PILHA_PADRAO 0xA5A5A5A5u
+#define PILHA_MARGEM_PALAVRAS 32   // Não pintadas logo abaixo do quadro de quem pinta a pilha em uso
+
+extern uint32_t __StackBottom, __StackTop;
+static uint32_t *pilha_nucleo1;
+static uint32_t *pilha_nucleo1_fim;
+
+// Volatile, para não virar um memset que usaria a própria região pintada
+static void pintar_pilha(uint32_t *inicio, uint32_t *fim) {
+    for (volatile uint32_t *p = inicio; p < fim; p++) {
+        *p = PILHA_PADRAO;
+    }
+}
+
+bool hal_pilha_uso(uint nucleo, uint32_t *uso, uint32_t *tamanho) {
+    const uint32_t *inicio = nucleo == 0 ? &__StackBottom : pilha_nucleo1;
+    const uint32_t *fim = nucleo == 0 ? &__StackTop : pilha_nucleo1_fim;
+    if (!inicio) {
+        return false;
+    }
+    const uint32_t *p = inicio;
+    while (p < fim && *p == PILHA_PADRAO) {
+        p++;
+    }
+    *uso = (fim - p) * sizeof(uint32_t);
+    *tamanho = (fim - inicio) * sizeof(uint32_t);
+    return true;
+}
+#endif
+
+// --- CONSOLE E TEMPO ---
+void hal_iniciar(void) {
+#if METRICAS
+    // A pilha do núcleo 0 já está em uso: só a parte abaixo deste quadro
+    uint32_t marcador;
+    pintar_pilha(&__StackBottom, &marcador - PILHA_MARGEM_PALAVRAS);
+#endif
+    stdio_init_all();
+    sleep_ms(3000); // Pausa para abrir o monitor serial
+}
+
+uint64_t hal_tempo_us(void) {
+    return time_us_64();
+}
+
+// --- GPIO ---
+void hal_gpio_saida(uint pino) {
+    gpio_init(pino);
+    gpio_set_dir(pino, GPIO_OUT);
+}
+
+void hal_gpio_escrever(uint pino, bool valor) {
+    gpio_put(pino, valor);
+}
+
+bool hal_gpio_ler(uint pino) {
+    return gpio_get(pino);
+}
+
+// --- RTC ---
+void hal_rtc_iniciar(const datetime_t *t) {
+    rtc_init();
+    rtc_set_datetime((datetime_t *)t);
+}
+
+void hal_rtc_ler(datetime_t *t) {
+    rtc_get_datetime(t);
+}
+
+void hal_rtc_ajustar(const datetime_t *t) {
+    rtc_set_datetime((datetime_t *)t);
+}
+
+// --- I2C ---
+// A fila de palavras vai do DMA direto ao registrador IC_DATA_CMD; o controlador gera um novo
+// START depois de cada STOP, então várias transações seguem no mesmo disparo de DMA.
+static int i2c_dma[2] = {-1, -1};
+
+static i2c_inst_t *instancia_i2c(uint barramento) {
+    return barramento ? i2c1 : i2c0;
+}
+
+void hal_i2c_iniciar(uint barramento, uint sda, uint scl, uint32_t frequencia_hz) {
+    i2c_init(instancia_i2c(barramento), frequencia_hz);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+    if (i2c_dma[barramento] < 0) {
+        i2c_dma[barramento] = dma_claim_unused_channel(true);
+    }
+}
+
+void hal_i2c_enviar(uint barramento, uint8_t endereco, const uint16_t *palavras, int quantidade) {
+    i2c_inst_t *i2c = instancia_i2c(barramento);
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+
+    // O endereço do escravo só pode ser trocado com o bloco desabilitado
+    hw->enable = 0;
+    hw->tar = endereco;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+    hw->enable = 1;
+
+    dma_channel_config c = dma_channel_get_default_config(i2c_dma[barramento]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure(i2c_dma[barramento], &c, &hw->data_cmd, palavras, quantidade, true);
+}
+
+// Indica se ainda há bytes a caminho do escravo (no DMA, na FIFO ou no barramento)
+bool hal_i2c_ocupado(uint barramento) {
+    if (i2c_dma[barramento] < 0) {
+        return false;
+    }
+    i2c_hw_t *hw = i2c_get_hw(instancia_i2c(barramento));
+
+    // Sem ACK do escravo: descarta o restante da fila para não travar
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        dma_channel_abort(i2c_dma[barramento]);
+        (void)hw->clr_tx_abrt;
+        return false;
+    }
+    if (dma_channel_is_busy(i2c_dma[barramento])) {
+        return true;
+    }
+    return !(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+void hal_i2c_escrever(uint barramento, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    while (hal_i2c_ocupado(barramento)) {
+        tight_loop_contents();
+    }
+    i2c_get_hw(instancia_i2c(barramento))->dma_cr = 0;
+    i2c_write_blocking(instancia_i2c(barramento), endereco, dados, tamanho, false);
+}
+
+// --- LEDS WS2812B ---
+// O DMA entrega o quadro inteiro à FIFO do PIO, uma palavra por pixel. O quadro fica num buffer
+// próprio, para que o chamador possa remontar o seu logo depois do envio.
+#define LEDS_MAX 64
+// Tempo, após o fim do DMA, para a FIFO esvaziar (até 9 palavras de 30 us) e o pulso de reset (>= 80 us) terminar
+#define LEDS_LATCH_US 400
+
+static PIO leds_pio;
+static uint leds_sm;
+static int leds_dma;
+static uint32_t leds_quadro[LEDS_MAX];
+static volatile bool leds_transmitindo = false;
+static volatile uint32_t leds_latch_ate_us = 0;
+
+// Fim do DMA: o latch dos LEDs passa a contar a partir daqui
+static void leds_dma_handler(void) {
+    if (dma_channel_get_irq0_status(leds_dma)) {
+        dma_channel_acknowledge_irq0(leds_dma);
+        leds_latch_ate_us = time_us_32() + LEDS_LATCH_US;
+        leds_transmitindo = false;
+    }
+}
+
+void hal_leds_iniciar(uint pino, uint quantidade) {
+    uint offset = pio_add_program(pio0, &ws2818b_program);
+    leds_pio = pio0;
+    int sm = pio_claim_unused_sm(leds_pio, false);
+    if (sm < 0) {
+        leds_pio = pio1;
+        sm = pio_claim_unused_sm(leds_pio, true);
+    }
+    leds_sm = sm;
+    ws2818b_program_init(leds_pio, leds_sm, offset, pino, 800000.f);
+
+    leds_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(leds_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(leds_pio, leds_sm, true));
+    dma_channel_configure(leds_dma, &c, &leds_pio->txf[leds_sm], leds_quadro, quantidade, false);
+
+    // A interrupção fica no núcleo que inicia os LEDs
+    dma_channel_set_irq0_enabled(leds_dma, true);
+    irq_add_shared_handler(DMA_IRQ_0, leds_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+bool hal_leds_enviar(const uint32_t *quadro, uint quantidade) {
+    if (leds_transmitindo || (int32_t)(leds_latch_ate_us - time_us_32()) > 0) {
+        return false;
+    }
+    if (quantidade > LEDS_MAX) {
+        quantidade = LEDS_MAX;
+    }
+    memcpy(leds_quadro, quadro, quantidade * sizeof(uint32_t));
+    leds_transmitindo = true;
+    dma_channel_transfer_from_buffer_now(leds_dma, leds_quadro, quantidade);
+    return true;
+}
+
+// --- REDE ---
+static void (*funcao_trabalho)(void);
+
+static void executar_trabalho(async_context_t *contexto, async_when_pending_worker_t *trabalhador) {
+    funcao_trabalho();
+}
+
+static async_when_pending_worker_t trabalhador = {.do_work = executar_trabalho};
+
+bool hal_rede_iniciar(void) {
+    if (cyw43_arch_init()) {
+        return false;
+    }
+    cyw43_arch_enable_sta_mode();
+    return true;
+}
+
+void hal_rede_conectar(const char *ssid, const char *senha) {
+    cyw43_arch_wifi_connect_async(ssid, senha, CYW43_AUTH_WPA2_AES_PSK);
+}
+
+bool hal_rede_enlace(void) {
+    return cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP;
+}
+
+void hal_rede_travar(void) {
+    cyw43_arch_lwip_begin();
+}
+
+void hal_rede_liberar(void) {
+    cyw43_arch_lwip_end();
+}
+
+void hal_rede_trabalho(void (*funcao)(void)) {
+    funcao_trabalho = funcao;
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &trabalhador);
+}
+
+void hal_rede_sinalizar(void) {
+    async_context_set_work_pending(cyw43_arch_async_context(), &trabalhador);
+}
+
+void hal_rede_processar(void) {
+    cyw43_arch_poll();
+}
+
+void hal_rede_aguardar(uint64_t prazo_us) {
+    cyw43_arch_wait_for_work_until(para_absoluto(prazo_us));
+}
+
+// --- NÚCLEO 1 ---
+static void (*nucleo1_iniciar)(void);
+static uint64_t (*nucleo1_passo)(void);
+
+static void nucleo1_principal(void) {
+    // Permite ao núcleo 0 suspender este núcleo durante gravações na flash
+    multicore_lockout_victim_init();
+    nucleo1_iniciar();
+    while (true) {
+        // Dorme até o prazo ou até o núcleo 0 enviar um comando (__sev)
+        best_effort_wfe_or_timeout(para_absoluto(nucleo1_passo()));
+    }
+}
+
+void hal_nucleo1_lancar(void (*iniciar)(void), uint64_t (*passo)(void), uint32_t *pilha, size_t tamanho_pilha) {
+    nucleo1_iniciar = iniciar;
+    nucleo1_passo = passo;
+#if METRICAS
+    pilha_nucleo1 = pilha;
+    pilha_nucleo1_fim = pilha + tamanho_pilha / sizeof(uint32_t);
+    pintar_pilha(pilha_nucleo1, pilha_nucleo1_fim);
+#endif
+    multicore_launch_core1_with_stack(nucleo1_principal, pilha, tamanho_pilha);
+}
+
+void hal_nucleo1_acordar(void) {
+    __sev();
+}
+
+// --- FLASH ---
+// Cada camada guarda ao menos os seus baldes fora o setor de folga (255 registros por setor)
+#define REGISTROS_POR_SETOR (FLASH_SECTOR_SIZE / FLASH_LOG_TAMANHO_REGISTRO - 1)
+_Static_assert((FLASH_CAMADA_5MIN_SETORES - 1) * REGISTROS_POR_SETOR >= CAMADA_5MIN_BALDES, "setores de 5 min insuficientes");
+_Static_assert((FLASH_CAMADA_1H_SETORES - 1) * REGISTROS_POR_SETOR >= CAMADA_1H_BALDES, "setores de 1 h insuficientes");
+
+static flash_regiao_t regiao_log;
+static flash_regiao_t regiao_camadas[CAMADAS_NUM];
+
+struct flash_dispositivo *hal_flash_log(void) {
+    return flash_regiao_iniciar(&regiao_log, flash_pico_dispositivo(), FLASH_LOG_INICIO, FLASH_LOG_SETORES);
+}
+
+struct flash_dispositivo *hal_flash_camada(int camada) {
+    switch (camada) {
+        case CAMADA_5MIN:
+            return flash_regiao_iniciar(&regiao_camadas[camada], flash_pico_dispositivo(), FLASH_CAMADA_5MIN_INICIO,
+                                        FLASH_CAMADA_5MIN_SETORES);
+        case CAMADA_1H:
+            return flash_regiao_iniciar(&regiao_camadas[camada], flash_pico_dispositivo(), FLASH_CAMADA_1H_INICIO,
+                                        FLASH_CAMADA_1H_SETORES);
+        default:
+            return NULL;
+    }
+}
+
+// --- MEMÓRIA DO LWIP ---
+#if METRICAS
+// Nomes dos pools na ordem do enum do memp, tirados da mesma lista que o lwIP usa para criá-los
+static const char *const NOMES_MEMP[MEMP_MAX] = {
+#define LWIP_MEMPOOL(nome, quantidade, tamanho, descricao) #nome,
+#include "lwip/priv/memp_std.h"
+};
+
+// O heap do lwIP (MEM_STATS) e cada pool do memp (MEMP_STATS), ligados em lwipopts.h com METRICAS
+int hal_rede_memoria(hal_memoria_t *pools, int maximo) {
+    int n = 0;
+    if (n < maximo) {
+        const struct stats_mem *m = &lwip_stats.mem;
+        pools[n++] = (hal_memoria_t){"HEAP", m->used, m->max, m->avail, m->err};
+    }
+    for (int i = 0; i < MEMP_MAX && n < maximo; i++) {
+        const struct stats_mem *m = lwip_stats.memp[i];
+        pools[n++] = (hal_memoria_t){NOMES_MEMP[i], m->used, m->max, m->avail, m->err};
+    }
+    return n;
+}
+#endif
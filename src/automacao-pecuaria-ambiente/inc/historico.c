@@ -0,0 +1,105 @@
+#include <string.h>
+#include "historico.h"
+
+#define HISTORICO_MASCARA (HISTORICO_CAPACIDADE - 1)
+
+_Static_assert((HISTORICO_CAPACIDADE & HISTORICO_MASCARA) == 0, "HISTORICO_CAPACIDADE deve ser potencia de 2");
+
+static amostra_t amostras[HISTORICO_CAPACIDADE];
+static uint32_t proxima_sequencia = 0;   // Sequência que a próxima amostra receberá
+static uint32_t quantidade = 0;          // Amostras guardadas (até HISTORICO_CAPACIDADE)
+
+void historico_iniciar(void) {
+    memset(amostras, 0, sizeof(amostras));
+    proxima_sequencia = 0;
+    quantidade = 0;
+}
+
+// Faz a numeração continuar de uma sequência anterior (por exemplo, a do log em flash após um reboot).
+// Só deve ser chamada com o histórico vazio.
+void historico_continuar_sequencia(uint32_t sequencia) {
+    proxima_sequencia = sequencia;
+}
+
+// Insere uma amostra, sobrescrevendo a mais antiga se o buffer estiver cheio. Retorna sua sequência.
+uint32_t historico_adicionar(const amostra_t *amostra) {
+    amostras[proxima_sequencia & HISTORICO_MASCARA] = *amostra;
+    if (quantidade < HISTORICO_CAPACIDADE) quantidade++;
+    return proxima_sequencia++;
+}
+
+uint32_t historico_quantidade(void) {
+    return quantidade;
+}
+
+// Sequência da amostra mais antiga ainda guardada
+uint32_t historico_primeira_sequencia(void) {
+    return proxima_sequencia - historico_quantidade();
+}
+
+uint32_t historico_proxima_sequencia(void) {
+    return proxima_sequencia;
+}
+
+bool historico_obter(uint32_t sequencia, amostra_t *amostra) {
+    if (sequencia < historico_primeira_sequencia() || sequencia >= proxima_sequencia) {
+        return false;
+    }
+    *amostra = amostras[sequencia & HISTORICO_MASCARA];
+    return true;
+}
+
+// Amostra por idade: 0 é a mais recente
+bool historico_obter_recente(uint32_t indice, amostra_t *amostra) {
+    if (indice >= historico_quantidade()) {
+        return false;
+    }
+    return historico_obter(proxima_sequencia - 1 - indice, amostra);
+}
+
+// Busca binária: sequência da primeira amostra com timestamp >= epoch
+// (ou historico_proxima_sequencia() se não houver nenhuma)
+uint32_t historico_buscar_epoch(uint32_t epoch) {
+    uint32_t inicio = historico_primeira_sequencia();
+    uint32_t fim = proxima_sequencia;
+
+    while (inicio < fim) {
+        uint32_t meio = inicio + (fim - inicio) / 2;
+        if (amostras[meio & HISTORICO_MASCARA].epoch < epoch) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio;
+}
+
+void historico_iterar_tudo(historico_iterador_t *it) {
+    it->sequencia = historico_primeira_sequencia();
+    it->fim = UINT32_MAX;
+}
+
+// Amostras a partir de uma sequência (útil para quem já leu até certo ponto)
+void historico_iterar_desde(historico_iterador_t *it, uint32_t sequencia) {
+    it->sequencia = sequencia;
+    it->fim = UINT32_MAX;
+}
+
+// Amostras com epoch_de <= timestamp <= epoch_ate
+void historico_iterar_intervalo(historico_iterador_t *it, uint32_t epoch_de, uint32_t epoch_ate) {
+    it->sequencia = historico_buscar_epoch(epoch_de);
+    it->fim = epoch_ate == UINT32_MAX ? UINT32_MAX : historico_buscar_epoch(epoch_ate + 1);
+}
+
+bool historico_proximo(historico_iterador_t *it, amostra_t *amostra) {
+    uint32_t primeira = historico_primeira_sequencia();
+    if (it->sequencia < primeira) {
+        it->sequencia = primeira;
+    }
+    if (it->sequencia >= it->fim || it->sequencia >= proxima_sequencia) {
+        return false;
+    }
+    *amostra = amostras[it->sequencia & HISTORICO_MASCARA];
+    it->sequencia++;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef historico_inc_h
+#define historico_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Histórico de amostras dos sensores em RAM, num buffer circular de tamanho potência de 2.
+// Inserção em O(1) sem deslocar elementos; cada amostra recebe um número de sequência
+// crescente, que identifica a amostra mesmo depois de o buffer dar a volta.
+
+#define HISTORICO_CAPACIDADE 4096   // Deve ser potência de 2 (4096 amostras de 1 min = ~2,8 dias)
+
+// Bits do campo 'reles'
+#define HISTORICO_RELE_LUZ          (1u << 0)
+#define HISTORICO_RELE_VENTILADOR   (1u << 1)
+#define HISTORICO_RELE_UMIDIFICADOR (1u << 2)
+
+// Amostra compacta (12 bytes), com leituras em ponto fixo
+typedef struct {
+    uint32_t epoch;          // Segundos desde 1970-01-01, no horário do RTC
+    int16_t temperatura;     // Décimos de °C
+    int16_t umidade;         // Décimos de %
+    int16_t luminosidade;    // Décimos de %
+    uint16_t reles;          // Estado dos relés (HISTORICO_RELE_*)
+} amostra_t;
+
+// Percorre as amostras em ordem cronológica, por número de sequência.
+// Sobrevive a inserções durante a iteração: se a amostra atual for sobrescrita, pula para a mais antiga.
+typedef struct {
+    uint32_t sequencia;      // Próxima amostra a devolver
+    uint32_t fim;            // Sequência limite (exclusiva)
+} historico_iterador_t;
+
+void historico_iniciar(void);
+void historico_continuar_sequencia(uint32_t sequencia);
+uint32_t historico_adicionar(const amostra_t *amostra);
+uint32_t historico_quantidade(void);
+uint32_t historico_primeira_sequencia(void);
+uint32_t historico_proxima_sequencia(void);
+bool historico_obter(uint32_t sequencia, amostra_t *amostra);
+bool historico_obter_recente(uint32_t indice, amostra_t *amostra);
+uint32_t historico_buscar_epoch(uint32_t epoch);
+
+void historico_iterar_tudo(historico_iterador_t *it);
+void historico_iterar_desde(historico_iterador_t *it, uint32_t sequencia);
+void historico_iterar_intervalo(historico_iterador_t *it, uint32_t epoch_de, uint32_t epoch_ate);
+bool historico_proximo(historico_iterador_t *it, amostra_t *amostra);
+
+#endif
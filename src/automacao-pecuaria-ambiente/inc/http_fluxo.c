@@ -0,0 +1,58 @@
+#include <string.h>
+#include "http_fluxo.h"
+
+// Fecha os 'tamanho' bytes gerados em buffer + HTTP_FLUXO_RESERVA como um chunk: o tamanho vai
+// logo antes deles e o CRLF logo depois. Sem dados, monta o chunk final no início do buffer.
+// Retorna onde o chunk começa no buffer; *fim recebe onde ele termina.
+size_t http_fluxo_chunk(char *buffer, size_t tamanho, size_t *fim) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (tamanho == 0) {
+        memcpy(buffer, "0\r\n\r\n", 5);
+        *fim = 5;
+        return 0;
+    }
+
+    char *p = buffer + HTTP_FLUXO_RESERVA + tamanho;
+    *p++ = '\r';
+    *p++ = '\n';
+    *fim = p - buffer;
+
+    p = buffer + HTTP_FLUXO_RESERVA;
+    *--p = '\n';
+    *--p = '\r';
+    do {
+        *--p = hex[tamanho & 0xF];
+        tamanho >>= 4;
+    } while (tamanho > 0);
+    return p - buffer;
+}
+
+// Início de um evento: "event: nome\n" (se houver nome) e o campo "data: ". Retorna o tamanho
+// escrito; os dados vêm logo em seguida.
+size_t http_fluxo_abrir_evento(char *buffer, const char *nome) {
+    char *p = buffer;
+    if (nome) {
+        size_t n = strlen(nome);
+        memcpy(p, "event: ", 7);
+        memcpy(p + 7, nome, n);
+        p[7 + n] = '\n';
+        p += 8 + n;
+    }
+    memcpy(p, "data: ", 6);
+    return p + 6 - buffer;
+}
+
+// Termina a linha 'data:' que acaba em buffer[fim] e acrescenta a linha em branco que entrega o
+// evento ao cliente. Retorna o novo fim.
+size_t http_fluxo_fechar_evento(char *buffer, size_t fim) {
+    buffer[fim++] = '\n';
+    buffer[fim++] = '\n';
+    return fim;
+}
+
+// Comentário vazio, ignorado pelo EventSource: mantém a conexão viva em proxies
+size_t http_fluxo_comentario(char *buffer) {
+    memcpy(buffer, ":\n\n", 3);
+    return 3;
+}
@@ -0,0 +1,21 @@
+#ifndef http_fluxo_inc_h
+#define http_fluxo_inc_h
+
+#include <stddef.h>
+
+// Enquadramento das respostas geradas em pedaços: chunks do HTTP/1.1 (Transfer-Encoding: chunked)
+// e eventos do Server-Sent Events. Os dados são gerados direto no buffer da conexão, depois de uma
+// reserva, e o enquadramento é escrito em volta deles, sem cópia.
+//
+// Um evento SSE leva os dados numa única linha 'data:'; quem gera garante que eles não têm '\n'
+// (o JSON de inc/json.h escapa as quebras de linha dentro dos textos).
+
+#define HTTP_FLUXO_RESERVA 8        // Antes dos dados de um chunk: tamanho em hexadecimal + CRLF ("1F8\r\n")
+#define HTTP_FLUXO_FOLGA 2          // Depois dos dados de um chunk ("\r\n") ou de um evento ("\n\n")
+
+size_t http_fluxo_chunk(char *buffer, size_t tamanho, size_t *fim);
+size_t http_fluxo_abrir_evento(char *buffer, const char *nome);
+size_t http_fluxo_fechar_evento(char *buffer, size_t fim);
+size_t http_fluxo_comentario(char *buffer);
+
+#endif
@@ -0,0 +1,261 @@
+#include <string.h>
+#include "http_requisicao.h"
+
+// Cabeçalhos cujo valor é guardado
+enum {
+    CABECALHO_IGNORADO,
+    CABECALHO_IF_NONE_MATCH,
+    CABECALHO_CONNECTION,
+    CABECALHO_CONTENT_LENGTH,
+    CABECALHO_TRANSFER_ENCODING,
+};
+
+#define CONTENT_LENGTH_MAX 100000000u
+
+static void falhar(http_requisicao_t *r, uint16_t status) {
+    r->estado = HTTP_ESTADO_ERRO;
+    r->status_erro = status;
+    r->manter_aberta = false;
+}
+
+static char minuscula(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// Guarda mais um caractere do token atual; tokens longos demais ficam com tamanho >= HTTP_NOME_MAX
+static void acumular_token(http_requisicao_t *r, char c) {
+    if (r->tamanho_token < HTTP_NOME_MAX - 1) {
+        r->token[r->tamanho_token] = c;
+    }
+    if (r->tamanho_token < HTTP_NOME_MAX) {
+        r->tamanho_token++;
+    }
+}
+
+static bool token_igual(http_requisicao_t *r, const char *texto) {
+    if (r->tamanho_token >= HTTP_NOME_MAX) {
+        return false;
+    }
+    r->token[r->tamanho_token] = '\0';
+    return strcmp(r->token, texto) == 0;
+}
+
+static void fim_metodo(http_requisicao_t *r) {
+    if (r->tamanho_token == 0 || r->tamanho_token >= HTTP_NOME_MAX) {
+        falhar(r, 400);
+        return;
+    }
+    if (token_igual(r, "GET")) {
+        r->metodo = HTTP_METODO_GET;
+    } else if (token_igual(r, "HEAD")) {
+        r->metodo = HTTP_METODO_HEAD;
+    } else if (token_igual(r, "POST")) {
+        r->metodo = HTTP_METODO_POST;
+    } else {
+        r->metodo = HTTP_METODO_OUTRO;
+    }
+    r->tamanho_token = 0;
+    r->estado = HTTP_ESTADO_ALVO;
+}
+
+static void fim_versao(http_requisicao_t *r) {
+    if (r->tamanho_token == 8 && token_igual(r, "HTTP/1.0")) {
+        r->versao_menor = 0;
+    } else if (r->tamanho_token == 8 && token_igual(r, "HTTP/1.1")) {
+        r->versao_menor = 1;
+    } else if (r->tamanho_token > 5 && r->tamanho_token < HTTP_NOME_MAX && strncmp(r->token, "HTTP/", 5) == 0) {
+        falhar(r, 505);
+        return;
+    } else {
+        falhar(r, 400);
+        return;
+    }
+    // HTTP/1.1 mantém a conexão por padrão; HTTP/1.0 só com "Connection: keep-alive"
+    r->manter_aberta = r->versao_menor >= 1;
+    r->tamanho_token = 0;
+    r->estado = HTTP_ESTADO_NOME;
+}
+
+static void fim_nome(http_requisicao_t *r) {
+    if (r->tamanho_token == 0) {
+        falhar(r, 400);
+        return;
+    }
+    if (token_igual(r, "if-none-match")) {
+        r->cabecalho = CABECALHO_IF_NONE_MATCH;
+        r->if_none_match[0] = '\0';
+    } else if (token_igual(r, "connection")) {
+        r->cabecalho = CABECALHO_CONNECTION;
+        r->conexao[0] = '\0';
+    } else if (token_igual(r, "content-length")) {
+        r->cabecalho = CABECALHO_CONTENT_LENGTH;
+        r->corpo_restante = 0;
+    } else if (token_igual(r, "transfer-encoding")) {
+        r->cabecalho = CABECALHO_TRANSFER_ENCODING;
+    } else {
+        r->cabecalho = CABECALHO_IGNORADO;
+    }
+    r->tamanho_token = 0;
+    r->tamanho_valor = 0;
+    r->estado = HTTP_ESTADO_VALOR;
+}
+
+static void caractere_valor(http_requisicao_t *r, char c) {
+    if (r->tamanho_valor == 0 && (c == ' ' || c == '\t')) {
+        return;     // Espaços antes do valor
+    }
+    switch (r->cabecalho) {
+        case CABECALHO_IF_NONE_MATCH:
+            if (r->tamanho_valor < HTTP_ETAG_MAX - 1) {
+                r->if_none_match[r->tamanho_valor] = c;
+                r->if_none_match[r->tamanho_valor + 1] = '\0';
+            }
+            break;
+        case CABECALHO_CONNECTION:
+            if (r->tamanho_valor < HTTP_TOKEN_MAX - 1) {
+                r->conexao[r->tamanho_valor] = minuscula(c);
+                r->conexao[r->tamanho_valor + 1] = '\0';
+            }
+            break;
+        case CABECALHO_CONTENT_LENGTH:
+            if (c == ' ' || c == '\t') {
+                break;
+            }
+            if (c < '0' || c > '9' || r->corpo_restante > CONTENT_LENGTH_MAX / 10) {
+                falhar(r, 400);
+                return;
+            }
+            r->corpo_restante = r->corpo_restante * 10 + (c - '0');
+            break;
+        case CABECALHO_TRANSFER_ENCODING:
+            r->corpo_chunked = true;    // Corpo que não sabemos pular: a conexão fecha após a resposta
+            break;
+    }
+    if (r->tamanho_valor < UINT8_MAX) {
+        r->tamanho_valor++;
+    }
+}
+
+static void fim_cabecalhos(http_requisicao_t *r) {
+    if (strstr(r->conexao, "close")) {
+        r->manter_aberta = false;
+    } else if (strstr(r->conexao, "keep-alive")) {
+        r->manter_aberta = true;
+    }
+    if (r->corpo_chunked) {
+        r->manter_aberta = false;
+        r->corpo_restante = 0;
+    }
+    r->estado = r->corpo_restante > 0 ? HTTP_ESTADO_CORPO : HTTP_ESTADO_COMPLETA;
+}
+
+void http_requisicao_iniciar(http_requisicao_t *r) {
+    memset(r, 0, sizeof(*r));
+    r->estado = HTTP_ESTADO_METODO;
+}
+
+// Consome bytes até completar a requisição (ou encontrar um erro) e retorna quantos usou.
+// Os bytes restantes já pertencem à próxima requisição da mesma conexão.
+size_t http_requisicao_alimentar(http_requisicao_t *r, const uint8_t *dados, size_t tamanho) {
+    size_t i = 0;
+    while (i < tamanho && r->estado != HTTP_ESTADO_COMPLETA && r->estado != HTTP_ESTADO_ERRO) {
+        if (r->estado == HTTP_ESTADO_CORPO) {
+            size_t n = tamanho - i < r->corpo_restante ? tamanho - i : r->corpo_restante;
+            r->corpo_restante -= n;
+            i += n;
+            if (r->corpo_restante == 0) {
+                r->estado = HTTP_ESTADO_COMPLETA;
+            }
+            continue;
+        }
+
+        char c = (char)dados[i++];
+        if (++r->tamanho_cabecalho > HTTP_CABECALHO_MAX) {
+            falhar(r, 431);
+            break;
+        }
+        if (c == '\r') {
+            continue;   // Aceita tanto CRLF quanto só LF
+        }
+
+        switch (r->estado) {
+            case HTTP_ESTADO_METODO:
+                if (c == '\n' && r->tamanho_token == 0) {
+                    break;      // Linhas vazias antes da requisição são toleradas
+                }
+                if (c == ' ') {
+                    fim_metodo(r);
+                } else if (c == '\n' || (unsigned char)c < 0x21) {
+                    falhar(r, 400);
+                } else {
+                    acumular_token(r, c);
+                }
+                break;
+
+            case HTTP_ESTADO_ALVO:
+                if (c == ' ' && r->tamanho_alvo > 0) {
+                    r->estado = HTTP_ESTADO_VERSAO;
+                } else if ((unsigned char)c < 0x21 || c == 0x7F) {
+                    falhar(r, 400);
+                } else if (r->tamanho_alvo >= HTTP_ALVO_MAX - 1) {
+                    falhar(r, 414);
+                } else {
+                    r->alvo[r->tamanho_alvo++] = c;
+                    r->alvo[r->tamanho_alvo] = '\0';
+                }
+                break;
+
+            case HTTP_ESTADO_VERSAO:
+                if (c == '\n') {
+                    fim_versao(r);
+                } else if (c == ' ' || c == '\t') {
+                    falhar(r, 400);
+                } else {
+                    acumular_token(r, c);
+                }
+                break;
+
+            case HTTP_ESTADO_NOME:
+                if (c == '\n') {
+                    if (r->tamanho_token == 0) {
+                        fim_cabecalhos(r);
+                    } else {
+                        falhar(r, 400);     // Linha de cabeçalho sem ':'
+                    }
+                } else if (c == ':') {
+                    fim_nome(r);
+                } else if ((unsigned char)c < 0x21) {
+                    falhar(r, 400);         // Espaço no nome ou continuação de linha (obsoleta)
+                } else {
+                    acumular_token(r, minuscula(c));
+                }
+                break;
+
+            case HTTP_ESTADO_VALOR:
+                if (c == '\n') {
+                    r->estado = HTTP_ESTADO_NOME;
+                } else {
+                    caractere_valor(r, c);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return i;
+}
+
+// Linha de status da resposta a uma requisição com erro ("400 Bad Request" etc.)
+const char *http_requisicao_status_erro(const http_requisicao_t *r) {
+    switch (r->status_erro) {
+        case 414:
+            return "414 URI Too Long";
+        case 431:
+            return "431 Request Header Fields Too Large";
+        case 505:
+            return "505 HTTP Version Not Supported";
+        default:
+            return "400 Bad Request";
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef http_requisicao_inc_h
+#define http_requisicao_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Analisador incremental de requisições HTTP/1.x. Recebe os bytes em pedaços de qualquer
+// tamanho (um pbuf por vez, por exemplo) e guarda só o que o servidor usa: método, alvo,
+// versão, If-None-Match e a decisão de manter a conexão aberta. O corpo, se houver
+// (Content-Length), é consumido e descartado para não atrapalhar a próxima requisição.
+
+#define HTTP_ALVO_MAX 128           // Caminho + query string
+#define HTTP_ETAG_MAX 48
+#define HTTP_CABECALHO_MAX 2048     // Linha de requisição + cabeçalhos
+#define HTTP_NOME_MAX 20            // Nomes maiores não interessam e são ignorados
+#define HTTP_TOKEN_MAX 12           // Valor guardado do cabeçalho Connection
+
+typedef enum {
+    HTTP_ESTADO_METODO,
+    HTTP_ESTADO_ALVO,
+    HTTP_ESTADO_VERSAO,
+    HTTP_ESTADO_NOME,
+    HTTP_ESTADO_VALOR,
+    HTTP_ESTADO_CORPO,
+    HTTP_ESTADO_COMPLETA,
+    HTTP_ESTADO_ERRO,
+} http_estado_t;
+
+typedef enum {
+    HTTP_METODO_GET,
+    HTTP_METODO_HEAD,
+    HTTP_METODO_POST,
+    HTTP_METODO_OUTRO,
+} http_metodo_t;
+
+typedef struct {
+    http_estado_t estado;
+    uint16_t status_erro;           // 400, 414, 431 ou 505 quando estado == HTTP_ESTADO_ERRO
+    http_metodo_t metodo;
+    uint8_t versao_menor;           // HTTP/1.0 ou HTTP/1.1
+    bool manter_aberta;
+    char alvo[HTTP_ALVO_MAX];
+    char if_none_match[HTTP_ETAG_MAX];
+
+    // Estado interno
+    char token[HTTP_NOME_MAX];      // Método, versão ou nome do cabeçalho em leitura
+    uint8_t tamanho_token;
+    uint8_t tamanho_valor;
+    uint8_t cabecalho;              // Cabeçalho cujo valor está sendo lido
+    uint16_t tamanho_alvo;
+    uint16_t tamanho_cabecalho;
+    bool corpo_chunked;
+    uint32_t corpo_restante;
+    char conexao[HTTP_TOKEN_MAX];
+} http_requisicao_t;
+
+void http_requisicao_iniciar(http_requisicao_t *r);
+size_t http_requisicao_alimentar(http_requisicao_t *r, const uint8_t *dados, size_t tamanho);
+const char *http_requisicao_status_erro(const http_requisicao_t *r);
+
+static inline bool http_requisicao_completa(const http_requisicao_t *r) {
+    return r->estado == HTTP_ESTADO_COMPLETA;
+}
+
+static inline bool http_requisicao_erro(const http_requisicao_t *r) {
+    return r->estado == HTTP_ESTADO_ERRO;
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "json.h"
+#include "formato.h"
+
+static void escrever(json_escritor_t *j, const char *dados, size_t n) {
+    // Sempre sobra um byte para o '\0'
+    if (j->estourou || j->tamanho + n >= j->capacidade) {
+        j->estourou = true;
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        j->buffer[j->tamanho++] = dados[i];
+    }
+    j->buffer[j->tamanho] = '\0';
+}
+
+static void escrever_caractere(json_escritor_t *j, char c) {
+    escrever(j, &c, 1);
+}
+
+// Vírgula antes de todo elemento que não seja o primeiro do nível (exceto valores de chaves)
+static void separar(json_escritor_t *j) {
+    if (j->apos_chave) {
+        j->apos_chave = false;
+        return;
+    }
+    uint16_t bit = 1u << j->nivel;
+    if (j->tem_elemento & bit) {
+        escrever_caractere(j, ',');
+    }
+    j->tem_elemento |= bit;
+}
+
+static void abrir(json_escritor_t *j, char c) {
+    separar(j);
+    escrever_caractere(j, c);
+    if (j->nivel + 1 < JSON_NIVEIS_MAX) {
+        j->nivel++;
+        j->tem_elemento &= ~(1u << j->nivel);
+    } else {
+        j->estourou = true;
+    }
+}
+
+static void fechar(json_escritor_t *j, char c) {
+    if (j->nivel > 0) {
+        j->nivel--;
+    }
+    escrever_caractere(j, c);
+}
+
+void json_iniciar(json_escritor_t *j, char *buffer, size_t capacidade) {
+    *j = (json_escritor_t){0};
+    json_trocar_buffer(j, buffer, capacidade);
+}
+
+// Continua o mesmo documento num buffer novo (vazio)
+void json_trocar_buffer(json_escritor_t *j, char *buffer, size_t capacidade) {
+    j->buffer = buffer;
+    j->capacidade = capacidade;
+    j->tamanho = 0;
+    j->estourou = capacidade == 0;
+    if (capacidade > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+size_t json_livre(const json_escritor_t *j) {
+    return j->estourou ? 0 : j->capacidade - j->tamanho - 1;
+}
+
+void json_abrir_objeto(json_escritor_t *j) {
+    abrir(j, '{');
+}
+
+void json_fechar_objeto(json_escritor_t *j) {
+    fechar(j, '}');
+}
+
+void json_abrir_lista(json_escritor_t *j) {
+    abrir(j, '[');
+}
+
+void json_fechar_lista(json_escritor_t *j) {
+    fechar(j, ']');
+}
+
+void json_chave(json_escritor_t *j, const char *nome) {
+    json_texto(j, nome);
+    escrever_caractere(j, ':');
+    j->apos_chave = true;
+}
+
+// Números são formatados direto no buffer quando cabem com folga; perto do fim, passam por
+// escrever(), que marca o estouro
+static void escrever_numero(json_escritor_t *j, char *(*formatar)(char *, int32_t), int32_t valor) {
+    separar(j);
+    if (!j->estourou && j->capacidade - j->tamanho > FORMATO_DECIMOS_MAX) {
+        j->tamanho = formatar(j->buffer + j->tamanho, valor) - j->buffer;
+        return;
+    }
+    char digitos[FORMATO_DECIMOS_MAX];
+    escrever(j, digitos, formatar(digitos, valor) - digitos);
+}
+
+void json_inteiro(json_escritor_t *j, int32_t valor) {
+    escrever_numero(j, formato_inteiro, valor);
+}
+
+// Valor em ponto fixo com uma casa decimal: 285 -> 28.5, -5 -> -0.5
+void json_decimos(json_escritor_t *j, int32_t decimos) {
+    escrever_numero(j, formato_decimos, decimos);
+}
+
+void json_booleano(json_escritor_t *j, bool valor) {
+    separar(j);
+    if (valor) {
+        escrever(j, "true", 4);
+    } else {
+        escrever(j, "false", 5);
+    }
+}
+
+void json_texto(json_escritor_t *j, const char *texto) {
+    static const char hex[] = "0123456789abcdef";
+    separar(j);
+    escrever_caractere(j, '"');
+    for (const char *p = texto; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            char escape[2] = {'\\', (char)c};
+            escrever(j, escape, 2);
+        } else if (c < 0x20) {
+            char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            escrever(j, escape, 6);
+        } else {
+            escrever_caractere(j, (char)c);
+        }
+    }
+    escrever_caractere(j, '"');
+}
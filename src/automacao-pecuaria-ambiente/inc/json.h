@@ -0,0 +1,40 @@
+#ifndef json_inc_h
+#define json_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Escritor de JSON sem alocação: escreve direto num buffer fornecido pelo chamador e
+// insere as vírgulas sozinho. Se o buffer acabar, marca 'estourou' e ignora o resto.
+// O estado de aninhamento sobrevive a json_trocar_buffer, o que permite gerar um
+// documento grande em pedaços (por exemplo, um chunk HTTP por vez).
+
+#define JSON_NIVEIS_MAX 16
+
+typedef struct {
+    char *buffer;
+    size_t capacidade;
+    size_t tamanho;
+    uint16_t tem_elemento;   // Bit n: o nível n já tem um elemento (o próximo precisa de vírgula)
+    uint8_t nivel;
+    bool apos_chave;         // O próximo valor é o de uma chave, sem vírgula antes
+    bool estourou;
+} json_escritor_t;
+
+void json_iniciar(json_escritor_t *j, char *buffer, size_t capacidade);
+void json_trocar_buffer(json_escritor_t *j, char *buffer, size_t capacidade);
+size_t json_livre(const json_escritor_t *j);
+
+void json_abrir_objeto(json_escritor_t *j);
+void json_fechar_objeto(json_escritor_t *j);
+void json_abrir_lista(json_escritor_t *j);
+void json_fechar_lista(json_escritor_t *j);
+void json_chave(json_escritor_t *j, const char *nome);
+
+void json_inteiro(json_escritor_t *j, int32_t valor);
+void json_decimos(json_escritor_t *j, int32_t decimos);
+void json_booleano(json_escritor_t *j, bool valor);
+void json_texto(json_escritor_t *j, const char *texto);
+
+#endif
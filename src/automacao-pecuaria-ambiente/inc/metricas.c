@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <string.h>
+#include "metricas.h"
+
+const metricas_escala_t METRICAS_ESCALA_US = {
+    .limites = {10, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000},
+    .rotulos = {"0.00001", "0.00005", "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025", "0.1"},
+    .em_segundos = true,
+};
+
+const metricas_escala_t METRICAS_ESCALA_BYTES = {
+    .limites = {64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 65536, 262144},
+    .rotulos = {"64", "128", "256", "512", "1024", "2048", "4096", "8192", "16384", "65536", "262144"},
+    .em_segundos = false,
+};
+
+void metricas_observar(metricas_histograma_t *h, const metricas_escala_t *escala, uint32_t valor) {
+    int i = 0;
+    while (i < METRICAS_BALDES - 1 && valor > escala->limites[i]) {
+        i++;
+    }
+    h->baldes[i]++;
+    h->contagem++;
+    h->soma += valor;
+}
+
+void metricas_iniciar(metricas_escritor_t *e, char *buffer, size_t capacidade, uint32_t inicio) {
+    *e = (metricas_escritor_t){.buffer = buffer, .capacidade = capacidade, .inicio = inicio};
+}
+
+// Próxima linha: true se ela deve ser escrita agora (nem enviada num trecho anterior, nem depois
+// de uma que não coube)
+static bool escrever_agora(metricas_escritor_t *e) {
+    if (e->cheio) {
+        return false;
+    }
+    if (e->linha < e->inicio) {
+        e->linha++;
+        return false;
+    }
+    return true;
+}
+
+// Fecha a linha formatada em buffer + tamanho: conta se coube inteira, senão a descarta
+static void concluir_linha(metricas_escritor_t *e, int n) {
+    if (n < 0 || (size_t)n >= e->capacidade - e->tamanho) {
+        e->cheio = true;
+        return;
+    }
+    e->tamanho += n;
+    e->linha++;
+}
+
+void metricas_familia(metricas_escritor_t *e, const char *nome, const char *tipo, const char *ajuda) {
+    if (escrever_agora(e)) {
+        concluir_linha(e, snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho,
+                                   "# HELP %s %s\n# TYPE %s %s\n", nome, ajuda, nome, tipo));
+    }
+}
+
+void metricas_valor(metricas_escritor_t *e, const char *nome, const char *rotulos, uint64_t valor) {
+    if (escrever_agora(e)) {
+        concluir_linha(e, snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho, "%s%s%s%s %llu\n",
+                                   nome, *rotulos ? "{" : "", rotulos, *rotulos ? "}" : "", (unsigned long long)valor));
+    }
+}
+
+void metricas_histograma(metricas_escritor_t *e, const char *nome, const char *rotulos,
+                         const metricas_histograma_t *h, const metricas_escala_t *escala) {
+    const char *virgula = *rotulos ? "," : "";
+    uint32_t acumulado = 0;
+    for (int i = 0; i < METRICAS_BALDES; i++) {
+        acumulado += h->baldes[i];
+        if (escrever_agora(e)) {
+            concluir_linha(e, snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho,
+                                       "%s_bucket{%s%sle=\"%s\"} %lu\n", nome, rotulos, virgula,
+                                       i < METRICAS_BALDES - 1 ? escala->rotulos[i] : "+Inf", (unsigned long)acumulado));
+        }
+    }
+
+    const char *abre = *rotulos ? "{" : "";
+    const char *fecha = *rotulos ? "}" : "";
+    if (escrever_agora(e)) {
+        unsigned long long soma = h->soma;
+        int n;
+        if (escala->em_segundos) {
+            n = snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho, "%s_sum%s%s%s %llu.%06llu\n",
+                         nome, abre, rotulos, fecha, soma / 1000000, soma % 1000000);
+        } else {
+            n = snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho, "%s_sum%s%s%s %llu\n",
+                         nome, abre, rotulos, fecha, soma);
+        }
+        concluir_linha(e, n);
+    }
+    if (escrever_agora(e)) {
+        concluir_linha(e, snprintf(e->buffer + e->tamanho, e->capacidade - e->tamanho, "%s_count%s%s%s %lu\n",
+                                   nome, abre, rotulos, fecha, (unsigned long)h->contagem));
+    }
+}
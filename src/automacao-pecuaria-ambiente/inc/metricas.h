@@ -0,0 +1,60 @@
+#ifndef metricas_inc_h
+#define metricas_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Instrumentação de tempo de execução, exposta em /metrics no formato de texto do Prometheus.
+// Histogramas de baldes fixos (uma comparação por balde e duas somas por observação, sem
+// alocação) e um escritor do formato que gera o documento linha a linha: refeito a cada chunk
+// HTTP, ele pula as linhas já enviadas e para na primeira que não cabe, então cada linha sai
+// inteira e com um valor coerente. Cada histograma tem um único escritor, o núcleo dono.
+// Com METRICAS desligada, METRICAS_MEDIR() fica só com a instrução medida.
+
+#define METRICAS_BALDES 12       // O último é o +Inf
+
+typedef struct {
+    uint32_t limites[METRICAS_BALDES - 1];      // Limite superior de cada balde, na unidade observada
+    const char *rotulos[METRICAS_BALDES - 1];   // O mesmo limite como 'le', na unidade exposta
+    bool em_segundos;                           // Observações em us, soma exposta em segundos
+} metricas_escala_t;
+
+extern const metricas_escala_t METRICAS_ESCALA_US;      // 10 us a 100 ms, exposta em segundos
+extern const metricas_escala_t METRICAS_ESCALA_BYTES;   // 64 B a 256 KiB
+
+typedef struct {
+    uint32_t baldes[METRICAS_BALDES];   // Não cumulativos; acumulados só na exposição
+    uint32_t contagem;
+    uint64_t soma;
+} metricas_histograma_t;
+
+typedef struct {
+    char *buffer;
+    size_t capacidade;
+    size_t tamanho;
+    uint32_t linha;      // Linha atual do documento
+    uint32_t inicio;     // Primeira linha a escrever neste trecho
+    bool cheio;          // Uma linha não coube; o próximo trecho recomeça em 'linha'
+} metricas_escritor_t;
+
+void metricas_observar(metricas_histograma_t *h, const metricas_escala_t *escala, uint32_t valor);
+
+void metricas_iniciar(metricas_escritor_t *e, char *buffer, size_t capacidade, uint32_t inicio);
+void metricas_familia(metricas_escritor_t *e, const char *nome, const char *tipo, const char *ajuda);
+void metricas_valor(metricas_escritor_t *e, const char *nome, const char *rotulos, uint64_t valor);
+void metricas_histograma(metricas_escritor_t *e, const char *nome, const char *rotulos,
+                         const metricas_histograma_t *h, const metricas_escala_t *escala);
+
+#if METRICAS
+#include "hal.h"
+#define METRICAS_MEDIR(histograma, instrucao) do {                                                    \
+        uint64_t inicio_medida_ = hal_tempo_us();                                                     \
+        instrucao;                                                                                    \
+        metricas_observar(&(histograma), &METRICAS_ESCALA_US, (uint32_t)(hal_tempo_us() - inicio_medida_)); \
+    } while (0)
+#else
+#define METRICAS_MEDIR(histograma, instrucao) do { instrucao; } while (0)
+#endif
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef oled_fonte_inc_h
+#define oled_fonte_inc_h
+
+#include <stdint.h>
+
+// Fonte 5x7 de inc/oled_texto.c: ASCII imprimível (0x20-0x7E) seguido do Latin-1 (0xA0-0xFF).
+// Um glifo é uma célula de 6 colunas de 8 pixels, uma por byte com o bit 0 em cima (o formato
+// das páginas do SSD1306); a sexta coluna é o espaço entre caracteres.
+// As maiúsculas e os algarismos usam as linhas 0 a 6 e as minúsculas têm a altura de x nas linhas
+// 2 a 6, deixando as linhas 0 e 1 para os acentos. Nas maiúsculas acentuadas a letra é reduzida
+// à altura das minúsculas para o acento caber na célula.
+static const uint8_t oled_fonte[95 + 96][6] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 20  
+    {0x00, 0x00, 0x5f, 0x00, 0x00, 0x00}, // 21 !
+    {0x00, 0x07, 0x00, 0x07, 0x00, 0x00}, // 22 "
+    {0x14, 0x7f, 0x14, 0x7f, 0x14, 0x00}, // 23 #
+    {0x24, 0x2a, 0x7f, 0x2a, 0x12, 0x00}, // 24 $
+    {0x23, 0x13, 0x08, 0x64, 0x62, 0x00}, // 25 %
+    {0x36, 0x49, 0x55, 0x22, 0x50, 0x00}, // 26 &
+    {0x00, 0x05, 0x03, 0x00, 0x00, 0x00}, // 27 '
+    {0x00, 0x1c, 0x22, 0x41, 0x00, 0x00}, // 28 (
+    {0x00, 0x41, 0x22, 0x1c, 0x00, 0x00}, // 29 )
+    {0x08, 0x2a, 0x1c, 0x2a, 0x08, 0x00}, // 2A *
+    {0x08, 0x08, 0x3e, 0x08, 0x08, 0x00}, // 2B +
+    {0x00, 0x50, 0x30, 0x00, 0x00, 0x00}, // 2C ,
+    {0x08, 0x08, 0x08, 0x08, 0x08, 0x00}, // 2D -
+    {0x00, 0x60, 0x60, 0x00, 0x00, 0x00}, // 2E .
+    {0x20, 0x10, 0x08, 0x04, 0x02, 0x00}, // 2F /
+    {0x3e, 0x51, 0x49, 0x45, 0x3e, 0x00}, // 30 0
+    {0x00, 0x42, 0x7f, 0x40, 0x00, 0x00}, // 31 1
+    {0x42, 0x61, 0x51, 0x49, 0x46, 0x00}, // 32 2
+    {0x21, 0x41, 0x45, 0x4b, 0x31, 0x00}, // 33 3
+    {0x18, 0x14, 0x12, 0x7f, 0x10, 0x00}, // 34 4
+    {0x27, 0x45, 0x45, 0x45, 0x39, 0x00}, // 35 5
+    {0x3c, 0x4a, 0x49, 0x49, 0x30, 0x00}, // 36 6
+    {0x01, 0x71, 0x09, 0x05, 0x03, 0x00}, // 37 7
+    {0x36, 0x49, 0x49, 0x49, 0x36, 0x00}, // 38 8
+    {0x06, 0x49, 0x49, 0x29, 0x1e, 0x00}, // 39 9
+    {0x00, 0x36, 0x36, 0x00, 0x00, 0x00}, // 3A :
+    {0x00, 0x56, 0x36, 0x00, 0x00, 0x00}, // 3B ;
+    {0x08, 0x14, 0x22, 0x41, 0x00, 0x00}, // 3C <
+    {0x14, 0x14, 0x14, 0x14, 0x14, 0x00}, // 3D =
+    {0x00, 0x41, 0x22, 0x14, 0x08, 0x00}, // 3E >
+    {0x02, 0x01, 0x51, 0x09, 0x06, 0x00}, // 3F ?
+    {0x32, 0x49, 0x79, 0x41, 0x3e, 0x00}, // 40 @
+    {0x7e, 0x11, 0x11, 0x11, 0x7e, 0x00}, // 41 A
+    {0x7f, 0x49, 0x49, 0x49, 0x36, 0x00}, // 42 B
+    {0x3e, 0x41, 0x41, 0x41, 0x22, 0x00}, // 43 C
+    {0x7f, 0x41, 0x41, 0x22, 0x1c, 0x00}, // 44 D
+    {0x7f, 0x49, 0x49, 0x49, 0x41, 0x00}, // 45 E
+    {0x7f, 0x09, 0x09, 0x01, 0x01, 0x00}, // 46 F
+    {0x3e, 0x41, 0x41, 0x51, 0x32, 0x00}, // 47 G
+    {0x7f, 0x08, 0x08, 0x08, 0x7f, 0x00}, // 48 H
+    {0x00, 0x41, 0x7f, 0x41, 0x00, 0x00}, // 49 I
+    {0x20, 0x40, 0x41, 0x3f, 0x01, 0x00}, // 4A J
+    {0x7f, 0x08, 0x14, 0x22, 0x41, 0x00}, // 4B K
+    {0x7f, 0x40, 0x40, 0x40, 0x40, 0x00}, // 4C L
+    {0x7f, 0x02, 0x04, 0x02, 0x7f, 0x00}, // 4D M
+    {0x7f, 0x04, 0x08, 0x10, 0x7f, 0x00}, // 4E N
+    {0x3e, 0x41, 0x41, 0x41, 0x3e, 0x00}, // 4F O
+    {0x7f, 0x09, 0x09, 0x09, 0x06, 0x00}, // 50 P
+    {0x3e, 0x41, 0x51, 0x21, 0x5e, 0x00}, // 51 Q
+    {0x7f, 0x09, 0x19, 0x29, 0x46, 0x00}, // 52 R
+    {0x46, 0x49, 0x49, 0x49, 0x31, 0x00}, // 53 S
+    {0x01, 0x01, 0x7f, 0x01, 0x01, 0x00}, // 54 T
+    {0x3f, 0x40, 0x40, 0x40, 0x3f, 0x00}, // 55 U
+    {0x1f, 0x20, 0x40, 0x20, 0x1f, 0x00}, // 56 V
+    {0x7f, 0x20, 0x18, 0x20, 0x7f, 0x00}, // 57 W
+    {0x63, 0x14, 0x08, 0x14, 0x63, 0x00}, // 58 X
+    {0x03, 0x04, 0x78, 0x04, 0x03, 0x00}, // 59 Y
+    {0x61, 0x51, 0x49, 0x45, 0x43, 0x00}, // 5A Z
+    {0x00, 0x7f, 0x41, 0x41, 0x00, 0x00}, // 5B [
+    {0x02, 0x04, 0x08, 0x10, 0x20, 0x00}, // 5C barra invertida
+    {0x00, 0x41, 0x41, 0x7f, 0x00, 0x00}, // 5D ]
+    {0x04, 0x02, 0x01, 0x02, 0x04, 0x00}, // 5E ^
+    {0x40, 0x40, 0x40, 0x40, 0x40, 0x00}, // 5F _
+    {0x00, 0x01, 0x02, 0x04, 0x00, 0x00}, // 60 `
+    {0x20, 0x54, 0x54, 0x54, 0x78, 0x00}, // 61 a
+    {0x7f, 0x48, 0x44, 0x44, 0x38, 0x00}, // 62 b
+    {0x38, 0x44, 0x44, 0x44, 0x20, 0x00}, // 63 c
+    {0x38, 0x44, 0x44, 0x48, 0x7f, 0x00}, // 64 d
+    {0x38, 0x54, 0x54, 0x54, 0x18, 0x00}, // 65 e
+    {0x08, 0x7e, 0x09, 0x01, 0x02, 0x00}, // 66 f
+    {0x0c, 0x52, 0x52, 0x52, 0x3e, 0x00}, // 67 g
+    {0x7f, 0x08, 0x04, 0x04, 0x78, 0x00}, // 68 h
+    {0x00, 0x44, 0x7d, 0x40, 0x00, 0x00}, // 69 i
+    {0x20, 0x40, 0x44, 0x3d, 0x00, 0x00}, // 6A j
+    {0x00, 0x7f, 0x10, 0x28, 0x44, 0x00}, // 6B k
+    {0x00, 0x41, 0x7f, 0x40, 0x00, 0x00}, // 6C l
+    {0x7c, 0x04, 0x18, 0x04, 0x78, 0x00}, // 6D m
+    {0x7c, 0x08, 0x04, 0x04, 0x78, 0x00}, // 6E n
+    {0x38, 0x44, 0x44, 0x44, 0x38, 0x00}, // 6F o
+    {0x7c, 0x14, 0x14, 0x14, 0x08, 0x00}, // 70 p
+    {0x08, 0x14, 0x14, 0x18, 0x7c, 0x00}, // 71 q
+    {0x7c, 0x08, 0x04, 0x04, 0x08, 0x00}, // 72 r
+    {0x48, 0x54, 0x54, 0x54, 0x20, 0x00}, // 73 s
+    {0x04, 0x3f, 0x44, 0x40, 0x20, 0x00}, // 74 t
+    {0x3c, 0x40, 0x40, 0x20, 0x7c, 0x00}, // 75 u
+    {0x1c, 0x20, 0x40, 0x20, 0x1c, 0x00}, // 76 v
+    {0x3c, 0x40, 0x30, 0x40, 0x3c, 0x00}, // 77 w
+    {0x44, 0x28, 0x10, 0x28, 0x44, 0x00}, // 78 x
+    {0x0c, 0x50, 0x50, 0x50, 0x3c, 0x00}, // 79 y
+    {0x44, 0x64, 0x54, 0x4c, 0x44, 0x00}, // 7A z
+    {0x00, 0x08, 0x36, 0x41, 0x00, 0x00}, // 7B {
+    {0x00, 0x00, 0x7f, 0x00, 0x00, 0x00}, // 7C |
+    {0x00, 0x41, 0x36, 0x08, 0x00, 0x00}, // 7D }
+    {0x04, 0x02, 0x04, 0x08, 0x04, 0x00}, // 7E ~
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // A0 espaço sem quebra
+    {0x00, 0x00, 0x7d, 0x00, 0x00, 0x00}, // A1 ¡
+    {0x1c, 0x22, 0x7f, 0x22, 0x10, 0x00}, // A2 ¢
+    {0x48, 0x3e, 0x49, 0x41, 0x22, 0x00}, // A3 £
+    {0x22, 0x1c, 0x14, 0x1c, 0x22, 0x00}, // A4 ¤
+    {0x15, 0x16, 0x7c, 0x16, 0x15, 0x00}, // A5 ¥
+    {0x00, 0x00, 0x77, 0x00, 0x00, 0x00}, // A6 ¦
+    {0x4a, 0x55, 0x55, 0x29, 0x00, 0x00}, // A7 §
+    {0x00, 0x01, 0x00, 0x01, 0x00, 0x00}, // A8 ¨
+    {0x3e, 0x41, 0x5d, 0x55, 0x3e, 0x00}, // A9 ©
+    {0x48, 0x55, 0x55, 0x5e, 0x00, 0x00}, // AA ª
+    {0x08, 0x14, 0x2a, 0x14, 0x22, 0x00}, // AB «
+    {0x04, 0x04, 0x04, 0x04, 0x1c, 0x00}, // AC ¬
+    {0x00, 0x08, 0x08, 0x08, 0x00, 0x00}, // AD hífen condicional
+    {0x3e, 0x55, 0x4d, 0x51, 0x3e, 0x00}, // AE ®
+    {0x01, 0x01, 0x01, 0x01, 0x01, 0x00}, // AF ¯
+    {0x06, 0x09, 0x09, 0x06, 0x00, 0x00}, // B0 °
+    {0x44, 0x44, 0x5f, 0x44, 0x44, 0x00}, // B1 ±
+    {0x12, 0x19, 0x15, 0x12, 0x00, 0x00}, // B2 ²
+    {0x11, 0x15, 0x15, 0x0a, 0x00, 0x00}, // B3 ³
+    {0x00, 0x00, 0x02, 0x01, 0x00, 0x00}, // B4 ´
+    {0xfc, 0x40, 0x40, 0x7c, 0x00, 0x00}, // B5 µ
+    {0x06, 0x0f, 0x7f, 0x01, 0x7f, 0x00}, // B6 ¶
+    {0x00, 0x00, 0x08, 0x00, 0x00, 0x00}, // B7 ·
+    {0x00, 0x80, 0xc0, 0x00, 0x00, 0x00}, // B8 ¸
+    {0x12, 0x1f, 0x10, 0x00, 0x00, 0x00}, // B9 ¹
+    {0x46, 0x49, 0x49, 0x46, 0x00, 0x00}, // BA º
+    {0x22, 0x14, 0x2a, 0x14, 0x08, 0x00}, // BB »
+    {0x17, 0x28, 0x34, 0x7a, 0x21, 0x00}, // BC ¼
+    {0x17, 0x08, 0x44, 0x6a, 0x59, 0x00}, // BD ½
+    {0x15, 0x3f, 0x20, 0x7e, 0x31, 0x00}, // BE ¾
+    {0x30, 0x48, 0x45, 0x40, 0x20, 0x00}, // BF ¿
+    {0x78, 0x25, 0x26, 0x24, 0x78, 0x00}, // C0 À
+    {0x78, 0x24, 0x26, 0x25, 0x78, 0x00}, // C1 Á
+    {0x78, 0x26, 0x25, 0x26, 0x78, 0x00}, // C2 Â
+    {0x7a, 0x25, 0x25, 0x26, 0x79, 0x00}, // C3 Ã
+    {0x78, 0x25, 0x24, 0x25, 0x78, 0x00}, // C4 Ä
+    {0x78, 0x27, 0x25, 0x27, 0x78, 0x00}, // C5 Å
+    {0x7e, 0x09, 0x7f, 0x49, 0x49, 0x00}, // C6 Æ
+    {0x3e, 0xc1, 0xc1, 0x41, 0x22, 0x00}, // C7 Ç
+    {0x7c, 0x55, 0x56, 0x54, 0x44, 0x00}, // C8 È
+    {0x7c, 0x54, 0x56, 0x55, 0x44, 0x00}, // C9 É
+    {0x7c, 0x56, 0x55, 0x56, 0x44, 0x00}, // CA Ê
+    {0x7c, 0x55, 0x54, 0x55, 0x44, 0x00}, // CB Ë
+    {0x00, 0x45, 0x7e, 0x44, 0x00, 0x00}, // CC Ì
+    {0x00, 0x44, 0x7e, 0x45, 0x00, 0x00}, // CD Í
+    {0x00, 0x46, 0x7d, 0x46, 0x00, 0x00}, // CE Î
+    {0x00, 0x45, 0x7c, 0x45, 0x00, 0x00}, // CF Ï
+    {0x7f, 0x49, 0x49, 0x22, 0x1c, 0x00}, // D0 Ð
+    {0x7e, 0x09, 0x11, 0x22, 0x7d, 0x00}, // D1 Ñ
+    {0x38, 0x45, 0x46, 0x44, 0x38, 0x00}, // D2 Ò
+    {0x38, 0x44, 0x46, 0x45, 0x38, 0x00}, // D3 Ó
+    {0x38, 0x46, 0x45, 0x46, 0x38, 0x00}, // D4 Ô
+    {0x3a, 0x45, 0x45, 0x46, 0x39, 0x00}, // D5 Õ
+    {0x38, 0x45, 0x44, 0x45, 0x38, 0x00}, // D6 Ö
+    {0x22, 0x14, 0x08, 0x14, 0x22, 0x00}, // D7 ×
+    {0x7e, 0x61, 0x5d, 0x43, 0x3f, 0x00}, // D8 Ø
+    {0x3c, 0x41, 0x42, 0x40, 0x3c, 0x00}, // D9 Ù
+    {0x3c, 0x40, 0x42, 0x41, 0x3c, 0x00}, // DA Ú
+    {0x3c, 0x42, 0x41, 0x42, 0x3c, 0x00}, // DB Û
+    {0x3c, 0x41, 0x40, 0x41, 0x3c, 0x00}, // DC Ü
+    {0x04, 0x08, 0x72, 0x09, 0x04, 0x00}, // DD Ý
+    {0x7f, 0x12, 0x12, 0x12, 0x0c, 0x00}, // DE Þ
+    {0x7e, 0x01, 0x49, 0x36, 0x00, 0x00}, // DF ß
+    {0x20, 0x55, 0x56, 0x54, 0x78, 0x00}, // E0 à
+    {0x20, 0x54, 0x56, 0x55, 0x78, 0x00}, // E1 á
+    {0x20, 0x56, 0x55, 0x56, 0x78, 0x00}, // E2 â
+    {0x22, 0x55, 0x55, 0x56, 0x79, 0x00}, // E3 ã
+    {0x20, 0x55, 0x54, 0x55, 0x78, 0x00}, // E4 ä
+    {0x20, 0x57, 0x55, 0x57, 0x78, 0x00}, // E5 å
+    {0x74, 0x54, 0x38, 0x54, 0x58, 0x00}, // E6 æ
+    {0x38, 0xc4, 0xc4, 0x44, 0x20, 0x00}, // E7 ç
+    {0x38, 0x55, 0x56, 0x54, 0x18, 0x00}, // E8 è
+    {0x38, 0x54, 0x56, 0x55, 0x18, 0x00}, // E9 é
+    {0x38, 0x56, 0x55, 0x56, 0x18, 0x00}, // EA ê
+    {0x38, 0x55, 0x54, 0x55, 0x18, 0x00}, // EB ë
+    {0x00, 0x45, 0x7e, 0x40, 0x00, 0x00}, // EC ì
+    {0x00, 0x44, 0x7e, 0x41, 0x00, 0x00}, // ED í
+    {0x00, 0x46, 0x7d, 0x42, 0x00, 0x00}, // EE î
+    {0x00, 0x45, 0x7c, 0x41, 0x00, 0x00}, // EF ï
+    {0x35, 0x4a, 0x4d, 0x48, 0x30, 0x00}, // F0 ð
+    {0x7e, 0x09, 0x05, 0x06, 0x79, 0x00}, // F1 ñ
+    {0x38, 0x45, 0x46, 0x44, 0x38, 0x00}, // F2 ò
+    {0x38, 0x44, 0x46, 0x45, 0x38, 0x00}, // F3 ó
+    {0x38, 0x46, 0x45, 0x46, 0x38, 0x00}, // F4 ô
+    {0x3a, 0x45, 0x45, 0x46, 0x39, 0x00}, // F5 õ
+    {0x38, 0x45, 0x44, 0x45, 0x38, 0x00}, // F6 ö
+    {0x08, 0x08, 0x2a, 0x08, 0x08, 0x00}, // F7 ÷
+    {0x78, 0x64, 0x54, 0x4c, 0x3c, 0x00}, // F8 ø
+    {0x3c, 0x41, 0x42, 0x20, 0x7c, 0x00}, // F9 ù
+    {0x3c, 0x40, 0x42, 0x21, 0x7c, 0x00}, // FA ú
+    {0x3c, 0x42, 0x41, 0x22, 0x7c, 0x00}, // FB û
+    {0x3c, 0x41, 0x40, 0x21, 0x7c, 0x00}, // FC ü
+    {0x0c, 0x50, 0x52, 0x51, 0x3c, 0x00}, // FD ý
+    {0xfe, 0x24, 0x24, 0x24, 0x18, 0x00}, // FE þ
+    {0x0c, 0x51, 0x50, 0x51, 0x3c, 0x00}, // FF ÿ
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include <string.h>
+#include "oled_grafico.h"
+
+void oled_grafico_iniciar(oled_grafico_t *g, int x, int pagina, int largura, int paginas, int32_t minimo, int32_t maximo) {
+    if (paginas < 1) paginas = 1;
+    if (paginas > OLED_GRAFICO_PAGINAS_MAX) paginas = OLED_GRAFICO_PAGINAS_MAX;
+    *g = (oled_grafico_t){
+        .x = x,
+        .pagina = pagina,
+        .largura = largura,
+        .paginas = paginas,
+        .minimo = minimo,
+        .maximo = maximo > minimo ? maximo : minimo + 1,
+        .vazio = true,
+    };
+}
+
+void oled_grafico_limpar(const oled_quadro_t *q, oled_grafico_t *g) {
+    for (int k = 0; k < g->paginas; k++) {
+        memset(q->bytes + (g->pagina + k) * q->largura + g->x, 0, g->largura);
+    }
+    g->vazio = true;
+}
+
+// Linha do valor na faixa, 0 em cima, arredondada e limitada às bordas
+static int linha_do_valor(const oled_grafico_t *g, int32_t valor) {
+    int altura = 8 * g->paginas;
+    if (valor <= g->minimo) return altura - 1;
+    if (valor >= g->maximo) return 0;
+    int32_t faixa = g->maximo - g->minimo;
+    int acima = (int)(((valor - g->minimo) * (int64_t)(altura - 1) + faixa / 2) / faixa);
+    return altura - 1 - acima;
+}
+
+void oled_grafico_adicionar(const oled_quadro_t *q, oled_grafico_t *g, int32_t valor) {
+    if (g->largura < 1) {
+        return;
+    }
+    int linha = linha_do_valor(g, valor);
+    int de = g->vazio ? linha : g->linha_anterior;
+    int ate = linha;
+    if (de > ate) {
+        int t = de;
+        de = ate;
+        ate = t;
+    }
+    // Bits de 'de' a 'ate'; com ate = 31, 2u << 31 dá 0 e a subtração completa a máscara
+    uint32_t coluna = ((2u << ate) - 1) & ~((1u << de) - 1);
+
+    uint8_t *linha_pagina = q->bytes + g->pagina * q->largura + g->x;
+    for (int k = 0; k < g->paginas; k++) {
+        memmove(linha_pagina, linha_pagina + 1, g->largura - 1);
+        linha_pagina[g->largura - 1] = (uint8_t)(coluna >> (8 * k));
+        linha_pagina += q->largura;
+    }
+    g->linha_anterior = linha;
+    g->vazio = false;
+}
@@ -0,0 +1,36 @@
+#ifndef oled_grafico_inc_h
+#define oled_grafico_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "oled_texto.h"
+
+// Gráfico de tendência (sparkline) numa faixa retangular do quadro do OLED (oled_quadro_t), com a
+// amostra mais recente na última coluna. A faixa começa numa página e ocupa páginas inteiras.
+// Cada amostra nova desloca a faixa uma coluna para a esquerda, com um memmove por página, e
+// desenha só a coluna nova: um traço vertical da altura da amostra anterior até a da nova, para
+// a linha sair contínua. Nada do que já foi desenhado é recalculado.
+// A escala é fixa (minimo a maximo, nas unidades da amostra): uma escala automática mudaria a
+// altura das colunas antigas e obrigaria a redesenhar o gráfico. Valores de fora ficam na borda.
+// Não usa o scroll horizontal do SSD1306: ele é contínuo (não anda uma coluna só), move as
+// páginas inteiras, com o texto ao lado, e a GRAM tem de ser reescrita depois de desligá-lo.
+
+#define OLED_GRAFICO_PAGINAS_MAX 4      // Coluna com até 32 pixels, num uint32_t
+
+typedef struct {
+    int x;                  // Primeira coluna da faixa
+    int pagina;             // Primeira página da faixa
+    int largura;            // Colunas (uma por amostra)
+    int paginas;            // 1 a OLED_GRAFICO_PAGINAS_MAX
+    int32_t minimo;         // Valor na linha de baixo
+    int32_t maximo;         // Valor na linha de cima
+    int linha_anterior;     // Linha (0 em cima) da última amostra
+    bool vazio;             // Nenhuma amostra ainda
+} oled_grafico_t;
+
+void oled_grafico_iniciar(oled_grafico_t *g, int x, int pagina, int largura, int paginas, int32_t minimo, int32_t maximo);
+// Apaga a faixa e esquece as amostras
+void oled_grafico_limpar(const oled_quadro_t *q, oled_grafico_t *g);
+void oled_grafico_adicionar(const oled_quadro_t *q, oled_grafico_t *g, int32_t valor);
+
+#endif
@@ -0,0 +1,123 @@
+#include <string.h>
+#include "oled_texto.h"
+#include "oled_fonte.h"
+
+// Próximo caractere de um texto UTF-8 como código Latin-1. Sequências de fora do Latin-1 ou
+// malformadas contam como um '?' cada.
+static uint8_t proximo_caractere(const char **texto) {
+    const uint8_t *p = (const uint8_t *)*texto;
+    uint8_t c = *p++;
+    if (c < 0x80) {
+        *texto = (const char *)p;
+        return c;
+    }
+    if ((c == 0xC2 || c == 0xC3) && (*p & 0xC0) == 0x80) {
+        uint8_t latin1 = (uint8_t)((c & 0x03) << 6 | (*p & 0x3F));
+        *texto = (const char *)(p + 1);
+        return latin1;
+    }
+    while ((*p & 0xC0) == 0x80) {
+        p++;
+    }
+    *texto = (const char *)p;
+    return '?';
+}
+
+static const uint8_t *glifo(uint8_t latin1) {
+    if (latin1 >= 0x20 && latin1 <= 0x7E) {
+        return oled_fonte[latin1 - 0x20];
+    }
+    if (latin1 >= 0xA0) {
+        return oled_fonte[95 + latin1 - 0xA0];
+    }
+    return oled_fonte['?' - 0x20];
+}
+
+static int limitar_escala(int escala) {
+    return escala < 1 ? 1 : escala > OLED_TEXTO_ESCALA_MAX ? OLED_TEXTO_ESCALA_MAX : escala;
+}
+
+// Cada pixel da coluna repetido 'escala' vezes na vertical
+static uint32_t ampliar(uint8_t coluna, int escala) {
+    uint32_t bloco = (1u << escala) - 1;
+    uint32_t ampliada = 0;
+    for (int i = 0; i < 8; i++) {
+        if (coluna & (1u << i)) {
+            ampliada |= bloco << (i * escala);
+        }
+    }
+    return ampliada;
+}
+
+void oled_texto_caractere(const oled_quadro_t *q, int x, int y, uint8_t latin1, int escala) {
+    escala = limitar_escala(escala);
+    int largura = OLED_FONTE_LARGURA * escala;
+    int altura = 8 * escala;
+    if (y + altura <= 0 || y >= q->paginas * 8 || x >= q->largura || x + largura <= 0) {
+        return;
+    }
+
+    const uint8_t *colunas = glifo(latin1);
+    int primeira = x < 0 ? -x : 0;
+    int ultima = x + largura > q->largura ? q->largura - x : largura;
+    int pagina = y < 0 ? 0 : y / 8;
+    uint8_t *destino = q->bytes + pagina * q->largura + x;
+
+    // Célula alinhada à página: as colunas do glifo já são os bytes do quadro
+    if (escala == 1 && y % 8 == 0) {
+        memcpy(destino + primeira, colunas + primeira, ultima - primeira);
+        return;
+    }
+
+    // Fora do alinhamento (ou ampliada) a coluna cobre várias páginas: é deslocada para a posição
+    // dentro da primeira e substitui, em cada página, só os bits da célula. Acima do quadro, as
+    // linhas que ficam de fora saem pela direita e a célula começa na página 0.
+    int acima = y < 0 ? -y : 0;
+    int deslocamento = y < 0 ? 0 : y % 8;
+    uint32_t mascara = (((1u << altura) - 1) >> acima) << deslocamento;
+    int paginas = (deslocamento + altura - acima + 7) / 8;
+    if (paginas > q->paginas - pagina) {
+        paginas = q->paginas - pagina;
+    }
+    for (int i = primeira; i < ultima; i++) {
+        uint32_t bits = (escala == 1 ? colunas[i] : ampliar(colunas[i / escala], escala)) >> acima << deslocamento;
+        uint8_t *byte = destino + i;
+        for (int k = 0; k < paginas; k++) {
+            uint8_t m = (uint8_t)(mascara >> (8 * k));
+            *byte = (uint8_t)((*byte & ~m) | (bits >> (8 * k)));
+            byte += q->largura;
+        }
+    }
+}
+
+int oled_texto_desenhar(const oled_quadro_t *q, int x, int y, const char *texto, int escala) {
+    int avanco = OLED_FONTE_LARGURA * limitar_escala(escala);
+
+    // Caso comum (texto alinhado à página, no tamanho normal): as células inteiras são copiadas
+    // com tamanho constante, que o compilador troca por poucas instruções
+    if (avanco == OLED_FONTE_LARGURA && y >= 0 && y < q->paginas * 8 && y % 8 == 0 && x >= 0) {
+        uint8_t *pagina = q->bytes + (y / 8) * q->largura;
+        while (*texto && x + OLED_FONTE_LARGURA <= q->largura) {
+            memcpy(pagina + x, glifo(proximo_caractere(&texto)), OLED_FONTE_LARGURA);
+            x += OLED_FONTE_LARGURA;
+        }
+    }
+
+    while (*texto) {
+        uint8_t c = proximo_caractere(&texto);
+        if (x < q->largura) {
+            oled_texto_caractere(q, x, y, c, escala);
+        }
+        x += avanco;
+    }
+    return x;
+}
+
+int oled_texto_largura(const char *texto, int escala) {
+    int caracteres = 0;
+    while (*texto) {
+        proximo_caractere(&texto);
+        caracteres++;
+    }
+    return caracteres * OLED_FONTE_LARGURA * limitar_escala(escala);
+}
@@ -0,0 +1,31 @@
+#ifndef oled_texto_inc_h
+#define oled_texto_inc_h
+
+#include <stdint.h>
+
+// Texto num quadro de display monocromático no formato do SSD1306: páginas de 8 linhas, um byte
+// por coluna de cada página, bit 0 em cima. Não depende do SDK nem do driver: quem desenha num
+// display de verdade marca depois as colunas alteradas (inc/ssd1306_i2c.c).
+// Os textos são UTF-8 e a fonte (inc/oled_fonte.h) cobre o ASCII imprimível e o Latin-1, com os
+// acentos do português; o resto vira '?'.
+// Cada caractere ocupa uma célula opaca de OLED_FONTE_LARGURA x 8 pixels, multiplicada pela
+// escala (1 a 3), em qualquer y: numa célula alinhada à página as colunas são copiadas direto; fora
+// dela, cada coluna é deslocada e combinada com as duas (ou, ampliada, três) páginas que cobre.
+// O que sair do quadro é cortado, em qualquer borda: com y negativo só aparecem as linhas de baixo.
+
+#define OLED_FONTE_LARGURA 6
+#define OLED_FONTE_ALTURA 8
+#define OLED_TEXTO_ESCALA_MAX 3
+
+typedef struct {
+    uint8_t *bytes;
+    int largura;        // Colunas
+    int paginas;        // Linhas / 8
+} oled_quadro_t;
+
+// Retorna o x logo depois do último caractere (mesmo que cortado)
+int oled_texto_desenhar(const oled_quadro_t *q, int x, int y, const char *texto, int escala);
+void oled_texto_caractere(const oled_quadro_t *q, int x, int y, uint8_t latin1, int escala);
+int oled_texto_largura(const char *texto, int escala);
+
+#endif
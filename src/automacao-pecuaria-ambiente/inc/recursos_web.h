@@ -0,0 +1,19 @@
+#ifndef recursos_web_inc_h
+#define recursos_web_inc_h
+
+#include <stdint.h>
+
+// Recursos estáticos do painel web (pasta web/), comprimidos em gzip durante o build
+// por embutir_recursos_web.cmake e gravados na flash como arrays const.
+typedef struct {
+    const char *caminho;        // Caminho da URL ("/" para index.html)
+    const char *tipo;           // Content-Type
+    const char *etag;           // ETag, já entre aspas
+    const uint8_t *dados;       // Conteúdo gzip
+    uint32_t tamanho;
+} recurso_web_t;
+
+extern const recurso_web_t recursos_web[];
+extern const uint32_t recursos_web_quantidade;
+
+#endif
@@ -0,0 +1,128 @@
+#include <string.h>
+#include "regras.h"
+
+void regras_iniciar(motor_regras_t *m) {
+    memset(m, 0, sizeof(*m));
+}
+
+bool regras_config_valida(const regra_config_t *c) {
+    if (c->entrada >= REGRA_NUM_ENTRADAS) {
+        return false;
+    }
+    if (c->sentido == REGRA_LIGA_ACIMA ? c->desliga > c->liga : c->desliga < c->liga) {
+        return false;   // Histerese invertida: a regra oscilaria
+    }
+    return c->janela_inicio < REGRAS_MINUTOS_DIA && c->janela_fim < REGRAS_MINUTOS_DIA;
+}
+
+// Cria uma regra desligada. Retorna seu índice, ou -1 se a configuração for inválida ou não houver espaço.
+int regras_adicionar(motor_regras_t *m, const regra_config_t *config) {
+    if (m->quantidade == REGRAS_MAX || !regras_config_valida(config)) {
+        return -1;
+    }
+    int indice = m->quantidade++;
+    m->regras[indice] = (regra_t){.config = *config, .pendente = true};
+    return indice;
+}
+
+// Troca a configuração (limiares, tempos, janela) de uma regra em funcionamento. O estado do
+// atuador e a contagem do tempo mínimo são mantidos; a regra é reavaliada na próxima passagem.
+bool regras_configurar(motor_regras_t *m, int indice, const regra_config_t *config) {
+    if (indice < 0 || indice >= m->quantidade || !regras_config_valida(config)) {
+        return false;
+    }
+    const char *nome = m->regras[indice].config.nome;
+    m->regras[indice].config = *config;
+    m->regras[indice].config.nome = nome;
+    m->regras[indice].pendente = true;
+    return true;
+}
+
+// Atualiza uma leitura; só as regras que a observam (e só se o valor mudou) ficam pendentes
+void regras_entrada(motor_regras_t *m, regra_entrada_t entrada, int16_t valor) {
+    uint8_t bit = 1u << entrada;
+    if ((m->entradas_validas & bit) && m->entradas[entrada] == valor) {
+        return;
+    }
+    m->entradas[entrada] = valor;
+    m->entradas_validas |= bit;
+    for (int i = 0; i < m->quantidade; i++) {
+        if (m->regras[i].config.entrada == entrada) {
+            m->regras[i].pendente = true;
+        }
+    }
+}
+
+static bool tem_janela(const regra_config_t *c) {
+    return c->janela_inicio != c->janela_fim;
+}
+
+// Atualiza o minuto do dia; só as regras com janela de horário ficam pendentes
+void regras_horario(motor_regras_t *m, uint16_t minuto_dia) {
+    if (m->minuto_dia == minuto_dia) {
+        return;
+    }
+    m->minuto_dia = minuto_dia;
+    for (int i = 0; i < m->quantidade; i++) {
+        if (tem_janela(&m->regras[i].config)) {
+            m->regras[i].pendente = true;
+        }
+    }
+}
+
+static bool dentro_da_janela(const regra_config_t *c, uint16_t minuto) {
+    if (!tem_janela(c)) {
+        return true;
+    }
+    if (c->janela_inicio < c->janela_fim) {
+        return minuto >= c->janela_inicio && minuto < c->janela_fim;
+    }
+    return minuto >= c->janela_inicio || minuto < c->janela_fim;
+}
+
+// Estado que a regra pede, antes dos tempos mínimos. Dentro da histerese, mantém o atual.
+static bool estado_desejado(const motor_regras_t *m, const regra_t *r) {
+    const regra_config_t *c = &r->config;
+    if (!dentro_da_janela(c, m->minuto_dia)) {
+        return false;
+    }
+    int16_t v = m->entradas[c->entrada];
+    if (c->sentido == REGRA_LIGA_ACIMA) {
+        if (v > c->liga) return true;
+        if (v <= c->desliga) return false;
+    } else {
+        if (v < c->liga) return true;
+        if (v >= c->desliga) return false;
+    }
+    return r->ligado;
+}
+
+// Reavalia as regras pendentes. Retorna uma máscara (bit i = regra i) das que trocaram de estado.
+// Uma troca barrada pelo tempo mínimo deixa a regra pendente até o tempo vencer.
+uint32_t regras_avaliar(motor_regras_t *m, uint32_t agora_s) {
+    uint32_t trocadas = 0;
+    for (int i = 0; i < m->quantidade; i++) {
+        regra_t *r = &m->regras[i];
+        if (!r->pendente) {
+            continue;
+        }
+        if (!(m->entradas_validas & (1u << r->config.entrada))) {
+            continue;   // Sem leitura ainda; fica pendente
+        }
+        m->avaliacoes++;
+
+        bool desejado = estado_desejado(m, r);
+        if (desejado != r->ligado) {
+            uint32_t minimo = r->ligado ? r->config.minimo_ligado_s : r->config.minimo_desligado_s;
+            if (r->trocas > 0 && agora_s - r->ultima_troca_s < minimo) {
+                continue;
+            }
+            r->ligado = desejado;
+            r->ultima_troca_s = agora_s;
+            r->trocas++;
+            trocadas |= 1u << i;
+        }
+        r->pendente = false;
+    }
+    return trocadas;
+}
@@ -0,0 +1,71 @@
+#ifndef regras_inc_h
+#define regras_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Motor de regras de controle, dirigido por tabela e sem dependência do SDK.
+// Cada atuador tem uma regra: a entrada que observa, um limiar para ligar e outro para desligar
+// (a faixa entre os dois é a histerese), tempos mínimos ligado e desligado e, opcionalmente, uma
+// janela de horário fora da qual fica desligado. Uma regra só é reavaliada quando uma de suas
+// entradas (a leitura ou, se tiver janela, o minuto do dia) muda, ou enquanto uma troca espera o
+// tempo mínimo vencer. As leituras e os limiares estão em décimos (°C, % ou % de luz).
+
+#define REGRAS_MAX 8
+#define REGRAS_MINUTOS_DIA (24 * 60)
+
+typedef enum {
+    REGRA_ENTRADA_TEMPERATURA,
+    REGRA_ENTRADA_UMIDADE,
+    REGRA_ENTRADA_LUMINOSIDADE,
+    REGRA_NUM_ENTRADAS
+} regra_entrada_t;
+
+typedef enum {
+    REGRA_LIGA_ACIMA,        // Liga acima de 'liga' e desliga em 'desliga' ou abaixo (desliga <= liga)
+    REGRA_LIGA_ABAIXO,       // Liga abaixo de 'liga' e desliga em 'desliga' ou acima (desliga >= liga)
+} regra_sentido_t;
+
+// Parte configurável da regra; é o que /api/rules mostra e altera
+typedef struct {
+    const char *nome;
+    regra_entrada_t entrada;
+    regra_sentido_t sentido;
+    int16_t liga;
+    int16_t desliga;
+    uint16_t minimo_ligado_s;
+    uint16_t minimo_desligado_s;
+    uint16_t janela_inicio;  // Minuto do dia; igual a janela_fim = o dia todo; maior = atravessa a meia-noite
+    uint16_t janela_fim;
+} regra_config_t;
+
+typedef struct {
+    regra_config_t config;
+    bool ligado;
+    bool pendente;           // Precisa ser reavaliada na próxima passagem
+    uint32_t ultima_troca_s;
+    uint32_t trocas;
+} regra_t;
+
+typedef struct {
+    regra_t regras[REGRAS_MAX];
+    uint8_t quantidade;
+    int16_t entradas[REGRA_NUM_ENTRADAS];
+    uint8_t entradas_validas;            // Bit n: a entrada n já recebeu um valor
+    uint16_t minuto_dia;
+    uint32_t avaliacoes;                 // Regras efetivamente avaliadas (para as estatísticas)
+} motor_regras_t;
+
+void regras_iniciar(motor_regras_t *m);
+int regras_adicionar(motor_regras_t *m, const regra_config_t *config);
+bool regras_config_valida(const regra_config_t *config);
+bool regras_configurar(motor_regras_t *m, int indice, const regra_config_t *config);
+void regras_entrada(motor_regras_t *m, regra_entrada_t entrada, int16_t valor);
+void regras_horario(motor_regras_t *m, uint16_t minuto_dia);
+uint32_t regras_avaliar(motor_regras_t *m, uint32_t agora_s);
+
+static inline bool regras_ligado(const motor_regras_t *m, int indice) {
+    return m->regras[indice].ligado;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include <string.h>
+#include "serie_binaria.h"
+
+static size_t escrever_u32(uint8_t *destino, uint32_t v) {
+    destino[0] = v;
+    destino[1] = v >> 8;
+    destino[2] = v >> 16;
+    destino[3] = v >> 24;
+    return 4;
+}
+
+static size_t escrever_varint(uint8_t *destino, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        destino[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    destino[n++] = (uint8_t)v;
+    return n;
+}
+
+// Zig-zag: valores pequenos, positivos ou negativos, viram varints curtos (0, -1, 1, -2... -> 0, 1, 2, 3...)
+static size_t escrever_zigzag(uint8_t *destino, int32_t v) {
+    return escrever_varint(destino, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+size_t serie_binaria_cabecalho(serie_binaria_t *s, uint8_t *destino, uint32_t primeira_sequencia,
+                               uint32_t proxima_sequencia, uint32_t epoch_base) {
+    memcpy(destino, "HBIN", 4);
+    destino[4] = SERIE_BINARIA_VERSAO;
+    destino[5] = SERIE_BINARIA_CABECALHO;
+    destino[6] = 0;
+    destino[7] = 0;
+    escrever_u32(destino + 8, primeira_sequencia);
+    escrever_u32(destino + 12, proxima_sequencia);
+    escrever_u32(destino + 16, epoch_base);
+
+    *s = (serie_binaria_t){.sequencia = primeira_sequencia, .epoch = epoch_base};
+    return SERIE_BINARIA_CABECALHO;
+}
+
+// Escreve um registro (no máximo SERIE_BINARIA_REGISTRO_MAX bytes) e retorna o tamanho
+size_t serie_binaria_registro(serie_binaria_t *s, uint8_t *destino, uint32_t sequencia, const amostra_t *a) {
+    size_t n = 0;
+    n += escrever_varint(destino + n, sequencia - s->sequencia);
+    n += escrever_zigzag(destino + n, (int32_t)(a->epoch - s->epoch));
+    n += escrever_zigzag(destino + n, a->temperatura - s->temperatura);
+    n += escrever_zigzag(destino + n, a->umidade - s->umidade);
+    n += escrever_zigzag(destino + n, a->luminosidade - s->luminosidade);
+    n += escrever_varint(destino + n, a->reles);
+
+    s->sequencia = sequencia + 1;
+    s->epoch = a->epoch;
+    s->temperatura = a->temperatura;
+    s->umidade = a->umidade;
+    s->luminosidade = a->luminosidade;
+    return n;
+}
@@ -0,0 +1,46 @@
+#ifndef serie_binaria_inc_h
+#define serie_binaria_inc_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "historico.h"
+
+// Formato binário do histórico (/api/history.bin), versão 1. Inteiros fixos em little-endian.
+//
+// Cabeçalho (20 bytes):
+//   0  "HBIN"                 assinatura
+//   4  u8  versao             1
+//   5  u8  tamanho_cabecalho  20 (versões futuras podem acrescentar campos; o leitor pula o resto)
+//   6  u16 reservado          0
+//   8  u32 primeira_sequencia número de sequência esperado para o primeiro registro
+//  12  u32 proxima_sequencia  cursor para a próxima coleta (?since=); os registros ficam abaixo dele
+//  16  u32 epoch_base         referência do primeiro delta de tempo
+//
+// Registros, até o fim do corpo, cada um com 6 varints (7 bits por byte, bit 7 = continua):
+//   salto       varint     amostras puladas antes desta (normalmente 0)
+//   d_epoch     zz-varint  segundos desde o registro anterior (o primeiro, desde epoch_base)
+//   d_temp      zz-varint  décimos de °C, diferença para o registro anterior (o primeiro, para 0)
+//   d_umid      zz-varint  décimos de %, idem
+//   d_luz       zz-varint  décimos de %, idem
+//   reles       varint     bits HISTORICO_RELE_*
+// zz-varint é o valor com sinal em zig-zag ((v << 1) ^ (v >> 31)) e então em varint.
+// Referência de leitura: tools/decodificar_historico.c.
+
+#define SERIE_BINARIA_VERSAO 1
+#define SERIE_BINARIA_CABECALHO 20
+#define SERIE_BINARIA_REGISTRO_MAX 30   // 6 varints de até 5 bytes
+
+// Valores do registro anterior, de onde saem os deltas do próximo
+typedef struct {
+    uint32_t sequencia;      // Sequência esperada para o próximo registro
+    uint32_t epoch;
+    int32_t temperatura;
+    int32_t umidade;
+    int32_t luminosidade;
+} serie_binaria_t;
+
+size_t serie_binaria_cabecalho(serie_binaria_t *s, uint8_t *destino, uint32_t primeira_sequencia,
+                               uint32_t proxima_sequencia, uint32_t epoch_base);
+size_t serie_binaria_registro(serie_binaria_t *s, uint8_t *destino, uint32_t sequencia, const amostra_t *a);
+
+#endif
@@ -1,98 +1,168 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
+#include <assert.h>
 #include "pico/stdlib.h"
-#include "pico/binary_info.h"
-#include "hardware/i2c.h"
-#include "ssd1306_font.h"
-#include "ssd1306_i2c.h"
+#include "hal.h"
+#include "oled_texto.h"
+#include "oled_grafico.h"
+#include "ssd1306.h"
+
+// Área de renderização: uma faixa de colunas de uma ou mais páginas
+struct render_area {
+    uint8_t start_column;
+    uint8_t end_column;
+    uint8_t start_page;
+    uint8_t end_page;
+
+    int buffer_length;
+};
 
 // Calcular quanto do buffer será destinado à área de renderização
-void calculate_render_area_buffer_length(struct render_area *area) {
+static void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
 }
 
-// Processo de escrita do i2c espera um byte de controle, seguido por dados
-void ssd1306_send_command(uint8_t command) {
-    uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+// Indica se a transmissão anterior ainda está em andamento (no DMA, na FIFO ou no barramento).
+// O barramento é compartilhado: com dois painéis nele, a transmissão de um ocupa o outro.
+bool ssd1306_busy(const ssd1306_t *ssd) {
+    return hal_i2c_ocupado(ssd->barramento);
 }
 
-// Envia uma lista de comandos ao hardware
-void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+// Aguarda o fim da transmissão em andamento
+void ssd1306_wait(const ssd1306_t *ssd) {
+    while (ssd1306_busy(ssd)) {
+        tight_loop_contents();
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
+// Acrescenta uma transação I2C completa (byte de controle + dados) à fila de transmissão.
+// O byte de controle (0x00 para comandos, 0x40 para dados) abre cada transação, e transações
+// consecutivas seguem no mesmo disparo de DMA: o controlador gera um novo START após cada STOP.
+static void ssd1306_queue_transaction(ssd1306_t *ssd, uint8_t control, const uint8_t *data, size_t length) {
+    assert(ssd->tx_count + length + 1 <= ssd1306_tx_capacity);
 
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
+    uint16_t *words = ssd->tx_words + ssd->tx_count;
+    *words++ = control;
+    for (size_t i = 0; i < length; i++) {
+        *words++ = data[i];
+    }
+    words[-1] |= HAL_I2C_STOP;
+    ssd->tx_count += length + 1;
+}
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+// Envia a fila montada e retorna sem aguardar
+static void ssd1306_flush_async(ssd1306_t *ssd) {
+    if (ssd->tx_count > 0) {
+        hal_i2c_enviar(ssd->barramento, ssd->address, ssd->tx_words, ssd->tx_count);
+    }
+}
+
+// Envia uma lista de comandos ao hardware, todos numa única transação I2C
+void ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    ssd1306_wait(ssd);
+    ssd->tx_count = 0;
+    ssd1306_queue_transaction(ssd, 0x00, commands, number);
+    ssd1306_flush_async(ssd);
+    ssd1306_wait(ssd);
+}
 
-    free(temp_buffer);
+// Envia um único comando ao hardware
+void ssd1306_send_command(ssd1306_t *ssd, uint8_t command) {
+    ssd1306_send_command_list(ssd, &command, 1);
 }
 
-// Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
-void ssd1306_init() {
+// Acrescenta à fila o endereçamento de uma área e os seus dados
+static void ssd1306_queue_area(ssd1306_t *ssd, const uint8_t *data, const struct render_area *area) {
+    uint8_t commands[] = {
+        ssd1306_set_column_address, area->start_column, area->end_column,
+        ssd1306_set_page_address, area->start_page, area->end_page
+    };
+
+    ssd1306_queue_transaction(ssd, 0x00, commands, count_of(commands));
+    ssd1306_queue_transaction(ssd, 0x40, data, area->buffer_length);
+}
+
+// Prepara o painel 'address' do barramento 'barramento' (já iniciado com hal_i2c_iniciar) e envia
+// a sequência de inicialização numa única transação. O quadro começa apagado e inteiro por enviar.
+void ssd1306_init(ssd1306_t *ssd, uint barramento, uint8_t address, uint8_t width, uint8_t height, bool external_vcc) {
+    assert(width <= ssd1306_width && height <= ssd1306_height && height % 8 == 0);
+
+    memset(ssd, 0, sizeof(*ssd));
+    ssd->barramento = barramento;
+    ssd->address = address;
+    ssd->width = width;
+    ssd->height = height;
+    ssd->pages = height / ssd1306_page_height;
+    ssd->external_vcc = external_vcc;
+
     uint8_t commands[] = {
         ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
-        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01, 
-        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, height - 1,
         ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
         0x00, ssd1306_set_common_pin_configuration,
-    
-#if ((ssd1306_width == 128) && (ssd1306_height == 32))
-    0x02,
-#elif ((ssd1306_width == 128) && (ssd1306_height == 64))
-    0x12,
-#else
-    0x02,
-#endif
+        (width == 128 && height == 64) ? 0x12 : 0x02,
         ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
-        0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
+        external_vcc ? 0x22 : 0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
         0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
-        ssd1306_set_charge_pump, 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_charge_pump, external_vcc ? 0x10 : 0x14, ssd1306_set_scroll | 0x00,
         ssd1306_set_display | 0x01,
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
 // Cria a lista de comandos para configurar o scrolling
-void ssd1306_scroll(bool set) {
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
     uint8_t commands[] = {
-        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, 0x03,
+        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, ssd->pages - 1,
         0x00, 0xFF, ssd1306_set_scroll | (set ? 0x01 : 0)
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
-    uint8_t commands[] = {
-        ssd1306_set_column_address, area->start_column, area->end_column,
-        ssd1306_set_page_address, area->start_page, area->end_page
-    };
+// Marca as colunas [x_0, x_1] da página como alteradas
+static void ssd1306_mark_dirty(ssd1306_t *ssd, int page, int x_0, int x_1) {
+    if (page < 0 || page >= ssd->pages) {
+        return;
+    }
+    if (x_0 < 0) x_0 = 0;
+    if (x_1 > ssd->width - 1) x_1 = ssd->width - 1;
+    if (x_0 > x_1) {
+        return;
+    }
 
-    ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+    if (!ssd->dirty_page[page]) {
+        ssd->dirty_page[page] = true;
+        ssd->dirty_start_column[page] = x_0;
+        ssd->dirty_end_column[page] = x_1;
+        return;
+    }
+    if (x_0 < ssd->dirty_start_column[page]) ssd->dirty_start_column[page] = x_0;
+    if (x_1 > ssd->dirty_end_column[page]) ssd->dirty_end_column[page] = x_1;
 }
 
-// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
-void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
-    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
+// Limpa o buffer inteiro, marcando todas as páginas como alteradas
+void ssd1306_clear(ssd1306_t *ssd) {
+    ssd1306_clear_area(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
 
-    const int bytes_per_row = ssd1306_width;
+// Limpa as colunas [x_0, x_1] das páginas [page_0, page_1], marcando-as como alteradas
+void ssd1306_clear_area(ssd1306_t *ssd, int x_0, int x_1, int page_0, int page_1) {
+    for (int page = page_0; page <= page_1; page++) {
+        memset(ssd->buffer + page * ssd->width + x_0, 0, x_1 - x_0 + 1);
+        ssd1306_mark_dirty(ssd, page, x_0, x_1);
+    }
+}
+
+// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
+void ssd1306_set_pixel(ssd1306_t *ssd, int x, int y, bool set) {
+    assert(x >= 0 && x < ssd->width && y >= 0 && y < ssd->height);
 
-    int byte_idx = (y / 8) * bytes_per_row + x;
-    uint8_t byte = ssd[byte_idx];
+    int byte_idx = (y / 8) * ssd->width + x;
+    uint8_t byte = ssd->buffer[byte_idx];
 
     if (set) {
         byte |= 1 << (y % 8);
@@ -101,11 +171,12 @@ void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
         byte &= ~(1 << (y % 8));
     }
 
-    ssd[byte_idx] = byte;
+    ssd->buffer[byte_idx] = byte;
+    ssd1306_mark_dirty(ssd, y / 8, x, x);
 }
 
 // Algoritmo de Bresenham básico
-void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+void ssd1306_draw_line(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
     int dx = abs(x_1 - x_0); // Deslocamentos
     int dy = -abs(y_1 - y_0);
     int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
@@ -132,114 +203,146 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
     }
 }
 
-// Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
-{
-  if (character >= 'A' && character <= 'Z') {
-    return character - 'A' + 1;
-  }
-  else if (character >= '0' && character <= '9') {
-    return character - '0' + 27;
-  }
-  else
-    return 0;
+// Quadro de trás no formato de inc/oled_texto.h, para o texto e os gráficos
+static oled_quadro_t ssd1306_frame(ssd1306_t *ssd) {
+    return (oled_quadro_t){ssd->buffer, ssd->width, ssd->pages};
 }
 
-// Desenha um único caractere no display
-void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+// Texto em qualquer y, pela fonte e pelo blitter de inc/oled_texto.h; marca as colunas tocadas
+// nas páginas que a célula cobre
+static void ssd1306_mark_text(ssd1306_t *ssd, int16_t x, int16_t y, int end_x, int scale) {
+    int bottom = y + OLED_FONTE_ALTURA * scale - 1;
+    if (bottom < 0) {
         return;
     }
+    for (int page = y < 0 ? 0 : y / 8; page <= bottom / 8; page++) {
+        ssd1306_mark_dirty(ssd, page, x, end_x - 1);
+    }
+}
 
-    y = y / 8;
+// Desenha um único caractere (Latin-1) no display
+void ssd1306_draw_char(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character) {
+    oled_quadro_t frame = ssd1306_frame(ssd);
+    oled_texto_caractere(&frame, x, y, character, 1);
+    ssd1306_mark_text(ssd, x, y, x + OLED_FONTE_LARGURA, 1);
+}
 
-    character = toupper(character);
-    int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
+// Desenha uma string UTF-8 ampliada 'scale' vezes (1 a OLED_TEXTO_ESCALA_MAX)
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, int16_t x, int16_t y, const char *string, int scale) {
+    oled_quadro_t frame = ssd1306_frame(ssd);
+    int end_x = oled_texto_desenhar(&frame, x, y, string, scale);
+    ssd1306_mark_text(ssd, x, y, end_x, scale);
+}
 
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
-    }
+// Desenha uma string UTF-8 no tamanho normal (OLED_FONTE_LARGURA x 8 pixels por caractere)
+void ssd1306_draw_string(ssd1306_t *ssd, int16_t x, int16_t y, const char *string) {
+    ssd1306_draw_string_scaled(ssd, x, y, string, 1);
 }
 
-// Desenha uma string, chamando a função de desenhar caractere várias vezes
-void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
-        return;
+// Gráfico de tendência (inc/oled_grafico.h): desloca a faixa e desenha a coluna da amostra nova.
+// A faixa inteira fica marcada, mas o envio só leva as colunas que de fato mudaram.
+static void ssd1306_mark_sparkline(ssd1306_t *ssd, const oled_grafico_t *chart) {
+    for (int page = chart->pagina; page < chart->pagina + chart->paginas; page++) {
+        ssd1306_mark_dirty(ssd, page, chart->x, chart->x + chart->largura - 1);
     }
+}
 
-    while (*string) {
-        ssd1306_draw_char(ssd, x, y, *string++);
-        x += 8;
-    }
-}
-
-// Comando de configuração com base na estrutura ssd1306_t
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
-}
-
-// Função de configuração do display para o caso do bitmap
-void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
-}
-
-// Inicializa o display para o caso de exibição de bitmap
-void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-    ssd->width = width;
-    ssd->height = height;
-    ssd->pages = height / 8U;
-    ssd->address = address;
-    ssd->i2c_port = i2c;
-    ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
-}
-
-// Envia os dados ao display
-void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-    ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
-}
-
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+void ssd1306_sparkline_add(ssd1306_t *ssd, oled_grafico_t *chart, int32_t value) {
+    oled_quadro_t frame = ssd1306_frame(ssd);
+    oled_grafico_adicionar(&frame, chart, value);
+    ssd1306_mark_sparkline(ssd, chart);
+}
+
+void ssd1306_sparkline_clear(ssd1306_t *ssd, oled_grafico_t *chart) {
+    oled_quadro_t frame = ssd1306_frame(ssd);
+    oled_grafico_limpar(&frame, chart);
+    ssd1306_mark_sparkline(ssd, chart);
+}
+
+// Copia um bitmap do tamanho do painel (páginas de cima para baixo, um byte por coluna) para o
+// quadro de trás; vai ao display no próximo render_changes_on_display()
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
+    memcpy(ssd->buffer, bitmap, ssd->pages * ssd->width);
+    for (int page = 0; page < ssd->pages; page++) {
+        ssd1306_mark_dirty(ssd, page, 0, ssd->width - 1);
+    }
+}
+
+// Envia ao display apenas as colunas do quadro de trás que mudaram em relação ao da frente.
+// Cada página alterada vira uma área de renderização própria; se nada mudou, nada é enviado.
+// Não bloqueia: as áreas são copiadas para a fila e transmitidas por DMA, e o quadro de trás pode
+// ser redesenhado logo em seguida. Se o barramento ainda estiver ocupado (por este painel ou por
+// outro no mesmo barramento), as regiões continuam marcadas e são enviadas na próxima chamada
+// (retorna -1).
+// Retorna o número de áreas enfileiradas.
+int render_changes_on_display(ssd1306_t *ssd) {
+    int areas_sent = 0;
+
+    if (ssd1306_busy(ssd)) {
+        return -1;
+    }
+    ssd->tx_count = 0;
+
+    if (!ssd->front_valid) {
+        for (int page = 0; page < ssd->pages; page++) {
+            ssd1306_mark_dirty(ssd, page, 0, ssd->width - 1);
+        }
+    }
 
-        ssd1306_send_data(ssd);
+    for (int page = 0; page < ssd->pages; page++) {
+        if (!ssd->dirty_page[page]) {
+            continue;
+        }
+        ssd->dirty_page[page] = false;
+
+        int base = page * ssd->width;
+        int first = ssd->dirty_start_column[page];
+        int last = ssd->dirty_end_column[page];
+
+        // Estreita a faixa suja para as colunas que de fato diferem do quadro da frente
+        if (ssd->front_valid) {
+            while (first <= last && ssd->buffer[base + first] == ssd->front[base + first]) first++;
+            while (last >= first && ssd->buffer[base + last] == ssd->front[base + last]) last--;
+            if (first > last) {
+                continue;
+            }
+        }
+
+        struct render_area area = {
+            .start_column = first,
+            .end_column = last,
+            .start_page = page,
+            .end_page = page
+        };
+        calculate_render_area_buffer_length(&area);
+        ssd1306_queue_area(ssd, ssd->buffer + base + first, &area);
+        memcpy(ssd->front + base + first, ssd->buffer + base + first, area.buffer_length);
+        areas_sent++;
     }
-}
\ No newline at end of file
+
+    ssd->front_valid = true;
+    ssd1306_flush_async(ssd);
+    return areas_sent;
+}
+
+// Envia o quadro inteiro, numa única área, e aguarda o fim da transmissão. Para o primeiro
+// quadro e para depois de o painel ter sido reconfigurado; no resto, render_changes_on_display().
+void render_on_display(ssd1306_t *ssd) {
+    ssd1306_wait(ssd);
+    ssd->tx_count = 0;
+
+    struct render_area area = {
+        .start_column = 0,
+        .end_column = ssd->width - 1,
+        .start_page = 0,
+        .end_page = ssd->pages - 1
+    };
+    calculate_render_area_buffer_length(&area);
+    ssd1306_queue_area(ssd, ssd->buffer, &area);
+    memcpy(ssd->front, ssd->buffer, area.buffer_length);
+    memset(ssd->dirty_page, 0, sizeof(ssd->dirty_page));
+    ssd->front_valid = true;
+
+    ssd1306_flush_async(ssd);
+    ssd1306_wait(ssd);
+}
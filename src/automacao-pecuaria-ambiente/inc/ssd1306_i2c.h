@@ -1,14 +1,14 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
 
 #ifndef ssd1306_inc_h
 #define ssd1306_inc_h
 
-#define ssd1306_height 64 // Define a altura do display (32 pixels)
+// Tamanho máximo de um painel; cada ssd1306_t escolhe a altura (32 ou 64) em ssd1306_init()
+#define ssd1306_height 64 // Define a altura máxima do display (64 pixels)
 #define ssd1306_width 128 // Define a largura do display (128 pixels)
 
-#define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
+#define ssd1306_i2c_address _u(0x3C) // Endereço padrão do display (0x3D com o jumper do módulo)
 
 #define ssd1306_i2c_clock 400 // Define o tempo do clock (pode ser aumentado)
 
@@ -47,22 +47,36 @@
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
-struct render_area {
-    uint8_t start_column;
-    uint8_t end_column;
-    uint8_t start_page;
-    uint8_t end_page;
-
-    int buffer_length;
-};
+// Fila de transmissão de um painel: o quadro inteiro, com os comandos de endereçamento de cada
+// página, e folga para uma lista de comandos
+#define ssd1306_tx_capacity (ssd1306_n_pages * (ssd1306_width + 8) + 64)
 
+// Um painel num barramento I2C (0 ou 1) e endereço próprios; vários podem coexistir, inclusive
+// no mesmo barramento. Todo o estado do driver está aqui: nenhum painel interfere no outro.
 typedef struct {
-  uint8_t width, height, pages, address;
-  i2c_inst_t * i2c_port;
-  bool external_vcc;
-  uint8_t *ram_buffer;
-  size_t bufsize;
-  uint8_t port_buffer[2];
+    uint barramento;
+    uint8_t address;
+    uint8_t width, height, pages;
+    bool external_vcc;
+
+    // Quadro de trás: onde tudo é desenhado, a qualquer momento
+    uint8_t buffer[ssd1306_buffer_length];
+    // Quadro da frente: o que o painel mostra (ou vai mostrar, com a fila ainda em trânsito).
+    // É a base para enviar só as colunas que mudaram.
+    uint8_t front[ssd1306_buffer_length];
+    bool front_valid;
+
+    // Regiões sujas: para cada página, a faixa de colunas alterada desde o último envio
+    bool dirty_page[ssd1306_n_pages];
+    uint8_t dirty_start_column[ssd1306_n_pages];
+    uint8_t dirty_end_column[ssd1306_n_pages];
+
+    // Fila de transmissão. Cada posição já está no formato do registrador IC_DATA_CMD (byte de
+    // dados + bit de STOP), para que o DMA alimente o I2C diretamente (inc/hal.h). Como os bytes
+    // são copiados do quadro de trás para cá, o desenho do quadro seguinte pode começar enquanto
+    // este ainda está no barramento.
+    uint16_t tx_words[ssd1306_tx_capacity];
+    size_t tx_count;
 } ssd1306_t;
 
 #endif
\ No newline at end of file
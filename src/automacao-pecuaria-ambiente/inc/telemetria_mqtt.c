@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <string.h>
+#include "lwip/ip_addr.h"
+#include "lwip/apps/mqtt.h"
+#include "lwip/apps/mqtt_priv.h"   // mqtt_client_t alocado estaticamente, fora do heap do lwIP
+#include "telemetria_mqtt.h"
+#include "hal.h"
+#include "historico.h"
+#include "json.h"
+
+#define RECONEXAO_MS (10 * 1000)
+#define KEEP_ALIVE_S 60
+
+static mqtt_client_t cliente;
+static telemetria_mqtt_config_t config;
+static ip_addr_t endereco_broker;
+static char topico_estado[64];
+static char payload[TELEMETRIA_MQTT_PAYLOAD_MAX];
+
+static bool enlace_ativo;
+static bool conectando;
+static bool em_voo;                      // Um lote aguarda o PUBACK
+static uint32_t proxima_sequencia;       // Primeira amostra ainda não confirmada pelo broker
+static uint32_t fim_lote;                // Sequência seguinte à última amostra do lote em voo
+static uint64_t ultima_publicacao;       // hal_tempo_us()
+static uint64_t ultima_tentativa;        // HAL_PRAZO_NENHUM = ainda não tentou
+
+// Estatísticas
+static uint32_t lotes_publicados;
+static uint32_t amostras_publicadas;
+static uint32_t amostras_perdidas;       // Sobrescritas no histórico antes de sair
+static uint32_t falhas_publicacao;
+static uint32_t conexoes;
+
+static void publicacao_concluida(void *arg, err_t err) {
+    em_voo = false;
+    if (err != ERR_OK) {
+        falhas_publicacao++;    // O mesmo lote é reenviado no próximo passo
+        return;
+    }
+    amostras_publicadas += fim_lote - proxima_sequencia;
+    lotes_publicados++;
+    proxima_sequencia = fim_lote;
+    ultima_publicacao = hal_tempo_us();
+}
+
+static void conexao_alterada(mqtt_client_t *c, void *arg, mqtt_connection_status_t status) {
+    conectando = false;
+    em_voo = false;
+    if (status == MQTT_CONNECT_ACCEPTED) {
+        conexoes++;
+        mqtt_publish(c, topico_estado, "online", 6, 1, 1, NULL, NULL);
+    } else {
+        printf("MQTT: conexao encerrada (status %d).\n", status);
+    }
+}
+
+static void conectar() {
+    static struct mqtt_connect_client_info_t info;
+    info = (struct mqtt_connect_client_info_t){
+        .client_id = config.cliente,
+        .keep_alive = KEEP_ALIVE_S,
+        .will_topic = topico_estado,
+        .will_msg = "offline",
+        .will_qos = 1,
+        .will_retain = 1,
+    };
+    ultima_tentativa = hal_tempo_us();
+    if (mqtt_client_connect(&cliente, &endereco_broker, config.porta, conexao_alterada, NULL, &info) == ERR_OK) {
+        conectando = true;
+    }
+}
+
+// Monta e publica o próximo lote a partir do cursor
+static void publicar_lote() {
+    historico_iterador_t it;
+    historico_iterar_desde(&it, proxima_sequencia);
+
+    json_escritor_t j;
+    json_iniciar(&j, payload, sizeof(payload));
+    json_abrir_objeto(&j);
+    json_chave(&j, "seq");
+    json_inteiro(&j, proxima_sequencia);
+    json_chave(&j, "amostras");
+    json_abrir_lista(&j);
+
+    // Cada amostra tem no máximo ~40 bytes; sobra espaço para fechar o documento
+    amostra_t a;
+    uint16_t n = 0;
+    while (n < config.lote_maximo && json_livre(&j) > 48 && historico_proximo(&it, &a)) {
+        json_abrir_lista(&j);
+        json_inteiro(&j, a.epoch);
+        json_inteiro(&j, a.temperatura);
+        json_inteiro(&j, a.umidade);
+        json_inteiro(&j, a.luminosidade);
+        json_inteiro(&j, a.reles);
+        json_fechar_lista(&j);
+        n++;
+    }
+    json_fechar_lista(&j);
+    json_fechar_objeto(&j);
+
+    fim_lote = it.sequencia;
+    if (mqtt_publish(&cliente, config.topico, payload, j.tamanho, 1, 0, publicacao_concluida, NULL) == ERR_OK) {
+        em_voo = true;
+    } else {
+        falhas_publicacao++;
+    }
+}
+
+bool telemetria_mqtt_iniciar(const telemetria_mqtt_config_t *c, uint32_t primeira_sequencia) {
+    config = *c;
+    if (!ipaddr_aton(config.broker, &endereco_broker)) {
+        printf("MQTT: endereco de broker invalido: %s\n", config.broker);
+        return false;
+    }
+    snprintf(topico_estado, sizeof(topico_estado), "%s/estado", config.topico);
+    memset(&cliente, 0, sizeof(cliente));
+    proxima_sequencia = primeira_sequencia;
+    ultima_publicacao = hal_tempo_us();
+    ultima_tentativa = HAL_PRAZO_NENHUM;
+    return true;
+}
+
+// Chamada (no laço principal) quando o enlace Wi-Fi cai ou volta
+void telemetria_mqtt_enlace(bool ativo) {
+    hal_rede_travar();
+    enlace_ativo = ativo;
+    if (!ativo && mqtt_client_is_connected(&cliente)) {
+        mqtt_disconnect(&cliente);
+        conectando = false;
+        em_voo = false;
+    }
+    hal_rede_liberar();
+}
+
+static void executar_passo() {
+    if (!enlace_ativo) {
+        return;     // As amostras esperam no histórico
+    }
+    if (!mqtt_client_is_connected(&cliente)) {
+        bool espera_vencida = ultima_tentativa == HAL_PRAZO_NENHUM ||
+                              hal_tempo_us() - ultima_tentativa >= RECONEXAO_MS * 1000ull;
+        if (!conectando && espera_vencida) {
+            conectar();
+        }
+        return;
+    }
+    if (em_voo) {
+        return;
+    }
+
+    uint32_t primeira = historico_primeira_sequencia();
+    if (proxima_sequencia < primeira) {
+        amostras_perdidas += primeira - proxima_sequencia;
+        proxima_sequencia = primeira;
+    }
+    uint32_t pendentes = historico_proxima_sequencia() - proxima_sequencia;
+    if (pendentes == 0) {
+        return;
+    }
+
+    // Com a fila em dia, um lote por intervalo; com atraso (volta do Wi-Fi), um lote por passo
+    bool atrasado = pendentes >= config.lote_maximo;
+    bool intervalo_vencido = hal_tempo_us() - ultima_publicacao >= config.intervalo_ms * 1000ull;
+    if (atrasado || intervalo_vencido) {
+        publicar_lote();
+    }
+}
+
+// A cada TELEMETRIA_MQTT_PASSO_MS: conecta, publica no intervalo normal ou drena a fila acumulada.
+// Roda no laço principal; o lwIP e o histórico pertencem ao contexto da rede, daí hal_rede_travar().
+void telemetria_mqtt_tarefa(void *contexto) {
+    hal_rede_travar();
+    executar_passo();
+    hal_rede_liberar();
+}
+
+// O estado do cliente e o cursor são lidos sob o lock; o printf fica fora dele
+void telemetria_mqtt_imprimir_estatisticas(void) {
+    hal_rede_travar();
+    bool conectado = mqtt_client_is_connected(&cliente);
+    uint32_t pendentes = historico_proxima_sequencia() - proxima_sequencia;
+    hal_rede_liberar();
+
+    printf("MQTT: %s, %lu lotes / %lu amostras publicadas, %lu pendentes, %lu perdidas, %lu falhas, %lu conexoes\n",
+           conectado ? "conectado" : "desconectado", (unsigned long)lotes_publicados,
+           (unsigned long)amostras_publicadas, (unsigned long)pendentes, (unsigned long)amostras_perdidas,
+           (unsigned long)falhas_publicacao, (unsigned long)conexoes);
+}
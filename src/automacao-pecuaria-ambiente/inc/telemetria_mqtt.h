@@ -0,0 +1,33 @@
+#ifndef telemetria_mqtt_inc_h
+#define telemetria_mqtt_inc_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Telemetria MQTT 3.1.1 (opcional, compilada com TELEMETRIA_MQTT=1), sobre o cliente MQTT do lwIP.
+// Publica as amostras do histórico em lotes, um PUBLISH (QoS 1) por lote. A fila é o próprio
+// histórico em RAM: um cursor marca a primeira amostra ainda não confirmada pelo broker. Com o
+// Wi-Fi fora, as amostras se acumulam (até HISTORICO_CAPACIDADE; as mais antigas se perdem) e,
+// na volta, são drenadas um lote por passo, só depois da confirmação do lote anterior.
+//
+// Lote publicado em <topico>:   {"seq":N,"amostras":[[epoch,t,u,l,reles],...]}  (leituras em décimos)
+// Estado em <topico>/estado:    "online" (retido); "offline" como last will.
+
+#define TELEMETRIA_MQTT_PASSO_MS 2000       // Período da tarefa: ritmo máximo de drenagem da fila
+#define TELEMETRIA_MQTT_PAYLOAD_MAX 768     // Cabe no MQTT_OUTPUT_RINGBUF_SIZE de lwipopts.h
+
+typedef struct {
+    const char *broker;         // Endereço IP do broker
+    uint16_t porta;
+    const char *cliente;        // Client ID
+    const char *topico;
+    uint32_t intervalo_ms;      // Período normal entre lotes, com a fila em dia
+    uint16_t lote_maximo;       // Amostras por PUBLISH (também limitado pelo tamanho do payload)
+} telemetria_mqtt_config_t;
+
+bool telemetria_mqtt_iniciar(const telemetria_mqtt_config_t *config, uint32_t primeira_sequencia);
+void telemetria_mqtt_enlace(bool ativo);
+void telemetria_mqtt_tarefa(void *contexto);
+void telemetria_mqtt_imprimir_estatisticas(void);
+
+#endif
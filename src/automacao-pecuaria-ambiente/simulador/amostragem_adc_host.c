@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hal.h"
+#include "amostragem_adc.h"
+#include "simulador.h"
+
+// Aquisição do ADC simulada, com a interface de inc/amostragem_adc.h. amostragem_adc_processar()
+// gera, em round-robin, as leituras de 12 bits que o ADC teria feito a AMOSTRAGEM_ADC_TAXA_HZ
+// desde a chamada anterior e as passa pela mesma cadeia de filtros do firmware (inc/filtro_adc.c).
+// O primeiro canal é o LDR: a tensão cai com a luz do clima simulado, com ruído de alguns LSB e,
+// de vez em quando, uma leitura espúria (o que a mediana de 3 deve descartar). Os demais canais
+// ficam a meia escala.
+
+#define AMOSTRAGEM_ADC_HOST_RUIDO 8          // Amplitude do ruído, em LSB
+#define AMOSTRAGEM_ADC_HOST_ESPURIAS 5000    // Uma leitura espúria a cada tantas
+
+static uint pinos_canais[AMOSTRAGEM_ADC_MAX_CANAIS];
+static filtro_adc_t filtros[AMOSTRAGEM_ADC_MAX_CANAIS];
+static uint num_canais = 0;
+static uint64_t leituras_feitas;
+static uint32_t aleatorio;
+
+bool amostragem_adc_iniciar(const uint *pinos, uint n) {
+    if (n == 0 || n > AMOSTRAGEM_ADC_MAX_CANAIS) {
+        return false;
+    }
+    memcpy(pinos_canais, pinos, n * sizeof(uint));
+    num_canais = n;
+    for (uint i = 0; i < n; i++) {
+        filtro_adc_iniciar(&filtros[i]);
+    }
+    leituras_feitas = hal_tempo_us() * AMOSTRAGEM_ADC_TAXA_HZ / 1000000;
+    aleatorio = simulador.semente ^ 0xADCu;
+    return true;
+}
+
+void amostragem_adc_processar(void) {
+    uint64_t alvo = hal_tempo_us() * AMOSTRAGEM_ADC_TAXA_HZ / 1000000;
+    if (alvo == leituras_feitas) {
+        return;
+    }
+
+    // O clima muda devagar: um valor por chamada (a cada ~100 ms) basta
+    clima_t c;
+    clima_agora(&c);
+    int32_t ldr = (int32_t)(4095 * (100 - c.luminosidade) / 100);
+
+    for (; leituras_feitas < alvo; leituras_feitas++) {
+        uint canal = leituras_feitas % num_canais;
+        uint32_t sorteio = simulador_aleatorio(&aleatorio);
+        int32_t leitura = 2048;
+        if (canal == 0) {
+            leitura = ldr + (int32_t)(sorteio % (2 * AMOSTRAGEM_ADC_HOST_RUIDO + 1)) - AMOSTRAGEM_ADC_HOST_RUIDO;
+            if ((sorteio >> 16) % AMOSTRAGEM_ADC_HOST_ESPURIAS == 0) {
+                leitura = sorteio & 0xFFF;
+            }
+        }
+        filtro_adc_amostra(&filtros[canal], (uint16_t)(leitura < 0 ? 0 : leitura > 4095 ? 4095 : leitura));
+    }
+}
+
+const filtro_adc_t *amostragem_adc_filtro(uint pino) {
+    for (uint i = 0; i < num_canais; i++) {
+        if (pinos_canais[i] == pino) {
+            return &filtros[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t amostragem_adc_reinicios(void) {
+    return 0;
+}
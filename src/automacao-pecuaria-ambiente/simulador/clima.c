@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "hal.h"
+#include "data_hora.h"
+#include "simulador.h"
+
+// Clima do curral visto pelos sensores simulados.
+//
+// Sem arquivo, um modelo embutido na hora do RTC simulado: ciclo diário de 24 ± 6 °C com pico às
+// 15 h, frentes de alguns dias somadas ao ciclo, umidade relativa no sentido oposto da temperatura
+// e luz do dia entre 6 h e 18 h, atenuada por nebulosidade. As fases das frentes e das nuvens vêm
+// da semente, então cada semente é um "ano" diferente, mas sempre o mesmo.
+//
+// Com arquivo (--clima), uma série CSV "tempo;temperatura;umidade[;luminosidade]", separada por
+// ';' ou ','. O tempo é um epoch, segundos inteiros desde o início ou "AAAA-MM-DD HH:MM[:SS]"; a
+// primeira linha vale como o boot. Entre linhas, interpolação linear; no fim, a série recomeça.
+// Sem a coluna de luminosidade, vale a do modelo. Linhas que não começam por um tempo (cabeçalho,
+// comentários com '#') são ignoradas, então o CSV de /download do próprio firmware serve de série.
+
+#define CLIMA_DIA_S 86400.0
+
+typedef struct {
+    double tempo_s;       // Desde a primeira linha
+    float temperatura;
+    float umidade;
+    float luminosidade;   // NAN = do modelo
+} clima_ponto_t;
+
+static clima_ponto_t *serie;
+static size_t serie_tamanho;
+static double serie_periodo_s;
+static double fases[4];
+
+static double limitar(double v, double minimo, double maximo) {
+    return v < minimo ? minimo : v > maximo ? maximo : v;
+}
+
+static void modelo(uint32_t epoch, clima_t *c) {
+    double dia = epoch / CLIMA_DIA_S;
+    double hora = fmod(epoch, CLIMA_DIA_S) / 3600;
+    double frentes = 3.0 * sin(2 * M_PI * dia / 5.3 + fases[0]) + 1.5 * sin(2 * M_PI * dia / 2.1 + fases[1]);
+    double t = 24 + 6 * cos(2 * M_PI * (hora - 15) / 24) + frentes;
+    double u = 60 - 3.5 * (t - 24) + 8 * sin(2 * M_PI * dia / 3.7 + fases[2]);
+    double nuvens = 0.5 + 0.5 * sin(2 * M_PI * dia / 1.7 + fases[3]);
+    double luz = hora > 6 && hora < 18 ? 100 * sin(M_PI * (hora - 6) / 12) * (1 - 0.6 * nuvens * nuvens) : 0;
+
+    c->temperatura = (float)t;
+    c->umidade = (float)limitar(u, 15, 98);
+    c->luminosidade = (float)limitar(luz, 0, 100);
+}
+
+// Próximo campo depois do separador; NULL no fim da linha
+static const char *proximo_campo(const char *p) {
+    while (*p && *p != ';' && *p != ',' && *p != '\n') {
+        p++;
+    }
+    return *p == ';' || *p == ',' ? p + 1 : NULL;
+}
+
+static bool ler_serie(const char *arquivo) {
+    FILE *f = fopen(arquivo, "r");
+    if (!f) {
+        perror(arquivo);
+        return false;
+    }
+
+    char linha[256];
+    size_t capacidade = 0;
+    uint32_t primeiro = 0;
+    while (fgets(linha, sizeof(linha), f)) {
+        uint32_t epoch;
+        const char *p = linha;
+        if (!data_hora_analisar(p, &epoch)) {
+            continue;
+        }
+        const char *campo_t = proximo_campo(p);
+        const char *campo_u = campo_t ? proximo_campo(campo_t) : NULL;
+        const char *campo_l = campo_u ? proximo_campo(campo_u) : NULL;
+        if (!campo_u) {
+            continue;
+        }
+        if (serie_tamanho == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 256;
+            serie = realloc(serie, capacidade * sizeof(clima_ponto_t));
+        }
+        if (serie_tamanho == 0) {
+            primeiro = epoch;
+        }
+        clima_ponto_t *ponto = &serie[serie_tamanho];
+        ponto->tempo_s = (double)epoch - primeiro;
+        ponto->temperatura = strtof(campo_t, NULL);
+        ponto->umidade = strtof(campo_u, NULL);
+        ponto->luminosidade = campo_l ? strtof(campo_l, NULL) : NAN;
+        if (serie_tamanho > 0 && ponto->tempo_s <= serie[serie_tamanho - 1].tempo_s) {
+            continue;   // Fora de ordem ou repetida
+        }
+        serie_tamanho++;
+    }
+    fclose(f);
+
+    if (serie_tamanho < 2) {
+        fprintf(stderr, "%s: a serie de clima precisa de pelo menos duas linhas\n", arquivo);
+        return false;
+    }
+    // A volta fecha com o mesmo passo do último intervalo
+    serie_periodo_s = 2 * serie[serie_tamanho - 1].tempo_s - serie[serie_tamanho - 2].tempo_s;
+    fprintf(stderr, "Simulador: clima de %s, %zu linhas, %.1f h por volta\n", arquivo, serie_tamanho, serie_periodo_s / 3600);
+    return true;
+}
+
+bool clima_iniciar(const char *arquivo, uint32_t semente) {
+    uint32_t estado = semente;
+    for (int i = 0; i < 4; i++) {
+        fases[i] = 2 * M_PI * (simulador_aleatorio(&estado) / 4294967296.0);
+    }
+    return !arquivo || ler_serie(arquivo);
+}
+
+void clima_agora(clima_t *c) {
+    modelo(simulador_epoch(), c);
+    if (!serie) {
+        return;
+    }
+
+    double t = fmod(hal_tempo_us() / 1e6, serie_periodo_s);
+    size_t inicio = 0, fim = serie_tamanho;
+    while (fim - inicio > 1) {
+        size_t meio = (inicio + fim) / 2;
+        if (serie[meio].tempo_s <= t) {
+            inicio = meio;
+        } else {
+            fim = meio;
+        }
+    }
+    const clima_ponto_t *a = &serie[inicio];
+    const clima_ponto_t *b = &serie[(inicio + 1) % serie_tamanho];
+    double tempo_b = inicio + 1 < serie_tamanho ? b->tempo_s : serie_periodo_s;
+    float peso = (float)((t - a->tempo_s) / (tempo_b - a->tempo_s));
+
+    c->temperatura = a->temperatura + (b->temperatura - a->temperatura) * peso;
+    c->umidade = a->umidade + (b->umidade - a->umidade) * peso;
+    if (!isnan(a->luminosidade) && !isnan(b->luminosidade)) {
+        c->luminosidade = a->luminosidade + (b->luminosidade - a->luminosidade) * peso;
+    }
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "hal.h"
+#include "dht11.h"
+#include "simulador.h"
+
+// DHT11 simulado, com a interface de inc/dht11.h. dht11_disparar() lê o clima e monta o quadro de
+// 40 bits que o sensor enviaria; o quadro fica pronto ~25 ms depois (pulso de início e bits), em
+// tempo virtual, e passa pelo mesmo dht11_decodificar() do firmware antes de entrar na fila.
+// Com --falhas-dht11 P, uma fração P dos quadros falha, metade sem resposta (tempo esgotado no
+// disparo seguinte) e metade com um bit trocado (erro de checksum).
+
+#define DHT11_HOST_QUADRO_US 25000
+
+static uint32_t aleatorio;
+static uint64_t pronto_us;
+static bool perdido;
+static uint32_t palavra, checksum;
+
+bool dht11_iniciar(dht11_t *d, uint pino) {
+    d->pio = NULL;
+    d->sm = 0;
+    d->offset = 0;
+    d->pino = pino;
+    d->lendo = false;
+    d->leituras = 0;
+    d->erros_checksum = 0;
+    d->tempos_esgotados = 0;
+    canal_spsc_iniciar(&d->fila, d->buffer_fila, sizeof(dht11_leitura_t), DHT11_FILA_CAPACIDADE);
+    aleatorio = simulador.semente ^ 0x0D7110u;
+    return true;
+}
+
+// O quadro terminou: o que a interrupção do PIO faria no fim dele
+static void concluir(dht11_t *d) {
+    dht11_leitura_t leitura = {.instante_us = pronto_us};
+    d->lendo = false;
+    if (!dht11_decodificar(palavra, checksum, &leitura)) {
+        d->erros_checksum++;
+        return;
+    }
+    d->leituras++;
+    canal_spsc_enviar(&d->fila, &leitura);
+}
+
+static void verificar_quadro(dht11_t *d) {
+    if (d->lendo && !perdido && hal_tempo_us() >= pronto_us) {
+        concluir(d);
+    }
+}
+
+void dht11_disparar(dht11_t *d) {
+    verificar_quadro(d);
+    if (d->lendo) {
+        d->tempos_esgotados++;
+    }
+
+    // Umidade inteira; temperatura com o décimo e o sinal no bit 7, como nas revisões novas do sensor
+    clima_t c;
+    clima_agora(&c);
+    long umidade = lroundf(c.umidade);
+    long temperatura = lroundf(c.temperatura * 10);
+    uint8_t bytes[4] = {
+        (uint8_t)(umidade < 0 ? 0 : umidade > 99 ? 99 : umidade),
+        0,
+        (uint8_t)(labs(temperatura) / 10),
+        (uint8_t)((labs(temperatura) % 10) | (temperatura < 0 ? 0x80 : 0)),
+    };
+    palavra = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+    checksum = (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+
+    double sorteio = simulador_aleatorio(&aleatorio) / 4294967296.0;
+    perdido = sorteio < simulador.falhas_dht11 / 2;
+    if (!perdido && sorteio < simulador.falhas_dht11) {
+        palavra ^= 1u << (simulador_aleatorio(&aleatorio) % 32);
+    }
+
+    d->lendo = true;
+    pronto_us = hal_tempo_us() + DHT11_HOST_QUADRO_US;
+}
+
+bool dht11_receber(dht11_t *d, dht11_leitura_t *leitura) {
+    verificar_quadro(d);
+    return canal_spsc_receber(&d->fila, leitura);
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "flash_nor.h"
+
+static uint32_t tamanho_total(const flash_nor_t *nor) {
+    return nor->dispositivo.tamanho_setor * nor->dispositivo.num_setores;
+}
+
+static void persistir(flash_nor_t *nor, uint32_t deslocamento, uint32_t tamanho) {
+    if (nor->arquivo >= 0 && pwrite(nor->arquivo, nor->memoria + deslocamento, tamanho, deslocamento) != (ssize_t)tamanho) {
+        perror("flash_nor: pwrite");
+    }
+}
+
+// Decide o destino da próxima operação: retorna quantos bytes dela chegam à flash
+// (o tamanho inteiro se nada for injetado, 0 se ela falhar sem efeito)
+static uint32_t iniciar_operacao(flash_nor_t *nor, uint32_t tamanho, bool *interrompida) {
+    int64_t numero = nor->operacoes++;
+    *interrompida = false;
+    if (nor->desligada || (numero >= nor->recusa_de && numero < nor->recusa_ate)) {
+        return 0;
+    }
+    if (numero == nor->corte) {
+        *interrompida = true;
+        return nor->bytes_corte < tamanho ? nor->bytes_corte : tamanho;
+    }
+    return tamanho;
+}
+
+static void cortar_energia(flash_nor_t *nor) {
+    nor->desligada = true;
+    if (nor->ao_cortar) {
+        nor->ao_cortar(nor);
+    }
+}
+
+static void ler(flash_dispositivo_t *d, uint32_t deslocamento, void *destino, uint32_t tamanho) {
+    flash_nor_t *nor = d->contexto;
+    memcpy(destino, nor->memoria + deslocamento, tamanho);
+}
+
+static bool programar(flash_dispositivo_t *d, uint32_t deslocamento, const void *origem, uint32_t tamanho) {
+    flash_nor_t *nor = d->contexto;
+    if (deslocamento % d->tamanho_pagina || deslocamento + tamanho > tamanho_total(nor)) {
+        return false;
+    }
+
+    bool interrompida;
+    uint32_t gravados = iniciar_operacao(nor, tamanho, &interrompida);
+    const uint8_t *bytes = origem;
+    for (uint32_t i = 0; i < gravados; i++) {
+        nor->memoria[deslocamento + i] &= bytes[i];
+    }
+    // O byte em que a energia caiu fica pela metade
+    if (interrompida && gravados < tamanho) {
+        nor->memoria[deslocamento + gravados] &= bytes[gravados] | 0xF0;
+        gravados++;
+    }
+    persistir(nor, deslocamento, gravados);
+
+    if (interrompida) {
+        cortar_energia(nor);
+        return false;
+    }
+    return gravados == tamanho;
+}
+
+static bool apagar_setor(flash_dispositivo_t *d, uint32_t setor) {
+    flash_nor_t *nor = d->contexto;
+    if (setor >= d->num_setores) {
+        return false;
+    }
+
+    bool interrompida;
+    uint32_t apagados = iniciar_operacao(nor, d->tamanho_setor, &interrompida);
+    memset(nor->memoria + setor * d->tamanho_setor, 0xFF, apagados);
+    persistir(nor, setor * d->tamanho_setor, apagados);
+
+    if (interrompida) {
+        cortar_energia(nor);
+        return false;
+    }
+    return apagados == d->tamanho_setor;
+}
+
+void flash_nor_iniciar(flash_nor_t *nor, uint8_t *memoria, uint32_t tamanho_setor, uint32_t tamanho_pagina,
+                       uint32_t num_setores) {
+    *nor = (flash_nor_t){
+        .dispositivo = {
+            .tamanho_setor = tamanho_setor,
+            .tamanho_pagina = tamanho_pagina,
+            .num_setores = num_setores,
+            .ler = ler,
+            .programar = programar,
+            .apagar_setor = apagar_setor,
+            .contexto = nor,
+        },
+        .memoria = memoria,
+        .arquivo = -1,
+        .corte = -1,
+        .recusa_de = -1,
+        .recusa_ate = -1,
+    };
+    memset(memoria, 0xFF, tamanho_total(nor));
+}
+
+// Espelha a flash no arquivo. Um arquivo do tamanho certo é carregado; outro qualquer é
+// recriado apagado.
+bool flash_nor_abrir_arquivo(flash_nor_t *nor, const char *caminho) {
+    nor->arquivo = open(caminho, O_RDWR | O_CREAT, 0644);
+    if (nor->arquivo < 0) {
+        return false;
+    }
+    uint32_t tamanho = tamanho_total(nor);
+    if (pread(nor->arquivo, nor->memoria, tamanho, 0) != (ssize_t)tamanho) {
+        memset(nor->memoria, 0xFF, tamanho);
+        persistir(nor, 0, tamanho);
+    }
+    return true;
+}
+
+void flash_nor_cortar(flash_nor_t *nor, uint32_t operacao, uint32_t bytes) {
+    nor->corte = (int64_t)nor->operacoes + operacao;
+    nor->bytes_corte = bytes;
+}
+
+void flash_nor_recusar(flash_nor_t *nor, uint32_t operacao, uint32_t quantidade) {
+    nor->recusa_de = (int64_t)nor->operacoes + operacao;
+    nor->recusa_ate = nor->recusa_de + quantidade;
+}
+
+void flash_nor_religar(flash_nor_t *nor) {
+    nor->desligada = false;
+    nor->corte = -1;
+    nor->recusa_de = -1;
+    nor->recusa_ate = -1;
+}
@@ -0,0 +1,44 @@
+#ifndef flash_nor_h
+#define flash_nor_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash_log.h"
+
+// Flash NOR em memória, atrás de flash_dispositivo_t (inc/flash_log.h): a flash do log no
+// simulador (hal_host.c) e nos testes do log (tools/testar_flash_log.c). Como no chip, ler é
+// livre, programar só leva bits de 1 para 0, em páginas alinhadas, e apagar devolve o setor
+// inteiro a 0xFF. Opcionalmente, cada alteração também vai para um arquivo.
+//
+// Falhas injetadas, contadas em operações (programar ou apagar) a partir da chamada; 0 é a próxima:
+//   flash_nor_cortar()  - a energia cai no meio da operação, depois de 'bytes' bytes. Programar
+//                         deixa esses bytes gravados e o seguinte só com os 4 bits de baixo;
+//                         apagar deixa apagados só esses bytes do início do setor. Com 'bytes'
+//                         igual ou maior que a operação, ela termina e a energia cai logo depois.
+//                         Dali em diante a flash fica desligada: toda operação falha sem efeito
+//                         até flash_nor_religar().
+//   flash_nor_recusar() - 'quantidade' operações seguidas falham sem efeito, como um
+//                         flash_safe_execute() que expira.
+
+typedef struct flash_nor {
+    flash_dispositivo_t dispositivo;
+    uint8_t *memoria;
+    int arquivo;                // -1 = só em memória
+    uint32_t operacoes;         // Programações e apagamentos feitos até agora, inclusive falhos
+    int64_t corte;              // Operação em que a energia cai; -1 = nenhuma
+    uint32_t bytes_corte;
+    int64_t recusa_de;          // Operações recusadas: [recusa_de, recusa_ate)
+    int64_t recusa_ate;
+    bool desligada;
+    void (*ao_cortar)(struct flash_nor *nor);   // Avisada quando a energia cai; pode ser NULL
+} flash_nor_t;
+
+// 'memoria' deve ter tamanho_setor * num_setores bytes; começa apagada
+void flash_nor_iniciar(flash_nor_t *nor, uint8_t *memoria, uint32_t tamanho_setor, uint32_t tamanho_pagina,
+                       uint32_t num_setores);
+bool flash_nor_abrir_arquivo(flash_nor_t *nor, const char *caminho);
+void flash_nor_cortar(flash_nor_t *nor, uint32_t operacao, uint32_t bytes);
+void flash_nor_recusar(flash_nor_t *nor, uint32_t operacao, uint32_t quantidade);
+void flash_nor_religar(flash_nor_t *nor);
+
+#endif
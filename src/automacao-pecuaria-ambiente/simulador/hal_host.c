@@ -0,0 +1,604 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "hal.h"
+#include "data_hora.h"
+#include "flash_pico.h"
+#include "flash_nor.h"
+#include "camadas.h"
+#include "simulador.h"
+
+// Implementação de inc/hal.h para o simulador no Linux.
+//
+// O tempo é virtual: hal_tempo_us() só anda quando os dois "núcleos" não têm nada a fazer, e então
+// salta direto para o próximo prazo (ou acompanha o relógio real, escalado por --velocidade).
+// Tudo roda numa única thread: o laço principal do firmware (núcleo 0) chama hal_rede_aguardar(),
+// que executa os passos do núcleo 1 que vencerem antes de avançar o relógio. Como o núcleo 1 só
+// roda ali, um canal SPSC nunca é lido e escrito ao mesmo tempo, e sem tráfego HTTP a execução é
+// reproduzível. As tarefas terminam em tempo virtual zero; as durações medidas pelo agendador
+// aparecem como 0.
+//
+// Periféricos: relés com registro das trocas, RTC derivado do relógio virtual, o SSD1306 emulado
+// byte a byte (a GRAM vira imagens PGM), a fita de LEDs com o tempo de transmissão e latch, Wi-Fi
+// com tempo de associação e queda programável, e a flash do log como uma NOR em RAM.
+
+#define HAL_HOST_PINOS 30
+#define HAL_HOST_WIFI_ASSOCIACAO_US 2000000   // Do pedido de conexão ao enlace no ar
+#define HAL_HOST_LEDS_BIT_US 30               // 24 bits a 800 kHz por LED
+#define HAL_HOST_LEDS_LATCH_US 400
+#define HAL_HOST_VERIFICAR_SOQUETES_NS 1000000 // No modo mais rápido, olha os soquetes a cada 1 ms real
+
+static uint64_t agora_us;
+static uint64_t fim_us;
+static struct timespec inicio_real;
+
+static uint64_t tempo_real_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)(t.tv_sec - inicio_real.tv_sec) * 1000000000u + t.tv_nsec - inicio_real.tv_nsec;
+}
+
+uint32_t simulador_aleatorio(uint32_t *estado) {
+    uint32_t x = *estado ? *estado : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *estado = x;
+}
+
+// --- RTC ---
+static uint32_t rtc_base;   // Epoch no instante zero do relógio virtual
+
+uint32_t simulador_epoch(void) {
+    return rtc_base + (uint32_t)(agora_us / 1000000);
+}
+
+void hal_rtc_iniciar(const datetime_t *t) {
+    hal_rtc_ajustar(t);
+}
+
+void hal_rtc_ler(datetime_t *t) {
+    data_hora_de_epoch(simulador_epoch(), t);
+}
+
+void hal_rtc_ajustar(const datetime_t *t) {
+    rtc_base = data_hora_para_epoch(t) - (uint32_t)(agora_us / 1000000);
+}
+
+static void formatar_data_hora(char *texto, size_t tamanho, const char *formato) {
+    datetime_t t;
+    hal_rtc_ler(&t);
+    snprintf(texto, tamanho, formato, t.year, t.month, t.day, t.hour, t.min, t.sec);
+}
+
+// --- GPIO ---
+static struct {
+    bool saida;
+    bool valor;
+    uint32_t trocas;
+    uint64_t ligado_desde_us;
+    uint64_t tempo_ligado_us;
+} pinos[HAL_HOST_PINOS];
+
+static FILE *arquivo_eventos;
+
+void hal_gpio_saida(uint pino) {
+    if (pino < HAL_HOST_PINOS) {
+        pinos[pino].saida = true;
+    }
+}
+
+void hal_gpio_escrever(uint pino, bool valor) {
+    if (pino >= HAL_HOST_PINOS || pinos[pino].valor == valor) {
+        return;
+    }
+    pinos[pino].valor = valor;
+    pinos[pino].trocas++;
+    if (valor) {
+        pinos[pino].ligado_desde_us = agora_us;
+    } else {
+        pinos[pino].tempo_ligado_us += agora_us - pinos[pino].ligado_desde_us;
+    }
+    if (arquivo_eventos) {
+        char data_hora[24];
+        formatar_data_hora(data_hora, sizeof(data_hora), "%04d-%02d-%02d %02d:%02d:%02d");
+        fprintf(arquivo_eventos, "%.3f;%s;%u;%d\n", agora_us / 1e6, data_hora, pino, valor);
+    }
+}
+
+bool hal_gpio_ler(uint pino) {
+    return pino < HAL_HOST_PINOS && pinos[pino].valor;
+}
+
+// --- I2C: SSD1306 EMULADO ---
+// Um display por barramento. Cada transação começa por um byte de controle: 0x00 abre uma
+// sequência de comandos, 0x40 uma de dados, e com o bit 7 (0x80, 0xC0) vale só para o byte
+// seguinte, depois do qual vem outro byte de controle.
+typedef enum { I2C_CONTROLE, I2C_COMANDOS, I2C_DADOS, I2C_UM_COMANDO, I2C_UM_DADO } estado_i2c_t;
+
+typedef struct {
+    bool iniciado;
+    uint32_t frequencia_hz;
+    estado_i2c_t estado;
+    uint8_t gram[8][128];
+    bool ligado;
+    bool invertido;
+    uint8_t modo;               // 0 horizontal, 1 vertical, 2 página
+    uint8_t coluna_inicio, coluna_fim, pagina_inicio, pagina_fim;
+    uint8_t coluna, pagina;
+    uint8_t comando[8];         // Comando em andamento e seus argumentos
+    uint8_t comando_bytes;
+    uint8_t comando_esperados;
+    uint64_t palavras;          // Estatísticas do barramento
+    uint32_t transacoes;
+} oled_t;
+
+static oled_t oleds[2];
+
+// Bytes de argumento de cada comando que os tem
+static uint8_t argumentos_comando(uint8_t c) {
+    switch (c) {
+        case 0x21: case 0x22: case 0xA3:
+            return 2;
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x26: case 0x27:
+            return 6;
+        case 0x29: case 0x2A:
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+static void oled_executar(oled_t *o) {
+    const uint8_t *c = o->comando;
+    if (c[0] == 0xAE || c[0] == 0xAF) {
+        o->ligado = c[0] == 0xAF;
+    } else if (c[0] == 0xA6 || c[0] == 0xA7) {
+        o->invertido = c[0] == 0xA7;
+    } else if (c[0] == 0x20) {
+        o->modo = c[1] & 3;
+    } else if (c[0] == 0x21) {
+        o->coluna_inicio = o->coluna = c[1] & 0x7F;
+        o->coluna_fim = c[2] & 0x7F;
+    } else if (c[0] == 0x22) {
+        o->pagina_inicio = o->pagina = c[1] & 7;
+        o->pagina_fim = c[2] & 7;
+    } else if (c[0] >= 0xB0 && c[0] <= 0xB7) {
+        o->pagina = c[0] & 7;
+    } else if (c[0] <= 0x0F) {
+        o->coluna = (o->coluna & 0xF0) | c[0];
+    } else if (c[0] <= 0x1F) {
+        o->coluna = ((c[0] & 0x07) << 4) | (o->coluna & 0x0F);
+    }
+}
+
+static void oled_comando(oled_t *o, uint8_t b) {
+    if (o->comando_bytes == 0) {
+        o->comando_esperados = argumentos_comando(b);
+    }
+    o->comando[o->comando_bytes++] = b;
+    if (o->comando_bytes > o->comando_esperados) {
+        oled_executar(o);
+        o->comando_bytes = 0;
+    }
+}
+
+// Escreve na GRAM e avança o ponteiro conforme o modo de endereçamento
+static void oled_dado(oled_t *o, uint8_t b) {
+    o->gram[o->pagina & 7][o->coluna & 0x7F] = b;
+    if (o->modo == 2) {
+        o->coluna = (o->coluna + 1) & 0x7F;
+    } else if (o->modo == 0) {
+        if (o->coluna++ >= o->coluna_fim) {
+            o->coluna = o->coluna_inicio;
+            o->pagina = o->pagina >= o->pagina_fim ? o->pagina_inicio : o->pagina + 1;
+        }
+    } else if (o->pagina++ >= o->pagina_fim) {
+        o->pagina = o->pagina_inicio;
+        o->coluna = o->coluna >= o->coluna_fim ? o->coluna_inicio : o->coluna + 1;
+    }
+}
+
+static void oled_byte(oled_t *o, uint8_t b) {
+    switch (o->estado) {
+        case I2C_CONTROLE:
+            if (b & 0x80) {
+                o->estado = b & 0x40 ? I2C_UM_DADO : I2C_UM_COMANDO;
+            } else {
+                o->estado = b & 0x40 ? I2C_DADOS : I2C_COMANDOS;
+            }
+            break;
+        case I2C_COMANDOS:
+            oled_comando(o, b);
+            break;
+        case I2C_DADOS:
+            oled_dado(o, b);
+            break;
+        case I2C_UM_COMANDO:
+            oled_comando(o, b);
+            o->estado = I2C_CONTROLE;
+            break;
+        case I2C_UM_DADO:
+            oled_dado(o, b);
+            o->estado = I2C_CONTROLE;
+            break;
+    }
+}
+
+static void oled_stop(oled_t *o) {
+    o->estado = I2C_CONTROLE;
+    o->transacoes++;
+}
+
+void hal_i2c_iniciar(uint barramento, uint sda, uint scl, uint32_t frequencia_hz) {
+    oled_t *o = &oleds[barramento & 1];
+    memset(o, 0, sizeof(*o));
+    o->iniciado = true;
+    o->frequencia_hz = frequencia_hz;
+    o->coluna_fim = 127;
+    o->pagina_fim = 7;
+    o->modo = 2;   // Padrão do SSD1306 após o reset
+}
+
+// A transferência termina na hora: ssd1306_wait() espera em laço e o relógio virtual não andaria
+void hal_i2c_enviar(uint barramento, uint8_t endereco, const uint16_t *palavras, int quantidade) {
+    oled_t *o = &oleds[barramento & 1];
+    for (int i = 0; i < quantidade; i++) {
+        oled_byte(o, palavras[i] & 0xFF);
+        if (palavras[i] & HAL_I2C_STOP) {
+            oled_stop(o);
+        }
+    }
+    o->palavras += quantidade;
+}
+
+bool hal_i2c_ocupado(uint barramento) {
+    return false;
+}
+
+void hal_i2c_escrever(uint barramento, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    oled_t *o = &oleds[barramento & 1];
+    for (size_t i = 0; i < tamanho; i++) {
+        oled_byte(o, dados[i]);
+    }
+    oled_stop(o);
+    o->palavras += tamanho;
+}
+
+// Grava a GRAM de cada display como uma imagem PGM de 128x64
+static uint32_t quadros_gravados;
+static uint64_t ultimo_quadro_us = HAL_PRAZO_NENHUM;
+
+static void gravar_quadros(void) {
+    if (!simulador.quadros || ultimo_quadro_us == agora_us) {
+        return;
+    }
+    ultimo_quadro_us = agora_us;
+    char data_hora[24];
+    formatar_data_hora(data_hora, sizeof(data_hora), "%04d%02d%02d-%02d%02d%02d");
+    for (uint b = 0; b < 2; b++) {
+        const oled_t *o = &oleds[b];
+        if (!o->iniciado) {
+            continue;
+        }
+        char caminho[512];
+        snprintf(caminho, sizeof(caminho), "%s/oled%u-%s.pgm", simulador.quadros, b, data_hora);
+        FILE *f = fopen(caminho, "wb");
+        if (!f) {
+            fprintf(stderr, "Simulador: nao foi possivel gravar %s (%s)\n", caminho, strerror(errno));
+            continue;
+        }
+        fprintf(f, "P5\n128 64\n255\n");
+        for (int y = 0; y < 64; y++) {
+            uint8_t linha[128];
+            for (int x = 0; x < 128; x++) {
+                bool aceso = (o->gram[y / 8][x] >> (y % 8)) & 1;
+                linha[x] = o->ligado && (aceso != o->invertido) ? 255 : 0;
+            }
+            fwrite(linha, 1, sizeof(linha), f);
+        }
+        fclose(f);
+        quadros_gravados++;
+    }
+}
+
+// --- LEDS WS2812B ---
+static uint32_t leds_quadro[64];
+static uint leds_quantidade;
+static uint64_t leds_livre_us;
+static uint32_t leds_envios;
+
+void hal_leds_iniciar(uint pino, uint quantidade) {
+    leds_quantidade = quantidade < count_of(leds_quadro) ? quantidade : count_of(leds_quadro);
+}
+
+bool hal_leds_enviar(const uint32_t *quadro, uint quantidade) {
+    if (agora_us < leds_livre_us) {
+        return false;
+    }
+    if (quantidade > leds_quantidade) {
+        quantidade = leds_quantidade;
+    }
+    memcpy(leds_quadro, quadro, quantidade * sizeof(uint32_t));
+    leds_livre_us = agora_us + quantidade * HAL_HOST_LEDS_BIT_US + HAL_HOST_LEDS_LATCH_US;
+    leds_envios++;
+    return true;
+}
+
+// --- REDE ---
+static uint64_t associar_em_us = HAL_PRAZO_NENHUM;
+static uint32_t quedas_enlace;
+static bool enlace_anterior;
+static void (*funcao_trabalho)(void);
+static bool trabalho_pendente;
+
+static bool em_queda(void) {
+    double horas = agora_us / 3600e6;
+    return simulador.queda_wifi_duracao_h > 0 && horas >= simulador.queda_wifi_inicio_h &&
+           horas < simulador.queda_wifi_inicio_h + simulador.queda_wifi_duracao_h;
+}
+
+bool hal_rede_iniciar(void) {
+    return true;
+}
+
+void hal_rede_conectar(const char *ssid, const char *senha) {
+    if (associar_em_us == HAL_PRAZO_NENHUM) {
+        associar_em_us = agora_us + HAL_HOST_WIFI_ASSOCIACAO_US;
+    }
+}
+
+// Durante a queda, a associação se perde e o firmware precisa pedir outra conexão
+bool hal_rede_enlace(void) {
+    if (em_queda()) {
+        associar_em_us = HAL_PRAZO_NENHUM;
+    }
+    bool enlace = agora_us >= associar_em_us;
+    if (enlace_anterior && !enlace) {
+        quedas_enlace++;
+    }
+    enlace_anterior = enlace;
+    return enlace;
+}
+
+// Uma única thread: nada a travar
+void hal_rede_travar(void) {
+}
+
+void hal_rede_liberar(void) {
+}
+
+void hal_rede_trabalho(void (*funcao)(void)) {
+    funcao_trabalho = funcao;
+}
+
+void hal_rede_sinalizar(void) {
+    trabalho_pendente = true;
+}
+
+void hal_rede_processar(void) {
+    tcp_soquetes_processar();
+    if (trabalho_pendente && funcao_trabalho) {
+        trabalho_pendente = false;
+        funcao_trabalho();
+    }
+}
+
+// --- NÚCLEO 1 ---
+static uint64_t (*nucleo1_passo)(void);
+static uint64_t nucleo1_prazo_us;
+static bool nucleo1_acordado;
+
+void hal_nucleo1_lancar(void (*iniciar)(void), uint64_t (*passo)(void), uint32_t *pilha, size_t tamanho_pilha) {
+    iniciar();
+    nucleo1_passo = passo;
+    nucleo1_prazo_us = agora_us;
+}
+
+void hal_nucleo1_acordar(void) {
+    nucleo1_acordado = true;
+}
+
+// --- FLASH ---
+// NOR em RAM (flash_nor.c) com a mesma divisão em regiões da flash do Pico W (inc/flash_pico.h).
+// Com --flash, cada alteração também vai para o arquivo, que sobrevive entre execuções; com
+// --corte-flash, a energia cai no meio de uma gravação ou apagamento e o simulador termina ali,
+// para a próxima execução montar os logs a partir do que ficou.
+#define HAL_HOST_SETOR 4096
+#define HAL_HOST_PAGINA 256
+
+static uint8_t flash_memoria[FLASH_RESERVADA_SETORES * HAL_HOST_SETOR];
+static flash_nor_t flash_host = {.arquivo = -1};
+static bool flash_iniciada;
+static flash_regiao_t regiao_log;
+static flash_regiao_t regiao_camadas[CAMADAS_NUM];
+
+static void flash_cortada(flash_nor_t *nor) {
+    fprintf(stderr, "Simulador: energia cortada durante a operacao %lu da flash, em %.3f h\n",
+            (unsigned long)nor->corte + 1, agora_us / 3600e6);
+    exit(0);
+}
+
+static flash_dispositivo_t *flash_base(void) {
+    if (flash_iniciada) {
+        return &flash_host.dispositivo;
+    }
+    flash_iniciada = true;
+    flash_nor_iniciar(&flash_host, flash_memoria, HAL_HOST_SETOR, HAL_HOST_PAGINA, FLASH_RESERVADA_SETORES);
+    if (simulador.flash && !flash_nor_abrir_arquivo(&flash_host, simulador.flash)) {
+        fprintf(stderr, "Simulador: nao foi possivel abrir %s (%s)\n", simulador.flash, strerror(errno));
+    }
+    if (simulador.corte_flash > 0) {
+        // Ponto do corte dentro da operação sorteado com a semente: de nada gravado a tudo
+        uint32_t estado = simulador.semente;
+        flash_nor_cortar(&flash_host, simulador.corte_flash - 1, simulador_aleatorio(&estado) % (HAL_HOST_SETOR + 1));
+        flash_host.ao_cortar = flash_cortada;
+    }
+    return &flash_host.dispositivo;
+}
+
+struct flash_dispositivo *hal_flash_log(void) {
+    return flash_regiao_iniciar(&regiao_log, flash_base(), FLASH_LOG_INICIO, FLASH_LOG_SETORES);
+}
+
+struct flash_dispositivo *hal_flash_camada(int camada) {
+    switch (camada) {
+        case CAMADA_5MIN:
+            return flash_regiao_iniciar(&regiao_camadas[camada], flash_base(), FLASH_CAMADA_5MIN_INICIO,
+                                        FLASH_CAMADA_5MIN_SETORES);
+        case CAMADA_1H:
+            return flash_regiao_iniciar(&regiao_camadas[camada], flash_base(), FLASH_CAMADA_1H_INICIO,
+                                        FLASH_CAMADA_1H_SETORES);
+        default:
+            return NULL;
+    }
+}
+
+// --- MEMÓRIA ---
+int hal_rede_memoria(hal_memoria_t *pools, int maximo) {
+    return tcp_soquetes_memoria(pools, maximo);
+}
+
+// O núcleo 1 simulado roda na pilha do processo, dentro de hal_rede_aguardar(), e essa pilha não
+// tem tamanho fixo: nenhuma das duas é medida
+bool hal_pilha_uso(uint nucleo, uint32_t *uso, uint32_t *tamanho) {
+    return false;
+}
+
+// --- CONSOLE, TEMPO E LAÇO DE EVENTOS ---
+static uint64_t proximo_quadro_us = HAL_PRAZO_NENHUM;
+static uint64_t ancora_virtual_us;      // Com --velocidade: par de instantes que casa os dois relógios
+static uint64_t ancora_real_ns;
+static uint64_t ultima_verificacao_ns;
+
+void hal_iniciar(void) {
+    clock_gettime(CLOCK_MONOTONIC, &inicio_real);
+    fim_us = (uint64_t)(simulador.dias * 86400e6);
+    if (simulador.quadros && simulador.intervalo_quadros_s > 0) {
+        proximo_quadro_us = (uint64_t)simulador.intervalo_quadros_s * 1000000;
+    }
+    if (simulador.eventos) {
+        arquivo_eventos = fopen(simulador.eventos, "w");
+        if (!arquivo_eventos) {
+            fprintf(stderr, "Simulador: nao foi possivel criar %s (%s)\n", simulador.eventos, strerror(errno));
+        } else {
+            fprintf(arquivo_eventos, "tempo_s;data_hora;pino;estado\n");
+        }
+    }
+    fprintf(stderr, "Simulador: %.2f dias simulados, %s\n", simulador.dias,
+            simulador.velocidade > 0 ? "em tempo real escalado" : "o mais rapido possivel");
+}
+
+uint64_t hal_tempo_us(void) {
+    return agora_us;
+}
+
+static void finalizar(void) {
+    gravar_quadros();
+    fflush(stdout);
+    if (arquivo_eventos) {
+        fclose(arquivo_eventos);
+    }
+    if (flash_host.arquivo >= 0) {
+        close(flash_host.arquivo);
+    }
+
+    double real_s = tempo_real_ns() / 1e9;
+    double virtual_s = agora_us / 1e6;
+    fprintf(stderr, "\n--- Simulador ---\n");
+    fprintf(stderr, "Tempo simulado: %.0f s (%.2f dias) em %.2f s reais, %.0fx\n", virtual_s, virtual_s / 86400, real_s,
+            real_s > 0 ? virtual_s / real_s : 0);
+    for (uint p = 0; p < HAL_HOST_PINOS; p++) {
+        if (!pinos[p].saida) {
+            continue;
+        }
+        uint64_t ligado = pinos[p].tempo_ligado_us + (pinos[p].valor ? agora_us - pinos[p].ligado_desde_us : 0);
+        fprintf(stderr, "Pino %2u: %lu trocas, ligado %.1f%% do tempo\n", p, (unsigned long)pinos[p].trocas,
+                agora_us ? 100.0 * ligado / agora_us : 0);
+    }
+    for (uint b = 0; b < 2; b++) {
+        const oled_t *o = &oleds[b];
+        if (o->iniciado) {
+            // 9 ciclos de SCL por byte (8 bits + ACK)
+            fprintf(stderr, "I2C%u: %lu transacoes, %llu bytes, barramento ocupado %.4f%% do tempo\n", b,
+                    (unsigned long)o->transacoes, (unsigned long long)o->palavras,
+                    agora_us ? 100.0 * o->palavras * 9 / o->frequencia_hz / virtual_s : 0);
+        }
+    }
+    fprintf(stderr, "LEDs: %lu quadros enviados\n", (unsigned long)leds_envios);
+    fprintf(stderr, "Wi-Fi: %lu quedas do enlace\n", (unsigned long)quedas_enlace);
+    fprintf(stderr, "Quadros do OLED gravados: %lu\n", (unsigned long)quadros_gravados);
+    tcp_soquetes_imprimir_estatisticas();
+    exit(0);
+}
+
+// Há algo nos soquetes? No modo mais rápido, só consulta o kernel a cada 1 ms real, para que
+// a espera por eventos não domine o tempo de simulação.
+static bool soquetes_prontos(void) {
+    uint64_t agora_ns = tempo_real_ns();
+    if (simulador.velocidade <= 0 && agora_ns - ultima_verificacao_ns < HAL_HOST_VERIFICAR_SOQUETES_NS) {
+        return false;
+    }
+    ultima_verificacao_ns = agora_ns;
+    return tcp_soquetes_eventos(0);
+}
+
+// Leva o relógio virtual até 'alvo'. Com --velocidade, dorme o tempo real correspondente; um
+// evento de rede no meio do caminho encerra a espera no instante virtual equivalente.
+static void avancar_ate(uint64_t alvo) {
+    if (simulador.velocidade <= 0) {
+        agora_us = alvo;
+        return;
+    }
+    uint64_t real_ns = tempo_real_ns();
+    uint64_t real_alvo_ns = ancora_real_ns + (uint64_t)((alvo - ancora_virtual_us) * 1000.0 / simulador.velocidade);
+    if (real_ns > ancora_real_ns + (uint64_t)((agora_us - ancora_virtual_us) * 1000.0 / simulador.velocidade) + 1000000000u) {
+        // Mais de 1 s atrasado (máquina ocupada ou suspensa): recomeça a contar daqui
+        ancora_real_ns = real_ns;
+        ancora_virtual_us = agora_us;
+        real_alvo_ns = real_ns + (uint64_t)((alvo - agora_us) * 1000.0 / simulador.velocidade);
+    }
+    if (real_alvo_ns > real_ns + 1000000 && tcp_soquetes_eventos((int)((real_alvo_ns - real_ns) / 1000000))) {
+        uint64_t decorrido = (uint64_t)((tempo_real_ns() - ancora_real_ns) / 1000.0 * simulador.velocidade);
+        uint64_t parcial = ancora_virtual_us + decorrido;
+        agora_us = parcial < agora_us ? agora_us : parcial > alvo ? alvo : parcial;
+        return;
+    }
+    agora_us = alvo;
+}
+
+static uint64_t menor(uint64_t a, uint64_t b) {
+    return a < b ? a : b;
+}
+
+// Laço de eventos discretos: roda o núcleo 1 quando vence o prazo dele (ou quando é acordado) e
+// avança o relógio até o primeiro prazo pendente. Retorna ao núcleo 0 quando o prazo dele vence ou
+// quando há trabalho de rede.
+void hal_rede_aguardar(uint64_t prazo_us) {
+    while (true) {
+        if (nucleo1_passo && (nucleo1_acordado || agora_us >= nucleo1_prazo_us)) {
+            nucleo1_acordado = false;
+            nucleo1_prazo_us = nucleo1_passo();
+            continue;
+        }
+        if (agora_us >= proximo_quadro_us) {
+            gravar_quadros();
+            proximo_quadro_us += (uint64_t)simulador.intervalo_quadros_s * 1000000;
+        }
+        if (agora_us >= fim_us) {
+            finalizar();
+        }
+
+        uint64_t prazo_tcp = tcp_soquetes_proximo_prazo();
+        if (trabalho_pendente || agora_us >= prazo_us || agora_us >= prazo_tcp || soquetes_prontos()) {
+            return;
+        }
+        uint64_t alvo = menor(menor(prazo_us, nucleo1_prazo_us), menor(menor(proximo_quadro_us, fim_us), prazo_tcp));
+        avancar_ate(alvo);
+    }
+}
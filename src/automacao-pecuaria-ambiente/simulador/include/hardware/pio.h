@@ -0,0 +1,10 @@
+#ifndef simulador_hardware_pio_h
+#define simulador_hardware_pio_h
+
+#include "pico/stdlib.h"
+
+// inc/dht11.h guarda o PIO do sensor na sua estrutura; o driver do simulador não usa o campo
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef simulador_lwip_mqtt_h
+#define simulador_lwip_mqtt_h
+
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+
+// Subconjunto da API do cliente MQTT do lwIP (lwip/apps/mqtt.h) usado por inc/telemetria_mqtt.c,
+// com os mesmos tipos e valores. O simulador não tem cliente MQTT; estas funções são
+// implementadas pelo broker substituto de tools/testar_telemetria_mqtt.c.
+
+typedef struct mqtt_client_s mqtt_client_t;
+
+typedef enum {
+    MQTT_CONNECT_ACCEPTED = 0,
+    MQTT_CONNECT_REFUSED_PROTOCOL_VERSION = 1,
+    MQTT_CONNECT_REFUSED_IDENTIFIER = 2,
+    MQTT_CONNECT_REFUSED_SERVER = 3,
+    MQTT_CONNECT_REFUSED_USERNAME_PASS = 4,
+    MQTT_CONNECT_REFUSED_NOT_AUTHORIZED_ = 5,
+    MQTT_CONNECT_DISCONNECTED = 256,
+    MQTT_CONNECT_TIMEOUT = 257,
+} mqtt_connection_status_t;
+
+typedef void (*mqtt_connection_cb_t)(mqtt_client_t *cliente, void *arg, mqtt_connection_status_t status);
+typedef void (*mqtt_request_cb_t)(void *arg, err_t err);
+
+struct mqtt_connect_client_info_t {
+    const char *client_id;
+    const char *client_user;
+    const char *client_pass;
+    u16_t keep_alive;
+    const char *will_topic;
+    const char *will_msg;
+    u8_t will_qos;
+    u8_t will_retain;
+};
+
+err_t mqtt_client_connect(mqtt_client_t *cliente, const ip_addr_t *endereco, u16_t porta, mqtt_connection_cb_t funcao,
+                          void *arg, const struct mqtt_connect_client_info_t *info);
+void mqtt_disconnect(mqtt_client_t *cliente);
+u8_t mqtt_client_is_connected(mqtt_client_t *cliente);
+err_t mqtt_publish(mqtt_client_t *cliente, const char *topico, const void *payload, u16_t tamanho, u8_t qos,
+                   u8_t reter, mqtt_request_cb_t funcao, void *arg);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef simulador_lwip_mqtt_priv_h
+#define simulador_lwip_mqtt_priv_h
+
+#include "lwip/apps/mqtt.h"
+
+// Só para que mqtt_client_t possa ser alocado estaticamente, como no lwIP. O estado da conexão
+// fica com a implementação (o broker substituto).
+struct mqtt_client_s {
+    u8_t conn_state;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef simulador_lwip_err_h
+#define simulador_lwip_err_h
+
+#include <stdint.h>
+
+// Tipos e códigos de erro do lwIP (lwip/arch.h e lwip/err.h), com os mesmos valores
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_BUF -2
+#define ERR_TIMEOUT -3
+#define ERR_VAL -6
+#define ERR_USE -8
+#define ERR_CONN -11
+#define ERR_ABRT -13
+#define ERR_RST -14
+#define ERR_CLSD -15
+#define ERR_ARG -16
+
+#endif
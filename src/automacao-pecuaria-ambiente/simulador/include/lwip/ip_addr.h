@@ -0,0 +1,16 @@
+#ifndef simulador_lwip_ip_addr_h
+#define simulador_lwip_ip_addr_h
+
+#include "lwip/err.h"
+
+// Endereço IPv4 do lwIP, na ordem de bytes da rede. ipaddr_aton() fica com quem liga o módulo
+// que a usa (o broker substituto de tools/testar_telemetria_mqtt.c).
+typedef struct ip_addr {
+    u32_t addr;
+} ip_addr_t;
+
+#define IP_ADDR_ANY ((const ip_addr_t *)0)
+
+int ipaddr_aton(const char *texto, ip_addr_t *endereco);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef simulador_lwip_pbuf_h
+#define simulador_lwip_pbuf_h
+
+#include "lwip/err.h"
+
+// Cadeia de buffers recebidos, com os campos e as funções do lwIP que o servidor web usa.
+// Cada pbuf é um único bloco do malloc: a estrutura seguida dos dados.
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;     // Bytes desta pbuf e das seguintes
+    u16_t len;         // Bytes desta pbuf
+};
+
+struct pbuf *pbuf_alocar(const void *dados, u16_t tamanho);
+u8_t pbuf_free(struct pbuf *p);
+void pbuf_cat(struct pbuf *cabeca, struct pbuf *cauda);
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t tamanho);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef simulador_lwip_tcp_h
+#define simulador_lwip_tcp_h
+
+#include <stdbool.h>
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+#include "lwipopts.h"
+
+// Subconjunto da API "raw" de TCP do lwIP sobre soquetes do Linux (simulador/tcp_soquetes.c).
+// As callbacks são chamadas de hal_rede_processar(), como o cyw43 faz no contexto da rede.
+// A janela de recepção (TCP_WND) e o buffer de envio (TCP_SND_BUF) são os de lwipopts.h, de modo
+// que o servidor web vê os mesmos limites que na placa. Um byte aceito pelo kernel conta como
+// confirmado pelo cliente.
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *novo, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *pcb, u16_t tamanho);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *pcb);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb *tcp_new(void);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *endereco, u16_t porta);
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn funcao);
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn funcao);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn funcao);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn funcao);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn funcao, u8_t intervalo);
+void tcp_recved(struct tcp_pcb *pcb, u16_t tamanho);
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb);
+err_t tcp_write(struct tcp_pcb *pcb, const void *dados, u16_t tamanho, u8_t opcoes);
+err_t tcp_output(struct tcp_pcb *pcb);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+
+#endif
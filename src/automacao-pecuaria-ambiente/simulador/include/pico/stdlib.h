@@ -0,0 +1,19 @@
+#ifndef simulador_pico_stdlib_h
+#define simulador_pico_stdlib_h
+
+// Só os tipos e macros do SDK que o código compartilhado com o firmware usa fora de inc/hal.h.
+// No simulador não há nenhuma função do SDK: o hardware inteiro passa pela HAL.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/util/datetime.h"
+
+typedef unsigned int uint;
+
+#define _u(x) x ## u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+static inline void tight_loop_contents(void) {}
+
+#endif
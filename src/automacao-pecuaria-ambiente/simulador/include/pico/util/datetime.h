@@ -0,0 +1,17 @@
+#ifndef simulador_pico_datetime_h
+#define simulador_pico_datetime_h
+
+#include <stdint.h>
+
+// Mesmo leiaute do datetime_t do SDK (pico/types.h)
+typedef struct {
+    int16_t year;
+    int8_t month;
+    int8_t day;
+    int8_t dotw;   // 0 é domingo
+    int8_t hour;
+    int8_t min;
+    int8_t sec;
+} datetime_t;
+
+#endif
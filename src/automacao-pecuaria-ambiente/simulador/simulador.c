@@ -0,0 +1,103 @@
+/**
+ * Simulador do firmware no Linux: o mesmo automacao-pecuaria-ambiente.c, ligado à HAL do host
+ * (hal_host.c) em vez da do Pico, com sensores alimentados por um clima simulado ou gravado e o
+ * servidor web atendendo numa porta local. O relógio é virtual, então dias de operação (regras,
+ * histórico, camadas, log em flash) passam em segundos. Compilação, sem o SDK do Pico:
+ *
+ *   cmake -S . -B build-sim -DSIMULACAO_HOST=ON && cmake --build build-sim
+ *   ./build-sim/simulador --dias 7 --quadros /tmp/oled --eventos reles.csv > console.txt
+ *   ./build-sim/simulador --velocidade 60 --porta 8080      # 1 min por segundo; painel em localhost:8080
+ *
+ * O console do firmware sai em stdout; as mensagens e o relatório do simulador, em stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "simulador.h"
+
+simulador_config_t simulador = {
+    .dias = 1,
+    .velocidade = 0,
+    .porta = 8080,
+    .semente = 1,
+    .intervalo_quadros_s = 3600,
+};
+
+int firmware_main(void);
+
+static void ajuda(const char *programa) {
+    fprintf(stderr,
+            "Uso: %s [opcoes]\n"
+            "  --dias N               duracao simulada (padrao 1)\n"
+            "  --velocidade X         segundos simulados por segundo real; 0 = o mais rapido possivel (padrao)\n"
+            "  --porta P              porta local do servidor web; 0 desativa (padrao 8080)\n"
+            "  --clima ARQUIVO        serie CSV tempo;temperatura;umidade[;luminosidade] em vez do modelo\n"
+            "  --semente N            semente do clima e das falhas (padrao 1)\n"
+            "  --quadros DIR          grava o OLED como PGM em DIR\n"
+            "  --intervalo-quadros S  segundos simulados entre quadros (padrao 3600)\n"
+            "  --eventos ARQUIVO      CSV com cada troca de estado dos reles\n"
+            "  --flash ARQUIVO        guarda a flash dos logs entre execucoes\n"
+            "  --corte-flash N        corta a energia no meio da N-esima gravacao ou apagamento da flash\n"
+            "  --falhas-dht11 P       fracao de quadros do DHT11 perdidos ou corrompidos (0..1)\n"
+            "  --queda-wifi H:D       derruba o Wi-Fi na hora H por D horas\n",
+            programa);
+}
+
+int main(int argc, char **argv) {
+    static const struct option opcoes[] = {
+        {"dias", required_argument, NULL, 'd'},
+        {"velocidade", required_argument, NULL, 'v'},
+        {"porta", required_argument, NULL, 'p'},
+        {"clima", required_argument, NULL, 'c'},
+        {"semente", required_argument, NULL, 's'},
+        {"quadros", required_argument, NULL, 'q'},
+        {"intervalo-quadros", required_argument, NULL, 'i'},
+        {"eventos", required_argument, NULL, 'e'},
+        {"flash", required_argument, NULL, 'f'},
+        {"corte-flash", required_argument, NULL, 'k'},
+        {"falhas-dht11", required_argument, NULL, 'x'},
+        {"queda-wifi", required_argument, NULL, 'w'},
+        {"ajuda", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int opcao;
+    while ((opcao = getopt_long(argc, argv, "h", opcoes, NULL)) != -1) {
+        switch (opcao) {
+            case 'd': simulador.dias = atof(optarg); break;
+            case 'v': simulador.velocidade = atof(optarg); break;
+            case 'p': simulador.porta = (uint16_t)atoi(optarg); break;
+            case 'c': simulador.clima = optarg; break;
+            case 's': simulador.semente = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'q': simulador.quadros = optarg; break;
+            case 'i': simulador.intervalo_quadros_s = (uint32_t)atoi(optarg); break;
+            case 'e': simulador.eventos = optarg; break;
+            case 'f': simulador.flash = optarg; break;
+            case 'k': simulador.corte_flash = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'x': simulador.falhas_dht11 = atof(optarg); break;
+            case 'w':
+                if (sscanf(optarg, "%lf:%lf", &simulador.queda_wifi_inicio_h, &simulador.queda_wifi_duracao_h) != 2) {
+                    fprintf(stderr, "--queda-wifi espera HORA:DURACAO, em horas\n");
+                    return 2;
+                }
+                break;
+            default:
+                ajuda(argv[0]);
+                return opcao == 'h' ? 0 : 2;
+        }
+    }
+    if (simulador.dias <= 0 || simulador.velocidade < 0 || simulador.falhas_dht11 < 0 || simulador.falhas_dht11 > 1) {
+        ajuda(argv[0]);
+        return 2;
+    }
+
+    if (!clima_iniciar(simulador.clima, simulador.semente)) {
+        return 1;
+    }
+    tcp_soquetes_mapear_porta(80, simulador.porta);
+
+    // Só retorna se o firmware sair por conta própria; o fim da simulação encerra o processo
+    return firmware_main();
+}
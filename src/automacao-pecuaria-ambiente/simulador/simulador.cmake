@@ -0,0 +1,26 @@
+# Linux simulator: the firmware's main file and SDK-independent modules, linked against the host
+# HAL, the socket-backed lwIP subset and simulated sensors (see simulador/simulador.c)
+
+add_executable(simulador
+        automacao-pecuaria-ambiente.c
+        inc/ssd1306_i2c.c inc/oled_texto.c inc/oled_grafico.c inc/agendador.c inc/canal_spsc.c inc/historico.c inc/data_hora.c inc/flash_log.c
+        inc/formato.c inc/json.c inc/http_fluxo.c inc/http_requisicao.c inc/serie_binaria.c inc/regras.c inc/agregados.c inc/camadas.c
+        inc/dht11_quadro.c inc/filtro_adc.c inc/metricas.c
+        simulador/simulador.c simulador/hal_host.c simulador/tcp_soquetes.c simulador/clima.c
+        simulador/dht11_host.c simulador/amostragem_adc_host.c simulador/flash_nor.c)
+
+embutir_recursos_web(simulador)
+
+# The firmware's main() becomes firmware_main(), called by the simulator after parsing its options.
+# Both sensors and /metrics are always on; MQTT telemetry needs lwIP's MQTT client and stays off.
+set_source_files_properties(automacao-pecuaria-ambiente.c PROPERTIES COMPILE_DEFINITIONS main=firmware_main)
+target_compile_definitions(simulador PRIVATE SIMULACAO_HOST=1 SENSOR_DHT11=1 SENSOR_LDR=1 METRICAS=1)
+
+# simulador/include holds stand-ins for the few SDK and lwIP headers the shared code includes
+target_include_directories(simulador PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc
+        ${CMAKE_CURRENT_SOURCE_DIR}/simulador
+        ${CMAKE_CURRENT_SOURCE_DIR}/simulador/include)
+
+target_link_libraries(simulador m)
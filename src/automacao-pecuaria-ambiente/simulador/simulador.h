@@ -0,0 +1,51 @@
+#ifndef simulador_h
+#define simulador_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+// Configuração e serviços comuns às peças do simulador (hal_host.c, tcp_soquetes.c, clima.c e
+// os drivers de sensores do host). Só o simulador inclui este arquivo; o firmware só vê inc/hal.h.
+
+typedef struct {
+    double dias;                    // Duração simulada
+    double velocidade;              // Segundos simulados por segundo real; 0 = o mais rápido possível
+    uint16_t porta;                 // Porta do host para a porta 80 do firmware; 0 = sem servidor web
+    const char *clima;              // Série CSV de clima, ou NULL para o modelo embutido
+    uint32_t semente;               // Semente do clima e das falhas injetadas
+    const char *quadros;            // Diretório dos quadros do OLED (PGM), ou NULL
+    uint32_t intervalo_quadros_s;
+    const char *eventos;            // CSV das trocas dos relés, ou NULL
+    const char *flash;              // Arquivo que guarda a flash dos logs entre execuções, ou NULL
+    uint32_t corte_flash;           // Operação da flash em que a energia cai (1 = a primeira); 0 = nenhuma
+    double falhas_dht11;            // Fração dos quadros do DHT11 perdidos ou corrompidos
+    double queda_wifi_inicio_h;     // Queda do Wi-Fi, em horas desde o boot (duração 0 = nenhuma)
+    double queda_wifi_duracao_h;
+} simulador_config_t;
+
+extern simulador_config_t simulador;
+
+// Relógio virtual (hal_host.c)
+uint32_t simulador_epoch(void);     // Hora do RTC simulado, em segundos desde 1970
+uint32_t simulador_aleatorio(uint32_t *estado);   // xorshift32, para execuções reproduzíveis
+
+// Clima do curral (clima.c), em unidades de exibição: °C, % e % de luz
+typedef struct {
+    float temperatura;
+    float umidade;
+    float luminosidade;
+} clima_t;
+
+bool clima_iniciar(const char *arquivo, uint32_t semente);
+void clima_agora(clima_t *c);
+
+// Subconjunto do lwIP sobre soquetes (tcp_soquetes.c)
+void tcp_soquetes_mapear_porta(uint16_t porta, uint16_t porta_host);
+bool tcp_soquetes_eventos(int espera_ms);    // Espera até haver algo para tcp_soquetes_processar()
+void tcp_soquetes_processar(void);           // Roda as callbacks; chamado por hal_rede_processar()
+uint64_t tcp_soquetes_proximo_prazo(void);   // Próximo tcp_poll, em tempo virtual
+void tcp_soquetes_imprimir_estatisticas(void);
+int tcp_soquetes_memoria(hal_memoria_t *pools, int maximo);   // Para hal_rede_memoria()
+
+#endif
@@ -0,0 +1,575 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#undef TCP_MSS   // Nome de opção de soquete em netinet/tcp.h; aqui vale o tamanho de segmento de lwipopts.h
+#include "lwip/tcp.h"
+#include "hal.h"
+#include "simulador.h"
+
+// A API raw do lwIP que o servidor web usa, sobre soquetes não bloqueantes do Linux.
+// Tudo roda numa única thread: as callbacks saem de tcp_soquetes_processar(), chamada pelo laço
+// principal do firmware através de hal_rede_processar(), como o cyw43 faz na placa.
+// Diferenças em relação ao lwIP:
+// - um byte aceito pelo kernel conta como confirmado pelo cliente (tcp_sent);
+// - tcp_write() sempre copia os dados;
+// - o tcp_poll corre em tempo virtual, como os demais prazos do firmware.
+
+#define TCP_SOQUETES_MAX_PCBS 16
+#define TCP_SOQUETES_MAX_PORTAS 4
+#define TCP_SOQUETES_INTERVALO_US 500000      // Unidade do intervalo de tcp_poll (TCP_SLOW_INTERVAL)
+#define TCP_SOQUETES_PRAZO_FECHAR_US 5000000  // Espera pelo FIN do cliente depois de tcp_close
+
+typedef enum {
+    PCB_LIVRE,
+    PCB_NOVO,          // Criado por tcp_new, ainda sem soquete
+    PCB_ESCUTANDO,
+    PCB_CONECTADO,
+    PCB_FECHANDO,      // tcp_close: termina de enviar e descarta o que chegar até o FIN do cliente
+    PCB_DESCARTADO,    // Volta a PCB_LIVRE no fim de tcp_soquetes_processar()
+} estado_pcb_t;
+
+struct tcp_pcb {
+    estado_pcb_t estado;
+    int soquete;
+    u16_t porta;
+    void *arg;
+    tcp_accept_fn aceitar;
+    tcp_recv_fn receber;
+    tcp_sent_fn enviado;
+    tcp_err_fn erro;
+    tcp_poll_fn sondar;
+    uint64_t intervalo_poll_us;
+    uint64_t proximo_poll_us;
+    uint64_t prazo_fechar_us;
+    u32_t janela;                 // Bytes que ainda podem ser entregues antes de tcp_recved
+    bool remoto_fechou;
+    err_t erro_pendente;          // Falha de envio, informada fora de tcp_output
+    struct pbuf *recusado;        // Dados que a callback de recepção não aceitou
+    u32_t confirmados;            // Aceitos pelo kernel e ainda não informados em tcp_sent
+    u32_t envio_usados;
+    uint8_t envio[TCP_SND_BUF];
+};
+
+static struct tcp_pcb pcbs[TCP_SOQUETES_MAX_PCBS];
+
+static struct {
+    u16_t porta;
+    u16_t porta_host;
+} portas[TCP_SOQUETES_MAX_PORTAS];
+
+static struct {
+    uint32_t aceitas;
+    uint32_t recusadas;           // Sem pcb livre
+    uint64_t bytes_recebidos;
+    uint64_t bytes_enviados;
+} estatisticas;
+
+// Uso dos "pools" para /metrics: os pcbs são um vetor fixo, como no lwIP; as pbufs vêm do malloc
+static struct {
+    uint32_t pbufs;
+    uint32_t pbufs_maximo;
+    uint32_t pcbs_maximo;
+    uint32_t pcbs_falhas;
+} memoria;
+
+// --- PBUF ---
+struct pbuf *pbuf_alocar(const void *dados, u16_t tamanho) {
+    struct pbuf *p = malloc(sizeof(struct pbuf) + tamanho);
+    if (!p) {
+        return NULL;
+    }
+    p->next = NULL;
+    p->payload = p + 1;
+    p->tot_len = tamanho;
+    p->len = tamanho;
+    memcpy(p->payload, dados, tamanho);
+    if (++memoria.pbufs > memoria.pbufs_maximo) {
+        memoria.pbufs_maximo = memoria.pbufs;
+    }
+    return p;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    u8_t liberados = 0;
+    while (p) {
+        struct pbuf *proximo = p->next;
+        free(p);
+        memoria.pbufs--;
+        liberados++;
+        p = proximo;
+    }
+    return liberados;
+}
+
+void pbuf_cat(struct pbuf *cabeca, struct pbuf *cauda) {
+    struct pbuf *p = cabeca;
+    for (; p->next; p = p->next) {
+        p->tot_len += cauda->tot_len;
+    }
+    p->tot_len += cauda->tot_len;
+    p->next = cauda;
+}
+
+// Descarta 'tamanho' bytes do início da cadeia; retorna a nova cabeça
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t tamanho) {
+    while (q && tamanho > 0) {
+        if (tamanho >= q->len) {
+            struct pbuf *proximo = q->next;
+            tamanho -= q->len;
+            free(q);
+            memoria.pbufs--;
+            q = proximo;
+        } else {
+            q->payload = (uint8_t *)q->payload + tamanho;
+            q->len -= tamanho;
+            q->tot_len -= tamanho;
+            tamanho = 0;
+        }
+    }
+    return q;
+}
+
+// --- PCBS ---
+void tcp_soquetes_mapear_porta(uint16_t porta, uint16_t porta_host) {
+    for (int i = 0; i < TCP_SOQUETES_MAX_PORTAS; i++) {
+        if (portas[i].porta == 0 || portas[i].porta == porta) {
+            portas[i].porta = porta;
+            portas[i].porta_host = porta_host;
+            return;
+        }
+    }
+}
+
+static u16_t porta_host(u16_t porta) {
+    for (int i = 0; i < TCP_SOQUETES_MAX_PORTAS; i++) {
+        if (portas[i].porta == porta) {
+            return portas[i].porta_host;
+        }
+    }
+    return porta;
+}
+
+static bool sem_bloqueio(int soquete) {
+    int flags = fcntl(soquete, F_GETFL);
+    return flags >= 0 && fcntl(soquete, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Fecha com RST, como o lwIP faz em tcp_abort
+static void fechar_abortando(int soquete) {
+    struct linger l = {.l_onoff = 1, .l_linger = 0};
+    setsockopt(soquete, SOL_SOCKET, SO_LINGER, &l, sizeof(l));
+    close(soquete);
+}
+
+static void descartar(struct tcp_pcb *pcb) {
+    if (pcb->recusado) {
+        pbuf_free(pcb->recusado);
+        pcb->recusado = NULL;
+    }
+    pcb->estado = PCB_DESCARTADO;
+}
+
+struct tcp_pcb *tcp_new(void) {
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        if (pcbs[i].estado == PCB_LIVRE) {
+            struct tcp_pcb *pcb = &pcbs[i];
+            memset(pcb, 0, offsetof(struct tcp_pcb, envio));
+            pcb->estado = PCB_NOVO;
+            pcb->soquete = -1;
+            uint32_t uso = 0;
+            for (int j = 0; j < TCP_SOQUETES_MAX_PCBS; j++) {
+                uso += pcbs[j].estado != PCB_LIVRE;
+            }
+            if (uso > memoria.pcbs_maximo) {
+                memoria.pcbs_maximo = uso;
+            }
+            return pcb;
+        }
+    }
+    memoria.pcbs_falhas++;
+    return NULL;
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *endereco, u16_t porta) {
+    pcb->porta = porta;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    pcb->estado = PCB_ESCUTANDO;
+    u16_t porta = porta_host(pcb->porta);
+    if (porta == 0) {
+        fprintf(stderr, "Simulador: porta %u do firmware desativada\n", pcb->porta);
+        return pcb;
+    }
+
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    int um = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    struct sockaddr_in endereco = {.sin_family = AF_INET, .sin_port = htons(porta), .sin_addr.s_addr = htonl(INADDR_ANY)};
+    if (s < 0 || bind(s, (struct sockaddr *)&endereco, sizeof(endereco)) < 0 || listen(s, 8) < 0 || !sem_bloqueio(s)) {
+        fprintf(stderr, "Simulador: porta %u indisponivel (%s); servidor sem conexoes\n", porta, strerror(errno));
+        if (s >= 0) {
+            close(s);
+        }
+        return pcb;
+    }
+    pcb->soquete = s;
+    fprintf(stderr, "Simulador: porta %u do firmware em http://localhost:%u/\n", pcb->porta, porta);
+    return pcb;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn funcao) {
+    pcb->aceitar = funcao;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) {
+    pcb->arg = arg;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn funcao) {
+    pcb->receber = funcao;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn funcao) {
+    pcb->enviado = funcao;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn funcao) {
+    pcb->erro = funcao;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn funcao, u8_t intervalo) {
+    pcb->sondar = funcao;
+    pcb->intervalo_poll_us = (uint64_t)intervalo * TCP_SOQUETES_INTERVALO_US;
+    pcb->proximo_poll_us = hal_tempo_us() + pcb->intervalo_poll_us;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t tamanho) {
+    pcb->janela += tamanho;
+    if (pcb->janela > TCP_WND) {
+        pcb->janela = TCP_WND;
+    }
+}
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+    return pcb->estado == PCB_CONECTADO ? (u16_t)(TCP_SND_BUF - pcb->envio_usados) : 0;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dados, u16_t tamanho, u8_t opcoes) {
+    if (pcb->estado != PCB_CONECTADO) {
+        return ERR_CONN;
+    }
+    if (tamanho > TCP_SND_BUF - pcb->envio_usados) {
+        return ERR_MEM;
+    }
+    memcpy(pcb->envio + pcb->envio_usados, dados, tamanho);
+    pcb->envio_usados += tamanho;
+    return ERR_OK;
+}
+
+// Passa ao kernel o que couber; o que ele aceitar conta como confirmado
+static void descarregar(struct tcp_pcb *pcb) {
+    while (pcb->envio_usados > 0 && pcb->erro_pendente == ERR_OK) {
+        ssize_t n = send(pcb->soquete, pcb->envio, pcb->envio_usados, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                pcb->erro_pendente = ERR_RST;
+            }
+            return;
+        }
+        pcb->envio_usados -= n;
+        memmove(pcb->envio, pcb->envio + n, pcb->envio_usados);
+        pcb->confirmados += n;
+        estatisticas.bytes_enviados += n;
+    }
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+    if (pcb->estado == PCB_CONECTADO || pcb->estado == PCB_FECHANDO) {
+        descarregar(pcb);
+    }
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    if (pcb->estado == PCB_CONECTADO) {
+        // O resto do envio segue; nenhuma callback é chamada depois do close
+        pcb->estado = PCB_FECHANDO;
+        pcb->prazo_fechar_us = hal_tempo_us() + TCP_SOQUETES_PRAZO_FECHAR_US;
+        pcb->receber = NULL;
+        pcb->enviado = NULL;
+        pcb->erro = NULL;
+        pcb->sondar = NULL;
+        descarregar(pcb);
+        return ERR_OK;
+    }
+    if (pcb->estado != PCB_FECHANDO) {
+        if (pcb->soquete >= 0) {
+            close(pcb->soquete);
+            pcb->soquete = -1;
+        }
+        descartar(pcb);
+    }
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    tcp_err_fn erro = pcb->estado == PCB_CONECTADO ? pcb->erro : NULL;
+    void *arg = pcb->arg;
+    if (pcb->soquete >= 0) {
+        fechar_abortando(pcb->soquete);
+        pcb->soquete = -1;
+    }
+    descartar(pcb);
+    if (erro) {
+        erro(arg, ERR_ABRT);
+    }
+}
+
+// --- PROCESSAMENTO ---
+// O pcb deixa de existir antes da callback de erro, como no lwIP
+static void falhar(struct tcp_pcb *pcb, err_t err) {
+    tcp_err_fn erro = pcb->estado == PCB_CONECTADO ? pcb->erro : NULL;
+    void *arg = pcb->arg;
+    close(pcb->soquete);
+    pcb->soquete = -1;
+    descartar(pcb);
+    if (erro) {
+        erro(arg, err);
+    }
+}
+
+// Entrega dados (ou o fim da conexão, com p == NULL) à aplicação
+static void entregar(struct tcp_pcb *pcb, struct pbuf *p) {
+    if (!pcb->receber) {
+        // Sem callback, o lwIP descarta os dados e fecha no fim (tcp_recv_null)
+        if (p) {
+            tcp_recved(pcb, p->tot_len);
+            pbuf_free(p);
+        } else {
+            tcp_close(pcb);
+        }
+        return;
+    }
+    err_t err = pcb->receber(pcb->arg, pcb, p, ERR_OK);
+    if (err != ERR_OK && err != ERR_ABRT && p && pcb->estado == PCB_CONECTADO) {
+        pcb->recusado = p;   // Nova tentativa na próxima passagem
+    }
+}
+
+static void aceitar_conexoes(struct tcp_pcb *escuta) {
+    int s;
+    while ((s = accept(escuta->soquete, NULL, NULL)) >= 0) {
+        struct tcp_pcb *novo = tcp_new();
+        if (!novo || !sem_bloqueio(s)) {
+            estatisticas.recusadas++;
+            fechar_abortando(s);
+            if (novo) {
+                novo->estado = PCB_LIVRE;
+            }
+            continue;
+        }
+        int um = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+        novo->estado = PCB_CONECTADO;
+        novo->soquete = s;
+        novo->porta = escuta->porta;
+        novo->janela = TCP_WND;
+        estatisticas.aceitas++;
+
+        err_t err = escuta->aceitar ? escuta->aceitar(escuta->arg, novo, ERR_OK) : ERR_VAL;
+        if (err != ERR_OK && err != ERR_ABRT && novo->estado == PCB_CONECTADO) {
+            tcp_abort(novo);
+        }
+    }
+}
+
+static void ler(struct tcp_pcb *pcb) {
+    uint8_t dados[TCP_MSS];
+    if (pcb->estado == PCB_FECHANDO) {
+        ssize_t n = recv(pcb->soquete, dados, sizeof(dados), MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            pcb->remoto_fechou = true;
+        }
+        return;
+    }
+    if (pcb->recusado || pcb->janela == 0 || pcb->remoto_fechou) {
+        return;
+    }
+
+    size_t maximo = pcb->janela < sizeof(dados) ? pcb->janela : sizeof(dados);
+    ssize_t n = recv(pcb->soquete, dados, maximo, MSG_DONTWAIT);
+    if (n > 0) {
+        struct pbuf *p = pbuf_alocar(dados, (u16_t)n);
+        if (!p) {
+            return;
+        }
+        pcb->janela -= n;
+        estatisticas.bytes_recebidos += n;
+        entregar(pcb, p);
+    } else if (n == 0) {
+        pcb->remoto_fechou = true;
+        entregar(pcb, NULL);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        falhar(pcb, ERR_RST);
+    }
+}
+
+// Monta a lista de soquetes e os eventos de interesse de cada um
+static int montar_pollfds(struct pollfd *fds, struct tcp_pcb **donos) {
+    int n = 0;
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        struct tcp_pcb *pcb = &pcbs[i];
+        short eventos = 0;
+        if (pcb->soquete < 0) {
+            continue;
+        }
+        if (pcb->estado == PCB_ESCUTANDO) {
+            eventos = POLLIN;
+        } else if (pcb->estado == PCB_CONECTADO) {
+            eventos = (pcb->janela > 0 && !pcb->remoto_fechou && !pcb->recusado ? POLLIN : 0) |
+                      (pcb->envio_usados > 0 ? POLLOUT : 0);
+        } else if (pcb->estado == PCB_FECHANDO) {
+            eventos = (pcb->remoto_fechou ? 0 : POLLIN) | (pcb->envio_usados > 0 ? POLLOUT : 0);
+        }
+        if (eventos) {
+            fds[n] = (struct pollfd){.fd = pcb->soquete, .events = eventos};
+            donos[n++] = pcb;
+        }
+    }
+    return n;
+}
+
+// Trabalho que não depende do kernel: confirmações a informar, erros e pcbs a recolher
+static bool trabalho_interno(void) {
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        const struct tcp_pcb *pcb = &pcbs[i];
+        if (pcb->estado == PCB_DESCARTADO ||
+            (pcb->estado == PCB_CONECTADO && ((pcb->confirmados > 0 && pcb->enviado) || pcb->erro_pendente != ERR_OK)) ||
+            (pcb->estado == PCB_FECHANDO && pcb->envio_usados == 0 && pcb->remoto_fechou)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool tcp_soquetes_eventos(int espera_ms) {
+    if (trabalho_interno()) {
+        return true;
+    }
+    struct pollfd fds[TCP_SOQUETES_MAX_PCBS];
+    struct tcp_pcb *donos[TCP_SOQUETES_MAX_PCBS];
+    int n = montar_pollfds(fds, donos);
+    if (n == 0) {
+        if (espera_ms > 0) {
+            poll(NULL, 0, espera_ms);
+        }
+        return false;
+    }
+    return poll(fds, n, espera_ms) > 0;
+}
+
+uint64_t tcp_soquetes_proximo_prazo(void) {
+    uint64_t prazo = HAL_PRAZO_NENHUM;
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        const struct tcp_pcb *pcb = &pcbs[i];
+        if (pcb->estado == PCB_CONECTADO && pcb->sondar && pcb->proximo_poll_us < prazo) {
+            prazo = pcb->proximo_poll_us;
+        } else if (pcb->estado == PCB_FECHANDO && pcb->prazo_fechar_us < prazo) {
+            prazo = pcb->prazo_fechar_us;
+        }
+    }
+    return prazo;
+}
+
+void tcp_soquetes_processar(void) {
+    struct pollfd fds[TCP_SOQUETES_MAX_PCBS];
+    struct tcp_pcb *donos[TCP_SOQUETES_MAX_PCBS];
+    int n = montar_pollfds(fds, donos);
+    if (n > 0 && poll(fds, n, 0) > 0) {
+        for (int i = 0; i < n; i++) {
+            struct tcp_pcb *pcb = donos[i];
+            // Uma callback anterior pode ter fechado este pcb
+            if (!fds[i].revents || pcb->soquete != fds[i].fd) {
+                continue;
+            }
+            if (pcb->estado == PCB_ESCUTANDO) {
+                aceitar_conexoes(pcb);
+                continue;
+            }
+            if (fds[i].revents & POLLOUT) {
+                descarregar(pcb);
+            }
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ler(pcb);
+            }
+        }
+    }
+
+    uint64_t agora = hal_tempo_us();
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        struct tcp_pcb *pcb = &pcbs[i];
+        if (pcb->estado == PCB_CONECTADO && pcb->erro_pendente != ERR_OK) {
+            falhar(pcb, pcb->erro_pendente);
+        }
+        if (pcb->estado == PCB_CONECTADO && pcb->recusado) {
+            struct pbuf *p = pcb->recusado;
+            pcb->recusado = NULL;
+            entregar(pcb, p);
+        }
+        if (pcb->estado == PCB_CONECTADO && pcb->confirmados > 0 && pcb->enviado) {
+            u16_t confirmados = pcb->confirmados > 0xFFFF ? 0xFFFF : (u16_t)pcb->confirmados;
+            pcb->confirmados -= confirmados;
+            pcb->enviado(pcb->arg, pcb, confirmados);
+        }
+        if (pcb->estado == PCB_CONECTADO && pcb->sondar && agora >= pcb->proximo_poll_us) {
+            pcb->proximo_poll_us = agora + pcb->intervalo_poll_us;
+            pcb->sondar(pcb->arg, pcb);
+        }
+        if (pcb->estado == PCB_FECHANDO && pcb->erro_pendente == ERR_OK && pcb->envio_usados > 0) {
+            descarregar(pcb);
+        }
+        if (pcb->estado == PCB_FECHANDO &&
+            (pcb->erro_pendente != ERR_OK || (pcb->envio_usados == 0 && (pcb->remoto_fechou || agora >= pcb->prazo_fechar_us)))) {
+            close(pcb->soquete);
+            pcb->soquete = -1;
+            descartar(pcb);
+        }
+    }
+
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        if (pcbs[i].estado == PCB_DESCARTADO) {
+            pcbs[i].estado = PCB_LIVRE;
+        }
+    }
+}
+
+void tcp_soquetes_imprimir_estatisticas(void) {
+    fprintf(stderr, "HTTP: %lu conexoes aceitas, %lu recusadas; %llu bytes recebidos, %llu enviados\n",
+            (unsigned long)estatisticas.aceitas, (unsigned long)estatisticas.recusadas,
+            (unsigned long long)estatisticas.bytes_recebidos, (unsigned long long)estatisticas.bytes_enviados);
+}
+
+int tcp_soquetes_memoria(hal_memoria_t *pools, int maximo) {
+    uint32_t pcbs_uso = 0;
+    for (int i = 0; i < TCP_SOQUETES_MAX_PCBS; i++) {
+        pcbs_uso += pcbs[i].estado != PCB_LIVRE;
+    }
+    int n = 0;
+    if (n < maximo) {
+        pools[n++] = (hal_memoria_t){"TCP_PCB", pcbs_uso, memoria.pcbs_maximo, TCP_SOQUETES_MAX_PCBS, memoria.pcbs_falhas};
+    }
+    if (n < maximo) {
+        pools[n++] = (hal_memoria_t){"PBUF", memoria.pbufs, memoria.pbufs_maximo, 0, 0};
+    }
+    return n;
+}
@@ -0,0 +1,114 @@
+/**
+ * Decodificador de referência do formato binário do histórico (/api/history.bin).
+ * O formato está descrito em inc/serie_binaria.h. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -o decodificar_historico decodificar_historico.c
+ *   curl -s "http://<pico>/api/history.bin?since=0" | ./decodificar_historico
+ *
+ * Imprime uma linha por amostra (sequencia;data;temperatura;umidade;luminosidade;reles) e,
+ * na saída de erro, o cursor para a próxima coleta.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const uint8_t *dados;
+    size_t tamanho;
+    size_t posicao;
+} leitor_t;
+
+static uint32_t ler_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool ler_varint(leitor_t *l, uint32_t *valor) {
+    uint32_t v = 0;
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        if (l->posicao >= l->tamanho) {
+            return false;
+        }
+        uint8_t b = l->dados[l->posicao++];
+        v |= (uint32_t)(b & 0x7F) << deslocamento;
+        if (!(b & 0x80)) {
+            *valor = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ler_zigzag(leitor_t *l, int32_t *valor) {
+    uint32_t v;
+    if (!ler_varint(l, &v)) {
+        return false;
+    }
+    *valor = (int32_t)((v >> 1) ^ (0u - (v & 1)));
+    return true;
+}
+
+int main(int argc, char **argv) {
+    FILE *entrada = stdin;
+    if (argc > 1 && !(entrada = fopen(argv[1], "rb"))) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static uint8_t buffer[4 * 1024 * 1024];
+    size_t tamanho = fread(buffer, 1, sizeof(buffer), entrada);
+    leitor_t l = {buffer, tamanho, 0};
+
+    if (tamanho < 8 || memcmp(buffer, "HBIN", 4) != 0) {
+        fprintf(stderr, "assinatura HBIN ausente\n");
+        return 1;
+    }
+    if (buffer[4] != 1) {
+        fprintf(stderr, "versao %u nao suportada\n", buffer[4]);
+        return 1;
+    }
+    size_t tamanho_cabecalho = buffer[5];
+    if (tamanho_cabecalho < 20 || tamanho < tamanho_cabecalho) {
+        fprintf(stderr, "cabecalho incompleto\n");
+        return 1;
+    }
+
+    uint32_t sequencia = ler_u32(buffer + 8);
+    uint32_t proxima = ler_u32(buffer + 12);
+    uint32_t epoch = ler_u32(buffer + 16);
+    int32_t temperatura = 0, umidade = 0, luminosidade = 0;
+    l.posicao = tamanho_cabecalho;
+
+    printf("sequencia;data;temperatura;umidade;luminosidade;reles\n");
+    uint32_t quantidade = 0;
+    while (l.posicao < l.tamanho) {
+        uint32_t salto, reles;
+        int32_t d_epoch, d_temperatura, d_umidade, d_luminosidade;
+        if (!ler_varint(&l, &salto) || !ler_zigzag(&l, &d_epoch) || !ler_zigzag(&l, &d_temperatura) ||
+            !ler_zigzag(&l, &d_umidade) || !ler_zigzag(&l, &d_luminosidade) || !ler_varint(&l, &reles)) {
+            fprintf(stderr, "registro truncado na posicao %zu\n", l.posicao);
+            return 1;
+        }
+        sequencia += salto;
+        epoch += (uint32_t)d_epoch;
+        temperatura += d_temperatura;
+        umidade += d_umidade;
+        luminosidade += d_luminosidade;
+
+        // Os timestamps já estão no horário do RTC do Pico: formata sem conversão de fuso
+        time_t t = epoch;
+        struct tm data;
+        char texto[32];
+        gmtime_r(&t, &data);
+        strftime(texto, sizeof(texto), "%Y-%m-%d %H:%M:%S", &data);
+        printf("%u;%s;%.1f;%.1f;%.1f;%u\n", sequencia, texto, temperatura / 10.0, umidade / 10.0,
+               luminosidade / 10.0, reles);
+        sequencia++;
+        quantidade++;
+    }
+
+    fprintf(stderr, "%u amostras; proxima coleta: ?since=%u\n", quantidade, proxima);
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * Simulação, no computador, de mais de um ano de amostras passando pelas camadas de consolidação
+ * (inc/camadas.c), com os logs das camadas numa NOR simulada do tamanho das regiões do Pico W
+ * (inc/flash_pico.h). Cada balde guardado é conferido com o mínimo, a média e o máximo calculados
+ * direto das amostras brutas, e a escolha de camada é conferida para consultas típicas. Depois, um
+ * reboot sem descarregar as páginas pendentes: as camadas são montadas de novo e refeitas só com o
+ * fim do histórico, como em restaurar_historico(), e tudo é conferido outra vez. No fim, imprime a
+ * tendência sazonal lida da camada de 1 h. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -I../inc -I../simulador -o simular_camadas simular_camadas.c ../inc/camadas.c \
+ *       ../inc/historico.c ../inc/flash_log.c ../simulador/flash_nor.c -lm
+ *   ./simular_camadas
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "inc/camadas.h"
+#include "inc/flash_pico.h"
+#include "simulador/flash_nor.h"
+
+#define INICIO 1735689600u                 // 2025-01-01 00:00
+#define DIA (24 * 60 * 60)
+#define DIAS 420                           // Mais do que os setores da camada de 1 h guardam: ela dá a volta
+#define PERIODO 60                         // Uma amostra por minuto, como o firmware
+#define FALHA_INICIO (INICIO + 200 * DIA)  // Três dias sem energia
+#define FALHA_FIM (FALHA_INICIO + 3 * DIA + 1234)
+
+#define SETOR 4096
+#define PAGINA 256
+#define POR_SETOR (SETOR / FLASH_LOG_TAMANHO_REGISTRO - 1)
+
+static int falhas;
+static uint8_t memoria_5min[FLASH_CAMADA_5MIN_SETORES * SETOR];
+static uint8_t memoria_1h[FLASH_CAMADA_1H_SETORES * SETOR];
+static flash_nor_t nor_5min;
+static flash_nor_t nor_1h;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-64s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// Referência: agregados exatos de cada balde, calculados das amostras brutas
+typedef struct {
+    int32_t minimo[2], maximo[2];
+    int64_t soma[3];
+    uint32_t amostras;
+} referencia_t;
+
+// Um dia a mais: o que é simulado depois do reboot
+static referencia_t ref_5min[(DIAS + 1) * 24 * 12 + 1];
+static referencia_t ref_1h[(DIAS + 1) * 24 + 1];
+
+static void referenciar(referencia_t *r, const amostra_t *a) {
+    int32_t v[3] = {a->temperatura, a->umidade, a->luminosidade};
+    for (int i = 0; i < 2; i++) {
+        if (r->amostras == 0 || v[i] < r->minimo[i]) r->minimo[i] = v[i];
+        if (r->amostras == 0 || v[i] > r->maximo[i]) r->maximo[i] = v[i];
+    }
+    for (int i = 0; i < 3; i++) r->soma[i] += v[i];
+    r->amostras++;
+}
+
+// Passo de 0,5 dos baldes, com o mesmo arredondamento e os mesmos limites
+static int32_t quantizar(int32_t decimos, int32_t deslocamento) {
+    int32_t v = decimos + deslocamento;
+    v = v < 0 ? 0 : (v + 2) / 5;
+    return (v > 254 ? 254 : v) * 5 - deslocamento;
+}
+
+static int32_t media(int64_t soma, uint32_t n) {
+    return (int32_t)lround((double)soma / n);
+}
+
+// Compara um ponto da camada (já quantizado ou exato) com a referência do seu balde
+static bool confere(const camadas_ponto_t *p, const referencia_t *r, bool quantizado) {
+    int32_t esperado[7] = {
+        r->minimo[0], media(r->soma[0], r->amostras), r->maximo[0],
+        r->minimo[1], media(r->soma[1], r->amostras), r->maximo[1], media(r->soma[2], r->amostras),
+    };
+    int32_t obtido[7] = {p->temperatura[0], p->temperatura[1], p->temperatura[2],
+                         p->umidade[0], p->umidade[1], p->umidade[2], p->luminosidade};
+    for (int i = 0; i < 7; i++) {
+        int32_t e = quantizado ? quantizar(esperado[i], i < 3 ? 400 : 0) : esperado[i];
+        if (e != obtido[i]) {
+            printf("  epoch %u campo %d: %d, esperado %d\n", p->epoch, i, obtido[i], e);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Clima de um curral: estação do ano, ciclo diário e ruído de leitura de 1 décimo
+static amostra_t gerar(uint32_t epoch) {
+    double dia = (epoch - INICIO) / (double)DIA;
+    double hora = fmod(dia, 1.0) * 24;
+    double t = 22 + 7 * cos(2 * M_PI * dia / 365) + 5 * sin(2 * M_PI * (hora - 9) / 24);
+    double u = fmin(100, fmax(5, 65 - 2.5 * (t - 22) + 10 * sin(2 * M_PI * dia / 30)));
+    double l = hora > 6 && hora < 18 ? 90 * sin(M_PI * (hora - 6) / 12) : 0;
+    return (amostra_t){
+        .epoch = epoch,
+        .temperatura = (int16_t)lround(t * 10) + rand() % 3 - 1,
+        .umidade = (int16_t)lround(u * 10) + rand() % 3 - 1,
+        .luminosidade = (int16_t)lround(l * 10),
+    };
+}
+
+// Todo o conteúdo das camadas, conferido com a referência: retenção, cada balde e a lacuna da falha
+static void conferir_camadas(uint32_t agora, const char *quando) {
+    char caso[96];
+    camadas_iterador_t it;
+    camadas_ponto_t p;
+
+    // Camada de 5 min: tudo o que ela guarda, balde a balde (o último ainda está em andamento)
+    uint32_t inicio_5min, inicio_1h;
+    camadas_inicio(CAMADA_5MIN, &inicio_5min);
+    camadas_inicio(CAMADA_1H, &inicio_1h);
+    snprintf(caso, sizeof(caso), "%s: 5 min guarda ao menos 2 semanas", quando);
+    verificar(agora - inicio_5min >= 14 * DIA && agora - inicio_5min < FLASH_CAMADA_5MIN_SETORES * POR_SETOR * CAMADA_5MIN_LARGURA, caso);
+    snprintf(caso, sizeof(caso), "%s: 1 h guarda ao menos 1 ano, e deu a volta", quando);
+    verificar(agora - inicio_1h >= 365 * DIA && inicio_1h > INICIO, caso);
+
+    camadas_iterar(&it, inicio_5min, UINT32_MAX, 0);
+    bool ok = it.camada == CAMADA_5MIN;
+    uint32_t pontos = 0;
+    while (ok && camadas_proximo(&it, &p)) {
+        const referencia_t *r = &ref_5min[(p.epoch - INICIO) / CAMADA_5MIN_LARGURA];
+        bool em_andamento = p.epoch / CAMADA_5MIN_LARGURA == agora / CAMADA_5MIN_LARGURA;
+        ok = confere(&p, r, !em_andamento);
+        pontos++;
+    }
+    snprintf(caso, sizeof(caso), "%s: baldes de 5 min iguais a referencia", quando);
+    verificar(ok && pontos == (agora - inicio_5min) / CAMADA_5MIN_LARGURA + 1, caso);
+
+    // Camada de 1 h: todos os baldes fechados, com a falha de energia como lacuna
+    camadas_iterar(&it, inicio_1h, agora - CAMADA_1H_LARGURA, 0);
+    ok = it.camada == CAMADA_1H;
+    pontos = 0;
+    while (ok && camadas_proximo(&it, &p)) {
+        ok = confere(&p, &ref_1h[(p.epoch - INICIO) / CAMADA_1H_LARGURA], true);
+        pontos++;
+    }
+    uint32_t horas_com_amostras = 0;
+    for (uint32_t epoch = inicio_1h; epoch <= agora - CAMADA_1H_LARGURA; epoch += CAMADA_1H_LARGURA) {
+        horas_com_amostras += ref_1h[(epoch - INICIO) / CAMADA_1H_LARGURA].amostras > 0;
+    }
+    snprintf(caso, sizeof(caso), "%s: baldes de 1 h iguais a referencia", quando);
+    verificar(ok && pontos == horas_com_amostras, caso);
+    camadas_iterar(&it, FALHA_INICIO + CAMADA_1H_LARGURA, FALHA_FIM - CAMADA_1H_LARGURA, 0);
+    snprintf(caso, sizeof(caso), "%s: falha de energia fica como lacuna de 3 dias", quando);
+    verificar(inicio_1h < FALHA_INICIO && it.camada == CAMADA_1H && !camadas_proximo(&it, &p), caso);
+}
+
+int main(void) {
+    flash_nor_iniciar(&nor_5min, memoria_5min, SETOR, PAGINA, FLASH_CAMADA_5MIN_SETORES);
+    flash_nor_iniciar(&nor_1h, memoria_1h, SETOR, PAGINA, FLASH_CAMADA_1H_SETORES);
+    historico_iniciar();
+    verificar(camadas_iniciar(&nor_5min.dispositivo, &nor_1h.dispositivo), "logs das camadas montados na flash apagada");
+    srand(2025);
+
+    camadas_iterador_t it;
+    camadas_ponto_t p;
+    verificar(camadas_escolher(0, UINT32_MAX, 100, &(uint32_t){0}) == CAMADA_BRUTA &&
+              (camadas_iterar(&it, 0, UINT32_MAX, 100), !camadas_proximo(&it, &p)), "sem amostras, consulta vazia");
+
+    uint32_t agora = INICIO;
+    uint32_t amostras = 0;
+    for (uint32_t epoch = INICIO; epoch < INICIO + DIAS * DIA; epoch += PERIODO) {
+        if (epoch >= FALHA_INICIO && epoch < FALHA_FIM) {
+            continue;
+        }
+        amostra_t a = gerar(epoch);
+        historico_adicionar(&a);
+        camadas_adicionar(&a);
+        referenciar(&ref_5min[(epoch - INICIO) / CAMADA_5MIN_LARGURA], &a);
+        referenciar(&ref_1h[(epoch - INICIO) / CAMADA_1H_LARGURA], &a);
+        agora = epoch;
+        amostras++;
+    }
+    printf("%u amostras em %d dias; flash das camadas: %u + %u setores, %lu bytes de RAM\n", amostras, DIAS,
+           FLASH_CAMADA_5MIN_SETORES, FLASH_CAMADA_1H_SETORES, (unsigned long)(2 * sizeof(flash_log_t)));
+
+    conferir_camadas(agora, "continuo");
+
+    camadas_iterar(&it, 0, UINT32_MAX, 0);
+    verificar(it.camada == CAMADA_1H && it.agrupar == 1, "tudo sem orcamento: camada de 1 h");
+
+    // Escolha da camada para consultas típicas
+    uint32_t inicio_1h, agrupar;
+    camadas_inicio(CAMADA_1H, &inicio_1h);
+    verificar(camadas_escolher(agora - 6 * 3600, agora, 500, &agrupar) == CAMADA_BRUTA, "ultimas 6 h em 500 pontos: amostras brutas");
+    verificar(camadas_escolher(agora - 6 * 3600, agora, 100, &agrupar) == CAMADA_5MIN, "ultimas 6 h em 100 pontos: 5 min");
+    verificar(camadas_escolher(agora - 7 * DIA, agora, 3000, &agrupar) == CAMADA_5MIN, "ultima semana em 3000 pontos: 5 min");
+    verificar(camadas_escolher(agora - 7 * DIA, agora, 500, &agrupar) == CAMADA_1H && agrupar == 1, "ultima semana em 500 pontos: 1 h");
+    verificar(camadas_escolher(agora - 30 * DIA, agora, 50, &agrupar) == CAMADA_1H && agrupar == 15, "ultimo mes em 50 pontos: 1 h agrupada");
+    verificar(camadas_escolher(agora - 20 * DIA, agora, 100000, &agrupar) == CAMADA_1H, "20 dias atras: a camada de 5 min nao alcanca");
+
+    // Orçamento: grupos de baldes nunca passam do número de pontos pedido e conferem com a referência
+    // (a hora em andamento fica de fora, por ainda não estar quantizada)
+    camadas_iterar(&it, inicio_1h, agora - CAMADA_1H_LARGURA, 400);
+    uint32_t pontos = 0;
+    bool ok = it.agrupar == (camadas_contar(CAMADA_1H, inicio_1h, agora - CAMADA_1H_LARGURA) + 399) / 400;
+    uint32_t agrupamento = it.agrupar;
+    while (camadas_proximo(&it, &p)) {
+        int32_t minimo = INT32_MAX, maximo = INT32_MIN;
+        for (uint32_t h = 0; h < agrupamento; h++) {
+            uint32_t epoch = p.epoch + h * CAMADA_1H_LARGURA;
+            const referencia_t *r = &ref_1h[(epoch - INICIO) / CAMADA_1H_LARGURA];
+            if (epoch < inicio_1h || epoch > agora - CAMADA_1H_LARGURA || r->amostras == 0) {
+                continue;
+            }
+            if (quantizar(r->minimo[0], 400) < minimo) minimo = quantizar(r->minimo[0], 400);
+            if (quantizar(r->maximo[0], 400) > maximo) maximo = quantizar(r->maximo[0], 400);
+        }
+        ok = ok && (minimo == INT32_MAX || (p.temperatura[0] == minimo && p.temperatura[2] == maximo));
+        pontos++;
+    }
+    printf("  camada de 1 h em 400 pontos: %u pontos de %u h\n", pontos, agrupamento);
+    verificar(ok && pontos <= 400, "camada de 1 h em 400 pontos: grupos com extremos certos");
+
+    // Reboot: a energia cai com páginas ainda na RAM; o histórico volta com as últimas amostras
+    // (no firmware, do log de amostras) e só elas passam de novo pelas camadas
+    static amostra_t ultimas[HISTORICO_CAPACIDADE];
+    uint32_t n = historico_quantidade();
+    for (uint32_t i = 0; i < n; i++) {
+        historico_obter_recente(n - 1 - i, &ultimas[i]);
+    }
+    uint32_t pendentes = camadas_log(CAMADA_5MIN)->pendentes + camadas_log(CAMADA_1H)->pendentes;
+    historico_iniciar();
+    verificar(camadas_iniciar(&nor_5min.dispositivo, &nor_1h.dispositivo), "reboot: logs das camadas montados de novo");
+    for (uint32_t i = 0; i < n; i++) {
+        historico_adicionar(&ultimas[i]);
+        camadas_adicionar(&ultimas[i]);
+    }
+    printf("  reboot: %u baldes perdidos na RAM, %u amostras repassadas\n", pendentes, n);
+    conferir_camadas(agora, "reboot");
+
+    // Mais um dia depois do reboot: os logs seguem de onde estavam
+    for (uint32_t epoch = agora + PERIODO; epoch < agora + DIA; epoch += PERIODO) {
+        amostra_t a = gerar(epoch);
+        historico_adicionar(&a);
+        camadas_adicionar(&a);
+        referenciar(&ref_5min[(epoch - INICIO) / CAMADA_5MIN_LARGURA], &a);
+        referenciar(&ref_1h[(epoch - INICIO) / CAMADA_1H_LARGURA], &a);
+    }
+    agora += DIA - PERIODO;
+    conferir_camadas(agora, "dia seguinte");
+
+    // Tendência sazonal: o ano em 12 pontos
+    printf("\n  %-12s %22s %22s\n", "inicio", "temperatura min/med/max", "umidade min/med/max");
+    camadas_iterar(&it, agora - 365 * DIA, agora, 12);
+    while (camadas_proximo(&it, &p)) {
+        printf("  dia %-8u %6.1f %6.1f %6.1f   %6.1f %6.1f %6.1f\n", (p.epoch - INICIO) / DIA,
+               p.temperatura[0] / 10.0, p.temperatura[1] / 10.0, p.temperatura[2] / 10.0,
+               p.umidade[0] / 10.0, p.umidade[1] / 10.0, p.umidade[2] / 10.0);
+    }
+    printf("\n");
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,455 @@
+/**
+ * Validação, no computador, do programa PIO do DHT11 (dht11.pio) contra formas de onda.
+ * Lê o próprio dht11.pio, executa as instruções num interpretador mínimo do PIO (1 ciclo = 1 us)
+ * e alimenta o pino com trens de pulsos do sensor. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -o simular_dht11_pio simular_dht11_pio.c
+ *   ./simular_dht11_pio ../dht11.pio                 # casos sintéticos
+ *   ./simular_dht11_pio ../dht11.pio captura.txt     # forma de onda gravada
+ *
+ * A captura tem uma linha "nivel duracao_us" por trecho, a partir do instante em que o Pico solta
+ * a linha (por exemplo, exportada de um analisador lógico). Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_INSTRUCOES 32
+#define MAX_ROTULOS 16
+#define MAX_TRECHOS 128
+#define PULSO_INICIO_US 20000       // Mesmo valor de DHT11_PULSO_INICIO_US
+#define PULSO_INICIO_MIN_US 18000   // Menor pulso a que o sensor responde
+#define CICLOS_MAXIMOS 100000       // Sem IRQ até aqui: a máquina ficou parada num 'wait'
+
+// --- PROGRAMA ---
+typedef enum { OP_PULL, OP_PUSH, OP_MOV, OP_SET, OP_JMP, OP_WAIT, OP_IN, OP_IRQ, OP_NOP } operacao_t;
+typedef enum { REG_X, REG_Y, REG_OSR, REG_ISR, REG_NULL, REG_PINDIRS, REG_PINS } registrador_t;
+typedef enum { JMP_SEMPRE, JMP_X_ZERO, JMP_X_DEC, JMP_Y_ZERO, JMP_Y_DEC } condicao_t;
+
+typedef struct {
+    operacao_t op;
+    registrador_t destino;
+    registrador_t origem;
+    condicao_t condicao;
+    char rotulo[24];
+    int alvo;
+    uint32_t valor;         // SET: valor; WAIT: polaridade; IN: bits
+    int atraso;
+} instrucao_t;
+
+typedef struct {
+    instrucao_t instrucoes[MAX_INSTRUCOES];
+    int tamanho;
+    int wrap_target;
+    int wrap;
+    char rotulos[MAX_ROTULOS][24];
+    int posicoes[MAX_ROTULOS];
+    int num_rotulos;
+} programa_t;
+
+static bool falhar(const char *mensagem, const char *linha) {
+    fprintf(stderr, "dht11.pio: %s: %s\n", mensagem, linha);
+    return false;
+}
+
+static registrador_t registrador(const char *nome) {
+    if (!strcmp(nome, "x")) return REG_X;
+    if (!strcmp(nome, "y")) return REG_Y;
+    if (!strcmp(nome, "osr")) return REG_OSR;
+    if (!strcmp(nome, "isr")) return REG_ISR;
+    if (!strcmp(nome, "pindirs")) return REG_PINDIRS;
+    if (!strcmp(nome, "pins")) return REG_PINS;
+    return REG_NULL;
+}
+
+// Interpreta só o subconjunto de instruções que dht11.pio usa
+static bool carregar_programa(const char *caminho, programa_t *p) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        return false;
+    }
+    memset(p, 0, sizeof(*p));
+    p->wrap = -1;
+
+    char linha[256];
+    bool ok = true;
+    while (ok && fgets(linha, sizeof(linha), f)) {
+        if (linha[0] == '%') break;                 // Bloco c-sdk
+        char *comentario = strpbrk(linha, ";");
+        if (comentario) *comentario = '\0';
+
+        char *tokens[8];
+        int n = 0;
+        for (char *t = strtok(linha, " \t\r\n,"); t && n < 8; t = strtok(NULL, " \t\r\n,")) {
+            tokens[n++] = t;
+        }
+        if (n == 0) continue;
+
+        if (!strcmp(tokens[0], ".wrap_target")) { p->wrap_target = p->tamanho; continue; }
+        if (!strcmp(tokens[0], ".wrap")) { p->wrap = p->tamanho - 1; continue; }
+        if (tokens[0][0] == '.') continue;          // .program, .side_set etc.
+        size_t len = strlen(tokens[0]);
+        if (tokens[0][len - 1] == ':') {
+            tokens[0][len - 1] = '\0';
+            snprintf(p->rotulos[p->num_rotulos], 24, "%s", tokens[0]);
+            p->posicoes[p->num_rotulos++] = p->tamanho;
+            continue;
+        }
+        if (p->tamanho == MAX_INSTRUCOES) { ok = falhar("programa maior que 32 instrucoes", tokens[0]); break; }
+
+        instrucao_t *i = &p->instrucoes[p->tamanho++];
+        if (tokens[n - 1][0] == '[') {
+            i->atraso = atoi(tokens[n - 1] + 1);
+            n--;
+        }
+
+        const char *m = tokens[0];
+        if (!strcmp(m, "pull")) i->op = OP_PULL;
+        else if (!strcmp(m, "push")) i->op = OP_PUSH;
+        else if (!strcmp(m, "nop")) i->op = OP_NOP;
+        else if (!strcmp(m, "irq")) i->op = OP_IRQ;
+        else if (!strcmp(m, "mov") && n == 3) {
+            i->op = OP_MOV;
+            i->destino = registrador(tokens[1]);
+            i->origem = registrador(tokens[2]);
+        } else if (!strcmp(m, "set") && n == 3) {
+            i->op = OP_SET;
+            i->destino = registrador(tokens[1]);
+            i->valor = strtoul(tokens[2], NULL, 0);
+        } else if (!strcmp(m, "in") && n == 3 && !strcmp(tokens[1], "pins")) {
+            i->op = OP_IN;
+            i->valor = strtoul(tokens[2], NULL, 0);
+        } else if (!strcmp(m, "wait") && n == 4 && !strcmp(tokens[2], "pin")) {
+            i->op = OP_WAIT;
+            i->valor = strtoul(tokens[1], NULL, 0);
+        } else if (!strcmp(m, "jmp") && (n == 2 || n == 3)) {
+            i->op = OP_JMP;
+            i->condicao = JMP_SEMPRE;
+            if (n == 3) {
+                if (!strcmp(tokens[1], "!x")) i->condicao = JMP_X_ZERO;
+                else if (!strcmp(tokens[1], "x--")) i->condicao = JMP_X_DEC;
+                else if (!strcmp(tokens[1], "!y")) i->condicao = JMP_Y_ZERO;
+                else if (!strcmp(tokens[1], "y--")) i->condicao = JMP_Y_DEC;
+                else ok = falhar("condicao de jmp nao suportada", tokens[1]);
+            }
+            snprintf(i->rotulo, sizeof(i->rotulo), "%s", tokens[n - 1]);
+        } else {
+            ok = falhar("instrucao nao suportada pelo simulador", m);
+        }
+    }
+    fclose(f);
+
+    for (int k = 0; ok && k < p->tamanho; k++) {
+        instrucao_t *i = &p->instrucoes[k];
+        if (i->op != OP_JMP) continue;
+        i->alvo = -1;
+        for (int r = 0; r < p->num_rotulos; r++) {
+            if (!strcmp(p->rotulos[r], i->rotulo)) i->alvo = p->posicoes[r];
+        }
+        if (i->alvo < 0) {
+            if (!isdigit((unsigned char)i->rotulo[0])) ok = falhar("rotulo desconhecido", i->rotulo);
+            else i->alvo = atoi(i->rotulo);
+        }
+    }
+    if (p->wrap < 0) p->wrap = p->tamanho - 1;
+    return ok && p->tamanho > 0;
+}
+
+// --- LINHA DE DADOS ---
+// Trechos que o sensor impõe à linha, contados a partir do instante em que o Pico a solta
+typedef struct {
+    int niveis[MAX_TRECHOS];
+    uint32_t duracoes[MAX_TRECHOS];
+    int quantidade;
+} forma_onda_t;
+
+typedef struct {
+    const forma_onda_t *sensor;   // NULL: sensor ausente
+    bool dirigindo;               // Pico segurando a linha em nível baixo
+    uint64_t inicio_pulso;
+    bool respondendo;
+    uint64_t soltura;
+} linha_t;
+
+static int nivel_linha(const linha_t *l, uint64_t agora) {
+    if (l->dirigindo) return 0;
+    if (!l->respondendo) return 1;                  // Pull-up
+    uint64_t t = agora - l->soltura;
+    for (int k = 0; k < l->sensor->quantidade; k++) {
+        if (t < l->sensor->duracoes[k]) return l->sensor->niveis[k];
+        t -= l->sensor->duracoes[k];
+    }
+    return 1;
+}
+
+static void direcao_pino(linha_t *l, bool saida, uint64_t agora) {
+    if (saida && !l->dirigindo) {
+        l->dirigindo = true;
+        l->respondendo = false;
+        l->inicio_pulso = agora;
+    } else if (!saida && l->dirigindo) {
+        l->dirigindo = false;
+        l->soltura = agora;
+        l->respondendo = l->sensor && agora - l->inicio_pulso >= PULSO_INICIO_MIN_US;
+    }
+}
+
+// --- MÁQUINA DE ESTADOS ---
+typedef struct {
+    const programa_t *programa;
+    int pc;
+    uint32_t x, y, osr, isr;
+    int bits_isr;
+    uint32_t fifo_tx[4], fifo_rx[4];
+    int ocupacao_tx, ocupacao_rx;
+    bool irq;
+    int atraso;
+    uint64_t ciclo;
+} maquina_t;
+
+static void avancar(maquina_t *m) {
+    m->pc = (m->pc == m->programa->wrap) ? m->programa->wrap_target : m->pc + 1;
+}
+
+static void empurrar(maquina_t *m) {
+    if (m->ocupacao_rx < 4) m->fifo_rx[m->ocupacao_rx++] = m->isr;
+    m->isr = 0;
+    m->bits_isr = 0;
+}
+
+// Um ciclo de clock; instruções paradas (pull/wait) não avançam o pc
+static void passo(maquina_t *m, linha_t *l) {
+    if (m->atraso > 0) {
+        m->atraso--;
+        m->ciclo++;
+        return;
+    }
+
+    const instrucao_t *i = &m->programa->instrucoes[m->pc];
+    int pino = nivel_linha(l, m->ciclo);
+    bool executou = true;
+    int proximo = -1;
+
+    switch (i->op) {
+        case OP_PULL:
+            if (m->ocupacao_tx == 0) { executou = false; break; }
+            m->osr = m->fifo_tx[0];
+            memmove(m->fifo_tx, m->fifo_tx + 1, --m->ocupacao_tx * sizeof(uint32_t));
+            break;
+        case OP_PUSH:
+            empurrar(m);
+            break;
+        case OP_MOV: {
+            uint32_t v = i->origem == REG_OSR ? m->osr : i->origem == REG_ISR ? m->isr :
+                         i->origem == REG_X ? m->x : i->origem == REG_Y ? m->y : 0;
+            if (i->destino == REG_X) m->x = v;
+            else if (i->destino == REG_Y) m->y = v;
+            break;
+        }
+        case OP_SET:
+            if (i->destino == REG_X) m->x = i->valor;
+            else if (i->destino == REG_Y) m->y = i->valor;
+            else if (i->destino == REG_PINDIRS) direcao_pino(l, i->valor & 1, m->ciclo);
+            break;
+        case OP_JMP: {
+            bool saltar = true;
+            if (i->condicao == JMP_X_ZERO) saltar = m->x == 0;
+            else if (i->condicao == JMP_Y_ZERO) saltar = m->y == 0;
+            else if (i->condicao == JMP_X_DEC) saltar = m->x-- != 0;
+            else if (i->condicao == JMP_Y_DEC) saltar = m->y-- != 0;
+            if (saltar) proximo = i->alvo;
+            break;
+        }
+        case OP_WAIT:
+            executou = (uint32_t)pino == i->valor;
+            break;
+        case OP_IN:
+            // Deslocamento à esquerda e autopush a 32 bits, como em dht11_program_init()
+            for (uint32_t b = 0; b < i->valor; b++) {
+                m->isr = (m->isr << 1) | (uint32_t)pino;
+                if (++m->bits_isr == 32) empurrar(m);
+            }
+            break;
+        case OP_IRQ:
+            m->irq = true;
+            break;
+        case OP_NOP:
+            break;
+    }
+
+    m->ciclo++;
+    if (!executou) return;
+    m->atraso = i->atraso;
+    if (proximo >= 0) m->pc = proximo;
+    else avancar(m);
+}
+
+// Dispara uma leitura e roda até a IRQ de fim de quadro; false se ela não vier
+static bool ler_quadro(maquina_t *m, linha_t *l, uint32_t palavras[2]) {
+    m->fifo_tx[m->ocupacao_tx++] = PULSO_INICIO_US;
+    m->irq = false;
+    for (uint64_t limite = m->ciclo + CICLOS_MAXIMOS; m->ciclo < limite && !m->irq;) {
+        passo(m, l);
+    }
+    if (!m->irq || m->ocupacao_rx < 2) return false;
+    palavras[0] = m->fifo_rx[0];
+    palavras[1] = m->fifo_rx[1];
+    memmove(m->fifo_rx, m->fifo_rx + 2, (m->ocupacao_rx -= 2) * sizeof(uint32_t));
+    return true;
+}
+
+static void iniciar_maquina(maquina_t *m, const programa_t *p) {
+    memset(m, 0, sizeof(*m));
+    m->programa = p;
+}
+
+// --- FORMAS DE ONDA ---
+static void trecho(forma_onda_t *f, int nivel, uint32_t duracao) {
+    if (f->quantidade < MAX_TRECHOS) {
+        f->niveis[f->quantidade] = nivel;
+        f->duracoes[f->quantidade++] = duracao;
+    }
+}
+
+static uint32_t variar(uint32_t nominal, uint32_t variacao) {
+    return variacao ? nominal - variacao + (uint32_t)(rand() % (2 * variacao + 1)) : nominal;
+}
+
+// Quadro do DHT11 com os tempos do datasheet, opcionalmente com variação aleatória em cada trecho
+static void sintetizar(forma_onda_t *f, const uint8_t bytes[5], bool com_variacao) {
+    f->quantidade = 0;
+    trecho(f, 1, variar(30, com_variacao ? 10 : 0));        // Espera do sensor: 20 a 40 us
+    trecho(f, 0, variar(80, com_variacao ? 5 : 0));
+    trecho(f, 1, variar(80, com_variacao ? 5 : 0));
+    for (int k = 0; k < 40; k++) {
+        bool um = (bytes[k / 8] >> (7 - k % 8)) & 1;
+        trecho(f, 0, variar(50, com_variacao ? 4 : 0));
+        trecho(f, 1, um ? variar(70, com_variacao ? 5 : 0) : variar(27, com_variacao ? 4 : 0));
+    }
+    trecho(f, 0, 50);                                       // Fim do quadro; depois a linha volta ao pull-up
+}
+
+static bool carregar_captura(const char *caminho, forma_onda_t *f) {
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo) {
+        perror(caminho);
+        return false;
+    }
+    f->quantidade = 0;
+    int nivel;
+    unsigned duracao;
+    while (fscanf(arquivo, "%d %u", &nivel, &duracao) == 2) {
+        trecho(f, nivel != 0, duracao);
+    }
+    fclose(arquivo);
+    return f->quantidade > 0;
+}
+
+// --- CASOS ---
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-52s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static bool checksum_ok(const uint32_t palavras[2]) {
+    uint32_t p = palavras[0];
+    return (uint8_t)((p >> 24) + (p >> 16) + (p >> 8) + p) == (uint8_t)palavras[1];
+}
+
+static bool quadro_igual(const uint32_t palavras[2], const uint8_t bytes[5]) {
+    uint32_t esperado = ((uint32_t)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    return palavras[0] == esperado && palavras[1] == bytes[4];
+}
+
+static void montar_bytes(uint8_t bytes[5], uint8_t umidade, uint8_t temperatura, uint8_t temperatura_dec) {
+    bytes[0] = umidade;
+    bytes[1] = 0;
+    bytes[2] = temperatura;
+    bytes[3] = temperatura_dec;
+    bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s dht11.pio [captura.txt]\n", argv[0]);
+        return 2;
+    }
+    programa_t programa;
+    if (!carregar_programa(argv[1], &programa)) {
+        return 2;
+    }
+    printf("%d instrucoes carregadas de %s\n", programa.tamanho, argv[1]);
+
+    maquina_t m;
+    linha_t l;
+    forma_onda_t f;
+    uint32_t palavras[2];
+    uint8_t bytes[5];
+
+    if (argc >= 3) {
+        if (!carregar_captura(argv[2], &f)) return 2;
+        iniciar_maquina(&m, &programa);
+        l = (linha_t){.sensor = &f};
+        bool lido = ler_quadro(&m, &l, palavras);
+        if (!lido) {
+            printf("Captura: quadro incompleto\n");
+        } else {
+            printf("Captura: %02x %02x %02x %02x %02x, checksum %s\n", palavras[0] >> 24, (palavras[0] >> 16) & 0xFF,
+                   (palavras[0] >> 8) & 0xFF, palavras[0] & 0xFF, palavras[1], checksum_ok(palavras) ? "ok" : "invalido");
+        }
+        return lido && checksum_ok(palavras) ? 0 : 1;
+    }
+
+    // Tempos nominais, uma sequência de quadros na mesma máquina (testa o .wrap)
+    const uint8_t valores[][3] = {{55, 24, 0}, {0, 0, 0}, {95, 50, 9}, {255, 255, 255}, {30, 1, 0x81}};
+    iniciar_maquina(&m, &programa);
+    for (size_t k = 0; k < sizeof(valores) / sizeof(valores[0]); k++) {
+        char caso[64];
+        montar_bytes(bytes, valores[k][0], valores[k][1], valores[k][2]);
+        sintetizar(&f, bytes, false);
+        l = (linha_t){.sensor = &f};
+        snprintf(caso, sizeof(caso), "nominal: umidade %u, temperatura %u.%u", valores[k][0], valores[k][1], valores[k][2]);
+        verificar(ler_quadro(&m, &l, palavras) && quadro_igual(palavras, bytes), caso);
+    }
+
+    // Tempos variando dentro da tolerância do sensor
+    srand(1234);
+    bool todos = true;
+    for (int k = 0; k < 500; k++) {
+        montar_bytes(bytes, rand() % 100, rand() % 60, rand() % 10);
+        sintetizar(&f, bytes, true);
+        l = (linha_t){.sensor = &f};
+        todos = todos && ler_quadro(&m, &l, palavras) && quadro_igual(palavras, bytes);
+    }
+    verificar(todos, "500 quadros com variacao nos tempos");
+
+    // Checksum corrompido: o PIO entrega o quadro, a conferência o recusa
+    montar_bytes(bytes, 60, 25, 0);
+    bytes[4] ^= 0x01;
+    sintetizar(&f, bytes, false);
+    l = (linha_t){.sensor = &f};
+    verificar(ler_quadro(&m, &l, palavras) && !checksum_ok(palavras), "checksum corrompido e detectado");
+
+    // Sem sensor: nenhuma IRQ; o driver reinicia a máquina no disparo seguinte
+    l = (linha_t){.sensor = NULL};
+    verificar(!ler_quadro(&m, &l, palavras), "sensor ausente nao gera quadro");
+
+    iniciar_maquina(&m, &programa);
+    montar_bytes(bytes, 70, 31, 0);
+    sintetizar(&f, bytes, false);
+    l = (linha_t){.sensor = &f};
+    uint64_t inicio = m.ciclo;
+    bool lido = ler_quadro(&m, &l, palavras);
+    printf("Duracao de uma leitura: %llu us\n", (unsigned long long)(m.ciclo - inicio));
+    verificar(lido && quadro_igual(palavras, bytes), "leitura depois de reiniciar a maquina");
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
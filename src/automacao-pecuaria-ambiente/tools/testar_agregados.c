@@ -0,0 +1,193 @@
+/**
+ * Testes, no computador, das estatísticas móveis e do ITU (inc/agregados.c), comparando cada
+ * consulta com uma referência ingênua que guarda todas as amostras e percorre a janela inteira.
+ * Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -o testar_agregados testar_agregados.c ../inc/agregados.c -lm
+ *   ./testar_agregados
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "inc/agregados.h"
+
+#define MAX_AMOSTRAS 200000
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// Referência: todas as amostras, na ordem de chegada
+typedef struct {
+    uint32_t instante;
+    int16_t valores[AGREGADOS_GRANDEZAS];
+} amostra_referencia_t;
+
+static amostra_referencia_t referencia[MAX_AMOSTRAS];
+static uint32_t total_referencia;
+
+// Mesma definição de janela do módulo: o balde da última amostra e os 'baldes' anteriores
+static bool resumo_ingenuo(uint32_t largura, uint32_t baldes, int g, agregados_resumo_t *r) {
+    if (total_referencia == 0) {
+        return false;
+    }
+    uint32_t atual = referencia[total_referencia - 1].instante / largura;
+    int64_t soma = 0;
+    *r = (agregados_resumo_t){.minimo = INT16_MAX, .maximo = INT16_MIN};
+    for (uint32_t i = 0; i < total_referencia; i++) {
+        uint32_t s = referencia[i].instante / largura;
+        if (s + baldes < atual) {
+            continue;
+        }
+        int16_t v = referencia[i].valores[g];
+        if (v < r->minimo) r->minimo = v;
+        if (v > r->maximo) r->maximo = v;
+        soma += v;
+        r->amostras++;
+    }
+    if (r->amostras == 0) {
+        return false;
+    }
+    r->media = (int16_t)lround((double)soma / r->amostras);
+    return true;
+}
+
+// Alimenta os dois lados e compara todas as janelas e grandezas; retorna o número de divergências
+static uint32_t alimentar(agregados_t *a, uint32_t instante, int16_t temperatura, int16_t umidade) {
+    agregados_amostra(a, instante, temperatura, umidade);
+    referencia[total_referencia++] = (amostra_referencia_t){
+        .instante = instante, .valores = {temperatura, umidade, agregados_itu(temperatura, umidade)}};
+
+    uint32_t divergencias = 0;
+    for (int j = 0; j < a->quantidade; j++) {
+        for (int g = 0; g < AGREGADOS_GRANDEZAS; g++) {
+            agregados_resumo_t r = {0}, esperado = {0};
+            bool tem = agregados_resumo(a, j, g, &r);
+            bool tem_esperado = resumo_ingenuo(a->janelas[j].largura_s, a->janelas[j].baldes, g, &esperado);
+            if (tem != tem_esperado || (tem && (r.minimo != esperado.minimo || r.maximo != esperado.maximo ||
+                                                r.media != esperado.media || r.amostras != esperado.amostras))) {
+                if (divergencias++ == 0) {
+                    printf("  t=%u janela %d grandeza %d: %d/%d/%d (%u) esperado %d/%d/%d (%u)\n", instante, j, g,
+                           r.minimo, r.maximo, r.media, r.amostras, esperado.minimo, esperado.maximo,
+                           esperado.media, esperado.amostras);
+                }
+            }
+        }
+    }
+    return divergencias;
+}
+
+static void iniciar_janelas_firmware(agregados_t *a) {
+    agregados_iniciar(a);
+    agregados_adicionar_janela(a, 60, 60);        // 1 h
+    agregados_adicionar_janela(a, 5 * 60, 72);    // 6 h
+    agregados_adicionar_janela(a, 20 * 60, 72);   // 24 h
+    total_referencia = 0;
+}
+
+// Passeio aleatório com o período do ciclo de controle e falhas ocasionais de leitura
+static void testar_passeio(void) {
+    static agregados_t a;
+    iniciar_janelas_firmware(&a);
+    srand(7);
+    int16_t t = 250, u = 600;
+    uint32_t instante = 1, divergencias = 0;
+    for (int i = 0; i < 3 * 2880; i++) {   // 3 dias
+        t += rand() % 7 - 3;
+        u += rand() % 11 - 5;
+        u = u < 200 ? 200 : u > 950 ? 950 : u;
+        instante += rand() % 50 == 0 ? 30 * (1 + rand() % 20) : 30;
+        divergencias += alimentar(&a, instante, t, u);
+    }
+    verificar(divergencias == 0, "passeio de 3 dias: igual a referencia em toda consulta");
+}
+
+// Rajadas de amostras no mesmo balde, valores repetidos e lacunas maiores que as janelas
+static void testar_lacunas(void) {
+    static agregados_t a;
+    agregados_iniciar(&a);
+    agregados_adicionar_janela(&a, 10, 5);
+    agregados_adicionar_janela(&a, 7, 1);
+    total_referencia = 0;
+    srand(99);
+    uint32_t instante = 0, divergencias = 0;
+    for (int i = 0; i < 20000; i++) {
+        int sorteio = rand() % 100;
+        instante += sorteio < 60 ? 0 : sorteio < 95 ? 1 + rand() % 12 : 40 + rand() % 200;
+        divergencias += alimentar(&a, instante, (int16_t)(rand() % 5 * 10 - 20), (int16_t)(rand() % 1000));
+    }
+    verificar(divergencias == 0, "rajadas, repetidos e lacunas longas: igual a referencia");
+
+    agregados_amostra(&a, instante + 10000, 333, 444);
+    agregados_resumo_t r;
+    verificar(agregados_resumo(&a, 0, AGREGADO_TEMPERATURA, &r) && r.amostras == 1 && r.minimo == 333 &&
+              r.maximo == 333, "depois de uma lacuna longa, so a amostra nova");
+}
+
+static void testar_limites(void) {
+    static agregados_t a;
+    agregados_iniciar(&a);
+    agregados_resumo_t r;
+    verificar(agregados_adicionar_janela(&a, 0, 10) == -1 && agregados_adicionar_janela(&a, 60, 0) == -1 &&
+              agregados_adicionar_janela(&a, 60, AGREGADOS_BALDES_MAX + 1) == -1, "janelas invalidas recusadas");
+    int j = agregados_adicionar_janela(&a, 60, 60);
+    verificar(!agregados_resumo(&a, j, AGREGADO_ITU, &r), "janela sem amostras nao tem resumo");
+    verificar(!agregados_resumo(&a, 1, AGREGADO_ITU, &r), "janela inexistente nao tem resumo");
+    agregados_amostra(&a, 100, -35, 50);
+    agregados_amostra(&a, 130, -36, 50);
+    verificar(agregados_resumo(&a, j, AGREGADO_TEMPERATURA, &r) && r.media == -36, "media negativa arredondada");
+}
+
+// ITU inteiro contra a fórmula em ponto flutuante, e valores de tabela
+static void testar_itu(void) {
+    verificar(agregados_itu(300, 600) == 798, "ITU de 30,0 C e 60 % = 79,8");
+    verificar(agregados_itu(250, 500) == 718, "ITU de 25,0 C e 50 % = 71,8");
+    int maior_erro = 0;
+    for (int t = -100; t <= 500; t++) {
+        for (int u = 0; u <= 1000; u += 5) {
+            double tc = t / 10.0, ur = u / 10.0;
+            double esperado = (1.8 * tc + 32) - (0.55 - 0.0055 * ur) * (1.8 * tc - 26);
+            int erro = abs(agregados_itu(t, u) - (int)lround(esperado * 10));
+            if (erro > maior_erro) maior_erro = erro;
+        }
+    }
+    verificar(maior_erro <= 1, "ITU inteiro fica a 0,1 da formula em ponto flutuante");
+    verificar(agregados_itu(300, 1200) == agregados_itu(300, 1000), "umidade acima de 100 % e limitada");
+    verificar(!strcmp(agregados_itu_faixa(719), "conforto") && !strcmp(agregados_itu_faixa(720), "leve") &&
+              !strcmp(agregados_itu_faixa(800), "moderado") && !strcmp(agregados_itu_faixa(980), "severo") &&
+              !strcmp(agregados_itu_faixa(981), "perigo"), "faixas de estresse termico");
+}
+
+// Custo por amostra: constante, independente do tamanho das janelas
+static void medir_custo(void) {
+    static agregados_t a;
+    iniciar_janelas_firmware(&a);
+    const int n = 2000000;
+    clock_t inicio = clock();
+    for (int i = 0; i < n; i++) {
+        agregados_amostra(&a, (uint32_t)i * 30, (int16_t)(250 + i % 40), (int16_t)(600 - i % 90));
+    }
+    double ns = (double)(clock() - inicio) / CLOCKS_PER_SEC * 1e9 / n;
+    printf("  %.0f ns por amostra com as 3 janelas do firmware (%zu bytes de estado)\n", ns, sizeof(a));
+}
+
+int main(void) {
+    testar_itu();
+    testar_limites();
+    testar_passeio();
+    testar_lacunas();
+    medir_custo();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
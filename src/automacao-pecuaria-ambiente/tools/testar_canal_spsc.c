@@ -0,0 +1,197 @@
+/**
+ * Testes, no computador, do canal SPSC entre os núcleos (inc/canal_spsc.c). Primeiro os casos de
+ * uma thread (vazio, cheio, contadores dando a volta); depois o estresse: um produtor e um
+ * consumidor em threads separadas trocam milhões de mensagens numeradas por um canal pequeno, como
+ * os retratos do núcleo 1, e o consumidor confere que nenhuma se perdeu, repetiu, trocou de ordem
+ * ou chegou pela metade. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -pthread -I.. -o testar_canal_spsc testar_canal_spsc.c ../inc/canal_spsc.c
+ *   ./testar_canal_spsc
+ *
+ * Com -fsanitize=thread no lugar de -O2, o ThreadSanitizer também confere as ordens de memória.
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "inc/canal_spsc.h"
+
+#define MENSAGENS 4000000
+#define RETRATOS 500000
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// --- UMA THREAD ---
+static void testar_vazio_e_cheio(void) {
+    uint32_t buffer[4];
+    canal_spsc_t canal;
+    canal_spsc_iniciar(&canal, buffer, sizeof(uint32_t), 4);
+
+    uint32_t v = 0;
+    bool certo = !canal_spsc_receber(&canal, &v) && canal_spsc_ocupacao(&canal) == 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        certo = certo && canal_spsc_enviar(&canal, &i);
+    }
+    uint32_t extra = 99;
+    certo = certo && !canal_spsc_enviar(&canal, &extra) && canal.descartados == 1 &&
+            canal_spsc_ocupacao(&canal) == 4;
+    for (uint32_t i = 0; i < 4; i++) {
+        certo = certo && canal_spsc_receber(&canal, &v) && v == i;
+    }
+    certo = certo && !canal_spsc_receber(&canal, &v) && v == 3;
+    verificar(certo, "vazio recusa receber; cheio recusa e conta o descarte");
+}
+
+// Os contadores são de 32 bits e só crescem: a conta cabeca - cauda tem de valer na virada
+static void testar_virada_dos_contadores(void) {
+    uint32_t buffer[8];
+    canal_spsc_t canal;
+    canal_spsc_iniciar(&canal, buffer, sizeof(uint32_t), 8);
+    atomic_store(&canal.cabeca, UINT32_MAX - 5);
+    atomic_store(&canal.cauda, UINT32_MAX - 5);
+
+    bool certo = true;
+    uint32_t proximo = 0, esperado = 0, v;
+    for (int volta = 0; volta < 40; volta++) {
+        // Enche até recusar, esvazia pela metade
+        while (canal_spsc_enviar(&canal, &proximo)) {
+            proximo++;
+        }
+        certo = certo && canal_spsc_ocupacao(&canal) == 8;
+        for (int i = 0; i < 4; i++) {
+            certo = certo && canal_spsc_receber(&canal, &v) && v == esperado++;
+        }
+    }
+    while (canal_spsc_receber(&canal, &v)) {
+        certo = certo && v == esperado++;
+    }
+    verificar(certo && esperado == proximo && atomic_load(&canal.cabeca) < 1000,
+              "contadores passam de UINT32_MAX sem perder a conta");
+}
+
+// --- DUAS THREADS ---
+// Mensagem do tamanho de um retrato de verdade: número de sequência e carga derivada dele, para
+// detectar cópia pela metade
+typedef struct {
+    uint32_t sequencia;
+    uint32_t carga[30];
+    uint32_t soma;
+} retrato_t;
+
+static void preencher(retrato_t *r, uint32_t sequencia) {
+    r->sequencia = sequencia;
+    r->soma = sequencia;
+    for (int i = 0; i < 30; i++) {
+        r->carga[i] = sequencia * 2654435761u + i;
+        r->soma += r->carga[i];
+    }
+}
+
+static bool integro(const retrato_t *r) {
+    uint32_t soma = r->sequencia;
+    for (int i = 0; i < 30; i++) {
+        if (r->carga[i] != r->sequencia * 2654435761u + i) return false;
+        soma += r->carga[i];
+    }
+    return soma == r->soma;
+}
+
+typedef struct {
+    canal_spsc_t canal;
+    uint32_t total;
+    bool retratos;              // Mensagens retrato_t em vez de uint32_t
+    uint32_t recusas;           // Envios recusados por canal cheio (o produtor tenta de novo)
+    uint32_t esperas;           // Recepções sem nada disponível
+    uint32_t perdidas, repetidas, fora_de_ordem, corrompidas;
+} estresse_t;
+
+static void *produtor(void *arg) {
+    estresse_t *e = arg;
+    retrato_t r;
+    for (uint32_t s = 0; s < e->total; s++) {
+        if (e->retratos) {
+            preencher(&r, s);
+        }
+        while (!canal_spsc_enviar(&e->canal, e->retratos ? (const void *)&r : (const void *)&s)) {
+            e->recusas++;
+            if ((e->recusas & 63) == 0) sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumidor(void *arg) {
+    estresse_t *e = arg;
+    uint32_t esperada = 0;
+    retrato_t r;
+    uint32_t s;
+    while (esperada < e->total) {
+        if (!canal_spsc_receber(&e->canal, e->retratos ? (void *)&r : (void *)&s)) {
+            e->esperas++;
+            if ((e->esperas & 63) == 0) sched_yield();
+            continue;
+        }
+        if (e->retratos) {
+            if (!integro(&r)) e->corrompidas++;
+            s = r.sequencia;
+        }
+        if (s < esperada) {
+            e->repetidas++;
+        } else {
+            if (s > esperada) {
+                e->perdidas += s - esperada;
+                e->fora_de_ordem++;
+            }
+            esperada = s + 1;
+        }
+    }
+    return NULL;
+}
+
+static bool estressar(estresse_t *e, void *buffer, uint32_t capacidade) {
+    canal_spsc_iniciar(&e->canal, buffer, e->retratos ? sizeof(retrato_t) : sizeof(uint32_t), capacidade);
+    pthread_t p, c;
+    pthread_create(&c, NULL, consumidor, e);
+    pthread_create(&p, NULL, produtor, e);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+
+    printf("    %u mensagens: %u recusas por canal cheio, %u esperas por canal vazio\n",
+           e->total, e->recusas, e->esperas);
+    uint32_t sobra;
+    bool vazio = !canal_spsc_receber(&e->canal, e->retratos ? (void *)&(retrato_t){0} : (void *)&sobra);
+    return vazio && e->perdidas == 0 && e->repetidas == 0 && e->fora_de_ordem == 0 && e->corrompidas == 0 &&
+           e->canal.descartados == e->recusas;
+}
+
+static void testar_estresse_palavras(void) {
+    static uint32_t buffer[4];
+    estresse_t e = {.total = MENSAGENS};
+    verificar(estressar(&e, buffer, 4), "4 milhoes de palavras num canal de 4: nada perdido ou repetido");
+}
+
+static void testar_estresse_retratos(void) {
+    static retrato_t buffer[8];
+    estresse_t e = {.total = RETRATOS, .retratos = true};
+    verificar(estressar(&e, buffer, 8), "retratos de 128 bytes num canal de 8: em ordem e inteiros");
+}
+
+int main(void) {
+    testar_vazio_e_cheio();
+    testar_virada_dos_contadores();
+    testar_estresse_palavras();
+    testar_estresse_retratos();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
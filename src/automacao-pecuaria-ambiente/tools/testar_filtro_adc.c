@@ -0,0 +1,136 @@
+/**
+ * Validação, no computador, da cadeia de filtros do ADC (inc/filtro_adc.c) com traços sintéticos
+ * ou gravados. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -o testar_filtro_adc testar_filtro_adc.c ../inc/filtro_adc.c
+ *   ./testar_filtro_adc                      # casos sintéticos
+ *   ./testar_filtro_adc traco.txt [canais]   # traço gravado
+ *
+ * O traço tem uma leitura de 12 bits por linha, como o anel do DMA as recebe; com mais de um canal
+ * em round-robin, as leituras vêm intercaladas e só o primeiro canal é filtrado. Cada média fechada
+ * é impressa como "leitura;valor filtrado". Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/filtro_adc.h"
+
+#define TAXA_HZ 1000                 // Mesma taxa de AMOSTRAGEM_ADC_TAXA_HZ com um canal
+#define MAX_TRACO (1u << 20)
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-56s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// Ruído uniforme de +-amplitude LSB em torno do nível
+static uint16_t ruido(int nivel, int amplitude) {
+    int v = nivel + (amplitude ? rand() % (2 * amplitude + 1) - amplitude : 0);
+    return v < 0 ? 0 : v > 4095 ? 4095 : (uint16_t)v;
+}
+
+// Passa 'segundos' de leituras geradas por 'gerar' e devolve o maior desvio do valor filtrado
+// em relação a 'esperado' (escala de 16 bits), depois de 'ignorar' médias de acomodação
+static int rodar(filtro_adc_t *f, double segundos, uint16_t (*gerar)(uint32_t), int esperado, uint32_t ignorar) {
+    int desvio = 0;
+    uint32_t medias = 0;
+    for (uint32_t i = 0; i < (uint32_t)(segundos * TAXA_HZ); i++) {
+        if (filtro_adc_amostra(f, gerar(i)) && ++medias > ignorar) {
+            int d = abs((int)f->valor - esperado);
+            if (d > desvio) desvio = d;
+        }
+    }
+    return desvio;
+}
+
+static uint16_t nivel_com_ruido(uint32_t i) { return ruido(2000, 12); }
+static uint16_t meio_lsb(uint32_t i) { return 1000 + (i & 1); }
+static uint16_t picos_isolados(uint32_t i) { return i % 37 == 0 ? 4095 : i % 53 == 0 ? 0 : ruido(2000, 4); }
+static uint16_t rajada_curta(uint32_t i) { return (i >= 3000 && i < 3800) ? 300 : ruido(2000, 4); }
+static uint16_t degrau(uint32_t i) { return i < 3000 ? 2000 : 800; }
+
+static int filtrar_traco(const char *caminho, uint32_t canais) {
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo) {
+        perror(caminho);
+        return 2;
+    }
+    static uint16_t traco[MAX_TRACO];
+    uint32_t n = 0;
+    unsigned v;
+    while (n < MAX_TRACO && fscanf(arquivo, "%u", &v) == 1) {
+        traco[n++] = (uint16_t)v;
+    }
+    fclose(arquivo);
+
+    filtro_adc_t f;
+    filtro_adc_iniciar(&f);
+    for (uint32_t i = 0; i < n; i += canais) {
+        if (filtro_adc_amostra(&f, traco[i])) {
+            printf("%lu;%u\n", (unsigned long)(i / canais), f.valor);
+        }
+    }
+    fprintf(stderr, "%lu leituras, %lu medias\n", (unsigned long)n, (unsigned long)f.atualizacoes);
+    return f.atualizacoes > 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) {
+        return filtrar_traco(argv[1], argc >= 3 ? (uint32_t)atoi(argv[2]) : 1);
+    }
+    srand(1234);
+    filtro_adc_t f;
+    const int escala = 1 << FILTRO_ADC_DESLOCAMENTO;   // Leitura de 12 bits -> valor de 16 bits
+
+    filtro_adc_iniciar(&f);
+    verificar(f.atualizacoes == 0 && !filtro_adc_amostra(&f, 2000), "sem valor antes da primeira media");
+
+    filtro_adc_iniciar(&f);
+    int d = rodar(&f, 20, nivel_com_ruido, 2000 * escala, 0);
+    printf("  ruido de +-12 LSB: desvio maximo %d (%.2f LSB)\n", d, (double)d / escala);
+    verificar(d <= 2 * escala, "nivel constante com ruido fica em +-2 LSB");
+
+    filtro_adc_iniciar(&f);
+    verificar(rodar(&f, 5, meio_lsb, 1000 * escala + escala / 2, 0) <= 1, "sobreamostragem resolve meio LSB");
+
+    filtro_adc_iniciar(&f);
+    d = rodar(&f, 20, picos_isolados, 2000 * escala, 0);
+    printf("  picos isolados de 0 e 4095: desvio maximo %d (%.2f LSB)\n", d, (double)d / escala);
+    verificar(d <= escala, "picos isolados nao chegam a saida");
+
+    filtro_adc_iniciar(&f);
+    d = rodar(&f, 10, rajada_curta, 2000 * escala, 0);
+    printf("  sombra de 800 ms: desvio maximo %d (%.2f LSB)\n", d, (double)d / escala);
+    verificar(d <= escala, "variacao de 800 ms e rejeitada pela mediana");
+
+    // Um degrau real precisa aparecer na saída depois de meia janela da mediana
+    filtro_adc_iniciar(&f);
+    uint32_t medias_ate_seguir = 0;
+    bool seguiu = false;
+    for (uint32_t i = 0; i < 10 * TAXA_HZ && !seguiu; i++) {
+        if (filtro_adc_amostra(&f, degrau(i)) && i >= 3000) {
+            medias_ate_seguir++;
+            seguiu = f.valor == 800 * escala;
+        }
+    }
+    printf("  degrau: saida acompanhou depois de %lu medias\n", (unsigned long)medias_ate_seguir);
+    verificar(seguiu && medias_ate_seguir <= FILTRO_ADC_MEDIANA / 2 + 2, "degrau real chega a saida");
+
+    // Leituras intercaladas de dois canais, como no anel do DMA em round-robin; as duas primeiras
+    // de cada canal só abastecem a mediana de 3
+    #define INTERCALADAS (2 * (FILTRO_ADC_SOBREAMOSTRAGEM + 2))
+    static uint16_t intercaladas[INTERCALADAS];
+    for (uint32_t i = 0; i < INTERCALADAS; i++) {
+        intercaladas[i] = i % 2 ? 4000 : 1234;
+    }
+    filtro_adc_iniciar(&f);
+    filtro_adc_amostras(&f, intercaladas, INTERCALADAS, 2);
+    verificar(f.atualizacoes == 1 && f.valor == 1234 * escala, "passo separa os canais intercalados");
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
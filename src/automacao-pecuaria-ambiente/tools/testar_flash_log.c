@@ -0,0 +1,376 @@
+/**
+ * Testes, no computador, do log em flash (inc/flash_log.c) sobre a NOR simulada
+ * (simulador/flash_nor.c), com quedas de energia injetadas. Uma carga de anexações (com
+ * descarregamentos avulsos, como os da tarefa periódica) é repetida cortando a energia em cada
+ * uma das operações da flash - cada página gravada, cada cabeçalho e cada apagamento de setor - e
+ * em vários pontos dentro dela: no início, no meio de um registro, na fronteira de um registro,
+ * no fim da página e do setor. Depois de religar, o log é montado de novo e conferido:
+ *   - nenhuma leitura devolve dado errado (registros rasgados são rejeitados pelo CRC);
+ *   - todo registro que já estava gravado antes do corte continua legível, exceto os do setor que
+ *     estava sendo apagado;
+ *   - nenhuma sequência é reutilizada, e o log continua anexando e sobrevive a nova montagem.
+ * Também cobre operações recusadas pela flash (flash_safe_execute() que expira), o arquivo que
+ * guarda a flash entre execuções, os saltos de sequência (flash_log_avancar(), usado pelas camadas)
+ * e logs de tipos diferentes em regiões da mesma flash. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -I../inc -I../simulador -o testar_flash_log testar_flash_log.c ../inc/flash_log.c \
+ *       ../simulador/flash_nor.c
+ *   ./testar_flash_log
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "inc/flash_log.h"
+#include "simulador/flash_nor.h"
+
+// Flash pequena para que a carga dê várias voltas: 4 setores de 1 KiB, páginas de 256 bytes,
+// ou seja, 63 registros por setor (o slot 0 é o cabeçalho) e 16 por página
+#define SETOR 1024
+#define PAGINA 256
+#define SETORES 4
+#define POR_SETOR (SETOR / FLASH_LOG_TAMANHO_REGISTRO - 1)
+
+#define CARGA 600
+#define DESCARREGAR_A_CADA 7
+#define CARGA_APOS_CORTE 200
+
+static int falhas;
+static uint8_t memoria[SETOR * SETORES];
+static flash_nor_t nor;
+static flash_log_t log_flash;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// Amostra que a sequência 's' deve ter: qualquer leitura pode ser conferida sem guardar nada
+static amostra_t amostra_da_sequencia(uint32_t s) {
+    return (amostra_t){
+        .epoch = 1700000000u + 60 * s,
+        .temperatura = (int16_t)(s % 500) - 100,
+        .umidade = (int16_t)(1000 - s % 900),
+        .luminosidade = (int16_t)(s % 1001),
+        .reles = (uint16_t)(s & 7),
+    };
+}
+
+static bool confere(uint32_t s, const amostra_t *a) {
+    amostra_t e = amostra_da_sequencia(s);
+    return a->epoch == e.epoch && a->temperatura == e.temperatura && a->umidade == e.umidade &&
+           a->luminosidade == e.luminosidade && a->reles == e.reles;
+}
+
+// Anexa 'n' amostras, descarregando de tempos em tempos, até acabar ou a energia cair. Retorna a
+// sequência até a qual (exclusive) tudo está comprovadamente na flash.
+static uint32_t carga(uint32_t n, uint32_t duraveis) {
+    for (uint32_t i = 0; i < n && !nor.desligada; i++) {
+        amostra_t a = amostra_da_sequencia(flash_log_proxima_sequencia(&log_flash));
+        flash_log_anexar(&log_flash, &a);
+        if (i % DESCARREGAR_A_CADA == DESCARREGAR_A_CADA - 1) {
+            flash_log_descarregar(&log_flash);
+        }
+        if (!nor.desligada) {
+            duraveis = flash_log_proxima_sequencia(&log_flash) - log_flash.pendentes;
+        }
+    }
+    return duraveis;
+}
+
+// Nenhuma leitura com dado errado; conta as legíveis
+static bool leituras_corretas(uint32_t *legiveis) {
+    *legiveis = 0;
+    amostra_t a;
+    uint32_t fim = flash_log_proxima_sequencia(&log_flash);
+    for (uint32_t s = flash_log_primeira_sequencia(&log_flash); s < fim; s++) {
+        if (flash_log_ler(&log_flash, s, &a)) {
+            if (!confere(s, &a)) {
+                printf("    sequencia %u com dado errado\n", s);
+                return false;
+            }
+            (*legiveis)++;
+        }
+    }
+    return !flash_log_ler(&log_flash, fim, &a);
+}
+
+// Toda sequência de [de, ate) ainda guardada é legível e correta
+static bool legiveis_de(uint32_t de, uint32_t ate) {
+    uint32_t primeira = flash_log_primeira_sequencia(&log_flash);
+    amostra_t a;
+    for (uint32_t s = de > primeira ? de : primeira; s < ate; s++) {
+        if (!flash_log_ler(&log_flash, s, &a) || !confere(s, &a)) {
+            printf("    sequencia %u perdida\n", s);
+            return false;
+        }
+    }
+    return true;
+}
+
+// As sequências duráveis que ainda deveriam estar guardadas são legíveis. Só um setor (o que
+// estava sendo apagado) pode ter sido perdido: ficam ao menos SETORES - 1 setores cheios.
+static bool duraveis_preservados(uint32_t duraveis) {
+    uint32_t primeira = flash_log_primeira_sequencia(&log_flash);
+    uint32_t minimo = duraveis < (SETORES - 1) * POR_SETOR ? duraveis : (SETORES - 1) * POR_SETOR;
+    if (flash_log_proxima_sequencia(&log_flash) < duraveis || (primeira < duraveis && duraveis - primeira < minimo) ||
+        (primeira >= duraveis && minimo > 0)) {
+        printf("    log com %u..%u, duraveis ate %u\n", primeira, flash_log_proxima_sequencia(&log_flash), duraveis);
+        return false;
+    }
+    return legiveis_de(0, duraveis);
+}
+
+// Um cenário: carga do zero com a energia caindo na operação 'operacao', depois de 'bytes' bytes
+typedef struct {
+    bool ok;
+    bool houve_corte;
+    uint32_t rejeitados;        // Registros rasgados rejeitados na remontagem
+} cenario_t;
+
+static cenario_t cortar_em(uint32_t operacao, uint32_t bytes) {
+    cenario_t c = {.ok = true};
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_nor_cortar(&nor, operacao, bytes);
+    uint32_t duraveis = 0;
+    if (flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS)) {
+        duraveis = carga(CARGA, 0);
+    }
+    c.houve_corte = nor.desligada;
+
+    // Religa e monta a partir do que ficou
+    flash_nor_religar(&nor);
+    uint32_t legiveis;
+    c.ok = flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS) && leituras_corretas(&legiveis) &&
+           duraveis_preservados(duraveis);
+    c.rejeitados = log_flash.registros_corrompidos;
+    uint32_t proxima_corte = flash_log_proxima_sequencia(&log_flash);
+
+    // O log continua de onde parou, sem reutilizar sequências, e sobrevive a outra montagem
+    if (c.ok) {
+        carga(CARGA_APOS_CORTE, 0);
+    }
+    // Só os registros rasgados, de 'duraveis' a 'proxima_corte', podem faltar
+    uint32_t fim = proxima_corte + CARGA_APOS_CORTE;
+    c.ok = c.ok && flash_log_descarregar(&log_flash) && flash_log_proxima_sequencia(&log_flash) == fim;
+    c.ok = c.ok && flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS) && leituras_corretas(&legiveis) &&
+           flash_log_proxima_sequencia(&log_flash) == fim && legiveis_de(0, duraveis) &&
+           legiveis_de(proxima_corte, fim) && fim - flash_log_primeira_sequencia(&log_flash) >= (SETORES - 1) * POR_SETOR;
+    return c;
+}
+
+static void testar_cortes(void) {
+    // Quantas operações a carga faz sem falhas
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    carga(CARGA, 0);
+    uint32_t operacoes = nor.operacoes;
+
+    // Pontos de corte dentro da operação: nada, meio byte, dentro do cabeçalho ou do registro,
+    // fronteiras de registro, meio e fim da página, meio e fim do setor
+    static const uint32_t pontos[] = {0, 1, 8, 15, 16, 17, 31, 32, 128, 255, 256, 512, 1023, 1024};
+    const int num_pontos = sizeof(pontos) / sizeof(pontos[0]);
+
+    int cenarios = 0, com_rejeicao = 0;
+    bool certo = true;
+    for (uint32_t op = 0; op <= operacoes && certo; op++) {
+        for (int p = 0; p < num_pontos && certo; p++) {
+            cenario_t c = cortar_em(op, pontos[p]);
+            if (!c.ok) {
+                printf("    corte na operacao %u apos %u bytes\n", op, pontos[p]);
+            }
+            certo = c.ok && (c.houve_corte || op == operacoes);
+            cenarios++;
+            com_rejeicao += c.rejeitados > 0;
+        }
+    }
+    printf("    %u operacoes por carga, %d cenarios, %d com registros rasgados rejeitados\n", operacoes, cenarios,
+           com_rejeicao);
+    verificar(certo && com_rejeicao > 0, "corte em cada operacao: recupera sem dado errado nem perda");
+}
+
+static void testar_crc(void) {
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    carga(40, 0);
+    flash_log_descarregar(&log_flash);
+
+    // Um bit trocado no registro da sequência 5 (slot 6 do setor 0) e outro no cabeçalho
+    memoria[6 * FLASH_LOG_TAMANHO_REGISTRO + 2] ^= 0x04;
+    amostra_t a;
+    bool certo = !flash_log_ler(&log_flash, 5, &a) && log_flash.registros_corrompidos == 1 &&
+                 flash_log_ler(&log_flash, 4, &a) && confere(4, &a) && flash_log_ler(&log_flash, 6, &a);
+    verificar(certo, "bit trocado num registro: so ele e rejeitado");
+
+    memoria[4] ^= 0x01;
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    verificar(!flash_log_ler(&log_flash, 4, &a) && flash_log_primeira_sequencia(&log_flash) == 0 &&
+              flash_log_proxima_sequencia(&log_flash) == 0,
+              "cabecalho corrompido: o setor nao e montado");
+}
+
+// Operações recusadas (sem efeito) não podem levar o log a gravar fora do lugar nem deixar buracos
+static void testar_recusas(void) {
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    // Duas voltas e o setor atual cheio: o próximo setor, o mais antigo, ainda tem registros
+    carga(SETORES * POR_SETOR * 2 + POR_SETOR, 0);
+    flash_log_descarregar(&log_flash);
+    uint32_t proxima = flash_log_proxima_sequencia(&log_flash);
+    uint32_t proximo_setor = (log_flash.setor_atual + 1) % SETORES;
+    uint8_t antes[SETORES * SETOR];
+    memcpy(antes, memoria, sizeof(antes));
+
+    // Apagamento recusado: a amostra é recusada e nada muda na flash
+    flash_nor_recusar(&nor, 0, 1);
+    amostra_t a = amostra_da_sequencia(proxima);
+    uint32_t legiveis;
+    bool recusada = log_flash.slot_atual == log_flash.registros_por_setor && !flash_log_anexar(&log_flash, &a) &&
+                    log_flash.falhas == 1 && flash_log_proxima_sequencia(&log_flash) == proxima &&
+                    memcmp(antes, memoria, sizeof(antes)) == 0;
+    verificar(recusada && leituras_corretas(&legiveis) &&
+              legiveis == proxima - flash_log_primeira_sequencia(&log_flash),
+              "apagamento recusado: amostra recusada, flash intacta");
+
+    // Cabeçalho recusado depois do apagamento: de novo recusada, e nada gravado fora do setor
+    flash_nor_recusar(&nor, 1, 1);
+    bool cabecalho = !flash_log_anexar(&log_flash, &a) && log_flash.falhas == 2 &&
+                     memcmp(antes, memoria, proximo_setor * SETOR) == 0 &&
+                     memcmp(antes + (proximo_setor + 1) * SETOR, memoria + (proximo_setor + 1) * SETOR,
+                            (SETORES - proximo_setor - 1) * SETOR) == 0;
+    verificar(cabecalho && leituras_corretas(&legiveis), "cabecalho recusado: nada gravado fora do setor");
+
+    // Na anexação seguinte a abertura é tentada de novo, e o log segue
+    bool segue = flash_log_anexar(&log_flash, &a) && flash_log_descarregar(&log_flash) &&
+                 log_flash.setor_atual == proximo_setor && flash_log_ler(&log_flash, proxima, &a) && confere(proxima, &a);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    verificar(segue && flash_log_proxima_sequencia(&log_flash) == proxima + 1 && leituras_corretas(&legiveis),
+              "abertura tentada de novo na anexacao seguinte");
+
+    // Página cheia recusada três vezes: ela fica na RAM, as amostras seguintes são recusadas até
+    // ela ser gravada, e a montagem não encontra buraco
+    flash_nor_recusar(&nor, 0, 3);
+    uint32_t operacoes = nor.operacoes;
+    uint32_t aceitas = 0, recusadas = 0;
+    while (nor.operacoes < operacoes + 4) {
+        uint32_t s = flash_log_proxima_sequencia(&log_flash);
+        a = amostra_da_sequencia(s);
+        if (flash_log_anexar(&log_flash, &a)) {
+            aceitas++;
+        } else {
+            recusadas++;
+        }
+    }
+    // A quarta operação grava a página, e a amostra daquela anexação já vai para a seguinte
+    bool pendente = recusadas == 2 && log_flash.pendentes == 1 && log_flash.falhas == 3;
+    uint32_t fim = flash_log_proxima_sequencia(&log_flash);
+    flash_log_descarregar(&log_flash);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    verificar(pendente && flash_log_proxima_sequencia(&log_flash) == fim && fim == proxima + 1 + aceitas &&
+              leituras_corretas(&legiveis) && duraveis_preservados(fim),
+              "pagina recusada: tentada de novo, sem buraco nem sequencia repetida");
+}
+
+// A flash espelhada num arquivo sobrevive ao fim do processo
+static void testar_arquivo(void) {
+    char caminho[] = "/tmp/testar_flash_log_XXXXXX";
+    int fd = mkstemp(caminho);
+    if (fd < 0) {
+        verificar(false, "arquivo temporario");
+        return;
+    }
+    close(fd);
+
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    bool certo = flash_nor_abrir_arquivo(&nor, caminho) && flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    flash_nor_cortar(&nor, 30, 100);
+    uint32_t duraveis = carga(CARGA, 0);
+    close(nor.arquivo);
+
+    memset(memoria, 0, sizeof(memoria));
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    uint32_t legiveis;
+    certo = certo && flash_nor_abrir_arquivo(&nor, caminho) && flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS) &&
+            leituras_corretas(&legiveis) && duraveis_preservados(duraveis) && duraveis > 0;
+    close(nor.arquivo);
+    unlink(caminho);
+    verificar(certo, "arquivo da flash: corte numa execucao, recuperacao na seguinte");
+}
+
+// Saltos de sequência: registros vazios dentro do setor, setor novo quando não cabem
+static void testar_avancar(void) {
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    amostra_t a = amostra_da_sequencia(1000);
+    bool certo = flash_log_avancar(&log_flash, 1000) && flash_log_anexar(&log_flash, &a) &&
+                 flash_log_primeira_sequencia(&log_flash) == 1000 && log_flash.setor_atual == 0;
+    verificar(certo, "log vazio: recomeca o setor na sequencia pedida");
+
+    a = amostra_da_sequencia(1005);
+    certo = flash_log_avancar(&log_flash, 1005) && flash_log_anexar(&log_flash, &a) && log_flash.slot_atual == 7;
+    for (uint32_t s = 1001; s < 1005; s++) {
+        certo = certo && !flash_log_ler(&log_flash, s, &a);
+    }
+    certo = certo && flash_log_ler(&log_flash, 1005, &a) && confere(1005, &a) && log_flash.registros_corrompidos == 0;
+    verificar(certo, "salto dentro do setor: registros vazios, nao corrompidos");
+
+    uint32_t longe = 1006 + POR_SETOR;
+    a = amostra_da_sequencia(longe);
+    certo = flash_log_avancar(&log_flash, longe) && flash_log_anexar(&log_flash, &a) && log_flash.setor_atual == 1 &&
+            !flash_log_avancar(&log_flash, longe) && flash_log_descarregar(&log_flash);
+    flash_log_montar(&log_flash, &nor.dispositivo, FLASH_LOG_AMOSTRAS);
+    uint32_t legiveis;
+    certo = certo && flash_log_primeira_sequencia(&log_flash) == 1000 && flash_log_proxima_sequencia(&log_flash) == longe + 1 &&
+            leituras_corretas(&legiveis) && legiveis == 3 && log_flash.registros_corrompidos == 0;
+    verificar(certo, "salto maior que o setor: setor novo, sobrevive a montagem");
+}
+
+// Logs de tipos diferentes em regiões da mesma flash não se misturam
+static void testar_regioes(void) {
+    static flash_log_t outro;
+    flash_regiao_t regioes[2];
+    flash_nor_iniciar(&nor, memoria, SETOR, PAGINA, SETORES);
+    flash_dispositivo_t *amostras = flash_regiao_iniciar(&regioes[0], &nor.dispositivo, 0, SETORES / 2);
+    flash_dispositivo_t *baldes = flash_regiao_iniciar(&regioes[1], &nor.dispositivo, SETORES / 2, SETORES / 2);
+
+    const uint32_t tipo_baldes = 0x4C414248u;
+    flash_log_montar(&log_flash, amostras, FLASH_LOG_AMOSTRAS);
+    flash_log_montar(&outro, baldes, tipo_baldes);
+    uint8_t dados[FLASH_LOG_TAMANHO_DADOS] = {1, 2, 3};
+    for (uint32_t s = 0; s < POR_SETOR + 10; s++) {
+        amostra_t a = amostra_da_sequencia(s);
+        flash_log_anexar(&log_flash, &a);
+        flash_log_anexar_dados(&outro, dados);
+    }
+    flash_log_descarregar(&log_flash);
+    flash_log_descarregar(&outro);
+
+    uint32_t legiveis;
+    uint8_t lidos[FLASH_LOG_TAMANHO_DADOS];
+    bool certo = flash_log_montar(&log_flash, amostras, FLASH_LOG_AMOSTRAS) && leituras_corretas(&legiveis) &&
+                 legiveis == POR_SETOR + 10 && flash_log_montar(&outro, baldes, tipo_baldes) &&
+                 flash_log_proxima_sequencia(&outro) == POR_SETOR + 10 && flash_log_ler_dados(&outro, POR_SETOR, lidos) &&
+                 memcmp(lidos, dados, sizeof(dados)) == 0;
+    verificar(certo, "duas regioes da mesma flash: cada log no seu lugar");
+
+    flash_log_montar(&outro, amostras, tipo_baldes);
+    verificar(flash_log_proxima_sequencia(&outro) == 0 && !flash_log_ler_dados(&outro, 0, lidos),
+              "tipo diferente: setores de outro log nao sao montados");
+}
+
+int main(void) {
+    testar_cortes();
+    testar_crc();
+    testar_recusas();
+    testar_arquivo();
+    testar_avancar();
+    testar_regioes();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * Testes, no computador, do gráfico de tendência do OLED (inc/oled_grafico.c): os quadros são
+ * comparados com imagens de referência em arte ASCII ('#' aceso, '.' apagado) e, para sequências
+ * longas, com um desenho do zero, pixel a pixel. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -o testar_grafico_oled testar_grafico_oled.c ../inc/oled_grafico.c
+ *   ./testar_grafico_oled
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/oled_grafico.h"
+
+#define LARGURA 16
+#define PAGINAS 6
+
+static int falhas;
+static uint8_t memoria[LARGURA * PAGINAS];
+static const oled_quadro_t quadro = {memoria, LARGURA, PAGINAS};
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static bool pixel(int x, int y) {
+    return memoria[(y / 8) * LARGURA + x] & (1u << (y % 8));
+}
+
+// Compara o retângulo com canto em (x, y) com a imagem de referência, uma linha por '\n'.
+// Na diferença, mostra as duas lado a lado.
+static bool imagem(int x, int y, const char *referencia) {
+    bool igual = true;
+    int linhas = 0;
+    for (const char *p = referencia; *p; linhas++) {
+        const char *fim = strchr(p, '\n');
+        int largura = fim ? (int)(fim - p) : (int)strlen(p);
+        for (int i = 0; i < largura; i++) {
+            if (pixel(x + i, y + linhas) != (p[i] == '#')) igual = false;
+        }
+        p += largura + (fim ? 1 : 0);
+    }
+    if (!igual) {
+        const char *p = referencia;
+        for (int l = 0; l < linhas; l++) {
+            const char *fim = strchr(p, '\n');
+            int largura = fim ? (int)(fim - p) : (int)strlen(p);
+            printf("    %.*s   ", largura, p);
+            for (int i = 0; i < largura; i++) putchar(pixel(x + i, y + l) ? '#' : '.');
+            putchar('\n');
+            p += largura + (fim ? 1 : 0);
+        }
+    }
+    return igual;
+}
+
+// Gráfico de 8 colunas na página 1, de 0 a 70: cada 10 unidades é uma linha. O resto do quadro
+// fica aceso, para mostrar que nada fora da faixa é tocado.
+static void preparar(oled_grafico_t *g) {
+    memset(memoria, 0xFF, sizeof(memoria));
+    oled_grafico_iniciar(g, 4, 1, 8, 1, 0, 70);
+    oled_grafico_limpar(&quadro, g);
+}
+
+static void testar_primeira_amostra(void) {
+    oled_grafico_t g;
+    preparar(&g);
+    oled_grafico_adicionar(&quadro, &g, 30);
+    verificar(imagem(3, 7,
+                     "##########\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#.......##\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "##########"),
+              "primeira amostra: um ponto na ultima coluna, vizinhanca intacta");
+}
+
+static void testar_subida(void) {
+    oled_grafico_t g;
+    preparar(&g);
+    for (int v = 0; v <= 70; v += 10) {
+        oled_grafico_adicionar(&quadro, &g, v);
+    }
+    verificar(imagem(4, 8,
+                     ".......#\n"
+                     "......##\n"
+                     ".....##.\n"
+                     "....##..\n"
+                     "...##...\n"
+                     "..##....\n"
+                     ".##.....\n"
+                     "##......"),
+              "subida: cada coluna liga a amostra anterior a nova");
+}
+
+static void testar_salto_e_bordas(void) {
+    oled_grafico_t g;
+    preparar(&g);
+    oled_grafico_adicionar(&quadro, &g, 40);
+    oled_grafico_adicionar(&quadro, &g, -500);     // Abaixo da escala: linha de baixo
+    oled_grafico_adicionar(&quadro, &g, 9999);     // Acima: linha de cima
+    oled_grafico_adicionar(&quadro, &g, 64);       // Arredondado para 60
+    oled_grafico_adicionar(&quadro, &g, 66);       // E para 70
+    verificar(imagem(4, 8,
+                     ".....###\n"
+                     ".....###\n"
+                     ".....#..\n"
+                     "...###..\n"
+                     "....##..\n"
+                     "....##..\n"
+                     "....##..\n"
+                     "....##.."),
+              "fora da escala vai para a borda; salto vira traco vertical");
+}
+
+static void testar_rolagem(void) {
+    oled_grafico_t g;
+    preparar(&g);
+    const int valores[] = {70, 70, 0, 0, 0, 0, 0, 0, 0, 0, 20};
+    for (int i = 0; i < (int)(sizeof(valores) / sizeof(valores[0])); i++) {
+        oled_grafico_adicionar(&quadro, &g, valores[i]);
+    }
+    verificar(imagem(3, 8,
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#........#\n"
+                     "#.......##\n"
+                     "#.......##\n"
+                     "##########"),
+              "as amostras mais antigas saem pela esquerda, sem puxar as vizinhas");
+
+    oled_grafico_limpar(&quadro, &g);
+    oled_grafico_adicionar(&quadro, &g, 0);
+    verificar(imagem(4, 8,
+                     "........\n"
+                     "........\n"
+                     "........\n"
+                     "........\n"
+                     "........\n"
+                     "........\n"
+                     "........\n"
+                     ".......#"),
+              "limpar apaga a faixa e recomeca sem ligar a amostra antiga");
+}
+
+// Referência: o gráfico das últimas 'largura' amostras desenhado do zero, pixel a pixel
+static bool comparar_com_referencia(const oled_grafico_t *g, const int32_t *valores, int n) {
+    int altura = 8 * g->paginas;
+    for (int c = 0; c < g->largura; c++) {
+        int i = n - g->largura + c;
+        for (int l = 0; l < altura; l++) {
+            bool esperado = false;
+            if (i >= 0) {
+                int32_t faixa = g->maximo - g->minimo;
+                int linha_i, linha_anterior;
+                for (int k = 0; k < 2; k++) {
+                    int j = k == 0 ? i : (i > 0 ? i - 1 : i);
+                    int32_t v = valores[j] < g->minimo ? g->minimo : valores[j] > g->maximo ? g->maximo : valores[j];
+                    int linha = altura - 1 - (int)(((v - g->minimo) * (int64_t)(altura - 1) + faixa / 2) / faixa);
+                    if (k == 0) linha_i = linha; else linha_anterior = linha;
+                }
+                int de = linha_i < linha_anterior ? linha_i : linha_anterior;
+                int ate = linha_i < linha_anterior ? linha_anterior : linha_i;
+                esperado = l >= de && l <= ate;
+            }
+            if (pixel(g->x + c, g->pagina * 8 + l) != esperado) return false;
+        }
+    }
+    return true;
+}
+
+static void testar_sequencias_longas(void) {
+    bool iguais = true;
+    srand(1);
+    for (int paginas = 1; paginas <= OLED_GRAFICO_PAGINAS_MAX && iguais; paginas++) {
+        oled_grafico_t g;
+        memset(memoria, 0, sizeof(memoria));
+        oled_grafico_iniciar(&g, 1, 1, 13, paginas, -100, 350);
+        int32_t valores[300];
+        for (int n = 0; n < 300 && iguais; n++) {
+            valores[n] = -150 + rand() % 550;
+            oled_grafico_adicionar(&quadro, &g, valores[n]);
+            iguais = comparar_com_referencia(&g, valores, n + 1);
+        }
+    }
+    verificar(iguais, "incremental igual ao desenho do zero, 1 a 4 paginas");
+}
+
+int main(void) {
+    testar_primeira_amostra();
+    testar_subida();
+    testar_salto_e_bordas();
+    testar_rolagem();
+    testar_sequencias_longas();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
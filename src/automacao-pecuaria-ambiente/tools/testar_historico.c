@@ -0,0 +1,204 @@
+/**
+ * Testes, no computador, do histórico em buffer circular (inc/historico.c): enchimento além da
+ * capacidade, amostras mais antiga e mais nova, consultas por intervalo atravessando o ponto em
+ * que o buffer dá a volta (comparadas com uma referência que guarda tudo) e consultas vazias ou
+ * fora da faixa. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -o testar_historico testar_historico.c ../inc/historico.c
+ *   ./testar_historico
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/historico.h"
+
+#define TOTAL (3 * HISTORICO_CAPACIDADE + 300)
+#define EPOCH_BASE 1700000000u
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// Referência: todas as amostras já inseridas, por sequência
+static amostra_t todas[TOTAL];
+
+static amostra_t amostra_numero(uint32_t n) {
+    // De minuto em minuto, com alguns saltos (falta de energia) e repetições do mesmo segundo
+    static uint32_t epoch = EPOCH_BASE;
+    if (n > 0) epoch += n % 97 == 0 ? 3600 : n % 31 == 0 ? 0 : 60;
+    return (amostra_t){
+        .epoch = epoch,
+        .temperatura = (int16_t)(250 + n % 50),
+        .umidade = (int16_t)(600 - n % 40),
+        .luminosidade = (int16_t)(n % 1000),
+        .reles = (uint16_t)(n & 7),
+    };
+}
+
+static bool mesma(const amostra_t *a, const amostra_t *b) {
+    return a->epoch == b->epoch && a->temperatura == b->temperatura && a->umidade == b->umidade &&
+           a->luminosidade == b->luminosidade && a->reles == b->reles;
+}
+
+// Confere o iterador contra a referência: as amostras guardadas com epoch em [de, ate], em ordem
+static bool intervalo_igual(uint32_t de, uint32_t ate, uint32_t inseridas) {
+    historico_iterador_t it;
+    historico_iterar_intervalo(&it, de, ate);
+    uint32_t primeira = inseridas > HISTORICO_CAPACIDADE ? inseridas - HISTORICO_CAPACIDADE : 0;
+    amostra_t a;
+    for (uint32_t s = primeira; s < inseridas; s++) {
+        if (todas[s].epoch < de || todas[s].epoch > ate) continue;
+        if (!historico_proximo(&it, &a) || !mesma(&a, &todas[s])) {
+            printf("    [%u, %u]: amostra %u divergente ou ausente\n", de, ate, s);
+            return false;
+        }
+    }
+    if (historico_proximo(&it, &a)) {
+        printf("    [%u, %u]: amostra a mais (epoch %u)\n", de, ate, a.epoch);
+        return false;
+    }
+    return true;
+}
+
+static void testar_vazio(void) {
+    historico_iniciar();
+    historico_iterador_t it;
+    amostra_t a;
+    bool certo = historico_quantidade() == 0 && !historico_obter(0, &a) && !historico_obter_recente(0, &a) &&
+                 historico_buscar_epoch(EPOCH_BASE) == historico_proxima_sequencia();
+    historico_iterar_tudo(&it);
+    certo = certo && !historico_proximo(&it, &a);
+    historico_iterar_intervalo(&it, 0, UINT32_MAX);
+    verificar(certo && !historico_proximo(&it, &a), "historico vazio: nada a obter nem a iterar");
+}
+
+static void testar_enchimento(void) {
+    historico_iniciar();
+    bool certo = true;
+    for (uint32_t n = 0; n < TOTAL; n++) {
+        todas[n] = amostra_numero(n);
+        certo = certo && historico_adicionar(&todas[n]) == n;
+        uint32_t esperada = n + 1 < HISTORICO_CAPACIDADE ? n + 1 : HISTORICO_CAPACIDADE;
+        certo = certo && historico_quantidade() == esperada;
+    }
+    verificar(certo, "sequencias crescentes e quantidade limitada a capacidade");
+
+    amostra_t a;
+    uint32_t primeira = TOTAL - HISTORICO_CAPACIDADE;
+    certo = historico_primeira_sequencia() == primeira && historico_proxima_sequencia() == TOTAL &&
+            historico_obter(primeira, &a) && mesma(&a, &todas[primeira]) &&
+            historico_obter(TOTAL - 1, &a) && mesma(&a, &todas[TOTAL - 1]) &&
+            !historico_obter(primeira - 1, &a) && !historico_obter(TOTAL, &a);
+    verificar(certo, "mais antiga e mais nova; sobrescritas e futuras recusadas");
+
+    certo = historico_obter_recente(0, &a) && mesma(&a, &todas[TOTAL - 1]) &&
+            historico_obter_recente(HISTORICO_CAPACIDADE - 1, &a) && mesma(&a, &todas[primeira]) &&
+            !historico_obter_recente(HISTORICO_CAPACIDADE, &a);
+    verificar(certo, "por idade: 0 e a mais nova, capacidade-1 a mais antiga");
+
+    historico_iterador_t it;
+    historico_iterar_tudo(&it);
+    uint32_t s = primeira;
+    while (historico_proximo(&it, &a)) {
+        certo = certo && mesma(&a, &todas[s++]);
+    }
+    verificar(certo && s == TOTAL, "iterar tudo: a janela guardada inteira, em ordem");
+}
+
+static void testar_intervalos_na_volta(void) {
+    // Com o buffer cheio e dando a volta a cada inserção: consultas entre a amostra física
+    // HISTORICO_CAPACIDADE - 1 e a 0 (ponto de volta) e outras, sorteadas
+    historico_iniciar();
+    bool certo = true;
+    srand(7);
+    for (uint32_t n = 0; n < TOTAL && certo; n++) {
+        todas[n] = amostra_numero(n);
+        historico_adicionar(&todas[n]);
+        if (n < HISTORICO_CAPACIDADE || n % 37 != 0) continue;
+
+        uint32_t primeira = n + 1 - HISTORICO_CAPACIDADE;
+        uint32_t volta = (n + 1) & ~(uint32_t)(HISTORICO_CAPACIDADE - 1);   // Sequência na posição 0
+        if (volta > primeira && volta < n) {
+            certo = intervalo_igual(todas[volta - 3].epoch, todas[volta + 2 < n ? volta + 2 : n].epoch, n + 1);
+        }
+        uint32_t a = primeira + rand() % (n + 1 - primeira);
+        uint32_t b = primeira + rand() % (n + 1 - primeira);
+        if (a > b) { uint32_t t = a; a = b; b = t; }
+        certo = certo && intervalo_igual(todas[a].epoch, todas[b].epoch, n + 1);
+        certo = certo && intervalo_igual(todas[a].epoch + 1, todas[b].epoch - 1, n + 1);
+    }
+    verificar(certo, "intervalos atravessando o ponto de volta iguais a referencia");
+}
+
+static void testar_fora_da_faixa(void) {
+    // Estado de testar_intervalos_na_volta: TOTAL amostras inseridas
+    uint32_t primeira = TOTAL - HISTORICO_CAPACIDADE;
+    uint32_t mais_antiga = todas[primeira].epoch, mais_nova = todas[TOTAL - 1].epoch;
+    historico_iterador_t it;
+    amostra_t a;
+
+    historico_iterar_intervalo(&it, todas[0].epoch, mais_antiga - 1);
+    bool certo = !historico_proximo(&it, &a);
+    historico_iterar_intervalo(&it, mais_nova + 1, UINT32_MAX);
+    certo = certo && !historico_proximo(&it, &a);
+    historico_iterar_intervalo(&it, mais_nova, mais_antiga);
+    certo = certo && !historico_proximo(&it, &a);
+    verificar(certo, "antes da mais antiga, depois da mais nova e de > ate: vazio");
+
+    verificar(intervalo_igual(0, UINT32_MAX, TOTAL) && intervalo_igual(0, mais_antiga, TOTAL) &&
+              intervalo_igual(mais_nova, UINT32_MAX, TOTAL),
+              "limites abertos recortados para o que esta guardado");
+
+    verificar(historico_buscar_epoch(0) == primeira && historico_buscar_epoch(UINT32_MAX) == TOTAL,
+              "busca por epoch fora da faixa da na primeira ou na proxima");
+}
+
+// Um leitor que ficou para trás pula para a mais antiga em vez de ler amostras sobrescritas
+static void testar_iterador_atrasado(void) {
+    historico_iniciar();
+    for (uint32_t n = 0; n < 100; n++) {
+        todas[n] = amostra_numero(n);
+        historico_adicionar(&todas[n]);
+    }
+    historico_iterador_t it;
+    amostra_t a;
+    historico_iterar_desde(&it, 50);
+    bool certo = historico_proximo(&it, &a) && mesma(&a, &todas[50]);
+    for (uint32_t n = 100; n < 100 + HISTORICO_CAPACIDADE + 10; n++) {
+        todas[n] = amostra_numero(n);
+        historico_adicionar(&todas[n]);
+    }
+    certo = certo && historico_proximo(&it, &a) && mesma(&a, &todas[110]);
+    historico_iterar_desde(&it, 100 + HISTORICO_CAPACIDADE + 10);
+    verificar(certo && !historico_proximo(&it, &a), "iterador atrasado recomeca na mais antiga guardada");
+}
+
+static void testar_continuar_sequencia(void) {
+    historico_iniciar();
+    historico_continuar_sequencia(5000);
+    amostra_t x = amostra_numero(1);
+    amostra_t a;
+    bool certo = historico_adicionar(&x) == 5000 && historico_primeira_sequencia() == 5000 &&
+                 historico_obter(5000, &a) && mesma(&a, &x) && !historico_obter(4999, &a);
+    verificar(certo, "numeracao continuada apos o log em flash");
+}
+
+int main(void) {
+    testar_vazio();
+    testar_enchimento();
+    testar_intervalos_na_volta();
+    testar_fora_da_faixa();
+    testar_iterador_atrasado();
+    testar_continuar_sequencia();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,379 @@
+/**
+ * Testes, no computador, do analisador incremental de requisições HTTP (inc/http_requisicao.c):
+ * método, alvo, versão, keep-alive, If-None-Match, corpo descartado, requisições em sequência
+ * na mesma conexão (pipelining) e os erros 400, 414, 431 e 505. Cada fluxo é analisado de uma
+ * vez e de novo em pedaços cortados em posições aleatórias, como chegam os pbufs, e os dois
+ * resultados têm de ser iguais. Bytes aleatórios completam a bateria. Não depende do SDK do Pico:
+ *
+ *   cc -Wall -O2 -I.. -o testar_http_requisicao testar_http_requisicao.c ../inc/http_requisicao.c
+ *   ./testar_http_requisicao
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/http_requisicao.h"
+
+#define MAX_REQUISICOES 8
+#define CORTES_POR_FLUXO 300
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static uint32_t semente_atual;
+
+static uint32_t aleatorio(void) {
+    // xorshift32
+    uint32_t x = semente_atual;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return semente_atual = x;
+}
+
+// O que o servidor vê de cada requisição
+typedef struct {
+    http_estado_t estado;
+    uint16_t status_erro;
+    http_metodo_t metodo;
+    uint8_t versao_menor;
+    bool manter_aberta;
+    char alvo[HTTP_ALVO_MAX];
+    char if_none_match[HTTP_ETAG_MAX];
+} resultado_t;
+
+typedef struct {
+    resultado_t requisicoes[MAX_REQUISICOES];
+    int quantidade;
+    size_t consumidos;          // Bytes usados até a última requisição terminar (ou falhar)
+    bool incompleta;            // Sobrou uma requisição pela metade
+} analise_t;
+
+static void guardar(analise_t *a, const http_requisicao_t *r) {
+    resultado_t *res = &a->requisicoes[a->quantidade++];
+    memset(res, 0, sizeof(*res));
+    res->estado = r->estado;
+    res->status_erro = r->status_erro;
+    if (r->estado == HTTP_ESTADO_COMPLETA) {
+        res->metodo = r->metodo;
+        res->versao_menor = r->versao_menor;
+        res->manter_aberta = r->manter_aberta;
+        strcpy(res->alvo, r->alvo);
+        strcpy(res->if_none_match, r->if_none_match);
+    }
+}
+
+// Analisa o fluxo de uma conexão como o servidor: ao completar uma requisição, começa a próxima
+// com os bytes que sobraram; num erro, para. Com semente 0 entrega tudo de uma vez; senão, em
+// pedaços de 1 a 40 bytes.
+static void analisar(const char *fluxo, size_t tamanho, uint32_t semente, analise_t *a) {
+    memset(a, 0, sizeof(*a));
+    semente_atual = semente;
+    http_requisicao_t r;
+    http_requisicao_iniciar(&r);
+
+    size_t p = 0;
+    bool erro = false;
+    while (p < tamanho && !erro && a->quantidade < MAX_REQUISICOES) {
+        size_t pedaco = semente ? 1 + aleatorio() % 40 : tamanho;
+        if (pedaco > tamanho - p) pedaco = tamanho - p;
+        size_t fim_pedaco = p + pedaco;
+
+        // Um pedaço pode carregar o fim de uma requisição e o começo da próxima
+        while (p < fim_pedaco) {
+            size_t usados = http_requisicao_alimentar(&r, (const uint8_t *)fluxo + p, fim_pedaco - p);
+            if (usados > fim_pedaco - p) {
+                a->consumidos = (size_t)-1;
+                return;
+            }
+            p += usados;
+            if (http_requisicao_completa(&r) || http_requisicao_erro(&r)) {
+                guardar(a, &r);
+                a->consumidos = p;
+                if (http_requisicao_erro(&r) || a->quantidade == MAX_REQUISICOES) {
+                    erro = true;
+                    break;
+                }
+                http_requisicao_iniciar(&r);
+            } else if (usados == 0) {
+                break;
+            }
+        }
+    }
+    a->incompleta = !erro && r.estado != HTTP_ESTADO_METODO;
+}
+
+static bool analises_iguais(const analise_t *a, const analise_t *b) {
+    if (a->quantidade != b->quantidade || a->consumidos != b->consumidos || a->incompleta != b->incompleta) {
+        return false;
+    }
+    return memcmp(a->requisicoes, b->requisicoes, sizeof(resultado_t) * a->quantidade) == 0;
+}
+
+// Analisa de uma vez e em CORTES_POR_FLUXO divisões aleatórias; retorna a análise de referência
+// e se todas as divisões deram o mesmo resultado
+static bool analisar_cortado(const char *fluxo, size_t tamanho, analise_t *referencia) {
+    analisar(fluxo, tamanho, 0, referencia);
+    for (uint32_t semente = 1; semente <= CORTES_POR_FLUXO; semente++) {
+        analise_t cortada;
+        analisar(fluxo, tamanho, semente * 2654435761u, &cortada);
+        if (!analises_iguais(referencia, &cortada)) {
+            return false;
+        }
+    }
+    // Byte a byte
+    analise_t um_a_um;
+    memset(&um_a_um, 0, sizeof(um_a_um));
+    http_requisicao_t r;
+    http_requisicao_iniciar(&r);
+    for (size_t p = 0; p < tamanho && um_a_um.quantidade < MAX_REQUISICOES; p++) {
+        size_t usados = http_requisicao_alimentar(&r, (const uint8_t *)fluxo + p, 1);
+        if (http_requisicao_completa(&r) || http_requisicao_erro(&r)) {
+            guardar(&um_a_um, &r);
+            um_a_um.consumidos = p + usados;
+            if (http_requisicao_erro(&r)) break;
+            http_requisicao_iniciar(&r);
+            if (usados == 0) p--;
+        }
+    }
+    um_a_um.incompleta = !http_requisicao_erro(&r) && r.estado != HTTP_ESTADO_METODO &&
+                         um_a_um.quantidade < MAX_REQUISICOES;
+    return analises_iguais(referencia, &um_a_um);
+}
+
+// Uma requisição só, que deve terminar com o estado e o status dados
+static const resultado_t *unica(const char *fluxo, analise_t *a, bool *cortes_iguais) {
+    *cortes_iguais = analisar_cortado(fluxo, strlen(fluxo), a);
+    return a->quantidade == 1 ? &a->requisicoes[0] : NULL;
+}
+
+static void caso_erro(const char *fluxo, uint16_t status, const char *caso) {
+    analise_t a;
+    bool iguais;
+    const resultado_t *r = unica(fluxo, &a, &iguais);
+    verificar(iguais && r && r->estado == HTTP_ESTADO_ERRO && r->status_erro == status, caso);
+}
+
+static void caso_ok(const char *fluxo, http_metodo_t metodo, const char *alvo, bool manter, const char *caso) {
+    analise_t a;
+    bool iguais;
+    const resultado_t *r = unica(fluxo, &a, &iguais);
+    verificar(iguais && r && r->estado == HTTP_ESTADO_COMPLETA && r->metodo == metodo && strcmp(r->alvo, alvo) == 0 &&
+              r->manter_aberta == manter && a.consumidos == strlen(fluxo),
+              caso);
+}
+
+static void testar_basicos(void) {
+    caso_ok("GET /api/status HTTP/1.1\r\nHost: pico\r\n\r\n", HTTP_METODO_GET, "/api/status", true, "GET HTTP/1.1 mantém a conexão");
+    caso_ok("GET / HTTP/1.0\r\n\r\n", HTTP_METODO_GET, "/", false, "HTTP/1.0 fecha por padrão");
+    caso_ok("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", HTTP_METODO_GET, "/", true, "HTTP/1.0 com keep-alive");
+    caso_ok("GET / HTTP/1.1\r\nconnection:close\r\n\r\n", HTTP_METODO_GET, "/", false, "HTTP/1.1 com Connection: close");
+    caso_ok("HEAD /app.js HTTP/1.1\r\n\r\n", HTTP_METODO_HEAD, "/app.js", true, "HEAD");
+    caso_ok("POST /api/rules?i=1&ativa=0 HTTP/1.1\r\nContent-Length: 0\r\n\r\n", HTTP_METODO_POST,
+            "/api/rules?i=1&ativa=0", true, "POST com query string");
+    caso_ok("\r\n\r\nGET /x HTTP/1.1\r\n\r\n", HTTP_METODO_GET, "/x", true, "linhas vazias antes da requisição");
+    caso_ok("GET /x HTTP/1.1\nHost: a\n\n", HTTP_METODO_GET, "/x", true, "só LF no lugar de CRLF");
+    caso_ok("GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", HTTP_METODO_GET, "/", false,
+            "corpo chunked fecha a conexão depois");
+
+    // Métodos sem rota viram HTTP_METODO_OUTRO, que o roteador responde com 405, e não 400
+    caso_ok("PUT /api/rules HTTP/1.1\r\n\r\n", HTTP_METODO_OUTRO, "/api/rules", true, "PUT é outro método (405)");
+    caso_ok("DELETE /api/rules HTTP/1.1\r\n\r\n", HTTP_METODO_OUTRO, "/api/rules", true, "DELETE é outro método (405)");
+    caso_ok("get / HTTP/1.1\r\n\r\n", HTTP_METODO_OUTRO, "/", true, "método diferencia maiúsculas (405)");
+    caso_ok("PROPFINDXXXXXXXXXXX / HTTP/1.1\r\n\r\n", HTTP_METODO_OUTRO, "/", true, "método de 19 letras é outro método (405)");
+
+    analise_t a;
+    bool iguais;
+    const resultado_t *r = unica("GET / HTTP/1.1\r\nIf-None-Match:  \"a1b2\"\r\n\r\n", &a, &iguais);
+    verificar(iguais && r && strcmp(r->if_none_match, "\"a1b2\"") == 0, "If-None-Match sem os espaços iniciais");
+    r = unica("GET / HTTP/1.1\r\nX-Muito-Comprido-Nome-De-Cabecalho: 1\r\n\r\n", &a, &iguais);
+    verificar(iguais && r && r->estado == HTTP_ESTADO_COMPLETA, "cabeçalho de nome longo é ignorado");
+}
+
+static void testar_erros(void) {
+    caso_erro("GET / HTTP/2.0\r\n\r\n", 505, "HTTP/2.0 -> 505");
+    caso_erro("GET / HTTP/1.2\r\n\r\n", 505, "HTTP/1.2 -> 505");
+    caso_erro("GET / HTTX/1.1\r\n\r\n", 400, "versão malformada -> 400");
+    caso_erro("GET /\r\n\r\n", 400, "linha sem versão -> 400");
+    caso_erro("GET  / HTTP/1.1\r\n\r\n", 400, "dois espaços antes do alvo -> 400");
+    caso_erro(" GET / HTTP/1.1\r\n\r\n", 400, "espaço antes do método -> 400");
+    caso_erro("PROPFINDXXXXXXXXXXXX / HTTP/1.1\r\n\r\n", 400, "método de 20 letras -> 400");
+    caso_erro("GET /a\x01 HTTP/1.1\r\n\r\n", 400, "byte de controle no alvo -> 400");
+    caso_erro("GET / HTTP/1.1\r\nSem-dois-pontos\r\n\r\n", 400, "cabeçalho sem ':' -> 400");
+    caso_erro("GET / HTTP/1.1\r\nNome Com Espaco: 1\r\n\r\n", 400, "espaço no nome do cabeçalho -> 400");
+    caso_erro("GET / HTTP/1.1\r\nA: 1\r\n continuação\r\n\r\n", 400, "continuação de linha -> 400");
+    caso_erro("GET / HTTP/1.1\r\n: vazio\r\n\r\n", 400, "nome de cabeçalho vazio -> 400");
+    caso_erro("POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", 400, "Content-Length não numérico -> 400");
+    caso_erro("POST / HTTP/1.1\r\nContent-Length: 99999999999\r\n\r\n", 400, "Content-Length enorme -> 400");
+
+    // Alvo: HTTP_ALVO_MAX - 1 caracteres cabem, um a mais é 414
+    char fluxo[HTTP_CABECALHO_MAX + 256];
+    char alvo[HTTP_ALVO_MAX + 1];
+    memset(alvo, 'a', sizeof(alvo));
+    alvo[0] = '/';
+    alvo[HTTP_ALVO_MAX - 1] = '\0';
+    snprintf(fluxo, sizeof(fluxo), "GET %s HTTP/1.1\r\n\r\n", alvo);
+    caso_ok(fluxo, HTTP_METODO_GET, alvo, true, "alvo no limite é aceito");
+    alvo[HTTP_ALVO_MAX - 1] = 'a';
+    alvo[HTTP_ALVO_MAX] = '\0';
+    snprintf(fluxo, sizeof(fluxo), "GET %s HTTP/1.1\r\n\r\n", alvo);
+    caso_erro(fluxo, 414, "alvo um byte acima do limite -> 414");
+
+    // Cabeçalhos: até HTTP_CABECALHO_MAX bytes contando a linha de requisição
+    const char inicio[] = "GET / HTTP/1.1\r\nX: ";
+    const char fim[] = "\r\n\r\n";
+    size_t enchimento = HTTP_CABECALHO_MAX - (sizeof(inicio) - 1) - (sizeof(fim) - 1);
+    memcpy(fluxo, inicio, sizeof(inicio) - 1);
+    memset(fluxo + sizeof(inicio) - 1, 'x', enchimento);
+    memcpy(fluxo + sizeof(inicio) - 1 + enchimento, fim, sizeof(fim));
+    caso_ok(fluxo, HTTP_METODO_GET, "/", true, "cabeçalhos no limite são aceitos");
+    memset(fluxo + sizeof(inicio) - 1, 'x', enchimento + 1);
+    memcpy(fluxo + sizeof(inicio) - 1 + enchimento + 1, fim, sizeof(fim));
+    caso_erro(fluxo, 431, "cabeçalhos um byte acima do limite -> 431");
+
+    // Erro não consome a conexão inteira: para no byte que o causou
+    analise_t a;
+    analisar("GET / HTTP/3\r\n\r\nGET / HTTP/1.1\r\n\r\n", 33, 0, &a);
+    verificar(a.quantidade == 1 && a.requisicoes[0].status_erro == 505 && a.consumidos == 14,
+              "erro para no fim da linha de requisição");
+
+    // Linhas de status que o servidor envia
+    http_requisicao_t r;
+    http_requisicao_iniciar(&r);
+    bool textos = true;
+    static const struct {
+        uint16_t status;
+        const char *texto;
+    } esperados[] = {
+        {400, "400 Bad Request"},
+        {414, "414 URI Too Long"},
+        {431, "431 Request Header Fields Too Large"},
+        {505, "505 HTTP Version Not Supported"},
+    };
+    for (size_t i = 0; i < sizeof(esperados) / sizeof(esperados[0]); i++) {
+        r.status_erro = esperados[i].status;
+        if (strcmp(http_requisicao_status_erro(&r), esperados[i].texto) != 0) textos = false;
+    }
+    verificar(textos, "linha de status de cada erro");
+}
+
+static void testar_sequencia(void) {
+    // Corpo descartado entre duas requisições, um corpo que parece requisição e um método
+    // desconhecido no meio (o 405 não impede a conexão de seguir)
+    static const char fluxo[] =
+        "POST /api/rules?i=0 HTTP/1.1\r\nContent-Length: 11\r\n\r\nhello world"
+        "GET /api/status HTTP/1.1\r\n\r\n"
+        "POST /x HTTP/1.1\r\nContent-Length: 28\r\n\r\nGET /falso HTTP/1.1\r\n\r\nabcd"
+        "PUT /api/rules HTTP/1.1\r\n\r\n"
+        "GET /events HTTP/1.1\r\nIf-None-Match: \"e1\"\r\nConnection: close\r\n\r\n";
+    analise_t a;
+    bool iguais = analisar_cortado(fluxo, sizeof(fluxo) - 1, &a);
+    verificar(iguais, "pipelining: mesmo resultado em qualquer corte");
+    verificar(a.quantidade == 5 && a.consumidos == sizeof(fluxo) - 1 && !a.incompleta, "pipelining: cinco requisições");
+    static const struct {
+        http_metodo_t metodo;
+        const char *alvo;
+        const char *if_none_match;
+        bool manter_aberta;
+    } esperadas[] = {
+        {HTTP_METODO_POST, "/api/rules?i=0", "", true},
+        {HTTP_METODO_GET, "/api/status", "", true},
+        {HTTP_METODO_POST, "/x", "", true},
+        {HTTP_METODO_OUTRO, "/api/rules", "", true},
+        {HTTP_METODO_GET, "/events", "\"e1\"", false},
+    };
+    bool campos = a.quantidade == 5;
+    for (int i = 0; campos && i < 5; i++) {
+        const resultado_t *r = &a.requisicoes[i];
+        campos = r->estado == HTTP_ESTADO_COMPLETA && r->metodo == esperadas[i].metodo && r->versao_menor == 1 &&
+                 strcmp(r->alvo, esperadas[i].alvo) == 0 && strcmp(r->if_none_match, esperadas[i].if_none_match) == 0 &&
+                 r->manter_aberta == esperadas[i].manter_aberta;
+    }
+    verificar(campos, "pipelining: corpos pulados, campos de cada requisição");
+
+    // Uma requisição que chega pela metade fica à espera do resto
+    analisar(fluxo, 70, 0, &a);
+    verificar(a.quantidade == 1 && a.incompleta, "requisição incompleta aguarda mais bytes");
+
+    // Depois de um erro, nada mais é analisado
+    static const char com_erro[] = "GET /a HTTP/1.1\r\n\r\nGET /b HTTP/9.9\r\n\r\nGET /c HTTP/1.1\r\n\r\n";
+    iguais = analisar_cortado(com_erro, sizeof(com_erro) - 1, &a);
+    verificar(iguais && a.quantidade == 2 && a.requisicoes[1].status_erro == 505, "pipelining: para no primeiro erro");
+
+    // Cada requisição tem o seu limite de cabeçalhos, não a conexão toda
+    char longo[16 * 400];
+    size_t n = 0;
+    for (int i = 0; i < 6; i++) {
+        n += sprintf(longo + n, "GET /%d HTTP/1.1\r\nX: %0900d\r\n\r\n", i, 0);
+    }
+    analisar(longo, n, 0, &a);
+    verificar(a.quantidade == 6 && a.requisicoes[5].estado == HTTP_ESTADO_COMPLETA, "limite de cabeçalhos zera a cada requisição");
+}
+
+// Bytes aleatórios e requisições válidas com bytes trocados: o analisador nunca passa dos
+// limites, o alvo fica terminado e o resultado não depende de como os bytes chegam
+static void testar_aleatorio(void) {
+    static const char base[] =
+        "POST /api/rules?i=1 HTTP/1.1\r\nHost: pico\r\nContent-Length: 5\r\nConnection: keep-alive\r\n\r\nabcde"
+        "GET /api/history?from=1&to=2 HTTP/1.0\r\nIf-None-Match: \"x\"\r\n\r\n";
+    bool iguais = true, limites = true;
+    uint32_t estado = 12345;
+    for (int rodada = 0; rodada < 3000; rodada++) {
+        char fluxo[sizeof(base) + 64];
+        size_t n;
+        estado = estado * 1103515245u + 12345u;
+        if (rodada % 3 == 0) {
+            n = 1 + (estado >> 8) % (sizeof(fluxo) - 1);
+            for (size_t i = 0; i < n; i++) {
+                estado = estado * 1103515245u + 12345u;
+                fluxo[i] = (char)(estado >> 16);
+            }
+        } else {
+            n = sizeof(base) - 1;
+            memcpy(fluxo, base, n);
+            for (int trocas = 1 + rodada % 4; trocas > 0; trocas--) {
+                estado = estado * 1103515245u + 12345u;
+                size_t pos = (estado >> 8) % n;
+                static const char troca[] = " :\r\n\t\x01/0aZ\x7f\xff";
+                fluxo[pos] = troca[(estado >> 20) % (sizeof(troca) - 1)];
+            }
+        }
+
+        analise_t a;
+        analisar(fluxo, n, 0, &a);
+        if (a.consumidos > n) limites = false;
+        for (int i = 0; i < a.quantidade; i++) {
+            const resultado_t *r = &a.requisicoes[i];
+            if (strlen(r->alvo) >= HTTP_ALVO_MAX || strlen(r->if_none_match) >= HTTP_ETAG_MAX) limites = false;
+            if (r->estado == HTTP_ESTADO_ERRO && r->status_erro != 400 && r->status_erro != 414 &&
+                r->status_erro != 431 && r->status_erro != 505) {
+                limites = false;
+            }
+        }
+        for (uint32_t semente = 1; semente <= 8; semente++) {
+            analise_t cortada;
+            analisar(fluxo, n, semente * 2654435761u + rodada, &cortada);
+            if (!analises_iguais(&a, &cortada)) iguais = false;
+        }
+    }
+    verificar(limites, "bytes aleatórios: limites respeitados");
+    verificar(iguais, "bytes aleatórios: resultado independe dos cortes");
+}
+
+int main(void) {
+    testar_basicos();
+    testar_erros();
+    testar_sequencia();
+    testar_aleatorio();
+
+    printf("\n%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
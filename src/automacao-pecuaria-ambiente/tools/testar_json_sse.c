@@ -0,0 +1,417 @@
+/**
+ * Testes, no computador, do escritor de JSON (inc/json.c) e do enquadramento das respostas em
+ * fluxo (inc/http_fluxo.c): escape de textos, formatação dos números, truncamento quando o buffer
+ * acaba, documento dividido em vários buffers, chunks HTTP e eventos SSE ('event:'/'data:' e a
+ * linha em branco). As saídas são lidas de volta por um leitor simples, como faria o cliente.
+ * Não depende do SDK do Pico:
+ *
+ *   cc -Wall -O2 -I.. -I../simulador/include -o testar_json_sse testar_json_sse.c \
+ *      ../inc/json.c ../inc/formato.c ../inc/http_fluxo.c
+ *   ./testar_json_sse
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/json.h"
+#include "inc/http_fluxo.h"
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static bool texto_json(const char *texto, const char *esperado) {
+    char buffer[128];
+    json_escritor_t j;
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_texto(&j, texto);
+    return !j.estourou && strcmp(buffer, esperado) == 0;
+}
+
+static bool decimos_json(int32_t valor, const char *esperado) {
+    char buffer[32];
+    json_escritor_t j;
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_decimos(&j, valor);
+    return !j.estourou && strcmp(buffer, esperado) == 0;
+}
+
+static bool inteiro_json(int32_t valor, const char *esperado) {
+    char buffer[32];
+    json_escritor_t j;
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_inteiro(&j, valor);
+    return !j.estourou && strcmp(buffer, esperado) == 0;
+}
+
+static void testar_escape(void) {
+    verificar(texto_json("abc", "\"abc\""), "texto simples entre aspas");
+    verificar(texto_json("", "\"\""), "texto vazio");
+    verificar(texto_json("a\"b", "\"a\\\"b\""), "aspas escapadas");
+    verificar(texto_json("c:\\x", "\"c:\\\\x\""), "barra invertida escapada");
+    verificar(texto_json("l1\nl2", "\"l1\\u000al2\""), "quebra de linha vira \\u000a");
+    verificar(texto_json("\r\t\x01\x1f", "\"\\u000d\\u0009\\u0001\\u001f\""), "demais caracteres de controle");
+    verificar(texto_json("Galpão 3°", "\"Galpão 3°\""), "UTF-8 passa sem alteração");
+    verificar(texto_json("\x7f", "\"\x7f\""), "DEL não é caractere de controle em JSON");
+
+    // Nenhum byte de controle sobra no texto: é o que mantém o JSON numa só linha 'data:'
+    char entrada[32], buffer[256];
+    for (int i = 0; i < 31; i++) entrada[i] = (char)(i + 1);
+    entrada[31] = '\0';
+    json_escritor_t j;
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_texto(&j, entrada);
+    bool limpo = !j.estourou;
+    for (size_t i = 0; i < j.tamanho; i++) {
+        if ((unsigned char)buffer[i] < 0x20) limpo = false;
+    }
+    verificar(limpo, "todos os bytes 0x01-0x1f saem escapados");
+}
+
+static void testar_numeros(void) {
+    verificar(inteiro_json(0, "0"), "inteiro 0");
+    verificar(inteiro_json(-1, "-1"), "inteiro -1");
+    verificar(inteiro_json(INT32_MAX, "2147483647"), "inteiro INT32_MAX");
+    verificar(inteiro_json(INT32_MIN, "-2147483648"), "inteiro INT32_MIN");
+    verificar(decimos_json(0, "0.0"), "décimos 0 -> 0.0");
+    verificar(decimos_json(285, "28.5"), "décimos 285 -> 28.5");
+    verificar(decimos_json(-5, "-0.5"), "décimos -5 -> -0.5");
+    verificar(decimos_json(-10, "-1.0"), "décimos -10 -> -1.0");
+    verificar(decimos_json(9, "0.9"), "décimos 9 -> 0.9");
+    verificar(decimos_json(INT32_MAX, "214748364.7"), "décimos INT32_MAX");
+    verificar(decimos_json(INT32_MIN, "-214748364.8"), "décimos INT32_MIN");
+
+    // Todos os décimos de -100.0 a 100.0 contra o printf
+    bool iguais = true;
+    for (int32_t v = -1000; v <= 1000; v++) {
+        char esperado[16];
+        snprintf(esperado, sizeof(esperado), "%s%d.%d", v < 0 ? "-" : "", abs(v) / 10, abs(v) % 10);
+        if (!decimos_json(v, esperado)) iguais = false;
+    }
+    verificar(iguais, "décimos de -100.0 a 100.0 iguais ao printf");
+
+    char buffer[64];
+    json_escritor_t j;
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_abrir_objeto(&j);
+    json_chave(&j, "t");
+    json_decimos(&j, 285);
+    json_chave(&j, "l");
+    json_abrir_lista(&j);
+    json_inteiro(&j, 1);
+    json_booleano(&j, true);
+    json_booleano(&j, false);
+    json_fechar_lista(&j);
+    json_fechar_objeto(&j);
+    verificar(strcmp(buffer, "{\"t\":28.5,\"l\":[1,true,false]}") == 0, "vírgulas e aninhamento");
+}
+
+// Documento de teste com textos e números de tamanhos variados
+static void escrever_documento(json_escritor_t *j) {
+    json_abrir_objeto(j);
+    json_chave(j, "nome");
+    json_texto(j, "Galpão \"A\"\n");
+    json_chave(j, "valores");
+    json_abrir_lista(j);
+    for (int i = 0; i < 20; i++) {
+        json_decimos(j, i * 1234567 - 9000000);
+        json_inteiro(j, i % 2 ? INT32_MIN : i);
+    }
+    json_fechar_lista(j);
+    json_chave(j, "ativo");
+    json_booleano(j, true);
+    json_fechar_objeto(j);
+}
+
+static bool eh_numero(char c) {
+    return (c >= '0' && c <= '9') || c == '.' || c == '-';
+}
+
+static void testar_truncamento(void) {
+    char completo[1024];
+    json_escritor_t j;
+    json_iniciar(&j, completo, sizeof(completo));
+    escrever_documento(&j);
+    size_t total = j.tamanho;
+    verificar(!j.estourou && total > 200, "documento de referência cabe");
+
+    bool prefixo = true, limite = true, terminado = true, inteiros = true, estouro = true;
+    for (size_t capacidade = 0; capacidade <= total + 2; capacidade++) {
+        char buffer[1100];
+        memset(buffer, '#', sizeof(buffer));
+        json_iniciar(&j, buffer, capacidade);
+        escrever_documento(&j);
+
+        if (j.estourou != (capacidade <= total)) estouro = false;
+        if (buffer[capacidade] != '#' || (capacidade > 0 && j.tamanho >= capacidade)) limite = false;
+        if (capacidade > 0 && buffer[j.tamanho] != '\0') terminado = false;
+        if (memcmp(buffer, completo, j.tamanho) != 0) prefixo = false;
+        // Um número nunca fica pela metade: se o texto acaba num dígito, o número acabou ali
+        if (j.tamanho > 0 && j.tamanho < total && eh_numero(buffer[j.tamanho - 1]) && eh_numero(completo[j.tamanho])) {
+            inteiros = false;
+        }
+        if (json_livre(&j) != 0 && j.estourou) estouro = false;
+    }
+    verificar(estouro, "estourou só quando o documento não cabe");
+    verificar(limite, "nunca escreve além da capacidade");
+    verificar(terminado, "sempre termina com '\\0'");
+    verificar(prefixo, "saída truncada é prefixo do documento");
+    verificar(inteiros, "números não ficam escritos pela metade");
+
+    // Depois do estouro, nada mais é escrito, nem o que caberia
+    char buffer[8];
+    json_iniciar(&j, buffer, sizeof(buffer));
+    json_texto(&j, "comprido demais");
+    size_t tamanho = j.tamanho;
+    json_inteiro(&j, 1);
+    verificar(j.estourou && j.tamanho == tamanho, "nada é escrito depois do estouro");
+}
+
+// Gera o documento em buffers pequenos, como as exportações geram um chunk por vez
+static void testar_troca_buffer(void) {
+    char completo[4096];
+    json_escritor_t j;
+    json_iniciar(&j, completo, sizeof(completo));
+    json_abrir_lista(&j);
+    for (int i = 0; i < 200; i++) {
+        json_abrir_lista(&j);
+        json_inteiro(&j, i);
+        json_decimos(&j, -i);
+        json_fechar_lista(&j);
+    }
+    json_fechar_lista(&j);
+
+    char juntos[4096] = "";
+    char pedaco[48];
+    int pedacos = 0, i = 0;
+    json_iniciar(&j, pedaco, sizeof(pedaco));
+    json_abrir_lista(&j);
+    for (;;) {
+        while (i < 200 && json_livre(&j) > 30) {
+            json_abrir_lista(&j);
+            json_inteiro(&j, i);
+            json_decimos(&j, -i);
+            json_fechar_lista(&j);
+            i++;
+        }
+        if (i == 200) json_fechar_lista(&j);
+        if (j.estourou) break;
+        strcat(juntos, pedaco);
+        pedacos++;
+        if (i == 200) break;
+        json_trocar_buffer(&j, pedaco, sizeof(pedaco));
+    }
+    verificar(!j.estourou && pedacos > 10, "documento gerado em vários buffers");
+    verificar(strcmp(juntos, completo) == 0, "pedaços juntos iguais ao documento inteiro");
+}
+
+// --- Leitores, do lado do cliente ---
+
+// Corpo com Transfer-Encoding: chunked. Retorna o tamanho do corpo ou -1 se o enquadramento
+// estiver errado; *final indica se o chunk final apareceu.
+static long ler_chunked(const char *fluxo, size_t tamanho, char *corpo, bool *final) {
+    size_t p = 0;
+    long n_corpo = 0;
+    *final = false;
+    while (p < tamanho) {
+        char *fim;
+        unsigned long n = strtoul(fluxo + p, &fim, 16);
+        if (fim == fluxo + p || fim + 2 > fluxo + tamanho || memcmp(fim, "\r\n", 2) != 0) return -1;
+        p = fim + 2 - fluxo;
+        if (n == 0) {
+            if (p + 2 != tamanho || memcmp(fluxo + p, "\r\n", 2) != 0) return -1;
+            *final = true;
+            return n_corpo;
+        }
+        if (p + n + 2 > tamanho || memcmp(fluxo + p + n, "\r\n", 2) != 0) return -1;
+        memcpy(corpo + n_corpo, fluxo + p, n);
+        n_corpo += n;
+        p += n + 2;
+    }
+    return n_corpo;
+}
+
+// Eventos SSE como o EventSource os entrega: linhas até '\n', campo e valor separados por ':'
+// (um espaço depois dele é descartado), comentários começam com ':', e a linha em branco
+// entrega o evento se houver dados
+typedef struct {
+    char tipo[32];
+    char dados[2048];
+} evento_t;
+
+static int ler_sse(const char *fluxo, size_t tamanho, evento_t *eventos, int max) {
+    int n = 0;
+    evento_t atual = {.tipo = ""};
+    bool tem_dados = false;
+    size_t p = 0;
+    while (p < tamanho) {
+        const char *linha = fluxo + p;
+        const char *fim = memchr(linha, '\n', tamanho - p);
+        if (!fim) break;   // Linha incompleta: espera o resto
+        size_t len = fim - linha;
+        p += len + 1;
+
+        if (len == 0) {
+            if (tem_dados && n < max) {
+                eventos[n++] = atual;
+            }
+            atual = (evento_t){.tipo = ""};
+            tem_dados = false;
+            continue;
+        }
+        if (linha[0] == ':') continue;
+
+        const char *dois_pontos = memchr(linha, ':', len);
+        size_t len_campo = dois_pontos ? (size_t)(dois_pontos - linha) : len;
+        const char *valor = dois_pontos ? dois_pontos + 1 : linha + len;
+        if (valor < fim && *valor == ' ') valor++;
+        size_t len_valor = fim - valor;
+
+        if (len_campo == 5 && memcmp(linha, "event", 5) == 0) {
+            snprintf(atual.tipo, sizeof(atual.tipo), "%.*s", (int)len_valor, valor);
+        } else if (len_campo == 4 && memcmp(linha, "data", 4) == 0) {
+            size_t usado = strlen(atual.dados);
+            if (tem_dados) atual.dados[usado++] = '\n';
+            memcpy(atual.dados + usado, valor, len_valor);
+            atual.dados[usado + len_valor] = '\0';
+            tem_dados = true;
+        }
+    }
+    return n;
+}
+
+static void testar_chunks(void) {
+    static char buffer[HTTP_FLUXO_RESERVA + 0x100000 + HTTP_FLUXO_FOLGA];
+    static const size_t tamanhos[] = {1, 9, 15, 16, 255, 256, 512, 1471, 4095, 4096, 0xFFFFF, 0x100000};
+    bool certos = true;
+    for (size_t t = 0; t < sizeof(tamanhos) / sizeof(tamanhos[0]); t++) {
+        size_t n = tamanhos[t];
+        memset(buffer, '#', sizeof(buffer));
+        for (size_t i = 0; i < n; i++) buffer[HTTP_FLUXO_RESERVA + i] = (char)('a' + i % 26);
+        size_t fim;
+        size_t inicio = http_fluxo_chunk(buffer, n, &fim);
+
+        char esperado[16];
+        int n_cabecalho = snprintf(esperado, sizeof(esperado), "%zX\r\n", n);
+        if (inicio + n_cabecalho != HTTP_FLUXO_RESERVA || memcmp(buffer + inicio, esperado, n_cabecalho) != 0 ||
+            fim != HTTP_FLUXO_RESERVA + n + HTTP_FLUXO_FOLGA) {
+            certos = false;
+            continue;
+        }
+        static char corpo[0x100000];
+        bool final;
+        long lido = ler_chunked(buffer + inicio, fim - inicio, corpo, &final);
+        if (lido != (long)n || final || memcmp(corpo, buffer + HTTP_FLUXO_RESERVA, n) != 0) certos = false;
+    }
+    verificar(certos, "chunk: tamanho em hexadecimal, dados e CRLF");
+
+    size_t fim;
+    size_t inicio = http_fluxo_chunk(buffer, 0, &fim);
+    verificar(inicio == 0 && fim == 5 && memcmp(buffer, "0\r\n\r\n", 5) == 0, "chunk final");
+
+    // Uma resposta inteira: JSON em chunks de no máximo 64 bytes, como a exportação gera
+    char fluxo[8192];
+    size_t n_fluxo = 0;
+    char completo[4096];
+    json_escritor_t ref;
+    json_iniciar(&ref, completo, sizeof(completo));
+    escrever_documento(&ref);
+    size_t enviados = 0;
+    for (;;) {
+        char chunk[HTTP_FLUXO_RESERVA + 64 + HTTP_FLUXO_FOLGA];
+        size_t n = ref.tamanho - enviados < 64 ? ref.tamanho - enviados : 64;
+        memcpy(chunk + HTTP_FLUXO_RESERVA, completo + enviados, n);
+        enviados += n;
+        inicio = http_fluxo_chunk(chunk, n, &fim);
+        memcpy(fluxo + n_fluxo, chunk + inicio, fim - inicio);
+        n_fluxo += fim - inicio;
+        if (n == 0) break;
+    }
+    char corpo[4096];
+    bool final;
+    long lido = ler_chunked(fluxo, n_fluxo, corpo, &final);
+    verificar(final && lido == (long)ref.tamanho && memcmp(corpo, completo, lido) == 0,
+              "resposta em chunks lida de volta pelo cliente");
+}
+
+static size_t gerar_evento(char *buffer, size_t capacidade, const char *nome, const char *texto, int32_t valor) {
+    size_t cabecalho = http_fluxo_abrir_evento(buffer, nome);
+    json_escritor_t j;
+    json_iniciar(&j, buffer + cabecalho, capacidade - cabecalho - HTTP_FLUXO_FOLGA);
+    json_abrir_objeto(&j);
+    json_chave(&j, "texto");
+    json_texto(&j, texto);
+    json_chave(&j, "valor");
+    json_decimos(&j, valor);
+    json_fechar_objeto(&j);
+    return http_fluxo_fechar_evento(buffer, cabecalho + j.tamanho);
+}
+
+static void testar_sse(void) {
+    char buffer[256];
+    size_t fim = gerar_evento(buffer, sizeof(buffer), "estado", "ok", 285);
+    const char esperado[] = "event: estado\ndata: {\"texto\":\"ok\",\"valor\":28.5}\n\n";
+    verificar(fim == sizeof(esperado) - 1 && memcmp(buffer, esperado, fim) == 0, "evento: linhas 'event:', 'data:' e em branco");
+
+    fim = http_fluxo_abrir_evento(buffer, NULL);
+    verificar(fim == 6 && memcmp(buffer, "data: ", 6) == 0, "evento sem nome só tem 'data:'");
+
+    // Um fluxo com eventos, comentários de keepalive e textos com quebras de linha e aspas
+    char fluxo[4096];
+    size_t n = 0;
+    static const char *textos[] = {"linha1\nlinha2", "\"aspas\"", "\r\n\r\n", "data: falso\n\nevent: x", ""};
+    for (int i = 0; i < 5; i++) {
+        n += gerar_evento(fluxo + n, sizeof(fluxo) - n, "estado", textos[i], -5 * i);
+        n += http_fluxo_comentario(fluxo + n);
+    }
+    evento_t eventos[8];
+    int lidos = ler_sse(fluxo, n, eventos, 8);
+    bool certos = lidos == 5;
+    for (int i = 0; certos && i < lidos; i++) {
+        char json[256];
+        json_escritor_t j;
+        json_iniciar(&j, json, sizeof(json));
+        json_abrir_objeto(&j);
+        json_chave(&j, "texto");
+        json_texto(&j, textos[i]);
+        json_chave(&j, "valor");
+        json_decimos(&j, -5 * i);
+        json_fechar_objeto(&j);
+        if (strcmp(eventos[i].tipo, "estado") != 0 || strcmp(eventos[i].dados, json) != 0 ||
+            strchr(eventos[i].dados, '\n')) {
+            certos = false;
+        }
+    }
+    verificar(certos, "cliente recebe cada evento inteiro, numa linha 'data:'");
+
+    n = 0;
+    for (int i = 0; i < 3; i++) n += http_fluxo_comentario(fluxo + n);
+    verificar(ler_sse(fluxo, n, eventos, 8) == 0, "keepalive não entrega evento");
+
+    // Evento cortado no meio só sai quando chega a linha em branco
+    n = gerar_evento(fluxo, sizeof(fluxo), "estado", "x", 1);
+    bool parcial = true;
+    for (size_t corte = 0; corte < n; corte++) {
+        if (ler_sse(fluxo, corte, eventos, 8) != 0) parcial = false;
+    }
+    verificar(parcial && ler_sse(fluxo, n, eventos, 8) == 1, "evento incompleto não é entregue");
+}
+
+int main(void) {
+    testar_escape();
+    testar_numeros();
+    testar_truncamento();
+    testar_troca_buffer();
+    testar_chunks();
+    testar_sse();
+
+    printf("\n%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+/**
+ * Testes, no computador, do motor de regras de controle (inc/regras.c) com sequências simuladas
+ * de leituras e de horários. Não depende do SDK do Pico:
+ *
+ *   cc -O2 -I.. -o testar_regras testar_regras.c ../inc/regras.c
+ *   ./testar_regras
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/regras.h"
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static const regra_config_t VENTILADOR = {
+    .nome = "ventilador", .entrada = REGRA_ENTRADA_TEMPERATURA, .sentido = REGRA_LIGA_ACIMA,
+    .liga = 280, .desliga = 270, .minimo_ligado_s = 300, .minimo_desligado_s = 120,
+};
+static const regra_config_t UMIDIFICADOR = {
+    .nome = "umidificador", .entrada = REGRA_ENTRADA_UMIDADE, .sentido = REGRA_LIGA_ABAIXO,
+    .liga = 450, .desliga = 480,
+};
+
+// Temperatura oscilando em torno de 28,0 °C: uma regra de limiar único trocaria a cada leitura
+static void testar_histerese(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regra_config_t sem_minimos = VENTILADOR;
+    sem_minimos.minimo_ligado_s = sem_minimos.minimo_desligado_s = 0;
+    regras_adicionar(&m, &sem_minimos);
+
+    srand(42);
+    for (uint32_t t = 0; t < 3600; t += 30) {
+        regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 276 + rand() % 9);   // 27,6 a 28,4
+        regras_avaliar(&m, t);
+    }
+    verificar(m.regras[0].trocas == 1 && regras_ligado(&m, 0), "ruido dentro da histerese: liga uma vez e fica");
+
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 271);
+    regras_avaliar(&m, 3600);
+    verificar(regras_ligado(&m, 0), "27,1 C ainda dentro da histerese: continua ligado");
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 270);
+    verificar(regras_avaliar(&m, 3630) == 1 && !regras_ligado(&m, 0), "27,0 C: desliga e sinaliza a troca");
+}
+
+static void testar_sentido_abaixo(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regras_adicionar(&m, &UMIDIFICADOR);
+
+    const int16_t sequencia[] = {500, 460, 449, 470, 479, 480, 455, 440};
+    const bool esperado[] = {false, false, true, true, true, false, false, true};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(sequencia) / sizeof(sequencia[0]); i++) {
+        regras_entrada(&m, REGRA_ENTRADA_UMIDADE, sequencia[i]);
+        regras_avaliar(&m, i * 30);
+        ok = ok && regras_ligado(&m, 0) == esperado[i];
+    }
+    verificar(ok, "liga abaixo de 45,0 % e desliga a partir de 48,0 %");
+}
+
+static void testar_tempos_minimos(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regras_adicionar(&m, &VENTILADOR);
+
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 300);
+    regras_avaliar(&m, 1000);
+    verificar(regras_ligado(&m, 0), "primeira troca nao espera tempo minimo");
+
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 250);
+    regras_avaliar(&m, 1100);
+    verificar(regras_ligado(&m, 0) && m.regras[0].pendente, "desligar antes de 300 s ligado fica pendente");
+    regras_avaliar(&m, 1299);
+    verificar(regras_ligado(&m, 0), "ainda ligado aos 299 s, mesmo sem leitura nova");
+    regras_avaliar(&m, 1300);
+    verificar(!regras_ligado(&m, 0) && !m.regras[0].pendente, "desliga aos 300 s");
+
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 300);
+    regras_avaliar(&m, 1350);
+    verificar(!regras_ligado(&m, 0), "religar antes de 120 s desligado e barrado");
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 275);
+    regras_avaliar(&m, 1360);
+    verificar(!m.regras[0].pendente, "leitura volta para a histerese: pendencia cancelada");
+    regras_avaliar(&m, 1500);
+    verificar(!regras_ligado(&m, 0), "sem pendencia, nao religa sozinho");
+}
+
+static void testar_janela(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regra_config_t luz = {
+        .nome = "luz", .entrada = REGRA_ENTRADA_LUMINOSIDADE, .sentido = REGRA_LIGA_ABAIXO,
+        .liga = 400, .desliga = 450, .janela_inicio = 18 * 60, .janela_fim = 5 * 60,   // Atravessa a meia-noite
+    };
+    regras_adicionar(&m, &luz);
+    regras_entrada(&m, REGRA_ENTRADA_LUMINOSIDADE, 100);
+
+    const uint16_t horarios[] = {12 * 60, 17 * 60 + 59, 18 * 60, 23 * 60 + 59, 0, 4 * 60 + 59, 5 * 60};
+    const bool esperado[] = {false, false, true, true, true, true, false};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(horarios) / sizeof(horarios[0]); i++) {
+        regras_horario(&m, horarios[i]);
+        regras_avaliar(&m, i * 60);
+        ok = ok && regras_ligado(&m, 0) == esperado[i];
+    }
+    verificar(ok, "janela 18:00-05:00 atravessando a meia-noite");
+}
+
+// Reavaliação só quando uma entrada da regra muda
+static void testar_avaliacao_por_mudanca(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regras_adicionar(&m, &VENTILADOR);
+    regras_adicionar(&m, &UMIDIFICADOR);
+
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 250);
+    regras_entrada(&m, REGRA_ENTRADA_UMIDADE, 600);
+    regras_avaliar(&m, 0);
+    uint32_t base = m.avaliacoes;
+
+    for (uint32_t t = 30; t <= 3000; t += 30) {
+        regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 250);
+        regras_entrada(&m, REGRA_ENTRADA_UMIDADE, 600);
+        regras_horario(&m, t / 60);     // Nenhuma das duas tem janela
+        regras_avaliar(&m, t);
+    }
+    verificar(m.avaliacoes == base, "entradas repetidas nao reavaliam nenhuma regra");
+
+    regras_entrada(&m, REGRA_ENTRADA_UMIDADE, 590);
+    regras_avaliar(&m, 3030);
+    verificar(m.avaliacoes == base + 1, "mudanca na umidade reavalia so o umidificador");
+}
+
+static void testar_reconfiguracao(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regras_adicionar(&m, &VENTILADOR);
+    regras_entrada(&m, REGRA_ENTRADA_TEMPERATURA, 285);
+    regras_avaliar(&m, 0);
+    verificar(regras_ligado(&m, 0), "28,5 C com limiar 28,0: ligado");
+
+    regra_config_t nova = VENTILADOR;
+    nova.liga = 300;
+    nova.desliga = 290;
+    nova.minimo_ligado_s = 0;
+    verificar(regras_configurar(&m, 0, &nova), "novos limiares aceitos em funcionamento");
+    regras_avaliar(&m, 10);
+    verificar(!regras_ligado(&m, 0), "28,5 C com desliga em 29,0: desliga sem leitura nova");
+
+    regra_config_t invertida = VENTILADOR;
+    invertida.desliga = 290;    // Acima do limiar de ligar: oscilaria
+    verificar(!regras_configurar(&m, 0, &invertida) && m.regras[0].config.liga == 300, "histerese invertida e recusada");
+    invertida = VENTILADOR;
+    invertida.janela_fim = 24 * 60;
+    verificar(!regras_configurar(&m, 0, &invertida), "janela fora do dia e recusada");
+    verificar(regras_adicionar(&m, &invertida) == -1, "regra invalida nao e adicionada");
+}
+
+static void testar_sem_leitura(void) {
+    motor_regras_t m;
+    regras_iniciar(&m);
+    regras_adicionar(&m, &UMIDIFICADOR);
+    verificar(regras_avaliar(&m, 0) == 0 && m.regras[0].pendente && m.avaliacoes == 0,
+              "sem leitura a regra espera, sem ligar com valor zero");
+}
+
+int main(void) {
+    testar_histerese();
+    testar_sentido_abaixo();
+    testar_tempos_minimos();
+    testar_janela();
+    testar_avaliacao_por_mudanca();
+    testar_reconfiguracao();
+    testar_sem_leitura();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * Testes, no computador, de ida e volta do formato binário do histórico: as amostras são
+ * codificadas por inc/serie_binaria.c e lidas de volta pelo decodificador de referência
+ * (tools/decodificar_historico.c), cuja saída é comparada com as amostras originais. Cobre os
+ * extremos do varint e do zig-zag (0, ±1, INT32_MIN, INT32_MAX, cada mudança de tamanho do
+ * varint), saltos de sequência, a sequência dando a volta em 2^32 e fluxos truncados.
+ * Não depende do SDK do Pico:
+ *
+ *   cc -O2 -o decodificar_historico decodificar_historico.c
+ *   cc -Wall -O2 -I.. -o testar_serie_binaria testar_serie_binaria.c ../inc/serie_binaria.c
+ *   ./testar_serie_binaria [./decodificar_historico]
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "inc/serie_binaria.h"
+
+#define MAX_AMOSTRAS 6000
+
+static int falhas;
+static const char *decodificador = "./decodificar_historico";
+static char arquivo_entrada[] = "/tmp/testar_serie_binaria_XXXXXX";
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+typedef struct {
+    uint8_t dados[SERIE_BINARIA_CABECALHO + MAX_AMOSTRAS * SERIE_BINARIA_REGISTRO_MAX];
+    size_t tamanho;
+    size_t fim_registro[MAX_AMOSTRAS + 1];  // Onde termina cada registro (0 = o cabeçalho)
+    size_t maior_registro;
+    int quantidade;
+    uint32_t sequencias[MAX_AMOSTRAS];
+    amostra_t amostras[MAX_AMOSTRAS];
+    uint32_t proxima;
+} fluxo_t;
+
+static void codificar_inicio(fluxo_t *f, serie_binaria_t *s, uint32_t primeira, uint32_t proxima, uint32_t epoch_base) {
+    f->tamanho = serie_binaria_cabecalho(s, f->dados, primeira, proxima, epoch_base);
+    f->fim_registro[0] = f->tamanho;
+    f->maior_registro = 0;
+    f->quantidade = 0;
+    f->proxima = proxima;
+}
+
+static void codificar(fluxo_t *f, serie_binaria_t *s, uint32_t sequencia, const amostra_t *a) {
+    size_t n = serie_binaria_registro(s, f->dados + f->tamanho, sequencia, a);
+    f->tamanho += n;
+    if (n > f->maior_registro) f->maior_registro = n;
+    f->sequencias[f->quantidade] = sequencia;
+    f->amostras[f->quantidade] = *a;
+    f->fim_registro[++f->quantidade] = f->tamanho;
+}
+
+// Cursor da próxima coleta só conhecido depois dos registros: reescreve o campo do cabeçalho
+static void definir_proxima(fluxo_t *f, uint32_t proxima) {
+    f->dados[12] = proxima;
+    f->dados[13] = proxima >> 8;
+    f->dados[14] = proxima >> 16;
+    f->dados[15] = proxima >> 24;
+    f->proxima = proxima;
+}
+
+// Linha que o decodificador deve imprimir para a amostra, montada direto dos valores originais
+static void linha_esperada(char *destino, size_t tamanho, uint32_t sequencia, const amostra_t *a) {
+    time_t t = a->epoch;
+    struct tm data;
+    char texto[32];
+    gmtime_r(&t, &data);
+    strftime(texto, sizeof(texto), "%Y-%m-%d %H:%M:%S", &data);
+    snprintf(destino, tamanho, "%u;%s;%.1f;%.1f;%.1f;%u\n", sequencia, texto, a->temperatura / 10.0,
+             a->umidade / 10.0, a->luminosidade / 10.0, a->reles);
+}
+
+// Passa os primeiros 'tamanho' bytes do fluxo pelo decodificador. Retorna o código de saída;
+// *iguais indica se a saída traz exatamente as 'esperadas' primeiras amostras e o cursor.
+static int decodificar(const fluxo_t *f, size_t tamanho, int esperadas, bool *iguais) {
+    FILE *arquivo = fopen(arquivo_entrada, "wb");
+    fwrite(f->dados, 1, tamanho, arquivo);
+    fclose(arquivo);
+
+    char comando[512];
+    snprintf(comando, sizeof(comando), "%s %s 2>%s.err", decodificador, arquivo_entrada, arquivo_entrada);
+    FILE *saida = popen(comando, "r");
+    char linha[256], esperada[256];
+    *iguais = fgets(linha, sizeof(linha), saida) &&
+              strcmp(linha, "sequencia;data;temperatura;umidade;luminosidade;reles\n") == 0;
+    for (int i = 0; *iguais && i < esperadas; i++) {
+        linha_esperada(esperada, sizeof(esperada), f->sequencias[i], &f->amostras[i]);
+        *iguais = fgets(linha, sizeof(linha), saida) && strcmp(linha, esperada) == 0;
+    }
+    *iguais = *iguais && !fgets(linha, sizeof(linha), saida);
+    while (fgets(linha, sizeof(linha), saida)) {
+    }
+    int status = pclose(saida);
+
+    // O cursor para a próxima coleta vai para a saída de erro
+    snprintf(comando, sizeof(comando), "%s.err", arquivo_entrada);
+    FILE *erros = fopen(comando, "r");
+    snprintf(esperada, sizeof(esperada), "%d amostras; proxima coleta: ?since=%u\n", esperadas, f->proxima);
+    *iguais = *iguais && fgets(linha, sizeof(linha), erros) && strcmp(linha, esperada) == 0;
+    fclose(erros);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static bool ida_e_volta(const fluxo_t *f) {
+    bool iguais;
+    return decodificar(f, f->tamanho, f->quantidade, &iguais) == 0 && iguais;
+}
+
+static void testar_vazio(void) {
+    static fluxo_t f;
+    serie_binaria_t s;
+    codificar_inicio(&f, &s, 77, 77, 1751328000);
+    verificar(f.tamanho == SERIE_BINARIA_CABECALHO && memcmp(f.dados, "HBIN\x01\x14\0\0", 8) == 0, "cabeçalho: assinatura, versão e tamanho");
+    verificar(ida_e_volta(&f), "só o cabeçalho: nenhuma amostra e o cursor");
+}
+
+// Zig-zag nos extremos: o delta de epoch é um int32 qualquer (o epoch dá a volta em 2^32)
+static void testar_zigzag(void) {
+    static const int32_t deltas[] = {0, 1, -1, 2, -2, 63, -64, 64, -65, INT32_MAX, INT32_MIN, INT32_MAX, -1, 1, INT32_MIN, 0};
+    static fluxo_t f;
+    serie_binaria_t s;
+    uint32_t epoch = 1751328000;
+    codificar_inicio(&f, &s, 0, 16, epoch);
+    for (int i = 0; i < 16; i++) {
+        epoch += (uint32_t)deltas[i];
+        amostra_t a = {.epoch = epoch, .temperatura = 250, .umidade = 600, .luminosidade = 0, .reles = 0};
+        codificar(&f, &s, i, &a);
+    }
+    verificar(ida_e_volta(&f), "delta de epoch 0, ±1, INT32_MIN e INT32_MAX");
+
+    // Registro com delta de epoch = INT32_MIN: zig-zag 0xFFFFFFFF, varint de 5 bytes
+    size_t n = f.fim_registro[11] - f.fim_registro[10];
+    verificar(n == 5 + 5 && f.dados[f.fim_registro[10] + 1] == 0xFF && f.dados[f.fim_registro[10] + 5] == 0x0F,
+              "INT32_MIN vira o varint FF FF FF FF 0F");
+
+    // Leituras de um extremo ao outro do int16 e de volta, sinal trocando a cada amostra
+    codificar_inicio(&f, &s, 0, 8, epoch);
+    static const int16_t leituras[] = {0, -1, 1, INT16_MIN, INT16_MAX, INT16_MIN, 0, -1};
+    for (int i = 0; i < 8; i++) {
+        amostra_t a = {.epoch = epoch + i * 60, .temperatura = leituras[i], .umidade = (int16_t)-leituras[7 - i],
+                       .luminosidade = leituras[(i + 3) % 8], .reles = i % 2 ? 0xFFFF : 0};
+        codificar(&f, &s, i, &a);
+    }
+    verificar(ida_e_volta(&f), "leituras nos extremos do int16, relés 0 e 0xFFFF");
+    verificar(f.maior_registro <= SERIE_BINARIA_REGISTRO_MAX, "registro nunca passa de SERIE_BINARIA_REGISTRO_MAX");
+}
+
+// Saltos de sequência em cada mudança de tamanho do varint (7, 14, 21 e 28 bits)
+static void testar_saltos(void) {
+    static const struct {
+        uint32_t salto;
+        size_t bytes;
+    } saltos[] = {
+        {0, 1}, {1, 1}, {127, 1}, {128, 2}, {16383, 2}, {16384, 3}, {(1u << 21) - 1, 3},
+        {1u << 21, 4}, {(1u << 28) - 1, 4}, {1u << 28, 5}, {UINT32_MAX - 100, 5},
+    };
+    static fluxo_t f;
+    serie_binaria_t s;
+    uint32_t sequencia = 1000;
+    codificar_inicio(&f, &s, sequencia, 0, 1751328000);
+    bool tamanhos = true;
+    for (size_t i = 0; i < sizeof(saltos) / sizeof(saltos[0]); i++) {
+        sequencia += saltos[i].salto;
+        amostra_t a = {.epoch = 1751328000, .temperatura = 0, .umidade = 0, .luminosidade = 0, .reles = 0};
+        codificar(&f, &s, sequencia, &a);
+        // Sem mudança nos valores, os outros cinco campos ocupam um byte cada
+        if (f.fim_registro[i + 1] - f.fim_registro[i] != saltos[i].bytes + 5) tamanhos = false;
+        sequencia++;
+    }
+    definir_proxima(&f, sequencia);
+    verificar(tamanhos, "tamanho do varint em cada fronteira de 7 bits");
+    verificar(ida_e_volta(&f), "saltos de sequência, inclusive dando a volta em 2^32");
+}
+
+// Caminhada aleatória parecida com o histórico real, com lacunas de vez em quando
+static void testar_aleatorio(void) {
+    static fluxo_t f;
+    serie_binaria_t s;
+    uint32_t estado = 2025;
+    uint32_t sequencia = UINT32_MAX - 2000;     // Atravessa a volta do contador no meio
+    uint32_t epoch = 1751328000;
+    amostra_t a = {.epoch = epoch, .temperatura = 250, .umidade = 700, .luminosidade = 300, .reles = 0};
+    codificar_inicio(&f, &s, sequencia, 0, epoch - 3600);
+    for (int i = 0; i < 5000; i++) {
+        estado = estado * 1103515245u + 12345u;
+        uint32_t r = estado >> 8;
+        if (r % 50 == 0) sequencia += 1 + r % 300;              // Amostras sobrescritas
+        a.epoch += r % 70 == 0 ? 86400 : r % 13 == 0 ? 0 : 60;  // Falta de energia, segundo repetido
+        a.temperatura += (int16_t)(r % 7) - 3;
+        a.umidade += (int16_t)((r >> 3) % 9) - 4;
+        a.luminosidade = (int16_t)((r >> 7) % 1001);
+        a.reles = (r >> 17) & 7;
+        codificar(&f, &s, sequencia++, &a);
+    }
+    definir_proxima(&f, sequencia);
+    verificar(ida_e_volta(&f), "5000 amostras aleatórias com lacunas");
+    verificar(f.tamanho < SERIE_BINARIA_CABECALHO + 5000 * 9, "série típica fica abaixo de 9 bytes por amostra");
+}
+
+// Corte em qualquer byte: no fim de um registro, as amostras inteiras saem; no meio, erro
+static void testar_truncado(void) {
+    static fluxo_t f;
+    serie_binaria_t s;
+    codificar_inicio(&f, &s, 5, 9, 1751328000);
+    uint32_t epoch = 1751328000;
+    for (int i = 0; i < 4; i++) {
+        epoch += i == 2 ? (uint32_t)INT32_MIN : 60;
+        amostra_t a = {.epoch = epoch, .temperatura = (int16_t)(i * 3000 - 4000), .umidade = 900, .luminosidade = 0, .reles = 5};
+        codificar(&f, &s, i == 3 ? 100000 : 5 + i, &a);
+    }
+
+    bool certos = true;
+    int registro = 0;
+    for (size_t corte = 0; corte <= f.tamanho; corte++) {
+        while (registro < f.quantidade && f.fim_registro[registro + 1] <= corte) registro++;
+        bool iguais;
+        int status = decodificar(&f, corte, registro, &iguais);
+        bool na_fronteira = corte == f.fim_registro[registro];
+        if (na_fronteira ? (status != 0 || !iguais) : status == 0) {
+            certos = false;
+        }
+    }
+    verificar(certos, "fluxo cortado em cada byte: erro no meio de um registro");
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) decodificador = argv[1];
+    if (access(decodificador, X_OK) != 0) {
+        fprintf(stderr, "decodificador %s nao encontrado; compile tools/decodificar_historico.c\n", decodificador);
+        return 1;
+    }
+    int arquivo = mkstemp(arquivo_entrada);
+    if (arquivo < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(arquivo);
+
+    testar_vazio();
+    testar_zigzag();
+    testar_saltos();
+    testar_aleatorio();
+    testar_truncado();
+
+    unlink(arquivo_entrada);
+    char erros[sizeof(arquivo_entrada) + 4];
+    snprintf(erros, sizeof(erros), "%s.err", arquivo_entrada);
+    unlink(erros);
+    printf("\n%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * Testes, no computador, do driver do SSD1306 (inc/ssd1306_i2c.c): a HAL do I2C é trocada por uma
+ * que grava cada envio, e o tráfego de cada função é comparado palavra por palavra (byte + bit de
+ * STOP), com barramento e endereço. Usa os cabeçalhos do SDK do simulador:
+ *
+ *   cc -O2 -I.. -I../simulador/include -o testar_ssd1306 testar_ssd1306.c ../inc/ssd1306_i2c.c \
+ *       ../inc/oled_texto.c ../inc/oled_grafico.c
+ *   ./testar_ssd1306
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/hal.h"
+#include "inc/ssd1306.h"
+
+#define MAX_ENVIOS 8
+#define MAX_PALAVRAS 2048
+
+// --- HAL DE TESTE ---
+typedef struct {
+    uint barramento;
+    uint8_t endereco;
+    const uint16_t *palavras;           // O que o DMA leria, ainda no driver
+    uint16_t copia[MAX_PALAVRAS];       // O que havia nele no disparo
+    int quantidade;
+} envio_t;
+
+static envio_t envios[MAX_ENVIOS];
+static int n_envios;
+static bool ocupado[2];
+
+void hal_i2c_iniciar(uint barramento, uint sda, uint scl, uint32_t frequencia_hz) {
+}
+
+void hal_i2c_enviar(uint barramento, uint8_t endereco, const uint16_t *palavras, int quantidade) {
+    if (n_envios == MAX_ENVIOS || quantidade > MAX_PALAVRAS) {
+        printf("    envio demais ou grande demais\n");
+        exit(1);
+    }
+    envio_t *e = &envios[n_envios++];
+    e->barramento = barramento;
+    e->endereco = endereco;
+    e->palavras = palavras;
+    memcpy(e->copia, palavras, quantidade * sizeof(uint16_t));
+    e->quantidade = quantidade;
+}
+
+bool hal_i2c_ocupado(uint barramento) {
+    return ocupado[barramento & 1];
+}
+
+// O driver só usa a fila com DMA
+void hal_i2c_escrever(uint barramento, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    printf("    escrita bloqueante inesperada\n");
+    exit(1);
+}
+
+// --- UTILITÁRIOS ---
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static void zerar_envios(void) {
+    n_envios = 0;
+    ocupado[0] = ocupado[1] = false;
+}
+
+// Tráfego esperado, montado transação a transação
+static uint16_t esperado[MAX_PALAVRAS];
+static int n_esperado;
+
+static void transacao(uint8_t controle, const uint8_t *bytes, int n) {
+    esperado[n_esperado++] = controle;
+    for (int i = 0; i < n; i++) {
+        esperado[n_esperado++] = bytes[i];
+    }
+    esperado[n_esperado - 1] |= HAL_I2C_STOP;
+}
+
+// Endereçamento de uma área (colunas [c0, c1] das páginas [p0, p1]) e os seus dados
+static void area(int c0, int c1, int p0, int p1, const uint8_t *bytes) {
+    const uint8_t comandos[] = {0x21, c0, c1, 0x22, p0, p1};
+    transacao(0x00, comandos, sizeof(comandos));
+    transacao(0x40, bytes, (c1 - c0 + 1) * (p1 - p0 + 1));
+}
+
+// O envio 'i' foi para o barramento e endereço dados, com exatamente o tráfego esperado.
+// Na diferença, mostra a primeira palavra divergente.
+static bool trafego(int i, uint barramento, uint8_t endereco) {
+    if (i >= n_envios) {
+        printf("    envio %d nao aconteceu (%d envios)\n", i, n_envios);
+        return false;
+    }
+    const envio_t *e = &envios[i];
+    if (e->barramento != barramento || e->endereco != endereco) {
+        printf("    envio para i2c%u 0x%02X\n", e->barramento, e->endereco);
+        return false;
+    }
+    for (int k = 0; k < e->quantidade || k < n_esperado; k++) {
+        if (k >= e->quantidade || k >= n_esperado || e->copia[k] != esperado[k]) {
+            printf("    palavra %d: enviada %03X, esperada %03X (%d enviadas, %d esperadas)\n", k,
+                   k < e->quantidade ? e->copia[k] : 0, k < n_esperado ? esperado[k] : 0, e->quantidade, n_esperado);
+            return false;
+        }
+    }
+    return true;
+}
+
+static ssd1306_t painel, outro, terceiro;
+
+// --- CASOS ---
+static void testar_iniciar(void) {
+    zerar_envios();
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    const uint8_t comandos_64[] = {
+        0xAE, 0x20, 0x00, 0x40, 0xA1, 0xA8, 0x3F, 0xC8, 0xD3, 0x00, 0xDA, 0x12, 0xD5,
+        0x80, 0xD9, 0xF1, 0xDB, 0x30, 0x81, 0xFF, 0xA4, 0xA6, 0x8D, 0x14, 0x2E, 0xAF,
+    };
+    n_esperado = 0;
+    transacao(0x00, comandos_64, sizeof(comandos_64));
+    verificar(n_envios == 1 && trafego(0, 1, 0x3C), "inicializacao 128x64 numa unica transacao");
+
+    zerar_envios();
+    ssd1306_init(&outro, 0, 0x3D, 128, 32, true);
+    const uint8_t comandos_32[] = {
+        0xAE, 0x20, 0x00, 0x40, 0xA1, 0xA8, 0x1F, 0xC8, 0xD3, 0x00, 0xDA, 0x02, 0xD5,
+        0x80, 0xD9, 0x22, 0xDB, 0x30, 0x81, 0xFF, 0xA4, 0xA6, 0x8D, 0x10, 0x2E, 0xAF,
+    };
+    n_esperado = 0;
+    transacao(0x00, comandos_32, sizeof(comandos_32));
+    verificar(n_envios == 1 && trafego(0, 0, 0x3D), "128x32 com VCC externo, no i2c0 em 0x3D");
+}
+
+static void testar_comandos(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar_envios();
+    ssd1306_scroll(&painel, true);
+    ssd1306_send_command(&painel, 0xA7);
+    const uint8_t rolagem[] = {0x26, 0x00, 0x00, 0x00, 0x07, 0x00, 0xFF, 0x2F};
+    const uint8_t invertido[] = {0xA7};
+    bool certo = n_envios == 2;
+    n_esperado = 0;
+    transacao(0x00, rolagem, sizeof(rolagem));
+    certo = certo && trafego(0, 1, 0x3C);
+    n_esperado = 0;
+    transacao(0x00, invertido, sizeof(invertido));
+    verificar(certo && trafego(1, 1, 0x3C), "rolagem das 8 paginas e comando avulso");
+}
+
+static void testar_primeiro_quadro_e_diferencas(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar_envios();
+
+    // O conteúdo da GRAM é desconhecido: o primeiro envio leva todas as páginas
+    int areas = render_changes_on_display(&painel);
+    uint8_t zeros[128] = {0};
+    n_esperado = 0;
+    for (int p = 0; p < 8; p++) {
+        area(0, 127, p, p, zeros);
+    }
+    verificar(areas == 8 && n_envios == 1 && trafego(0, 1, 0x3C), "primeiro quadro: as 8 paginas num unico disparo");
+
+    zerar_envios();
+    verificar(render_changes_on_display(&painel) == 0 && n_envios == 0, "sem alteracoes, nada vai ao barramento");
+
+    // Só as colunas que diferem: o 'A' ocupa 5 das 6 colunas da célula
+    zerar_envios();
+    ssd1306_draw_string(&painel, 6, 8, "A");
+    ssd1306_set_pixel(&painel, 127, 63, true);
+    areas = render_changes_on_display(&painel);
+    const uint8_t letra_a[] = {0x7E, 0x11, 0x11, 0x11, 0x7E};
+    const uint8_t canto[] = {0x80};
+    n_esperado = 0;
+    area(6, 10, 1, 1, letra_a);
+    area(127, 127, 7, 7, canto);
+    verificar(areas == 2 && n_envios == 1 && trafego(0, 1, 0x3C), "so as colunas alteradas, uma area por pagina");
+
+    // Redesenhar o mesmo texto marca a página, mas não há o que enviar
+    zerar_envios();
+    ssd1306_clear_area(&painel, 0, 63, 1, 1);
+    ssd1306_draw_string(&painel, 6, 8, "A");
+    verificar(render_changes_on_display(&painel) == 0 && n_envios == 0, "quadro redesenhado igual nao gera trafego");
+
+    // Acima do quadro: as linhas visíveis do 'A' sobem para a página 0, que é marcada e enviada
+    zerar_envios();
+    ssd1306_draw_string(&painel, 6, -3, "A");
+    areas = render_changes_on_display(&painel);
+    const uint8_t letra_a_cortada[] = {0x0F, 0x02, 0x02, 0x02, 0x0F};
+    n_esperado = 0;
+    area(6, 10, 0, 0, letra_a_cortada);
+    verificar(areas == 1 && n_envios == 1 && trafego(0, 1, 0x3C), "texto cortado em cima marca e envia a pagina 0");
+}
+
+static void testar_barramento_ocupado(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    render_changes_on_display(&painel);
+    zerar_envios();
+
+    ocupado[1] = true;
+    ssd1306_set_pixel(&painel, 0, 0, true);
+    bool adiado = render_changes_on_display(&painel) == -1 && n_envios == 0;
+    ocupado[1] = false;
+    int areas = render_changes_on_display(&painel);
+    const uint8_t ponto[] = {0x01};
+    n_esperado = 0;
+    area(0, 0, 0, 0, ponto);
+    verificar(adiado && areas == 1 && trafego(0, 1, 0x3C), "barramento ocupado: a regiao fica marcada para o proximo envio");
+}
+
+// Quadro de trás e fila separados: desenhar durante a transmissão não altera o que está indo
+static void testar_desenho_durante_envio(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    render_changes_on_display(&painel);
+    zerar_envios();
+
+    ssd1306_draw_string(&painel, 0, 0, "Temp: 28.5 °C");
+    render_changes_on_display(&painel);
+    ocupado[1] = true;      // Ainda no DMA
+    ssd1306_clear(&painel);
+    ssd1306_draw_string(&painel, 0, 0, "Temp: 99.9 °C");
+    ssd1306_draw_string_scaled(&painel, 0, 16, "88", 3);
+    bool intacto = n_envios == 1 &&
+                   memcmp(envios[0].palavras, envios[0].copia, envios[0].quantidade * sizeof(uint16_t)) == 0;
+    verificar(intacto, "desenho no quadro de tras nao altera a fila em transito");
+}
+
+static void testar_varios_paineis(void) {
+    zerar_envios();
+    ssd1306_init(&painel, 0, 0x3C, 128, 64, false);
+    ssd1306_init(&outro, 1, 0x3C, 128, 64, false);
+    ssd1306_init(&terceiro, 1, 0x3D, 128, 32, false);
+    render_changes_on_display(&painel);
+    render_changes_on_display(&outro);
+    render_changes_on_display(&terceiro);
+    bool certo = n_envios == 6 && envios[3].barramento == 0 && envios[4].barramento == 1 &&
+                 envios[5].barramento == 1 && envios[5].endereco == 0x3D && envios[5].quantidade == 4 * (7 + 129);
+
+    zerar_envios();
+    ssd1306_set_pixel(&painel, 1, 0, true);
+    ssd1306_set_pixel(&outro, 2, 8, true);
+    ssd1306_set_pixel(&terceiro, 3, 31, true);
+    render_changes_on_display(&painel);
+    render_changes_on_display(&outro);
+    ocupado[1] = true;      // O envio do segundo painel ocupa o i2c1 para o terceiro
+    certo = certo && render_changes_on_display(&terceiro) == -1;
+    ocupado[1] = false;
+    render_changes_on_display(&terceiro);
+
+    const uint8_t p1[] = {0x01}, p2[] = {0x01}, p3[] = {0x80};
+    n_esperado = 0;
+    area(1, 1, 0, 0, p1);
+    certo = certo && trafego(0, 0, 0x3C);
+    n_esperado = 0;
+    area(2, 2, 1, 1, p2);
+    certo = certo && trafego(1, 1, 0x3C);
+    n_esperado = 0;
+    area(3, 3, 3, 3, p3);
+    verificar(certo && trafego(2, 1, 0x3D), "tres paineis em dois barramentos, cada um com o seu quadro");
+}
+
+static void testar_bitmap_e_quadro_inteiro(void) {
+    static uint8_t bitmap[1024];
+    for (int i = 0; i < 1024; i++) {
+        bitmap[i] = (uint8_t)(i * 37) | 1;     // Nenhum byte igual ao quadro apagado
+    }
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    render_changes_on_display(&painel);
+    zerar_envios();
+    ssd1306_draw_bitmap(&painel, bitmap);
+    bool sem_envio = n_envios == 0;
+    render_changes_on_display(&painel);
+    n_esperado = 0;
+    for (int p = 0; p < 8; p++) {
+        area(0, 127, p, p, bitmap + p * 128);
+    }
+    verificar(sem_envio && n_envios == 1 && trafego(0, 1, 0x3C), "bitmap: copiado no quadro e enviado uma vez, no render");
+
+    zerar_envios();
+    ssd1306_clear(&painel);
+    ssd1306_draw_string(&painel, 0, 0, "Inicializando...");
+    render_on_display(&painel);
+    n_esperado = 0;
+    area(0, 127, 0, 7, painel.buffer);
+    bool inteiro = n_envios == 1 && trafego(0, 1, 0x3C);
+    zerar_envios();
+    verificar(inteiro && render_changes_on_display(&painel) == 0 && n_envios == 0,
+              "quadro inteiro numa area so, e depois nada pendente");
+}
+
+int main(void) {
+    testar_iniciar();
+    testar_comandos();
+    testar_primeiro_quadro_e_diferencas();
+    testar_barramento_ocupado();
+    testar_desenho_durante_envio();
+    testar_varios_paineis();
+    testar_bitmap_e_quadro_inteiro();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,454 @@
+/**
+ * Testes, no computador, da telemetria MQTT (inc/telemetria_mqtt.c) contra um broker substituto
+ * roteirizado, no lugar de um Mosquitto de verdade. O broker implementa a API do cliente MQTT do
+ * lwIP (simulador/include/lwip/apps/mqtt.h): cada CONNECT, PUBLISH e PUBACK acontece quando o
+ * roteiro manda, com o relógio da HAL (hal_tempo_us) avançando um passo da tarefa por vez.
+ * Cobre a conexão (last will, "online" retido), a espera entre tentativas, o lote no intervalo
+ * normal, a drenagem da fila acumulada com um lote em voo, o reenvio depois de falha ou queda,
+ * a perda das amostras sobrescritas e o lock da rede (hal_rede_travar) em toda chamada ao lwIP.
+ * Usa os cabeçalhos do SDK e do lwIP do simulador:
+ *
+ *   cc -Wall -O2 -I.. -I../simulador/include -o testar_telemetria_mqtt testar_telemetria_mqtt.c \
+ *      ../inc/telemetria_mqtt.c ../inc/historico.c ../inc/json.c ../inc/formato.c
+ *   ./testar_telemetria_mqtt
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "inc/hal.h"
+#include "inc/historico.h"
+#include "inc/telemetria_mqtt.h"
+#include "lwip/apps/mqtt.h"
+
+#define TOPICO "fazenda/curral-1/amostras"
+#define INTERVALO_MS (5 * 60 * 1000)
+#define LOTE_MAXIMO 15
+#define MAX_SEQUENCIAS 8192
+
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+// --- HAL: relógio do roteiro e o lock da rede ---
+static uint64_t agora_us = 1000000;
+static int travas;
+
+uint64_t hal_tempo_us(void) {
+    return agora_us;
+}
+
+void hal_rede_travar(void) {
+    travas++;
+}
+
+void hal_rede_liberar(void) {
+    travas--;
+}
+
+int ipaddr_aton(const char *texto, ip_addr_t *endereco) {
+    struct in_addr a;
+    if (inet_pton(AF_INET, texto, &a) != 1) {
+        return 0;
+    }
+    endereco->addr = a.s_addr;
+    return 1;
+}
+
+// --- BROKER SUBSTITUTO ---
+static struct {
+    bool conectado;
+    bool connack_pendente;              // CONNECT recebido, CONNACK ainda não enviado
+    mqtt_connection_cb_t ao_conectar;
+    void *arg_conectar;
+    mqtt_client_t *cliente;
+    int tentativas;
+    uint64_t tempo_tentativa;
+    char will_topico[64];
+    char will_msg[16];
+    u8_t will_qos, will_retain;
+    u16_t porta;
+    ip_addr_t endereco;
+
+    bool online_retido;
+    int publicacoes;                    // PUBLISHs de lotes recebidos
+    bool puback_pendente;
+    mqtt_request_cb_t ao_confirmar;
+    void *arg_confirmar;
+    uint32_t lote_seq;                  // Lote aguardando o PUBACK
+    int lote_quantidade;
+    bool lote_valido;                   // Payload bem formado e amostras iguais às do histórico
+
+    uint8_t entregues[MAX_SEQUENCIAS];  // Vezes que cada sequência foi confirmada
+    int chamadas_sem_trava;
+} broker;
+
+static amostra_t amostra_numero(uint32_t n) {
+    return (amostra_t){
+        .epoch = 1751328000 + n * 60,
+        .temperatura = (int16_t)(200 + n % 150),
+        .umidade = (int16_t)(950 - n % 400),
+        .luminosidade = (int16_t)(n * 7 % 1001),
+        .reles = n % 8,
+    };
+}
+
+static void exigir_trava(void) {
+    if (travas <= 0) broker.chamadas_sem_trava++;
+}
+
+err_t mqtt_client_connect(mqtt_client_t *cliente, const ip_addr_t *endereco, u16_t porta, mqtt_connection_cb_t funcao,
+                          void *arg, const struct mqtt_connect_client_info_t *info) {
+    exigir_trava();
+    if (broker.conectado || broker.connack_pendente) {
+        return ERR_USE;
+    }
+    broker.cliente = cliente;
+    broker.connack_pendente = true;
+    broker.ao_conectar = funcao;
+    broker.arg_conectar = arg;
+    broker.tentativas++;
+    broker.tempo_tentativa = agora_us;
+    broker.porta = porta;
+    broker.endereco = *endereco;
+    snprintf(broker.will_topico, sizeof(broker.will_topico), "%s", info->will_topic ? info->will_topic : "");
+    snprintf(broker.will_msg, sizeof(broker.will_msg), "%s", info->will_msg ? info->will_msg : "");
+    broker.will_qos = info->will_qos;
+    broker.will_retain = info->will_retain;
+    return ERR_OK;
+}
+
+// Como no lwIP: fecha sem chamar a callback de conexão e descarta o que aguardava confirmação
+void mqtt_disconnect(mqtt_client_t *cliente) {
+    exigir_trava();
+    broker.conectado = false;
+    broker.connack_pendente = false;
+    broker.puback_pendente = false;
+}
+
+u8_t mqtt_client_is_connected(mqtt_client_t *cliente) {
+    exigir_trava();
+    return broker.conectado;
+}
+
+// Lê {"seq":N,"amostras":[[epoch,t,u,l,reles],...]} e compara cada amostra com a do histórico
+static bool ler_lote(const char *payload, uint32_t *seq, int *quantidade) {
+    unsigned s;
+    int n;
+    if (sscanf(payload, "{\"seq\":%u,\"amostras\":[%n", &s, &n) != 1) {
+        return false;
+    }
+    const char *p = payload + n;
+    *seq = s;
+    *quantidade = 0;
+    while (*p == '[') {
+        unsigned epoch, reles;
+        int t, u, l;
+        if (sscanf(p, "[%u,%d,%d,%d,%u]%n", &epoch, &t, &u, &l, &reles, &n) != 5) {
+            return false;
+        }
+        amostra_t a = amostra_numero(s + *quantidade);
+        if (epoch != a.epoch || t != a.temperatura || u != a.umidade || l != a.luminosidade || reles != a.reles) {
+            return false;
+        }
+        (*quantidade)++;
+        p += n;
+        if (*p == ',') p++;
+    }
+    return strcmp(p, "]}") == 0;
+}
+
+err_t mqtt_publish(mqtt_client_t *cliente, const char *topico, const void *payload, u16_t tamanho, u8_t qos,
+                   u8_t reter, mqtt_request_cb_t funcao, void *arg) {
+    exigir_trava();
+    if (!broker.conectado) {
+        return ERR_CONN;
+    }
+    char texto[TELEMETRIA_MQTT_PAYLOAD_MAX + 1];
+    if (tamanho > TELEMETRIA_MQTT_PAYLOAD_MAX) {
+        broker.lote_valido = false;
+        return ERR_MEM;
+    }
+    memcpy(texto, payload, tamanho);
+    texto[tamanho] = '\0';
+
+    if (strcmp(topico, TOPICO "/estado") == 0) {
+        broker.online_retido = strcmp(texto, "online") == 0 && qos == 1 && reter;
+        return ERR_OK;
+    }
+    broker.publicacoes++;
+    broker.lote_valido = strcmp(topico, TOPICO) == 0 && qos == 1 && !reter && funcao &&
+                         ler_lote(texto, &broker.lote_seq, &broker.lote_quantidade);
+    broker.puback_pendente = true;
+    broker.ao_confirmar = funcao;
+    broker.arg_confirmar = arg;
+    return ERR_OK;
+}
+
+// Ações do broker; as callbacks rodam no contexto da rede, que na placa já tem o lock
+static void broker_connack(mqtt_connection_status_t status) {
+    broker.connack_pendente = false;
+    broker.conectado = status == MQTT_CONNECT_ACCEPTED;
+    travas++;
+    broker.ao_conectar(broker.cliente, broker.arg_conectar, status);
+    travas--;
+}
+
+static void broker_puback(err_t err) {
+    broker.puback_pendente = false;
+    if (err == ERR_OK) {
+        for (int i = 0; i < broker.lote_quantidade; i++) {
+            uint32_t s = broker.lote_seq + i;
+            if (s < MAX_SEQUENCIAS) broker.entregues[s]++;
+        }
+    }
+    travas++;
+    broker.ao_confirmar(broker.arg_confirmar, err);
+    travas--;
+}
+
+// A conexão cai do lado do broker com um lote em voo: o PUBACK nunca chega
+static void broker_cair(void) {
+    broker.conectado = false;
+    broker.puback_pendente = false;
+    travas++;
+    broker.ao_conectar(broker.cliente, broker.arg_conectar, MQTT_CONNECT_DISCONNECTED);
+    travas--;
+}
+
+// --- ROTEIRO ---
+static bool travas_equilibradas = true;
+static uint64_t tempo_iniciar;          // hal_tempo_us() em telemetria_mqtt_iniciar()
+
+static void passo(void) {
+    agora_us += TELEMETRIA_MQTT_PASSO_MS * 1000ull;
+    telemetria_mqtt_tarefa(NULL);
+    if (travas != 0) travas_equilibradas = false;
+}
+
+static void enlace(bool ativo) {
+    telemetria_mqtt_enlace(ativo);
+    if (travas != 0) travas_equilibradas = false;
+}
+
+static void adicionar(int quantidade) {
+    for (int i = 0; i < quantidade; i++) {
+        amostra_t a = amostra_numero(historico_proxima_sequencia());
+        historico_adicionar(&a);
+    }
+}
+
+// Passos e confirmações até a fila esvaziar. Retorna quantos lotes saíram; *em_voo_extra conta
+// publicações feitas com outro lote ainda sem PUBACK.
+static int drenar(int max_passos, bool *lotes_validos, int *em_voo_extra) {
+    int lotes = 0;
+    for (int i = 0; i < max_passos; i++) {
+        int antes = broker.publicacoes;
+        bool aguardava = broker.puback_pendente;
+        passo();
+        if (aguardava && broker.publicacoes != antes) (*em_voo_extra)++;
+        // Um passo sem PUBACK a cada três: o lote seguinte não pode sair antes dele
+        if (broker.puback_pendente && i % 3 != 0) {
+            if (!broker.lote_valido) *lotes_validos = false;
+            broker_puback(ERR_OK);
+            lotes++;
+        }
+        if (historico_proxima_sequencia() == broker.lote_seq + broker.lote_quantidade && !broker.puback_pendente &&
+            lotes > 0) {
+            break;
+        }
+    }
+    return lotes;
+}
+
+static void testar_conexao(void) {
+    telemetria_mqtt_config_t config = {
+        .broker = "nao-e-um-ip",
+        .porta = 1883,
+        .cliente = "pico-teste",
+        .topico = TOPICO,
+        .intervalo_ms = INTERVALO_MS,
+        .lote_maximo = LOTE_MAXIMO,
+    };
+    verificar(!telemetria_mqtt_iniciar(&config, 0), "endereço de broker inválido é recusado");
+    config.broker = "192.168.0.10";
+    historico_iniciar();
+    tempo_iniciar = agora_us;
+    verificar(telemetria_mqtt_iniciar(&config, historico_proxima_sequencia()), "configuração válida");
+
+    for (int i = 0; i < 5; i++) passo();
+    verificar(broker.tentativas == 0, "sem enlace, nenhuma tentativa de conexão");
+
+    enlace(true);
+    passo();
+    ip_addr_t esperado;
+    ipaddr_aton("192.168.0.10", &esperado);
+    verificar(broker.tentativas == 1 && broker.porta == 1883 && broker.endereco.addr == esperado.addr,
+              "com enlace, conecta no primeiro passo");
+    verificar(strcmp(broker.will_topico, TOPICO "/estado") == 0 && strcmp(broker.will_msg, "offline") == 0 &&
+              broker.will_qos == 1 && broker.will_retain,
+              "last will \"offline\" retido em <topico>/estado");
+
+    // Recusado: a próxima tentativa só depois de RECONEXAO_MS (10 s, cinco passos)
+    uint64_t primeira = broker.tempo_tentativa;
+    broker_connack(MQTT_CONNECT_REFUSED_SERVER);
+    for (int i = 0; i < 4; i++) passo();
+    bool esperou = broker.tentativas == 1;
+    passo();
+    verificar(esperou && broker.tentativas == 2 && broker.tempo_tentativa - primeira == 10000000,
+              "recusa: nova tentativa só depois de 10 s");
+
+    passo();
+    verificar(broker.tentativas == 2, "CONNACK pendente: não tenta de novo");
+    broker_connack(MQTT_CONNECT_ACCEPTED);
+    verificar(broker.online_retido, "conectado: publica \"online\" retido");
+}
+
+static void testar_intervalo(void) {
+    // Com a fila em dia, o lote sai quando vence o intervalo desde a última publicação
+    uint32_t primeira = historico_proxima_sequencia();
+    adicionar(3);
+    int passos = 0;
+    while (broker.publicacoes == 0 && passos < 1000) {
+        passo();
+        passos++;
+    }
+    // Ainda sem publicações, o intervalo conta desde telemetria_mqtt_iniciar()
+    uint64_t decorrido = agora_us - tempo_iniciar;
+    verificar(broker.publicacoes == 1 && decorrido >= INTERVALO_MS * 1000ull &&
+              decorrido < (INTERVALO_MS + TELEMETRIA_MQTT_PASSO_MS) * 1000ull,
+              "fila em dia: um lote quando vence o intervalo");
+    verificar(broker.lote_valido && broker.lote_seq == primeira && broker.lote_quantidade == 3,
+              "lote com as três amostras, a partir da sequência certa");
+
+    for (int i = 0; i < 200; i++) passo();
+    verificar(broker.publicacoes == 1, "nada mais sai com o lote aguardando o PUBACK");
+    broker_puback(ERR_OK);
+
+    adicionar(2);
+    for (int i = 0; i < 140; i++) passo();
+    verificar(broker.publicacoes == 1, "depois do PUBACK, espera o intervalo de novo");
+    for (int i = 0; i < 20 && broker.publicacoes == 1; i++) passo();
+    verificar(broker.publicacoes == 2 && broker.lote_seq == primeira + 3 && broker.lote_quantidade == 2,
+              "o lote seguinte começa depois do confirmado");
+    broker_puback(ERR_OK);
+}
+
+static void testar_drenagem(void) {
+    // Wi-Fi fora: as amostras se acumulam; na volta, um lote cheio por passo
+    enlace(false);
+    verificar(!broker.conectado, "enlace caiu: desconecta do broker");
+    uint32_t primeira = historico_proxima_sequencia();
+    adicionar(200);
+    int tentativas = broker.tentativas;
+    for (int i = 0; i < 30; i++) passo();
+    verificar(broker.tentativas == tentativas, "sem enlace, as amostras só se acumulam");
+
+    enlace(true);
+    passo();
+    broker_connack(MQTT_CONNECT_ACCEPTED);
+    int publicacoes = broker.publicacoes;
+    bool validos = true;
+    int em_voo_extra = 0;
+    int lotes = 0;
+    // Lotes cheios enquanto houver atraso; os 5 restantes (200 = 13 * 15 + 5) esperam o intervalo
+    while (lotes < 13) {
+        int antes = broker.publicacoes;
+        passo();
+        if (broker.publicacoes != antes) {
+            if (!broker.lote_valido || broker.lote_quantidade != LOTE_MAXIMO ||
+                broker.lote_seq != primeira + lotes * LOTE_MAXIMO) {
+                validos = false;
+            }
+            passo();    // Sem PUBACK ainda
+            if (broker.publicacoes != antes + 1) em_voo_extra++;
+            broker_puback(ERR_OK);
+            lotes++;
+        }
+        if (broker.publicacoes - publicacoes > 20) break;
+    }
+    verificar(validos && lotes == 13, "atraso: lotes cheios, em ordem, um por passo");
+    verificar(em_voo_extra == 0, "nunca mais de um lote em voo");
+    verificar(drenar(200, &validos, &em_voo_extra) == 1 && broker.lote_quantidade == 5 && validos,
+              "o resto da fila sai no intervalo normal");
+}
+
+static void testar_reenvio(void) {
+    uint32_t primeira = historico_proxima_sequencia();
+    adicionar(40);
+    passo();
+    verificar(broker.puback_pendente && broker.lote_seq == primeira, "lote publicado");
+    broker_puback(ERR_TIMEOUT);
+    passo();
+    verificar(broker.puback_pendente && broker.lote_seq == primeira && broker.lote_quantidade == LOTE_MAXIMO,
+              "falha no PUBACK: o mesmo lote é reenviado");
+    broker_puback(ERR_OK);
+
+    passo();
+    verificar(broker.puback_pendente && broker.lote_seq == primeira + LOTE_MAXIMO, "lote seguinte em voo");
+    broker_cair();
+    passo();
+    verificar(!broker.puback_pendente && broker.tentativas > 0, "queda com lote em voo: reconecta");
+    for (int i = 0; i < 5 && !broker.connack_pendente; i++) passo();
+    broker_connack(MQTT_CONNECT_ACCEPTED);
+    passo();
+    verificar(broker.puback_pendente && broker.lote_seq == primeira + LOTE_MAXIMO,
+              "depois da queda, o lote não confirmado é reenviado");
+    broker_puback(ERR_OK);
+    bool validos = true;
+    int em_voo_extra = 0;
+    drenar(400, &validos, &em_voo_extra);
+    verificar(validos && em_voo_extra == 0 && !broker.puback_pendente, "fila esvaziada depois do reenvio");
+}
+
+static void testar_perda(void) {
+    // Fora por mais tempo que o histórico guarda: as sobrescritas se perdem, o resto sai
+    enlace(false);
+    uint32_t inicio_perda = historico_proxima_sequencia();
+    adicionar(HISTORICO_CAPACIDADE + 100);
+    enlace(true);
+    passo();
+    broker_connack(MQTT_CONNECT_ACCEPTED);
+    passo();
+    verificar(broker.puback_pendente && broker.lote_seq == historico_primeira_sequencia() &&
+              broker.lote_seq == inicio_perda + 100,
+              "volta depois de estourar: começa na amostra mais antiga");
+    broker_puback(ERR_OK);
+    bool validos = true;
+    int em_voo_extra = 0;
+    drenar(2000, &validos, &em_voo_extra);
+    verificar(validos && em_voo_extra == 0, "fila de HISTORICO_CAPACIDADE drenada");
+
+    // Cada amostra foi confirmada exatamente uma vez, menos as sobrescritas
+    bool uma_vez = true;
+    for (uint32_t s = 0; s < historico_proxima_sequencia(); s++) {
+        bool perdida = s >= inicio_perda && s < inicio_perda + 100;
+        if (broker.entregues[s] != (perdida ? 0 : 1)) uma_vez = false;
+    }
+    verificar(uma_vez, "cada amostra entregue uma vez, exceto as perdidas");
+}
+
+int main(void) {
+    testar_conexao();
+    testar_intervalo();
+    testar_drenagem();
+    testar_reenvio();
+    testar_perda();
+
+    verificar(broker.chamadas_sem_trava == 0, "toda chamada ao lwIP com hal_rede_travar()");
+    verificar(travas_equilibradas, "travar e liberar sempre em pares");
+
+    printf("\n");
+    telemetria_mqtt_imprimir_estatisticas();
+    verificar(broker.chamadas_sem_trava == 0, "estatísticas lidas com hal_rede_travar()");
+    printf("\n%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
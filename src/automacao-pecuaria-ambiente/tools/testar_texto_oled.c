@@ -0,0 +1,288 @@
+/**
+ * Testes, no computador, do texto no quadro do OLED (inc/oled_texto.c): o quadro desenhado é
+ * comparado com imagens de referência em arte ASCII ('#' aceso, '.' apagado). Não depende do SDK
+ * do Pico:
+ *
+ *   cc -O2 -I.. -o testar_texto_oled testar_texto_oled.c ../inc/oled_texto.c
+ *   ./testar_texto_oled
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/oled_texto.h"
+
+#define LARGURA 128
+#define PAGINAS 8
+#define GUARDA 16       // Bytes depois do quadro que nada pode tocar
+
+static int falhas;
+static uint8_t memoria[LARGURA * PAGINAS + GUARDA];
+static const oled_quadro_t quadro = {memoria, LARGURA, PAGINAS};
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static void limpar(uint8_t valor) {
+    memset(memoria, valor, LARGURA * PAGINAS);
+    memset(memoria + LARGURA * PAGINAS, 0x5A, GUARDA);
+}
+
+static bool guarda_intacta(void) {
+    for (int i = 0; i < GUARDA; i++) {
+        if (memoria[LARGURA * PAGINAS + i] != 0x5A) return false;
+    }
+    return true;
+}
+
+static bool pixel(int x, int y) {
+    return memoria[(y / 8) * LARGURA + x] & (1u << (y % 8));
+}
+
+// Compara o retângulo com canto em (x, y) com a imagem de referência, uma linha por '\n'.
+// Na diferença, mostra as duas lado a lado.
+static bool imagem(int x, int y, const char *referencia) {
+    bool igual = true;
+    int linhas = 0;
+    for (const char *p = referencia; *p; linhas++) {
+        const char *fim = strchr(p, '\n');
+        int largura = fim ? (int)(fim - p) : (int)strlen(p);
+        for (int i = 0; i < largura; i++) {
+            if (pixel(x + i, y + linhas) != (p[i] == '#')) igual = false;
+        }
+        p += largura + (fim ? 1 : 0);
+    }
+    if (!igual) {
+        const char *p = referencia;
+        for (int l = 0; l < linhas; l++) {
+            const char *fim = strchr(p, '\n');
+            int largura = fim ? (int)(fim - p) : (int)strlen(p);
+            printf("    %.*s   ", largura, p);
+            for (int i = 0; i < largura; i++) putchar(pixel(x + i, y + l) ? '#' : '.');
+            putchar('\n');
+            p += largura + (fim ? 1 : 0);
+        }
+    }
+    return igual;
+}
+
+static void testar_alinhado(void) {
+    limpar(0);
+    int fim = oled_texto_desenhar(&quadro, 0, 8, "A1", 1);
+    verificar(fim == 12, "avanca 6 colunas por caractere");
+    verificar(imagem(0, 7,
+                     "............\n"
+                     ".###....#...\n"
+                     "#...#..##...\n"
+                     "#...#...#...\n"
+                     "#...#...#...\n"
+                     "#####...#...\n"
+                     "#...#...#...\n"
+                     "#...#..###..\n"
+                     "............\n"
+                     "............"),
+              "maiuscula e algarismo alinhados a pagina");
+}
+
+// A mesma célula em y = 11 ocupa as linhas 3 a 7 da página 1 e 0 a 2 da página 2
+static void testar_desalinhado(void) {
+    limpar(0);
+    oled_texto_desenhar(&quadro, 2, 11, "%:", 1);
+    verificar(imagem(0, 10,
+                     "..............\n"
+                     "..##..........\n"
+                     "..##..#..##...\n"
+                     ".....#...##...\n"
+                     "....#.........\n"
+                     "...#.....##...\n"
+                     "..#..##..##...\n"
+                     ".....##.......\n"
+                     "..............\n"
+                     ".............."),
+              "'%' e ':' deslocados 3 linhas dentro da pagina");
+}
+
+// Todos os glifos em todos os y de uma página: o caminho deslocado tem de dar os mesmos pixels
+// que a cópia direta da célula alinhada
+static void testar_caminhos_equivalentes(void) {
+    bool iguais = true;
+    for (int c = 0x20; c < 0x100 && iguais; c++) {
+        if (c > 0x7E && c < 0xA0) continue;
+        limpar(0);
+        oled_texto_caractere(&quadro, 0, 0, (uint8_t)c, 1);
+        uint8_t referencia[OLED_FONTE_LARGURA];
+        memcpy(referencia, memoria, sizeof(referencia));
+        for (int y = 1; y <= 56 && iguais; y++) {
+            limpar(0);
+            oled_texto_caractere(&quadro, 0, y, (uint8_t)c, 1);
+            for (int x = 0; x < OLED_FONTE_LARGURA; x++) {
+                for (int l = 0; l < 8; l++) {
+                    if (pixel(x, y + l) != ((referencia[x] >> l) & 1)) iguais = false;
+                }
+            }
+        }
+    }
+    verificar(iguais, "deslocado igual ao alinhado para os 191 glifos e y de 1 a 56");
+}
+
+// A célula é opaca: apaga o fundo dentro dela e não toca em nada fora
+static void testar_celula_opaca(void) {
+    limpar(0xFF);
+    oled_texto_desenhar(&quadro, 1, 5, ".", 1);
+    verificar(imagem(0, 3,
+                     "########\n"
+                     "########\n"
+                     "#......#\n"
+                     "#......#\n"
+                     "#......#\n"
+                     "#......#\n"
+                     "#......#\n"
+                     "#.##...#\n"
+                     "#.##...#\n"
+                     "#......#\n"
+                     "########"),
+              "fundo da celula apagado, vizinhanca intacta");
+}
+
+static void testar_ampliado(void) {
+    limpar(0);
+    int fim = oled_texto_desenhar(&quadro, 0, 4, "1", 2);
+    verificar(fim == 12, "escala 2 avanca 12 colunas");
+    verificar(imagem(0, 4,
+                     "....##......\n"
+                     "....##......\n"
+                     "..####......\n"
+                     "..####......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "....##......\n"
+                     "..######....\n"
+                     "..######....\n"
+                     "............\n"
+                     "............"),
+              "'1' em escala 2, cobrindo tres paginas");
+}
+
+static void testar_latin1(void) {
+    limpar(0);
+    int fim = oled_texto_desenhar(&quadro, 0, 0, "çãÉ°", 1);
+    verificar(fim == 24, "UTF-8 de dois bytes conta como um caractere");
+    verificar(imagem(0, 0,
+                     ".......##.#....#...##...\n"
+                     "......#..#....#...#..#..\n"
+                     ".###...###..#####.#..#..\n"
+                     "#.........#.#......##...\n"
+                     "#......####.####........\n"
+                     "#...#.#...#.#...........\n"
+                     ".###...####.#####.......\n"
+                     ".##....................."),
+              "cedilha, til, acento em maiuscula e grau");
+}
+
+static void testar_fora_da_fonte(void) {
+    limpar(0);
+    oled_texto_desenhar(&quadro, 0, 0, "?", 1);
+    uint8_t interrogacao[OLED_FONTE_LARGURA];
+    memcpy(interrogacao, memoria, sizeof(interrogacao));
+
+    limpar(0);
+    int fim = oled_texto_desenhar(&quadro, 0, 0, "\xE2\x82\xAC\xFF\t", 1);   // Euro, byte inválido, tabulação
+    bool iguais = fim == 3 * OLED_FONTE_LARGURA;
+    for (int i = 0; i < 3; i++) {
+        iguais &= memcmp(memoria + i * OLED_FONTE_LARGURA, interrogacao, OLED_FONTE_LARGURA) == 0;
+    }
+    verificar(iguais, "fora do Latin-1, malformado ou de controle vira '?'");
+    verificar(oled_texto_largura("ação", 1) == 24 && oled_texto_largura("ação", 2) == 48, "largura em pixels");
+}
+
+static void testar_cortes(void) {
+    limpar(0);
+    oled_texto_desenhar(&quadro, LARGURA - 3, 0, "AB", 1);
+    verificar(imagem(LARGURA - 3, 0,
+                     ".##\n"
+                     "#..\n"
+                     "#..\n"
+                     "#..\n"
+                     "###\n"
+                     "#..\n"
+                     "#..\n"
+                     "...")
+              && memoria[LARGURA] == 0, "cortado na borda direita, sem passar para a pagina seguinte");
+
+    limpar(0);
+    oled_texto_desenhar(&quadro, 0, 60, "A", 2);
+    verificar(imagem(0, 60,
+                     "..######....\n"
+                     "..######....\n"
+                     "##......##..\n"
+                     "##......##..")
+              && guarda_intacta(), "cortado embaixo, sem escrever alem do quadro");
+
+    limpar(0);
+    oled_texto_desenhar(&quadro, -4, 0, "AB", 1);
+    verificar(imagem(0, 0,
+                     "..####...\n"
+                     "#.#...#..\n"
+                     "#.#...#..\n"
+                     "#.####...\n"
+                     "#.#...#..\n"
+                     "#.#...#..\n"
+                     "#.####...\n"
+                     "........."),
+              "cortado na borda esquerda");
+
+    limpar(0xFF);
+    oled_texto_desenhar(&quadro, 0, -3, "A1", 1);
+    verificar(imagem(0, 0,
+                     "#...#...#...\n"
+                     "#####...#...\n"
+                     "#...#...#...\n"
+                     "#...#..###..\n"
+                     "............\n"
+                     "############")
+              && memoria[LARGURA] == 0xFF, "cortado em cima: so as linhas de baixo, na pagina 0");
+
+    limpar(0);
+    oled_texto_desenhar(&quadro, 0, -10, "A", 2);
+    verificar(imagem(0, 0,
+                     "##......##..\n"
+                     "##......##..\n"
+                     "##......##..\n"
+                     "##......##..\n"
+                     "............\n"
+                     "............")
+              && memoria[LARGURA] == 0, "ampliado e cortado em cima");
+
+    limpar(0);
+    oled_texto_desenhar(&quadro, 0, -8, "A", 1);
+    oled_texto_desenhar(&quadro, 0, -24, "A", 3);
+    oled_texto_desenhar(&quadro, 0, 64, "A", 1);
+    bool vazio = guarda_intacta();
+    for (int i = 0; i < LARGURA * PAGINAS; i++) vazio &= memoria[i] == 0;
+    verificar(vazio, "inteiro acima ou abaixo do quadro nao desenha");
+}
+
+int main(void) {
+    testar_alinhado();
+    testar_desalinhado();
+    testar_caminhos_equivalentes();
+    testar_celula_opaca();
+    testar_ampliado();
+    testar_latin1();
+    testar_fora_da_fonte();
+    testar_cortes();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * Testes, no computador, do transporte I2C do driver do SSD1306 (inc/ssd1306_i2c.c). A HAL do I2C
+ * é trocada por um dublê do DMA: cada disparo fica "em trânsito" por algumas consultas a
+ * hal_i2c_ocupado() e só então é posto no fio, lendo a fila do driver naquele momento. O fio é
+ * registrado como o analisador lógico o veria (S = START, endereço de escrita, bytes, P = STOP),
+ * e comparado byte a byte. Usa os cabeçalhos do SDK do simulador:
+ *
+ *   cc -O2 -I.. -I../simulador/include -o testar_transporte_i2c testar_transporte_i2c.c \
+ *       ../inc/ssd1306_i2c.c ../inc/oled_texto.c ../inc/oled_grafico.c
+ *   ./testar_transporte_i2c
+ *
+ * Retorna 0 se todos os casos passarem.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/hal.h"
+#include "inc/ssd1306.h"
+
+#define MAX_FIO 4096
+#define CONSULTAS_EM_TRANSITO 5
+
+// Marcadores do fio, fora da faixa de um byte
+#define S 0x100
+#define P 0x200
+
+// --- DUBLÊ DO DMA ---
+static const uint16_t *em_transito;     // Fila do driver, lida só quando "transmitida"
+static int quantidade_em_transito;
+static uint8_t endereco_em_transito;
+static int consultas_restantes;
+static int disparos;
+static int disparos_sobrepostos;        // Disparos com outro ainda em trânsito
+static int consultas;
+
+static uint16_t fio[MAX_FIO];
+static int n_fio;
+
+static void registrar(uint16_t simbolo) {
+    if (n_fio == MAX_FIO) {
+        printf("    fio cheio\n");
+        exit(1);
+    }
+    fio[n_fio++] = simbolo;
+}
+
+// O DMA terminou: as palavras vão para o fio, com um START e o endereço antes de cada transação
+static void transmitir(void) {
+    bool inicio = true;
+    for (int i = 0; i < quantidade_em_transito; i++) {
+        if (inicio) {
+            registrar(S);
+            registrar((uint16_t)(endereco_em_transito << 1));
+            inicio = false;
+        }
+        registrar(em_transito[i] & 0xFF);
+        if (em_transito[i] & HAL_I2C_STOP) {
+            registrar(P);
+            inicio = true;
+        }
+    }
+    em_transito = NULL;
+}
+
+void hal_i2c_iniciar(uint barramento, uint sda, uint scl, uint32_t frequencia_hz) {
+}
+
+void hal_i2c_enviar(uint barramento, uint8_t endereco, const uint16_t *palavras, int quantidade) {
+    if (em_transito) {
+        disparos_sobrepostos++;
+        transmitir();
+    }
+    em_transito = palavras;
+    quantidade_em_transito = quantidade;
+    endereco_em_transito = endereco;
+    consultas_restantes = CONSULTAS_EM_TRANSITO;
+    disparos++;
+}
+
+bool hal_i2c_ocupado(uint barramento) {
+    consultas++;
+    if (em_transito && --consultas_restantes == 0) {
+        transmitir();
+    }
+    return em_transito != NULL;
+}
+
+void hal_i2c_escrever(uint barramento, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    printf("    escrita bloqueante inesperada\n");
+    exit(1);
+}
+
+// --- UTILITÁRIOS ---
+static int falhas;
+
+static void verificar(bool condicao, const char *caso) {
+    printf("%-60s %s\n", caso, condicao ? "ok" : "FALHOU");
+    if (!condicao) falhas++;
+}
+
+static void zerar(void) {
+    while (hal_i2c_ocupado(1)) {
+    }
+    n_fio = 0;
+    disparos = 0;
+    disparos_sobrepostos = 0;
+    consultas = 0;
+}
+
+// Fio esperado, montado transação a transação, com o painel em 0x3C
+static uint16_t esperado[MAX_FIO];
+static int n_esperado;
+
+static void transacao(uint8_t controle, const uint8_t *bytes, int n) {
+    esperado[n_esperado++] = S;
+    esperado[n_esperado++] = 0x3C << 1;
+    esperado[n_esperado++] = controle;
+    for (int i = 0; i < n; i++) {
+        esperado[n_esperado++] = bytes[i];
+    }
+    esperado[n_esperado++] = P;
+}
+
+static bool fio_igual(void) {
+    for (int k = 0; k < n_fio || k < n_esperado; k++) {
+        if (k >= n_fio || k >= n_esperado || fio[k] != esperado[k]) {
+            printf("    simbolo %d: no fio %03X, esperado %03X (%d no fio, %d esperados)\n", k,
+                   k < n_fio ? fio[k] : 0, k < n_esperado ? esperado[k] : 0, n_fio, n_esperado);
+            return false;
+        }
+    }
+    return true;
+}
+
+static ssd1306_t painel;
+
+// --- CASOS ---
+static void testar_lista_de_comandos(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar();
+    const uint8_t comandos[] = {0xAE, 0xA7, 0x81, 0x40, 0xAF};
+    ssd1306_send_command_list(&painel, comandos, sizeof(comandos));
+    n_esperado = 0;
+    transacao(0x00, comandos, sizeof(comandos));
+    verificar(disparos == 1 && !hal_i2c_ocupado(1) && fio_igual(),
+              "lista de comandos: um START, o 0x00 e todos os bytes");
+}
+
+static void testar_quadro_inteiro(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar();
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        painel.buffer[i] = (uint8_t)(i * 7 + 3);
+    }
+    render_on_display(&painel);
+    ssd1306_wait(&painel);
+    const uint8_t enderecamento[] = {0x21, 0, 127, 0x22, 0, 7};
+    n_esperado = 0;
+    transacao(0x00, enderecamento, sizeof(enderecamento));
+    transacao(0x40, painel.buffer, ssd1306_buffer_length);
+    verificar(disparos == 1 && fio_igual(), "quadro: enderecamento e 1024 bytes com um so 0x40, um disparo");
+}
+
+// O envio retorna com o DMA ainda trabalhando; quem chama segue livre até consultar
+static void testar_sem_bloqueio(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar();
+    ssd1306_draw_string(&painel, 0, 0, "Temp");
+    render_changes_on_display(&painel);
+    // Uma única consulta, antes do disparo, para não sobrepor uma transmissão anterior
+    bool retornou_em_transito = consultas == 1 && em_transito != NULL && n_fio == 0;
+
+    // O laço principal consulta e faz outra coisa entre as consultas
+    int voltas = 0;
+    while (ssd1306_busy(&painel)) {
+        voltas++;
+    }
+    verificar(retornou_em_transito && voltas == CONSULTAS_EM_TRANSITO - 1 && n_fio > 0,
+              "render retorna sem esperar; o fim e visto por consulta");
+}
+
+// Um comando com o quadro ainda em trânsito espera o fim dele em vez de reescrever a fila
+static void testar_comando_durante_quadro(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar();
+    ssd1306_set_pixel(&painel, 5, 9, true);
+    render_changes_on_display(&painel);
+    const uint8_t invertido[] = {0xA7};
+    ssd1306_send_command(&painel, 0xA7);
+
+    const uint8_t pagina[128] = {[5] = 0x02};
+    n_esperado = 0;
+    for (int p = 0; p < 8; p++) {
+        const uint8_t enderecamento[] = {0x21, 0, 127, 0x22, p, p};
+        transacao(0x00, enderecamento, sizeof(enderecamento));
+        static const uint8_t zeros[128];
+        transacao(0x40, p == 1 ? pagina : zeros, 128);
+    }
+    transacao(0x00, invertido, sizeof(invertido));
+    verificar(disparos == 2 && disparos_sobrepostos == 0 && fio_igual(),
+              "comando espera o quadro em transito, que sai inteiro");
+}
+
+// A fila é persistente e fica no próprio painel: o mesmo endereço a cada quadro
+static void testar_fila_persistente(void) {
+    ssd1306_init(&painel, 1, 0x3C, 128, 64, false);
+    zerar();
+    const uint16_t *filas[3];
+    for (int i = 0; i < 3; i++) {
+        ssd1306_set_pixel(&painel, i, 0, true);
+        render_changes_on_display(&painel);
+        filas[i] = em_transito;
+        ssd1306_wait(&painel);
+    }
+    bool dentro = (const uint8_t *)filas[0] >= (const uint8_t *)&painel &&
+                  (const uint8_t *)filas[0] < (const uint8_t *)(&painel + 1);
+    verificar(filas[0] == painel.tx_words && filas[1] == filas[0] && filas[2] == filas[0] && dentro,
+              "fila de transmissao unica, dentro do painel, sem alocacao");
+}
+
+int main(void) {
+    testar_lista_de_comandos();
+    testar_quadro_inteiro();
+    testar_sem_bloqueio();
+    testar_comando_durante_quadro();
+    testar_fila_persistente();
+
+    printf("%s\n", falhas ? "FALHAS ENCONTRADAS" : "Todos os casos passaram");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,43 @@
+# Host tests (tools/testar_*.c and tools/simular_*.c): each one is an executable built from the test
+# and the modules it covers, the same files as the cc line in its header comment, and a ctest case
+# that passes when it exits with 0:
+#   cmake -S . -B build-sim -DSIMULACAO_HOST=ON && cmake --build build-sim && ctest --test-dir build-sim
+
+enable_testing()
+find_package(Threads REQUIRED)
+
+# adicionar_teste(<tools/ file name> [FONTES <inc/ and simulador/ sources>] [INCLUIR <extra include dirs>]
+#                 [BIBLIOTECAS <libraries>] [ARGUMENTOS <command line>])
+function(adicionar_teste NOME)
+    cmake_parse_arguments(TESTE "" "" "FONTES;INCLUIR;BIBLIOTECAS;ARGUMENTOS" ${ARGN})
+    add_executable(${NOME} tools/${NOME}.c ${TESTE_FONTES})
+    target_include_directories(${NOME} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR} ${TESTE_INCLUIR})
+    target_link_libraries(${NOME} PRIVATE ${TESTE_BIBLIOTECAS})
+    add_test(NAME ${NOME} COMMAND ${NOME} ${TESTE_ARGUMENTOS})
+endfunction()
+
+# The reference decoder of /api/history.bin, run by testar_serie_binaria on what the encoder wrote
+add_executable(decodificar_historico tools/decodificar_historico.c)
+
+adicionar_teste(testar_agregados FONTES inc/agregados.c BIBLIOTECAS m)
+adicionar_teste(testar_canal_spsc FONTES inc/canal_spsc.c BIBLIOTECAS Threads::Threads)
+adicionar_teste(testar_filtro_adc FONTES inc/filtro_adc.c)
+adicionar_teste(testar_flash_log FONTES inc/flash_log.c simulador/flash_nor.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/inc ${CMAKE_CURRENT_SOURCE_DIR}/simulador)
+adicionar_teste(testar_grafico_oled FONTES inc/oled_grafico.c)
+adicionar_teste(testar_historico FONTES inc/historico.c)
+adicionar_teste(testar_http_requisicao FONTES inc/http_requisicao.c)
+adicionar_teste(testar_json_sse FONTES inc/json.c inc/formato.c inc/http_fluxo.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/simulador/include)
+adicionar_teste(testar_regras FONTES inc/regras.c)
+adicionar_teste(testar_serie_binaria FONTES inc/serie_binaria.c ARGUMENTOS $<TARGET_FILE:decodificar_historico>)
+adicionar_teste(testar_ssd1306 FONTES inc/ssd1306_i2c.c inc/oled_texto.c inc/oled_grafico.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/simulador/include)
+adicionar_teste(testar_telemetria_mqtt FONTES inc/telemetria_mqtt.c inc/historico.c inc/json.c inc/formato.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/simulador/include)
+adicionar_teste(testar_texto_oled FONTES inc/oled_texto.c)
+adicionar_teste(testar_transporte_i2c FONTES inc/ssd1306_i2c.c inc/oled_texto.c inc/oled_grafico.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/simulador/include)
+adicionar_teste(simular_camadas FONTES inc/camadas.c inc/historico.c inc/flash_log.c simulador/flash_nor.c
+        INCLUIR ${CMAKE_CURRENT_SOURCE_DIR}/inc ${CMAKE_CURRENT_SOURCE_DIR}/simulador BIBLIOTECAS m)
+adicionar_teste(simular_dht11_pio ARGUMENTOS ${CMAKE_CURRENT_SOURCE_DIR}/dht11.pio)
@@ -0,0 +1,27 @@
+# Verifica, depois da ligação, se o firmware termina abaixo da região dos logs na flash
+# (FLASH_RESERVADA_DESLOCAMENTO, inc/flash_pico.h). Se passar, a primeira gravação de um log apagaria
+# o fim do próprio código; em vez disso, a compilação falha.
+# Uso: cmake -DNM=<nm> -DELF=<firmware elf> -DLIMITE=<endereço do início da região> -P verificar_flash.cmake
+
+cmake_minimum_required(VERSION 3.19)
+
+execute_process(COMMAND ${NM} --defined-only ${ELF}
+        OUTPUT_VARIABLE SIMBOLOS RESULT_VARIABLE RESULTADO)
+if (NOT RESULTADO EQUAL 0)
+    message(FATAL_ERROR "${NM} falhou em ${ELF}")
+endif()
+
+# __flash_binary_end vem do linker script do SDK: o fim do que é gravado na flash (código e dados)
+if (NOT "${SIMBOLOS}" MATCHES "(^|\n)([0-9a-fA-F]+) [A-Za-z] __flash_binary_end\n")
+    message(FATAL_ERROR "__flash_binary_end nao esta na tabela de simbolos de ${ELF}")
+endif()
+math(EXPR FIM "0x${CMAKE_MATCH_2}")
+math(EXPR LIMITE "${LIMITE}")
+
+if (FIM GREATER LIMITE)
+    math(EXPR EXCESSO "${FIM} - ${LIMITE}")
+    math(EXPR FIM_HEX "${FIM}" OUTPUT_FORMAT HEXADECIMAL)
+    math(EXPR LIMITE_HEX "${LIMITE}" OUTPUT_FORMAT HEXADECIMAL)
+    message(FATAL_ERROR "O firmware termina em ${FIM_HEX}, ${EXCESSO} bytes dentro da regiao dos logs, "
+            "que comeca em ${LIMITE_HEX}. Reduza o firmware ou os setores dos logs (inc/flash_pico.h).")
+endif()
@@ -0,0 +1,105 @@
+// Painel de controle: a página é estática (servida comprimida da flash). O estado inicial e o
+// histórico recente vêm de /api/status; depois, o firmware empurra as mudanças por /events (SSE).
+// As estatísticas móveis (/api/stats) são recarregadas a cada amostra nova do histórico.
+(function () {
+  var LINHAS_HISTORICO = 10;
+  var INTERVALO_MS = 10000;   // Só usado se o navegador não tiver EventSource
+
+  function doisDigitos(n) { return (n < 10 ? '0' : '') + n; }
+
+  // Os timestamps são segundos no horário do próprio RTC, então são exibidos sem conversão de fuso
+  function formatarData(epoch) {
+    var d = new Date(epoch * 1000);
+    return doisDigitos(d.getUTCDate()) + '/' + doisDigitos(d.getUTCMonth() + 1) + '/' + d.getUTCFullYear() + ' ' +
+      doisDigitos(d.getUTCHours()) + ':' + doisDigitos(d.getUTCMinutes()) + ':' + doisDigitos(d.getUTCSeconds());
+  }
+
+  function definir(id, texto) { document.getElementById(id).textContent = texto; }
+
+  function exibirEstado(s) {
+    definir('temperatura', s.temperatura.toFixed(1) + ' \u00b0C');
+    definir('umidade', s.umidade.toFixed(1) + ' %');
+    definir('luminosidade', s.luminosidade.toFixed(1) + ' %');
+    definir('itu', s.itu.toFixed(1));
+    definir('luz', s.luz ? 'Ligadas' : 'Desligadas');
+    definir('ventilador', s.ventilador ? 'Ligado' : 'Desligado');
+    definir('umidificador', s.umidificador ? 'Ligado' : 'Desligado');
+  }
+
+  // Amostra: [epoch, temperatura, umidade, luminosidade, relés], leituras em décimos.
+  // A mais nova fica no topo da tabela.
+  function inserirAmostra(corpo, h, noFim) {
+    var linha = corpo.insertRow(noFim ? -1 : 0);
+    linha.insertCell().textContent = formatarData(h[0]);
+    linha.insertCell().textContent = (h[1] / 10).toFixed(1) + ' \u00b0C';
+    linha.insertCell().textContent = (h[2] / 10).toFixed(1) + ' %';
+  }
+
+  function exibirStatus(s) {
+    exibirEstado(s);
+    var corpo = document.getElementById('historico');
+    corpo.textContent = '';
+    s.historico.forEach(function (h) { inserirAmostra(corpo, h, true); });
+  }
+
+  function resumo(r, unidade) {
+    return r ? r.min.toFixed(1) + ' / ' + r.media.toFixed(1) + ' / ' + r.max.toFixed(1) + unidade : '--';
+  }
+
+  function exibirAgregados(a) {
+    definir('faixa-itu', a.faixa);
+    var corpo = document.getElementById('agregados');
+    corpo.textContent = '';
+    a.janelas.forEach(function (jan) {
+      var linha = corpo.insertRow(-1);
+      linha.insertCell().textContent = jan.nome;
+      linha.insertCell().textContent = resumo(jan.temperatura, ' \u00b0C');
+      linha.insertCell().textContent = resumo(jan.umidade, ' %');
+      linha.insertCell().textContent = resumo(jan.itu, '');
+    });
+  }
+
+  function carregarAgregados() {
+    return fetch('/api/stats').then(function (r) { return r.json(); }).then(exibirAgregados);
+  }
+
+  function receberEvento(e) {
+    var s = JSON.parse(e.data);
+    exibirEstado(s);
+    if (s.amostras) {
+      var corpo = document.getElementById('historico');
+      s.amostras.forEach(function (h) { inserirAmostra(corpo, h, false); });
+      while (corpo.rows.length > LINHAS_HISTORICO) corpo.deleteRow(-1);
+      carregarAgregados().catch(function () {});
+    }
+  }
+
+  function carregarStatus() {
+    return fetch('/api/status').then(function (r) { return r.json(); }).then(exibirStatus).then(carregarAgregados);
+  }
+
+  function consultarPeriodicamente() {
+    carregarStatus()
+      .catch(function () {})
+      .then(function () { setTimeout(consultarPeriodicamente, INTERVALO_MS); });
+  }
+
+  if (!window.EventSource) {
+    consultarPeriodicamente();
+    return;
+  }
+
+  carregarStatus().catch(function () {});
+  var conectou = false;
+  var eventos = new EventSource('/events');
+  eventos.addEventListener('estado', receberEvento);
+  // Ao reconectar (retry do próprio EventSource), recarrega o histórico que pode ter sido perdido
+  eventos.addEventListener('open', function () {
+    if (conectou) carregarStatus().catch(function () {});
+    conectou = true;
+  });
+  // Recusado de vez (por exemplo, 503 com o servidor cheio): volta a consultar periodicamente
+  eventos.addEventListener('error', function () {
+    if (eventos.readyState === EventSource.CLOSED) consultarPeriodicamente();
+  });
+})();